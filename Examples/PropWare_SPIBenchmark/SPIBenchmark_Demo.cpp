@@ -0,0 +1,107 @@
+/**
+ * @file    SPIBenchmark_Demo.cpp
+ *
+ * @author  David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <PropWare/PropWare.h>
+#include <PropWare/hmi/output/printer.h>
+#include <PropWare/serial/spi/spi.h>
+
+using PropWare::Port;
+using PropWare::SPI;
+
+/** Pin number for MOSI (master out - slave in) */
+static const Port::Mask MOSI = Port::Mask::P0;
+/** Pin number for MISO (master in - slave out) */
+static const Port::Mask MISO = Port::Mask::P1;
+/** Pin number for the clock signal */
+static const Port::Mask SCLK = Port::Mask::P2;
+
+/** Same size as an SD card's sector */
+static const size_t BLOCK_SIZE = 512;
+
+static uint8_t buffer[BLOCK_SIZE];
+
+static void report (const char name[], const unsigned int cycles);
+
+/**
+ * @example     SPIBenchmark_Demo.cpp
+ *
+ * Count the system clock cycles needed to move a 512-byte block with each of PropWare::SPI's transfer routines, from
+ * the word-at-a-time shift_out/shift_in up to the counter-clocked PropWare::SPI::shift_out_block_nco and
+ * PropWare::SPI::shift_in_block_nco. Connect a logic analyzer to the SCLK pin to see each clock rate.
+ *
+ * @include PropWare_SPIBenchmark/CMakeLists.txt
+ */
+int main () {
+    const SPI spi(MOSI, MISO, SCLK, CLKFREQ / 20, SPI::Mode::MODE_0, SPI::BitMode::MSB_FIRST);
+    unsigned int start;
+
+    for (size_t i = 0; i < BLOCK_SIZE; ++i)
+        buffer[i] = (uint8_t) i;
+
+    pwOut << "System clock cycles to transfer " << (unsigned int) BLOCK_SIZE << " bytes at " << CLKFREQ << " Hz\n";
+    pwOut << "================================================\n";
+
+    start = CNT;
+    for (size_t i = 0; i < BLOCK_SIZE; ++i)
+        spi.shift_out(8, buffer[i]);
+    report("shift_out (8 bits at a time)", CNT - start);
+
+    start = CNT;
+    spi.shift_out_block_msb_first_fast(buffer, BLOCK_SIZE);
+    report("shift_out_block_msb_first_fast", CNT - start);
+
+    start = CNT;
+    spi.shift_out_block(buffer, BLOCK_SIZE);
+    report("shift_out_block", CNT - start);
+
+    start = CNT;
+    spi.shift_out_block_nco(buffer, BLOCK_SIZE);
+    report("shift_out_block_nco", CNT - start);
+
+    start = CNT;
+    for (size_t i = 0; i < BLOCK_SIZE; ++i)
+        buffer[i] = (uint8_t) spi.shift_in(8);
+    report("shift_in (8 bits at a time)", CNT - start);
+
+    start = CNT;
+    spi.shift_in_block_mode0_msb_first_fast(buffer, BLOCK_SIZE);
+    report("shift_in_block_mode0_msb_first_fast", CNT - start);
+
+    start = CNT;
+    spi.shift_in_block(buffer, BLOCK_SIZE);
+    report("shift_in_block", CNT - start);
+
+    start = CNT;
+    spi.shift_in_block_nco(buffer, BLOCK_SIZE);
+    report("shift_in_block_nco", CNT - start);
+
+    pwOut << "Counter-generated SCLK runs at " << SPI::get_nco_clock() << " Hz\n";
+    return 0;
+}
+
+void report (const char name[], const unsigned int cycles) {
+    const unsigned int bytesPerSecond = (unsigned int) ((uint64_t) BLOCK_SIZE * CLKFREQ / cycles);
+    pwOut << name << ": " << cycles << " cycles (" << bytesPerSecond / 1000 << " kB/s)\n";
+}
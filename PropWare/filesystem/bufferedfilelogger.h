@@ -0,0 +1,356 @@
+/**
+ * @file        PropWare/filesystem/bufferedfilelogger.h
+ *
+ * @author      David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <string.h>
+#include <PropWare/PropWare.h>
+#include <PropWare/concurrent/runnable.h>
+#include <PropWare/filesystem/filewriter.h>
+#include <PropWare/hmi/output/printcapable.h>
+#include <PropWare/utility/utility.h>
+
+namespace PropWare {
+
+/**
+ * @brief   Write-behind logger: producers append records to a hub RAM ring buffer and a dedicated cog drains it to a
+ *          file, one whole sector at a time
+ *
+ * Writing to an SD card directly can stall the calling cog for tens of milliseconds whenever the card decides to erase
+ * a block. With a BufferedFileLogger, only the flusher cog ever waits on the card. Appending a record is a bounded
+ * copy into the ring and never blocks: if the ring does not have room for the whole record, the record is dropped
+ * and counted instead. Use the high-water mark and the overflow counters to size the ring for your workload.
+ *
+ * A single producer needs no lock at all - the producer only ever moves the head and the flusher only ever moves the
+ * tail. The Propeller has no compare-and-swap, so when several cogs append to the same logger, pass a hardware lock to
+ * the constructor. It is held only while a record is copied into the ring (never during card I/O), so a producer
+ * waits for at most one other producer's copy.
+ *
+ * @code
+ * #include <PropWare/PropWare.h>
+ * #include <PropWare/memory/sd.h>
+ * #include <PropWare/filesystem/fat/fatfs.h>
+ * #include <PropWare/filesystem/fat/fatfilewriter.h>
+ * #include <PropWare/filesystem/bufferedfilelogger.h>
+ *
+ * char     ring[4096];
+ * uint32_t stack[192];
+ *
+ * int main () {
+ *     const PropWare::SD driver;
+ *     PropWare::FatFS    filesystem(driver);
+ *     filesystem.mount();
+ *
+ *     PropWare::FatFileWriter writer(filesystem, "data.log");
+ *     writer.open();
+ *
+ *     PropWare::BufferedFileLogger logger(writer, ring, stack);
+ *     PropWare::Runnable::invoke(logger);
+ *
+ *     const PropWare::Printer log(logger);
+ *     for (int i = 0; i < 1000; ++i)
+ *         log.printf("%d,%u\n", i, CNT);
+ *
+ *     logger.stop();
+ *     while (logger.is_running());
+ *     writer.close();
+ *     pwOut << "Ring high-water mark: " << logger.get_high_water_mark() << '\n';
+ * }
+ * @endcode
+ */
+class BufferedFileLogger : public Runnable,
+                           public PrintCapable {
+    public:
+        /** Pass as the lock number when only a single cog appends to the logger */
+        static const int      NO_LOCK     = -1;
+        /** Each write to the file ends on a multiple of this many bytes into it (except when flushing or stopping) */
+        static const uint16_t SECTOR_SIZE = 512;
+
+        typedef enum {
+            /** No error */ NO_ERROR = 0
+        } ErrorCode;
+
+    public:
+        /**
+         * @brief       Construct a logger that drains to an already-open file
+         *
+         * @param[in]   writer          File that all records are appended to. It must be open before the flusher
+         *                              is started, and must only be used by the flusher cog until the flusher stops
+         * @param[in]   ring[]          Statically-allocated ring buffer. Its size must be a power of two and at least
+         *                              one sector
+         * @param[in]   stack[]         Stack for the flusher cog
+         * @param[in]   lockNumber      Hardware lock that serializes producers, or BufferedFileLogger::NO_LOCK when
+         *                              only a single cog calls BufferedFileLogger::append
+         */
+        template<size_t RING_SIZE, size_t STACK_SIZE>
+        BufferedFileLogger (FileWriter &writer, char (&ring)[RING_SIZE], const uint32_t (&stack)[STACK_SIZE],
+                            const int lockNumber = NO_LOCK)
+                : Runnable(stack),
+                  m_writer(&writer),
+                  m_ring(ring),
+                  m_ringMask(RING_SIZE - 1),
+                  m_lock(lockNumber),
+                  m_head(0),
+                  m_tail(0),
+                  m_flushRequests(0),
+                  m_flushesServed(0),
+                  m_stopRequested(false),
+                  m_running(false),
+                  m_error(NO_ERROR) {
+            static_assert(0 == (RING_SIZE & (RING_SIZE - 1)), "Ring buffer size must be a power of two");
+            static_assert(SECTOR_SIZE <= RING_SIZE, "Ring buffer must hold at least one sector");
+            this->reset_statistics();
+            if (NO_LOCK != this->m_lock)
+                lockclr(this->m_lock);
+        }
+
+        /**
+         * @brief       Append a record to the ring without waiting for the card
+         *
+         * The record is either copied in full or not at all, so records never end up torn in the file.
+         *
+         * @param[in]   *record     Data to be logged
+         * @param[in]   length      Number of bytes in the record
+         *
+         * @return      True if the record was queued, false if the ring was full and the record was dropped
+         */
+        bool append (const void *record, const size_t length) {
+            if (NO_LOCK != this->m_lock)
+                while (lockset(this->m_lock));
+
+            const uint32_t head     = this->m_head;
+            const uint32_t pending  = head - this->m_tail;
+            const uint32_t capacity = this->m_ringMask + 1;
+            const bool     fits     = length <= capacity - pending;
+            if (fits) {
+                // Copy in (at most) two pieces: up to the end of the ring and then from its start
+                const uint32_t offset = head & this->m_ringMask;
+                const size_t   first  = length < capacity - offset ? length : capacity - offset;
+                memcpy(&this->m_ring[offset], record, first);
+                memcpy(this->m_ring, (const char *) record + first, length - first);
+
+                // The record must be in the ring before the flusher can see the new head
+                Utility::memory_barrier();
+                this->m_head = head + length;
+
+                if (pending + length > this->m_highWaterMark)
+                    this->m_highWaterMark = pending + length;
+            } else {
+                ++this->m_droppedRecords;
+                this->m_droppedBytes += length;
+            }
+
+            if (NO_LOCK != this->m_lock)
+                lockclr(this->m_lock);
+            return fits;
+        }
+
+        /**
+         * @brief       Append a null-terminated string as a single record
+         *
+         * @param[in]   string[]    Characters to be logged (the null terminator is not written)
+         *
+         * @return      True if the record was queued, false if it was dropped
+         */
+        bool append (const char string[]) {
+            return this->append(string, strlen(string));
+        }
+
+        void put_char (const char c) {
+            this->append(&c, 1);
+        }
+
+        void puts (const char string[]) {
+            this->append(string);
+        }
+
+        /**
+         * @brief   Ask the flusher to write everything queued so far - including a partial sector - and flush the file
+         *
+         * Returns immediately; use BufferedFileLogger::is_flush_pending to find out when the flush has completed.
+         */
+        void flush () {
+            if (NO_LOCK != this->m_lock)
+                while (lockset(this->m_lock));
+            ++this->m_flushRequests;
+            if (NO_LOCK != this->m_lock)
+                lockclr(this->m_lock);
+        }
+
+        /**
+         * @brief   Determine whether a flush requested with BufferedFileLogger::flush has not yet completed
+         */
+        bool is_flush_pending () const {
+            return this->m_flushRequests != this->m_flushesServed;
+        }
+
+        /**
+         * @brief   Ask the flusher to drain the ring, flush the file and then return from BufferedFileLogger::run
+         */
+        void stop () {
+            this->m_stopRequested = true;
+        }
+
+        /**
+         * @brief   Determine whether the flusher is still running. It stops after BufferedFileLogger::stop or on the
+         *          first error from the file (see BufferedFileLogger::get_error)
+         */
+        bool is_running () const {
+            return this->m_running;
+        }
+
+        /**
+         * @brief   First error returned by the file, or 0 if every write has succeeded
+         */
+        PropWare::ErrorCode get_error () const {
+            return this->m_error;
+        }
+
+        /**
+         * @brief   Number of bytes the ring can hold
+         */
+        uint32_t get_capacity () const {
+            return this->m_ringMask + 1;
+        }
+
+        /**
+         * @brief   Number of bytes appended but not yet written to the file
+         */
+        uint32_t get_pending_bytes () const {
+            return this->m_head - this->m_tail;
+        }
+
+        /**
+         * @brief   Largest number of bytes that have been waiting in the ring at once, since construction or the last
+         *          call to BufferedFileLogger::reset_statistics
+         */
+        uint32_t get_high_water_mark () const {
+            return this->m_highWaterMark;
+        }
+
+        /**
+         * @brief   Number of records dropped because the ring was full
+         */
+        uint32_t get_dropped_records () const {
+            return this->m_droppedRecords;
+        }
+
+        /**
+         * @brief   Total length of all records dropped because the ring was full
+         */
+        uint32_t get_dropped_bytes () const {
+            return this->m_droppedBytes;
+        }
+
+        /**
+         * @brief   Reset the high-water mark and overflow counters
+         */
+        void reset_statistics () {
+            this->m_highWaterMark  = 0;
+            this->m_droppedRecords = 0;
+            this->m_droppedBytes   = 0;
+        }
+
+        /**
+         * @brief   Flusher loop: drain whole sectors from the ring to the file until asked to stop
+         */
+        void run () {
+            this->m_running = true;
+
+            // The file offset of ring position t is fileSkew + t (modulo 2^32, which is all the alignment needs)
+            const uint32_t fileSkew = static_cast<uint32_t>(this->m_writer->tell()) - this->m_tail;
+
+            while (!this->m_error) {
+                // Read the requests before the head, so that everything appended before a request is drained by it
+                const bool     stopping = this->m_stopRequested;
+                const uint32_t requests = this->m_flushRequests;
+                const bool     flushing = stopping || requests != this->m_flushesServed;
+                Utility::memory_barrier();
+                const uint32_t tail     = this->m_tail;
+                const uint32_t pending  = this->m_head - tail;
+
+                // End each write on a sector boundary of the file, so that the file is handed whole, aligned sectors
+                // that it can write - as a multi-block write when several are queued - without reading them back
+                // first. A file opened for appending may be part-way into a sector, so the first write completes it
+                const uint32_t end   = fileSkew + tail + pending;
+                const uint32_t whole = (end & ~((uint32_t) SECTOR_SIZE - 1)) - fileSkew - tail;
+                if (whole <= pending && whole)
+                    this->m_error = this->drain(tail, whole);
+                else if (flushing) {
+                    if (pending)
+                        this->m_error = this->drain(tail, pending);
+                    if (!this->m_error)
+                        this->m_error = this->m_writer->flush();
+                    // Only the requests sampled above are served; any made since are left for the next pass
+                    this->m_flushesServed = requests;
+                    if (stopping)
+                        break;
+                }
+            }
+
+            this->m_running = false;
+        }
+
+    private:
+        PropWare::ErrorCode drain (const uint32_t tail, const uint32_t length) {
+            PropWare::ErrorCode err;
+
+            // Write (at most) two pieces: up to the end of the ring and then from its start
+            const uint32_t capacity = this->m_ringMask + 1;
+            const uint32_t offset   = tail & this->m_ringMask;
+            const uint32_t first    = Utility::min(length, capacity - offset);
+            check_errors(this->m_writer->write((const uint8_t *) &this->m_ring[offset], first));
+            if (first < length) {
+                check_errors(this->m_writer->write((const uint8_t *) this->m_ring, length - first));
+            }
+
+            // Only release the space once the file is done with it
+            Utility::memory_barrier();
+            this->m_tail = tail + length;
+            return NO_ERROR;
+        }
+
+    private:
+        FileWriter                   *m_writer;
+        char                         *m_ring;
+        const uint32_t               m_ringMask;
+        const int                    m_lock;
+        /** Total number of bytes ever appended; only moved by producers */
+        volatile uint32_t            m_head;
+        /** Total number of bytes ever written to the file; only moved by the flusher */
+        volatile uint32_t            m_tail;
+        /** Number of calls to BufferedFileLogger::flush; only moved by producers */
+        volatile uint32_t            m_flushRequests;
+        /** Value of m_flushRequests when the flusher last sampled it before flushing; only moved by the flusher */
+        volatile uint32_t            m_flushesServed;
+        volatile bool                m_stopRequested;
+        volatile bool                m_running;
+        volatile PropWare::ErrorCode m_error;
+        volatile uint32_t            m_highWaterMark;
+        volatile uint32_t            m_droppedRecords;
+        volatile uint32_t            m_droppedBytes;
+};
+
+}
@@ -0,0 +1,283 @@
+/**
+ * @file        PropWare/filesystem/fat/fatdirectoryiterator.h
+ *
+ * @author      David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <PropWare/filesystem/fat/fatfile.h>
+
+namespace PropWare {
+
+extern BlockStorage::Buffer SHARED_BUFFER;
+
+/**
+ * @brief   List the current working directory of a FAT 16, FAT 32 or exFAT storage device
+ *
+ * Every sector of the directory is read exactly once, so listing a directory of N entries costs N / 16 sector reads
+ * (with 512-byte sectors) instead of the N² / 32 it costs to call `FatFile::find` for each of them. Deleted entries,
+ * volume labels and long file name entries are skipped. On exFAT, each entry set is returned with its full name (see
+ * PropWare::FatFS for the names which are supported).
+ *
+ * @code
+ * int main () {
+ *     const SD driver;
+ *     FatFS filesystem(driver);
+ *     filesystem.mount();
+ *
+ *     FatDirectoryIterator        iterator(filesystem);
+ *     FatDirectoryIterator::Entry entry;
+ *     PropWare::ErrorCode         err;
+ *     while (!(err = iterator.next(&entry)))
+ *         pwOut << entry.name << (entry.is_directory() ? "/ " : " ") << entry.size << '\n';
+ *
+ *     if (FatFS::EOC_END != err)
+ *         pwOut << "Listing failed: " << err << '\n';
+ *     return 0;
+ * }
+ * @endcode
+ *
+ * The iterator can share a buffer with open files: files may be opened, read and written between calls to
+ * `FatDirectoryIterator::next`, at the cost of one more read to get the directory's sector back.
+ */
+class FatDirectoryIterator {
+    public:
+        typedef enum {
+            /** No error */ NO_ERROR = 0
+        } ErrorCode;
+
+        /**
+         * @brief   One file or sub-directory in the directory
+         */
+        struct Entry {
+            /** Short (8.3) name, with a period before the extension if there is one - or the full name on exFAT */
+            char     name[FatFS::EXFAT_MAX_NAME_LENGTH + 1];
+            /** Attribute flags, such as FatFile::SUB_DIR */
+            uint8_t  attributes;
+            /** Length of the file in bytes (always 0 for a directory) */
+            uint32_t size;
+            /** First cluster of the file or directory, or 0 if nothing has been allocated to it yet */
+            uint32_t firstCluster;
+
+            bool is_directory () const {
+                return FatFile::SUB_DIR & this->attributes;
+            }
+        };
+
+    public:
+        /**
+         * @brief       Construct an iterator positioned before the first entry of the current working directory
+         *
+         * @param[in]   fs          A mounted filesystem
+         * @param[in]   buffer      Buffer for directory sectors. If left as the default, the shared buffer is used
+         */
+        FatDirectoryIterator (FatFS &fs, BlockStorage::Buffer &buffer = SHARED_BUFFER)
+                : m_fs(&fs),
+                  m_driver(fs.get_driver()),
+                  m_buf(&buffer) {
+            this->m_meta.name = "Directory iterator";
+            this->rewind();
+        }
+
+        ~FatDirectoryIterator () {
+            // Don't leave a shared buffer pointing at metadata that is going away
+            if (&this->m_meta == this->m_buf->meta)
+                this->m_buf->meta = NULL;
+        }
+
+        /**
+         * @brief   Start over from the first entry of the current working directory
+         */
+        void rewind () {
+            const FatFS *fs = this->m_fs;
+
+            this->m_entryOffset         = 0;
+            this->m_loaded              = false;
+            this->m_finished            = false;
+            this->m_meta.curTier1Offset = 0;
+            this->m_meta.curTier2       = fs->m_dir_firstCluster;
+            this->m_meta.curTier2Addr   = this->in_fat16_root() ? fs->m_rootAddr
+                                                                : fs->compute_tier1_from_tier2(fs->m_dir_firstCluster);
+            // Looked up when the first sector is loaded
+            this->m_meta.nextTier2      = 0;
+            // The iterator never modifies a directory sector, so flushing the buffer must never write one back
+            this->m_meta.mod            = false;
+        }
+
+        /**
+         * @brief       Move to the next file or sub-directory
+         *
+         * @param[out]  *entry  Filled in with the entry's name, attributes, size and first cluster
+         *
+         * @return      0 upon success, FatFS::EOC_END once every entry has been returned, or another error code
+         */
+        PropWare::ErrorCode next (Entry *entry) {
+            PropWare::ErrorCode err;
+
+            if (this->m_finished)
+                return FatFS::EOC_END;
+            else if (FatFS::EX_FAT == this->m_fs->m_filesystem)
+                return this->next_entry_set(entry);
+
+            if (!this->m_loaded) {
+                check_errors(this->load_first_sector());
+            } else {
+                check_errors(this->claim_buffer());
+                check_errors(this->advance());
+            }
+
+            while (true) {
+                const uint8_t *fileEntry  = &this->m_buf->buf[this->m_entryOffset];
+                const uint8_t attributes = fileEntry[FatFile::FILE_ATTRIBUTE_OFFSET];
+
+                if (!fileEntry[0]) {
+                    // The first free entry marks the end of the directory
+                    this->m_finished = true;
+                    return FatFS::EOC_END;
+                } else if (FatFile::DELETED_FILE_MARK != fileEntry[0] && !(FatFile::VOLUME_ID & attributes)) {
+                    this->read_entry(fileEntry, entry);
+                    return NO_ERROR;
+                }
+
+                check_errors(this->advance());
+            }
+        }
+
+    private:
+        PropWare::ErrorCode next_entry_set (Entry *entry) {
+            PropWare::ErrorCode err;
+            FatFS::ExFatEntry   set;
+
+            if (!this->m_loaded) {
+                check_errors(this->load_first_sector());
+            } else {
+                check_errors(this->claim_buffer());
+            }
+
+            err = this->m_fs->next_entry_set(this->m_buf, &this->m_entryOffset, &set);
+            if (FatFS::PATH_NOT_FOUND == err || FatFS::EOC_END == err) {
+                this->m_finished = true;
+                return FatFS::EOC_END;
+            } else if (err)
+                return err;
+
+            strcpy(entry->name, set.name);
+            entry->attributes   = (uint8_t) set.attributes;
+            if (entry->is_directory())
+                entry->size = 0;
+            else
+                entry->size = UINT32_MAX < set.validDataLength ? UINT32_MAX : (uint32_t) set.validDataLength;
+            entry->firstCluster = set.firstCluster;
+            return NO_ERROR;
+        }
+
+        bool in_fat16_root () const {
+            return FatFS::FAT_16 == this->m_fs->m_filesystem && (uint32_t) -1 == this->m_meta.curTier2;
+        }
+
+        PropWare::ErrorCode load_first_sector () {
+            PropWare::ErrorCode err;
+
+            if (!this->in_fat16_root()) {
+                check_errors(this->m_fs->get_fat_value(this->m_meta.curTier2, &this->m_meta.nextTier2));
+            }
+            check_errors(this->m_driver->flush(this->m_buf));
+            this->m_buf->meta = &this->m_meta;
+            this->m_loaded    = true;
+            return this->m_driver->reload_buffer(this->m_buf);
+        }
+
+        /**
+         * @brief   Make sure the buffer still holds the directory sector, in case a file has used it in the meantime
+         */
+        PropWare::ErrorCode claim_buffer () {
+            PropWare::ErrorCode err;
+
+            if (&this->m_meta != this->m_buf->meta) {
+                check_errors(this->m_driver->flush(this->m_buf));
+                this->m_buf->meta = &this->m_meta;
+                check_errors(this->m_driver->reload_buffer(this->m_buf));
+            }
+            return NO_ERROR;
+        }
+
+        /**
+         * @brief   Step to the next entry, loading the directory's next sector when the current one is finished
+         */
+        PropWare::ErrorCode advance () {
+            PropWare::ErrorCode err;
+
+            this->m_entryOffset += FatFile::FILE_ENTRY_LENGTH;
+            if (this->m_driver->get_sector_size() != this->m_entryOffset)
+                return NO_ERROR;
+            this->m_entryOffset = 0;
+
+            BlockStorage::MetaData *meta = &this->m_meta;
+            if (this->in_fat16_root()) {
+                if (this->m_fs->m_rootDirSectors == meta->curTier1Offset + 1) {
+                    this->m_finished = true;
+                    return FatFS::EOC_END;
+                }
+                ++meta->curTier1Offset;
+            } else if ((1U << this->m_fs->get_tier1s_per_tier2_shift()) == meta->curTier1Offset + 1) {
+                if (this->m_fs->is_eoc(meta->nextTier2)) {
+                    this->m_finished = true;
+                    return FatFS::EOC_END;
+                }
+                meta->curTier2       = meta->nextTier2;
+                meta->curTier2Addr   = this->m_fs->compute_tier1_from_tier2(meta->curTier2);
+                meta->curTier1Offset = 0;
+                check_errors(this->m_fs->get_fat_value(meta->curTier2, &meta->nextTier2));
+            } else
+                ++meta->curTier1Offset;
+
+            // Directory sectors are only ever read, so there is nothing to flush
+            return this->m_driver->reload_buffer(this->m_buf);
+        }
+
+        void read_entry (const uint8_t fileEntry[], Entry *entry) const {
+            FatFile::get_filename(fileEntry, entry->name);
+            entry->attributes   = fileEntry[FatFile::FILE_ATTRIBUTE_OFFSET];
+            entry->size         = this->m_driver->get_long(FatFile::FILE_LEN_OFFSET, fileEntry);
+            entry->firstCluster = this->m_driver->get_short(FatFile::FILE_START_CLSTR_LOW, fileEntry);
+            if (FatFS::FAT_32 == this->m_fs->m_filesystem) {
+                const uint32_t highWord = this->m_driver->get_short(FatFile::FILE_START_CLSTR_HIGH, fileEntry);
+                // The highest 4 bits are always reserved
+                entry->firstCluster = (entry->firstCluster | highWord << 16) & 0x0FFFFFFF;
+            }
+        }
+
+    private:
+        FatFS                  *m_fs;
+        const BlockStorage     *m_driver;
+        BlockStorage::Buffer   *m_buf;
+        BlockStorage::MetaData m_meta;
+        /** Offset within the loaded sector of the current entry */
+        uint16_t               m_entryOffset;
+        /** Set once the first sector has been read */
+        bool                   m_loaded;
+        /** Set once the end of the directory has been reached */
+        bool                   m_finished;
+};
+
+}
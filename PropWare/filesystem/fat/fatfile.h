@@ -31,18 +31,35 @@
 namespace PropWare {
 
 /**
- * @brief   A generic interface for all files on the FAT 16/32 filesystem
+ * @brief   A generic interface for all files on the FAT 16/32 and exFAT filesystems
  */
 class FatFile : virtual public File {
+        friend class FatDirectoryIterator;
+
     public:
         typedef enum {
                                     NO_ERROR       = 0,
                                     BEG_ERROR      = Filesystem::END_ERROR + 1,
             /** FatFile Error  0 */ ENTRY_NOT_FILE = BEG_ERROR,
             /** FatFile Error  1 */ FILENAME_NOT_FOUND,
-                                    END_ERROR      = FILENAME_NOT_FOUND
+            /** FatFile Error  2 */ UNALIGNED_ACCESS,
+            /** FatFile Error  3 */ FILE_TOO_LARGE,
+            /** FatFile Error  4 */ SECTOR_NOT_BORROWED,
+                                    END_ERROR      = SECTOR_NOT_BORROWED
         } ErrorCode;
 
+        /**
+         * @brief   A run of clusters that are consecutive both in the file and on the storage device
+         */
+        struct Extent {
+            /** Index of the run's first cluster, counting from the beginning of the file */
+            uint32_t fileTier2;
+            /** Cluster number of the run's first cluster */
+            uint32_t tier2;
+            /** Number of clusters in the run */
+            uint32_t length;
+        };
+
     public:
         /**
          * @brief   Determine the name of a file
@@ -54,14 +71,22 @@ class FatFile : virtual public File {
             return this->m_name;
         }
 
+        /**
+         * @brief   Determine the name of a file without the path of its directory: "RUN.CSV" for a file named
+         *          "2026/10/16/run.csv"
+         */
+        const char *get_entry_name () const {
+            return &this->m_name[this->m_entryNameOffset];
+        }
+
         /**
          * @brief       Determine if a file exists (file does not have to be open)
          *
          * @returns     True if the file exists, false otherwise
          */
         bool exists () const {
-            uint16_t temp = 0;
-            return NO_ERROR == this->find(this->get_name(), &temp);
+            PropWare::ErrorCode err;
+            return this->exists(err);
         }
 
         /**
@@ -71,21 +96,119 @@ class FatFile : virtual public File {
          */
         bool exists (PropWare::ErrorCode &err) const {
             uint16_t temp = 0;
-            err = this->find(this->get_name(), &temp);
+            uint32_t previousDirectory;
+
+            if (!(err = this->enter_parent_directory(&previousDirectory))) {
+                err = this->find(this->get_entry_name(), &temp);
+                this->leave_parent_directory(previousDirectory);
+            }
             return NO_ERROR == err;
         }
 
+        /**
+         * @brief       Remember the file's cluster chain in the given statically-allocated array of extents
+         *
+         * The chain is recorded lazily, as the FAT is walked during normal reads, writes and seeks. Once a cluster
+         * has been recorded, moving to it (in either direction) no longer requires reading the FAT. Each extent holds
+         * one run of contiguous clusters, so even a small array covers a large, unfragmented file. When the array is
+         * full, clusters beyond the last extent are found by walking the FAT from the end of the last extent.
+         *
+         * @param[in]   extents     Statically allocated instance of an array, NOT a pointer
+         */
+        template<size_t N>
+        void set_extent_cache (Extent (&extents)[N]) {
+            this->set_extent_cache(extents, N);
+        }
+
+        /**
+         * @overload
+         *
+         * @param[in]   *extents    Address where the array begins. Pass `NULL` to disable the cache
+         * @param[in]   length      Number of extents allocated for the array
+         */
+        void set_extent_cache (Extent *extents, const size_t length) {
+            this->m_extents        = extents;
+            this->m_extentCapacity = length;
+            this->reset_extent_cache();
+            if (this->m_open)
+                this->record_extent(0, this->firstTier2);
+        }
+
+        /**
+         * @brief   Determine how many extents are currently recorded in the extent cache
+         */
+        size_t get_extent_count () const {
+            return this->m_extentCount;
+        }
+
     protected:
 
+        /**
+         * @param[in]   name[]  Name of the file, optionally preceded by the path of its directory such as
+         *                      "2026/10/16/run.csv" (see PropWare::FatFS::chdir). The whole path, including the
+         *                      null-terminator, must fit in PropWare::File::MAX_FILENAME_LENGTH characters
+         */
         FatFile (FatFS &fs, const char name[], BlockStorage::Buffer &buffer, const Printer &logger = pwOut)
                 : File(fs, name, buffer, logger),
-                  m_fs(&fs) {
+                  m_fs(&fs),
+                  m_extents(NULL),
+                  m_extentCapacity(0),
+                  m_extentCount(0),
+                  m_extentCoverage(0),
+                  m_reservedBegin(0),
+                  m_reservedEnd(0),
+                  m_noFatChain(false),
+                  m_borrowedSector(NO_TIER1) {
             strcpy(this->m_name, name);
-            Utility::to_upper(this->m_name);
+            // Short names are always upper case, but exFAT preserves the case a name was created with
+            if (FatFS::EX_FAT != fs.m_filesystem)
+                Utility::to_upper(this->m_name);
+
+            const char *lastSlash = strrchr(this->m_name, '/');
+            this->m_entryNameOffset = (uint8_t) (lastSlash ? lastSlash - this->m_name + 1 : 0);
+        }
+
+        virtual ~FatFile () {
+            // The buffer is usually shared with other files - don't leave it pointing at metadata that is going away
+            if (&this->m_contentMeta == this->m_buf->meta || &this->m_dirEntryMeta == this->m_buf->meta) {
+                this->m_driver->flush(this->m_buf);
+                this->m_buf->meta = NULL;
+            }
+        }
+
+        /**
+         * @brief       Make the directory holding this file the filesystem's working directory, for the duration of
+         *              an operation that searches for or creates the file's entry
+         *
+         * Files named without a path stay in the working directory
+         *
+         * @param[out]  *previousDirectory  First cluster of the working directory, to be given to
+         *                                  FatFile::leave_parent_directory when done
+         *
+         * @return      0 upon success, error code otherwise (the working directory is unchanged)
+         */
+        PropWare::ErrorCode enter_parent_directory (uint32_t *previousDirectory) const {
+            PropWare::ErrorCode err;
+            uint32_t            parent;
+
+            *previousDirectory = this->m_fs->m_dir_firstCluster;
+            if (this->m_entryNameOffset) {
+                check_errors(this->m_fs->resolve_directory(this->m_name, this->m_entryNameOffset, this->m_buf,
+                                                           &parent));
+                this->m_fs->m_dir_firstCluster = parent;
+            }
+            return NO_ERROR;
+        }
+
+        void leave_parent_directory (const uint32_t previousDirectory) const {
+            this->m_fs->m_dir_firstCluster = previousDirectory;
         }
 
         const uint8_t get_file_attributes (uint16_t fileEntryOffset) const {
-            return this->m_buf->buf[fileEntryOffset + FILE_ATTRIBUTE_OFFSET];
+            if (FatFS::EX_FAT == this->m_fs->m_filesystem)
+                return this->m_buf->buf[fileEntryOffset + FatFS::EXFAT_FILE_ATTRIBUTES];
+            else
+                return this->m_buf->buf[fileEntryOffset + FILE_ATTRIBUTE_OFFSET];
         }
 
         const bool is_directory (uint16_t fileEntryOffset) const {
@@ -99,6 +222,9 @@ class FatFile : virtual public File {
          * current directory; its relative location is communicated by
          * placing it in the address of *fileEntryOffset
          *
+         * If the filesystem has a directory index (see FatFS::set_directory_index), the first search scans the entire
+         * directory to build it and subsequent searches only load the sector holding the result.
+         *
          * @param[out]  *fileEntryOffset    The buffer offset will be returned
          *                                  via this address if the file is
          *                                  found
@@ -111,38 +237,42 @@ class FatFile : virtual public File {
          */
         PropWare::ErrorCode find (const char *filename, uint16_t *fileEntryOffset) const {
             PropWare::ErrorCode err;
-            char                readEntryName[FILENAME_STR_LEN];
 
-            *fileEntryOffset = 0;
+            if (FatFS::EX_FAT == this->m_fs->m_filesystem)
+                return this->find_entry_set(filename, fileEntryOffset);
 
-            check_errors(this->reload_directory_start());
-
-            // Loop through all entries in the current directory until we find the correct one
-            // Function will exit normally with FatFS::EOC_END error code if the file is not found
-            while (this->m_buf->buf[*fileEntryOffset]) {
-                // Check if file is valid, retrieve the name if it is
-                if (!this->file_deleted(*fileEntryOffset)) {
-                    this->get_filename(&this->m_buf->buf[*fileEntryOffset], readEntryName);
-                    if (!strcmp(filename, readEntryName))
-                        // File names match, return 0 to indicate a successful search
-                        return 0;
-                }
-
-                // Increment to the next file
-                *fileEntryOffset += FILE_ENTRY_LENGTH;
+            if (this->m_fs->directory_index_ready()) {
+                err = this->find_indexed(filename, fileEntryOffset);
+                // Anything but an unknown end of directory is conclusive. Otherwise, scan so that the buffer is left
+                // at the end of the directory, just like an unindexed search
+                if (FatFS::EOC_END != err)
+                    return err;
+            }
 
-                // If it was the last entry in this sector, proceed to the next
-                // one
-                if (this->m_driver->get_sector_size() == *fileEntryOffset) {
-                    // Last entry in the sector, attempt to load a new sector
-                    // Possible error value includes end-of-chain marker
-                    check_errors(this->load_next_sector(this->m_buf));
+            // A directory known to overflow the index is searched the same way as without one
+            if (NULL == this->m_fs->m_dirIndex || this->m_fs->directory_index_overflowed())
+                return this->find_by_scanning(filename, fileEntryOffset);
 
-                    *fileEntryOffset = 0;
-                }
-            }
+            this->m_fs->begin_directory_index();
+            err = this->find_by_scanning(filename, fileEntryOffset);
+            if (FatFile::FILENAME_NOT_FOUND != err && FatFS::EOC_END != err && NO_ERROR != err)
+                this->m_fs->invalidate_directory_index();
+            return err;
+        }
 
-            return FatFile::FILENAME_NOT_FOUND;
+        /**
+         * @brief       Search the current exFAT directory for a file's entry set
+         *
+         * @see FatFile::find
+         */
+        PropWare::ErrorCode find_entry_set (const char *filename, uint16_t *fileEntryOffset) const {
+            const size_t length = strlen(filename);
+            if (!FatFS::is_exfat_name(filename, length))
+                return File::INVALID_FILENAME;
+
+            const PropWare::ErrorCode err = this->m_fs->find_entry_set(this->m_buf, this->m_fs->m_dir_firstCluster,
+                                                                       filename, (uint8_t) length, fileEntryOffset);
+            return FatFS::PATH_NOT_FOUND == err ? (PropWare::ErrorCode) FatFile::FILENAME_NOT_FOUND : err;
         }
 
         /**
@@ -160,6 +290,19 @@ class FatFile : virtual public File {
             // Save the file entry's meta info
             this->m_dirEntryMeta = *(this->m_buf->meta);
 
+            this->m_curTier1      = 0;
+            this->m_curTier2      = 0;
+            this->fileEntryOffset = fileEntryOffset;
+            if (FatFS::EX_FAT == this->m_fs->m_filesystem) {
+                check_errors(this->read_stream_extension(fileEntryOffset));
+                // An empty exFAT file may have no clusters at all
+                if (!this->firstTier2) {
+                    this->m_curTier1 = NO_TIER1;
+                    return NO_ERROR;
+                }
+                return this->load_first_cluster();
+            }
+
             // Determine the file's first cluster
             if (FatFS::FAT_16 == this->m_fs->m_filesystem)
                 this->firstTier2 = this->m_driver->get_short(fileEntryOffset + FILE_START_CLSTR_LOW,
@@ -175,19 +318,66 @@ class FatFile : virtual public File {
                 this->firstTier2 &= 0x0FFFFFFF;
             }
 
-            // Compute some stuffs for the file
-            this->m_curTier2      = 0;
-            this->fileEntryOffset = fileEntryOffset;
             this->m_length        = this->m_driver->get_long(fileEntryOffset + FatFile::FILE_LEN_OFFSET,
                                                              this->m_buf->buf);
+            this->m_reservedBegin = this->m_reservedEnd = 0;
+            this->m_noFatChain    = false;
+            return this->load_first_cluster();
+        }
+
+        /**
+         * @brief       Read the first cluster and length of an exFAT file from its stream extension entry
+         *
+         * A file flagged as having no FAT chain is a single run of clusters, which is recorded as the file's
+         * reserved range so that the FAT is never consulted
+         *
+         * @param[in]   fileEntryOffset     Offset of the file's File entry within the buffer
+         *
+         * @return      0 upon success, FatFile::FILE_TOO_LARGE if the file's length does not fit in `m_length`, error
+         *              code otherwise
+         */
+        PropWare::ErrorCode read_stream_extension (const uint16_t fileEntryOffset) {
+            PropWare::ErrorCode err;
+            uint8_t             set[FatFS::EXFAT_MAX_SET_ENTRIES * FatFS::DIR_ENTRY_LENGTH];
+            uint8_t             entries;
+
+            check_errors(this->m_fs->read_entry_set(this->m_buf, fileEntryOffset, set, &entries));
+            const uint8_t *stream = &set[FatFS::DIR_ENTRY_LENGTH];
+            if (this->m_driver->get_long(FatFS::EXFAT_VALID_DATA_LENGTH + 4, stream)
+                    || this->m_driver->get_long(FatFS::EXFAT_DATA_LENGTH + 4, stream)
+                    || INT32_MAX < this->m_driver->get_long(FatFS::EXFAT_DATA_LENGTH, stream))
+                return FatFile::FILE_TOO_LARGE;
+
+            // Only the valid part of the file is readable; anything beyond it was allocated ahead of time
+            this->firstTier2 = this->m_driver->get_long(FatFS::EXFAT_FIRST_CLUSTER, stream);
+            this->m_length   = (int32_t) this->m_driver->get_long(FatFS::EXFAT_VALID_DATA_LENGTH, stream);
+
+            this->m_noFatChain = this->firstTier2 && (FatFS::EXFAT_NO_FAT_CHAIN & stream[FatFS::EXFAT_FLAGS]);
+            if (this->m_noFatChain) {
+                this->m_reservedBegin = this->firstTier2;
+                this->m_reservedEnd   = this->firstTier2 + this->m_fs->clusters_for_length(stream);
+            } else
+                this->m_reservedBegin = this->m_reservedEnd = 0;
+            return NO_ERROR;
+        }
+
+        /**
+         * @brief   Point the file's content metadata at its first cluster and load the first sector into the buffer
+         */
+        PropWare::ErrorCode load_first_cluster () {
+            PropWare::ErrorCode err;
 
             // Claim this buffer as our own
             this->m_contentMeta.curTier1Offset = 0;
             this->m_contentMeta.curTier2       = this->firstTier2;
             this->m_contentMeta.curTier2Addr   = this->m_fs->compute_tier1_from_tier2(this->firstTier2);
-            check_errors(this->m_fs->get_fat_value(this->m_contentMeta.curTier2, &(this->m_contentMeta.nextTier2)));
+            check_errors(this->get_next_tier2(this->m_contentMeta.curTier2, &(this->m_contentMeta.nextTier2)));
+            this->reset_extent_cache();
+            this->record_extent(0, this->firstTier2);
 
             // Finally, read the first sector
+            this->m_curTier1  = 0;
+            this->m_curTier2  = 0;
             this->m_buf->meta = &this->m_contentMeta;
             return this->m_driver->reload_buffer(this->m_buf);
         }
@@ -212,7 +402,7 @@ class FatFile : virtual public File {
          * @param[out]  *filename   Address in memory where the filename string
          *                          will be stored
          */
-        void get_filename (const uint8_t buf[], char filename[]) const {
+        static void get_filename (const uint8_t buf[], char filename[]) {
             uint8_t i, j = 0;
 
             // Read in the first 8 characters - stop when a space is reached or
@@ -239,6 +429,160 @@ class FatFile : virtual public File {
             filename[j] = 0;
         }
 
+        /**
+         * @brief       Search the current directory one entry at a time
+         *
+         * Every entry is added to the directory index (if one is being built), so the whole directory is scanned even
+         * after a match has been found; the buffer is then returned to the matching entry. Should the index run out of
+         * room, the search stops at the match like an unindexed one.
+         *
+         * @see FatFile::find
+         */
+        PropWare::ErrorCode find_by_scanning (const char *filename, uint16_t *fileEntryOffset) const {
+            PropWare::ErrorCode          err;
+            char                         readEntryName[FILENAME_STR_LEN];
+            const BlockStorage::MetaData *dirMeta  = &this->m_fs->m_dirMeta;
+            bool                         indexing  = this->m_fs->directory_index_ready();
+            bool                         found     = false;
+            FatFS::DirectoryIndexEntry   location;
+            FatFS::DirectoryIndexEntry   match;
+
+            *fileEntryOffset = 0;
+
+            check_errors(this->reload_directory_start());
+
+            // Loop through all entries in the current directory until we find the correct one
+            // Function will exit normally with FatFS::EOC_END error code if the file is not found
+            while (this->m_buf->buf[*fileEntryOffset]) {
+                // Check if file is valid, retrieve the name if it is
+                if (!this->file_deleted(*fileEntryOffset)) {
+                    this->get_filename(&this->m_buf->buf[*fileEntryOffset], readEntryName);
+                    location.tier2       = dirMeta->curTier2;
+                    location.tier1Offset = (uint16_t) dirMeta->curTier1Offset;
+                    location.entryOffset = *fileEntryOffset;
+
+                    if (!strcmp(filename, readEntryName)) {
+                        // File names match, return 0 to indicate a successful search
+                        if (!indexing)
+                            return 0;
+                        found = true;
+                        match = location;
+                    }
+
+                    if (indexing) {
+                        this->m_fs->index_directory_entry(FatFS::hash_filename(readEntryName), location);
+                        indexing = this->m_fs->m_dirIndexValid;
+                        if (!indexing && found) {
+                            *fileEntryOffset = match.entryOffset;
+                            return this->load_directory_location(match);
+                        }
+                    }
+                }
+
+                // Increment to the next file
+                *fileEntryOffset += FILE_ENTRY_LENGTH;
+
+                // If it was the last entry in this sector, proceed to the next
+                // one
+                if (this->m_driver->get_sector_size() == *fileEntryOffset) {
+                    // Last entry in the sector, attempt to load a new sector
+                    // Possible error value includes end-of-chain marker
+                    *fileEntryOffset = 0;
+                    if ((err = this->load_next_sector(this->m_buf))) {
+                        if (found && FatFS::EOC_END == err) {
+                            *fileEntryOffset = match.entryOffset;
+                            return this->load_directory_location(match);
+                        }
+                        return err;
+                    }
+                }
+            }
+
+            // The loop only ends here upon reaching the directory's first free entry
+            if (indexing) {
+                this->m_fs->m_dirIndexEnd.tier2       = dirMeta->curTier2;
+                this->m_fs->m_dirIndexEnd.tier1Offset = (uint16_t) dirMeta->curTier1Offset;
+                this->m_fs->m_dirIndexEnd.entryOffset = *fileEntryOffset;
+                this->m_fs->m_dirIndexEndKnown        = true;
+            }
+
+            if (found) {
+                *fileEntryOffset = match.entryOffset;
+                return this->load_directory_location(match);
+            } else
+                return FatFile::FILENAME_NOT_FOUND;
+        }
+
+        /**
+         * @brief       Search the current directory using the directory index
+         *
+         * @return      0 if the file was found, FatFile::FILENAME_NOT_FOUND with the buffer holding the directory's
+         *              first free entry if it was not, FatFS::EOC_END if it was not found and the first free entry is
+         *              unknown, or another error code
+         *
+         * @see FatFile::find
+         */
+        PropWare::ErrorCode find_indexed (const char *filename, uint16_t *fileEntryOffset) const {
+            PropWare::ErrorCode err;
+            char                readEntryName[FILENAME_STR_LEN];
+            const FatFS         *fs   = this->m_fs;
+            const uint16_t      hash  = FatFS::hash_filename(filename);
+
+            for (size_t i = 0; i < fs->m_dirIndexCapacity; ++i) {
+                const FatFS::DirectoryIndexEntry *slot = &fs->m_dirIndex[(hash + i) % fs->m_dirIndexCapacity];
+                if (!slot->hash)
+                    break;
+                else if (hash == slot->hash && FatFS::DELETED_INDEX_ENTRY != slot->entryOffset) {
+                    // Hashes can collide, so the name must still be checked
+                    check_errors(this->load_directory_location(*slot));
+                    if (!this->file_deleted(slot->entryOffset)) {
+                        this->get_filename(&this->m_buf->buf[slot->entryOffset], readEntryName);
+                        if (!strcmp(filename, readEntryName)) {
+                            *fileEntryOffset = slot->entryOffset;
+                            return 0;
+                        }
+                    }
+                }
+            }
+
+            if (!fs->m_dirIndexEndKnown)
+                return FatFS::EOC_END;
+
+            check_errors(this->load_directory_location(fs->m_dirIndexEnd));
+            *fileEntryOffset = fs->m_dirIndexEnd.entryOffset;
+            return FatFile::FILENAME_NOT_FOUND;
+        }
+
+        /**
+         * @brief       Load the sector of the current working directory holding a directory index entry
+         *
+         * @param[in]   location    Entry from the directory index
+         *
+         * @return      0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode load_directory_location (const FatFS::DirectoryIndexEntry &location) const {
+            PropWare::ErrorCode    err;
+            BlockStorage::MetaData *dirMeta = &this->m_fs->m_dirMeta;
+
+            if (this->m_buf->meta == dirMeta && location.tier2 == dirMeta->curTier2
+                    && location.tier1Offset == dirMeta->curTier1Offset)
+                return NO_ERROR;
+
+            check_errors(this->m_driver->flush(this->m_buf));
+            dirMeta->curTier2       = location.tier2;
+            dirMeta->curTier1Offset = location.tier1Offset;
+            if (FatFS::FAT_16 == this->m_fs->m_filesystem && (uint32_t) -1 == location.tier2)
+                // Root directory of FAT16 lives outside of the data region
+                dirMeta->curTier2Addr = this->m_fs->m_rootAddr;
+            else {
+                dirMeta->curTier2Addr = this->m_fs->compute_tier1_from_tier2(location.tier2);
+                check_errors(this->m_fs->get_fat_value(location.tier2, &dirMeta->nextTier2));
+            }
+
+            this->m_buf->meta = dirMeta;
+            return this->m_driver->reload_buffer(this->m_buf);
+        }
+
         /**
          * @brief       Find the next sector in the FAT, directory, or file.
          *              When it is found, load it into the appropriate global
@@ -271,12 +615,14 @@ class FatFile : virtual public File {
             else {
                 // Generic data cluster; Have we reached the end of the cluster?
                 const unsigned int tier1sPerTier2 = (unsigned int) (1 << this->m_fs->get_tier1s_per_tier2_shift());
-                buf->meta->curTier1Offset++;
-                if (tier1sPerTier2 == buf->meta->curTier1Offset) {
+                if (tier1sPerTier2 == buf->meta->curTier1Offset + 1) {
+                    // Stay on the final sector of the chain, so that the chain can be extended from there
+                    if (this->m_fs->is_eoc(buf->meta->nextTier2))
+                        return FatFS::EOC_END;
                     return this->inc_cluster();
                 } else
                     return this->m_driver->read_data_block(
-                            buf->meta->curTier1Offset + buf->meta->curTier2Addr, buf->buf);
+                            ++(buf->meta->curTier1Offset) + buf->meta->curTier2Addr, buf->buf);
             }
         }
 
@@ -383,45 +729,337 @@ class FatFile : virtual public File {
          */
         PropWare::ErrorCode load_sector_from_offset (const uint32_t requiredSector,
                                                      BlockStorage::MetaData *bufferMetadata) {
-            PropWare::ErrorCode    err;
-            const uint8_t          sectorsPerCluster = this->m_fs->m_tier1sPerTier2Shift;
-            unsigned int           requiredCluster   = requiredSector >> sectorsPerCluster;
+            PropWare::ErrorCode err;
 
             check_errors(this->m_driver->flush(this->m_buf));
+            check_errors(this->move_to_sector(requiredSector, bufferMetadata));
+
+            check_errors(this->m_driver->read_data_block(
+                    bufferMetadata->curTier2Addr + bufferMetadata->curTier1Offset, this->m_buf->buf));
+
+            return 0;
+        }
+
+        /**
+         * @brief       Lend out the file's buffer, which must hold the sector containing `offset`
+         *
+         * @param[in]   offset      Byte of the file that the borrower asked for
+         * @param[in]   end         Offset just past the last byte the borrower may access
+         * @param[out]  *length     Number of bytes the borrower may access: up to the end of the sector or `end`,
+         *                          whichever comes first
+         *
+         * @return      Address of the byte at `offset` within the buffer
+         */
+        uint8_t *lend_sector (const int32_t offset, const int32_t end, uint16_t *length) {
+            const uint16_t sectorSize   = this->m_driver->get_sector_size();
+            const uint16_t bufferOffset = (uint16_t) (offset & (sectorSize - 1));
+            const int32_t  available    = end - offset;
+
+            *length = (uint16_t) (available < sectorSize - bufferOffset ? available : sectorSize - bufferOffset);
+            this->m_borrowedSector = this->m_curTier1;
+            this->m_borrowedOffset = offset;
+            return &this->m_buf->buf[bufferOffset];
+        }
+
+        /**
+         * @brief   Determine whether the sector that was lent out is still in the buffer, untouched by other files
+         */
+        bool borrowed_sector_intact () const {
+            return NO_TIER1 != this->m_borrowedSector && &this->m_contentMeta == this->m_buf->meta
+                    && this->m_borrowedSector == this->m_curTier1;
+        }
+
+        /**
+         * @brief       Point the file's metadata at a sector without reading it from the storage device
+         *
+         * Clusters held in the extent cache are resolved directly. Otherwise, the FAT is walked forward from the
+         * current cluster when possible, or from the closest known cluster (the end of the extent cache or the file's
+         * first cluster) when the requested sector comes before the current cluster.
+         *
+         * @param[in]   requiredSector      Which sector is needed, counting from the beginning of the file
+         * @param[in]   *bufferMetadata     File content metadata to be updated
+         *
+         * @return      Returns 0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode move_to_sector (const uint32_t requiredSector, BlockStorage::MetaData *bufferMetadata) {
+            PropWare::ErrorCode err;
+            const uint8_t       sectorsPerCluster = this->m_fs->m_tier1sPerTier2Shift;
+            const uint32_t      requiredCluster   = requiredSector >> sectorsPerCluster;
 
             // Find the correct cluster
-            if (this->m_curTier2 < requiredCluster) {
-                // Desired cluster comes after the currently loaded one - this is easy and requires continuing to look
-                // forward through the FAT from the current position
-                do {
-                    bufferMetadata->curTier2 = bufferMetadata->nextTier2;
-                    check_errors(this->m_fs->get_fat_value(bufferMetadata->curTier2,
-                                                           &(bufferMetadata->nextTier2)));
-
-                    ++this->m_curTier2;
-                } while (this->m_curTier2 < requiredCluster);
-                bufferMetadata->curTier2Addr = this->m_fs->compute_tier1_from_tier2(bufferMetadata->curTier2);
-            } else if (this->m_curTier2 > requiredCluster) {
-                // Desired cluster is an earlier cluster than the currently loaded one - this requires starting from
-                // the beginning and working forward
-                this->m_curTier2         = 0;
-                bufferMetadata->curTier2 = this->firstTier2;
-                check_errors(this->m_fs->get_fat_value(bufferMetadata->curTier2, &(bufferMetadata->nextTier2)));
-                while (requiredCluster--) {
-                    ++this->m_curTier2;
-                    bufferMetadata->curTier2 = bufferMetadata->nextTier2;
-                    check_errors(this->m_fs->get_fat_value(bufferMetadata->curTier2,
-                                                           &(bufferMetadata->nextTier2)));
+            if (this->m_curTier2 != requiredCluster) {
+                if (this->m_noFatChain && requiredCluster < this->m_reservedEnd - this->firstTier2) {
+                    // The file is a single run of clusters - any of them can be found directly
+                    bufferMetadata->curTier2 = this->firstTier2 + requiredCluster;
+                    check_errors(this->get_next_tier2(bufferMetadata->curTier2, &(bufferMetadata->nextTier2)));
+                    this->m_curTier2 = requiredCluster;
+                } else if (requiredCluster < this->m_extentCoverage) {
+                    // Cluster has been seen before - no need to touch the FAT
+                    check_errors(this->jump_to_cluster(requiredCluster, bufferMetadata));
+                } else {
+                    if (this->m_extentCoverage && (this->m_curTier2 > requiredCluster
+                            || this->m_curTier2 + 1 < this->m_extentCoverage)) {
+                        // Skip ahead to the last cluster of the extent cache
+                        check_errors(this->jump_to_cluster(this->m_extentCoverage - 1, bufferMetadata));
+                    } else if (this->m_curTier2 > requiredCluster) {
+                        // Desired cluster is an earlier cluster than the currently loaded one - this requires
+                        // starting from the beginning and working forward
+                        this->m_curTier2         = 0;
+                        bufferMetadata->curTier2 = this->firstTier2;
+                        check_errors(this->get_next_tier2(bufferMetadata->curTier2, &(bufferMetadata->nextTier2)));
+                    }
+
+                    // Desired cluster comes after the current one - continue looking forward through the FAT
+                    while (this->m_curTier2 < requiredCluster)
+                        check_errors(this->next_cluster(bufferMetadata));
                 }
                 bufferMetadata->curTier2Addr = this->m_fs->compute_tier1_from_tier2(bufferMetadata->curTier2);
             }
 
             // Followed by finding the correct sector
-            bufferMetadata->curTier1Offset = (uint8_t) (requiredSector % (1 << sectorsPerCluster));
+            bufferMetadata->curTier1Offset = (unsigned int) (requiredSector % (1 << sectorsPerCluster));
             this->m_curTier1               = requiredSector;
 
-            check_errors(this->m_driver->read_data_block(
-                    bufferMetadata->curTier2Addr + bufferMetadata->curTier1Offset, this->m_buf->buf));
+            return 0;
+        }
+
+        /**
+         * @brief       Step the metadata forward to the next cluster in the chain
+         *
+         * @param[in]   *bufferMetadata     File content metadata to be updated
+         *
+         * @return      Returns 0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode next_cluster (BlockStorage::MetaData *bufferMetadata) {
+            const uint32_t cluster = bufferMetadata->nextTier2;
+
+            bufferMetadata->curTier2 = cluster;
+            ++this->m_curTier2;
+            this->record_extent(this->m_curTier2, cluster);
+
+            return this->get_next_tier2(cluster, &(bufferMetadata->nextTier2));
+        }
+
+        /**
+         * @brief       Determine which cluster follows one of the file's clusters
+         *
+         * Clusters reserved by FatFileWriter::preallocate are known to be linked one after another. An exFAT file
+         * without a FAT chain is one such run in its entirety, and nothing follows its last cluster
+         *
+         * @param[in]   cluster     One of the file's clusters
+         * @param[out]  *next       The following cluster, or an end-of-chain marker
+         *
+         * @return      Returns 0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode get_next_tier2 (const uint32_t cluster, uint32_t *next) {
+            if (this->m_reservedBegin <= cluster && cluster < this->m_reservedEnd) {
+                if (cluster + 1 < this->m_reservedEnd) {
+                    *next = cluster + 1;
+                    return NO_ERROR;
+                } else if (this->m_noFatChain) {
+                    *next = (uint32_t) FatFS::EOC_END;
+                    return NO_ERROR;
+                }
+            }
+            return this->m_fs->get_fat_value(cluster, next);
+        }
+
+        /**
+         * @brief       Add a cluster to the end of the file
+         *
+         * An exFAT file without a FAT chain grows in place for as long as the cluster after it is free. Once it is
+         * not, the file's clusters are linked in the FAT and it continues as an ordinary chain
+         *
+         * @param[in]   *bufferMetadata     File content metadata, pointing at the file's last cluster
+         *
+         * @return      Returns 0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode extend_chain (BlockStorage::MetaData *bufferMetadata) {
+            PropWare::ErrorCode err;
+
+            if (this->m_noFatChain) {
+                err = this->m_fs->claim_run(this->m_reservedEnd, 1);
+                if (NO_ERROR == err) {
+                    bufferMetadata->nextTier2 = this->m_reservedEnd++;
+                    return NO_ERROR;
+                } else if (FatFS::FAT_FULL != err)
+                    return err;
+                check_errors(this->link_fat_chain());
+            }
+            return this->m_fs->extend_fat(bufferMetadata);
+        }
+
+        /**
+         * @brief   Give an exFAT file without a FAT chain a chain, after which it can grow like any other file
+         *
+         * The file's reserved range is kept, so its existing clusters are still found without reading the FAT
+         */
+        PropWare::ErrorCode link_fat_chain () {
+            PropWare::ErrorCode err;
+
+            check_errors(this->m_fs->link_run(this->m_reservedBegin, this->m_reservedEnd - this->m_reservedBegin));
+            this->m_noFatChain = false;
+            return NO_ERROR;
+        }
+
+        /**
+         * @brief   Return all of the file's clusters to the filesystem
+         */
+        PropWare::ErrorCode release_clusters () {
+            if (this->m_noFatChain)
+                return this->m_fs->release_run(this->firstTier2, this->m_reservedEnd - this->firstTier2);
+            else
+                return this->m_fs->clear_chain(this->firstTier2);
+        }
+
+        /**
+         * @brief       Point the metadata at a cluster of the file which is held in the extent cache
+         *
+         * @param[in]   fileTier2           Cluster index, counting from the beginning of the file. Must be less than
+         *                                  `m_extentCoverage`
+         * @param[in]   *bufferMetadata     File content metadata to be updated
+         *
+         * @return      Returns 0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode jump_to_cluster (const uint32_t fileTier2, BlockStorage::MetaData *bufferMetadata) {
+            PropWare::ErrorCode err;
+
+            // Binary search for the last extent that starts at or before the requested cluster
+            size_t low  = 0;
+            size_t high = this->m_extentCount - 1;
+            while (low < high) {
+                const size_t mid = (low + high + 1) >> 1;
+                if (this->m_extents[mid].fileTier2 <= fileTier2)
+                    low = mid;
+                else
+                    high = mid - 1;
+            }
+
+            const Extent   *extent = &this->m_extents[low];
+            const uint32_t offset  = fileTier2 - extent->fileTier2;
+            bufferMetadata->curTier2 = extent->tier2 + offset;
+            if (offset + 1 < extent->length)
+                bufferMetadata->nextTier2 = bufferMetadata->curTier2 + 1;
+            else if (low + 1 < this->m_extentCount)
+                bufferMetadata->nextTier2 = this->m_extents[low + 1].tier2;
+            else
+                check_errors(this->get_next_tier2(bufferMetadata->curTier2, &(bufferMetadata->nextTier2)));
+            this->m_curTier2 = fileTier2;
+
+            return 0;
+        }
+
+        /**
+         * @brief       Add a cluster to the extent cache if it directly follows the clusters already recorded
+         *
+         * @param[in]   fileTier2   Cluster index, counting from the beginning of the file
+         * @param[in]   tier2       Cluster number
+         */
+        void record_extent (const uint32_t fileTier2, const uint32_t tier2) {
+            if (NULL == this->m_extents || fileTier2 != this->m_extentCoverage)
+                return;
+
+            if (this->m_extentCount) {
+                Extent *last = &this->m_extents[this->m_extentCount - 1];
+                if (last->tier2 + last->length == tier2) {
+                    ++last->length;
+                    ++this->m_extentCoverage;
+                    return;
+                }
+            }
+
+            if (this->m_extentCount < this->m_extentCapacity) {
+                Extent *extent = &this->m_extents[this->m_extentCount++];
+                extent->fileTier2 = fileTier2;
+                extent->tier2     = tier2;
+                extent->length    = 1;
+                ++this->m_extentCoverage;
+            }
+        }
+
+        void reset_extent_cache () {
+            this->m_extentCount    = 0;
+            this->m_extentCoverage = 0;
+        }
+
+        /**
+         * @brief       Read consecutive sectors of the file directly into `dst`, bypassing the file's buffer
+         *
+         * Every run of sectors that is physically contiguous on the storage device (all remaining sectors of a cluster
+         * plus any directly adjacent clusters in the chain) is requested from the driver with a single call to
+         * `BlockStorage::read_data_blocks`.
+         *
+         * @param[in]   firstSector     First sector to read, counting from the beginning of the file
+         * @param[in]   sectors         Number of sectors to read
+         * @param[out]  dst[]           Location in memory with room for `sectors` sectors
+         *
+         * @post        The file's buffer no longer holds a known sector of the file and will be reloaded on next access
+         *
+         * @return      Returns 0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode read_sectors_from_offset (uint32_t firstSector, uint32_t sectors, uint8_t dst[]) {
+            PropWare::ErrorCode    err;
+            BlockStorage::MetaData *meta = &this->m_contentMeta;
+
+            // Any modifications must be saved before the content metadata is moved
+            if (this->m_buf->meta == meta)
+                check_errors(this->m_driver->flush(this->m_buf));
+
+            while (sectors) {
+                uint32_t run;
+                check_errors(this->move_to_sector(firstSector, meta));
+                const uint32_t startAddress = meta->curTier2Addr + meta->curTier1Offset;
+                check_errors(this->measure_contiguous_run(sectors, false, &run));
+
+                check_errors(this->m_driver->read_data_blocks(startAddress, run, dst));
+
+                dst += run << this->m_driver->get_sector_size_shift();
+                firstSector += run;
+                sectors -= run;
+            }
+
+            // The buffer does not hold any of the sectors that were just read
+            this->m_curTier1 = NO_TIER1;
+
+            return 0;
+        }
+
+        /**
+         * @brief       Determine how many sectors, starting with the one pointed to by the file's content metadata, are
+         *              physically contiguous on the storage device
+         *
+         * The run always includes the remainder of the current cluster and grows by one cluster at a time for as long
+         * as the next cluster in the chain directly follows the current one.
+         *
+         * @param[in]   maxSectors  The run will not be longer than this many sectors
+         * @param[in]   extend      When set, the cluster chain is extended as needed instead of ending the run at the
+         *                          end-of-chain marker
+         * @param[out]  *run        Number of contiguous sectors
+         *
+         * @post        Content metadata points at the last cluster of the run
+         *
+         * @return      Returns 0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode measure_contiguous_run (const uint32_t maxSectors, const bool extend, uint32_t *run) {
+            PropWare::ErrorCode    err;
+            BlockStorage::MetaData *meta          = &this->m_contentMeta;
+            const uint32_t         tier1sPerTier2 = (uint32_t) (1 << this->m_fs->m_tier1sPerTier2Shift);
+
+            *run = tier1sPerTier2 - meta->curTier1Offset;
+            while (*run < maxSectors) {
+                if (extend && this->m_fs->is_eoc(meta->nextTier2))
+                    check_errors(this->extend_chain(meta));
+
+                if (meta->nextTier2 != meta->curTier2 + 1)
+                    break;
+
+                check_errors(this->next_cluster(meta));
+                *run += tier1sPerTier2;
+            }
+            meta->curTier2Addr = this->m_fs->compute_tier1_from_tier2(meta->curTier2);
+
+            if (*run > maxSectors)
+                *run = maxSectors;
 
             return 0;
         }
@@ -429,7 +1067,7 @@ class FatFile : virtual public File {
         PropWare::ErrorCode load_directory_sector () {
             PropWare::ErrorCode err;
             if (this->m_buf->meta != &this->m_dirEntryMeta) {
-                this->m_driver->flush(this->m_buf);
+                check_errors(this->m_driver->flush(this->m_buf));
                 this->m_buf->meta = &this->m_dirEntryMeta;
                 check_errors(this->m_driver->reload_buffer(this->m_buf));
             }
@@ -508,7 +1146,9 @@ class FatFile : virtual public File {
         }
 
     protected:
-        static const uint8_t FILE_LEN_OFFSET = 0x1C;  // Length of a file in bytes
+        static const uint8_t  FILE_LEN_OFFSET = 0x1C;  // Length of a file in bytes
+        /** Value of `m_curTier1` when no sector of the file is held in the buffer */
+        static const uint32_t NO_TIER1        = (uint32_t) -1;
 
         // File/directory values
         static const uint8_t FILE_ENTRY_LENGTH     = 32;  // An entry in a directory uses 32 bytes
@@ -552,6 +1192,26 @@ class FatFile : virtual public File {
         uint32_t m_dirTier1Addr;
         /** Address within the sector of this file's entry */
         uint16_t fileEntryOffset;
+        /** Index within `m_name` of the name of the file's entry, just past the path of its directory */
+        uint8_t  m_entryNameOffset;
+        /** Optional cache of the cluster chain (see FatFile::set_extent_cache) */
+        Extent   *m_extents;
+        size_t   m_extentCapacity;
+        size_t   m_extentCount;
+        /** Number of clusters, counting from the beginning of the file, recorded in the extent cache */
+        uint32_t m_extentCoverage;
+        /** Run of consecutive clusters (end is exclusive) that were linked to the file by FatFileWriter::preallocate */
+        uint32_t m_reservedBegin;
+        uint32_t m_reservedEnd;
+        /** Set for an exFAT file flagged as having no FAT chain, whose clusters are exactly the reserved range */
+        bool     m_noFatChain;
+        /** Sector (counting from the beginning of the file) lent out by `borrow_sector`, or NO_TIER1 */
+        uint32_t m_borrowedSector;
+        /** Offset that was asked for when the sector was borrowed */
+        int32_t  m_borrowedOffset;
 };
 
 }
+
+// Defines PropWare::FatFS::commit_pending_lengths, which every program with a PropWare::FatFS needs
+#include <PropWare/filesystem/fat/fatfilewriter.h>
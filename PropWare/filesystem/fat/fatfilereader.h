@@ -75,6 +75,16 @@ extern BlockStorage::Buffer SHARED_BUFFER;
  * }
  * @endcode
  *
+ * Sequential reads can be smoothed out with read-ahead: while the caller consumes one sector, the next sector of the
+ * file is requested from the storage device with `BlockStorage::submit_read`. Pair it with a driver that performs
+ * transfers in a helper cog, such as `PropWare::SDCog`, and crossing a sector boundary costs little more than a
+ * `memcpy`:
+ *
+ * @code
+ * uint8_t readAheadBuffer[512];
+ * reader.set_read_ahead_buffer(readAheadBuffer);
+ * @endcode
+ *
  */
 class FatFileReader : virtual public FatFile, virtual public FileReader {
     public:
@@ -94,29 +104,41 @@ class FatFileReader : virtual public FatFile, virtual public FileReader {
                        const Printer &logger = pwOut)
                 : File(fs, name, buffer, logger),
                   FatFile(fs, name, buffer, logger),
-                  FileReader(fs, name, buffer, logger) {
+                  FileReader(fs, name, buffer, logger),
+                  m_readAheadBuffer(NULL),
+                  m_readAheadSector(NO_TIER1) {
+        }
+
+        /**
+         * @brief   Wait for any outstanding read-ahead before the buffer goes away
+         */
+        ~FatFileReader () {
+            this->cancel_read_ahead();
         }
 
         PropWare::ErrorCode open () {
             PropWare::ErrorCode err;
-            uint16_t            fileEntryOffset = 0;
+            uint32_t            previousDirectory;
 
-            // Attempt to find the file
-            if ((err = this->find(this->get_name(), &fileEntryOffset)))
-                // Find returned an error; ensure it was EOC...
-                return FatFS::EOC_END == err ? FatFile::FILENAME_NOT_FOUND : err;
-
-            // `name` was found successfully
-            check_errors(this->open_existing_file(fileEntryOffset));
-            this->m_open = true;
-            return NO_ERROR;
+            check_errors(this->enter_parent_directory(&previousDirectory));
+            err = this->open_in_parent_directory();
+            this->leave_parent_directory(previousDirectory);
+            return err;
         }
 
         PropWare::ErrorCode safe_get_char (char &c) {
             PropWare::ErrorCode err;
 
             if (this->m_open) {
-                check_errors(this->load_sector_under_ptr());
+                // An empty exFAT file may have no clusters to read from
+                if (!this->firstTier2)
+                    return EOF_ERROR;
+
+                if (this->m_readAheadBuffer) {
+                    check_errors(this->load_sector_with_read_ahead());
+                } else {
+                    check_errors(this->load_sector_under_ptr());
+                }
 
                 // Get the character
                 const uint16_t bufferOffset = (uint16_t) (this->m_ptr % this->m_driver->get_sector_size());
@@ -130,6 +152,281 @@ class FatFileReader : virtual public FatFile, virtual public FileReader {
                 return FILE_NOT_OPEN;
             }
         }
+
+        /**
+         * @brief       Read a block of bytes from the file
+         *
+         * Partial sectors at either end of the request are copied out of the file's buffer with `memcpy`, while every
+         * whole, aligned sector in between is transferred straight from the storage device into `dst` via
+         * `FatFileReader::read_sectors`.
+         *
+         * @param[out]  *dst    Location in memory with room for `len` bytes
+         * @param[in]   len     Number of bytes to read
+         *
+         * @return      0 upon success, error code otherwise. Nothing is read if the request extends past the end of
+         *              the file
+         */
+        PropWare::ErrorCode read (uint8_t *dst, size_t len) {
+            PropWare::ErrorCode err;
+
+            if (!this->m_open)
+                return FILE_NOT_OPEN;
+            else if (this->m_ptr + (int32_t) len > this->m_length)
+                return EOF_ERROR;
+
+            const uint16_t sectorSize  = this->m_driver->get_sector_size();
+            const uint8_t  sectorShift = this->m_driver->get_sector_size_shift();
+            while (len) {
+                const uint16_t bufferOffset = (uint16_t) (this->m_ptr & (sectorSize - 1));
+
+                if (0 == bufferOffset && sectorSize <= len) {
+                    const uint32_t sectors = len >> sectorShift;
+                    check_errors(this->read_sectors(dst, sectors));
+                    dst += sectors << sectorShift;
+                    len -= sectors << sectorShift;
+                } else {
+                    if (this->m_readAheadBuffer) {
+                        check_errors(this->load_sector_with_read_ahead());
+                    } else {
+                        check_errors(this->load_sector_under_ptr());
+                    }
+
+                    const size_t remaining = (size_t) (sectorSize - bufferOffset);
+                    const size_t chunk     = len < remaining ? len : remaining;
+                    memcpy(dst, &this->m_buf->buf[bufferOffset], chunk);
+                    this->m_ptr += chunk;
+                    dst += chunk;
+                    len -= chunk;
+                }
+            }
+
+            return NO_ERROR;
+        }
+
+        /**
+         * @brief       Read whole sectors from the file directly into `buffer`
+         *
+         * The file's own buffer is bypassed and every run of consecutive sectors is requested from the storage device
+         * in a single transaction (such as an SD card's multi-block read), making this far faster than reading the
+         * same data one character at a time.
+         *
+         * @param[out]  buffer[]    Location in memory with room for `sectors` sectors of data
+         * @param[in]   sectors     Number of sectors to read
+         *
+         * @pre         The file pointer must be aligned to the beginning of a sector
+         *
+         * @post        The file pointer is advanced by the number of bytes read
+         *
+         * @return      0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode read_sectors (uint8_t buffer[], const uint32_t sectors) {
+            PropWare::ErrorCode err;
+
+            if (!this->m_open)
+                return FILE_NOT_OPEN;
+
+            const uint8_t sectorShift = this->m_driver->get_sector_size_shift();
+            if (this->m_ptr & (this->m_driver->get_sector_size() - 1))
+                return UNALIGNED_ACCESS;
+            else if (this->m_ptr + (int32_t) (sectors << sectorShift) > this->m_length)
+                return EOF_ERROR;
+
+            check_errors(this->cancel_read_ahead());
+            check_errors(this->read_sectors_from_offset((uint32_t) this->m_ptr >> sectorShift, sectors, buffer));
+            this->m_ptr += sectors << sectorShift;
+
+            return NO_ERROR;
+        }
+
+        /**
+         * @brief       Read part of the file in place, straight out of the file's buffer
+         *
+         * The sector holding `offset` is loaded (taking it from the read-ahead buffer when possible) and the caller
+         * is handed a pointer into the buffer, saving the copy made by `safe_get_char` or `read`. The pointer is valid
+         * until `FatFileReader::release_sector` is called; in the meantime, neither this file nor any other file
+         * sharing its buffer may be used. The file pointer is not moved.
+         *
+         * @code
+         * uint8_t checksum = 0;
+         * for (int32_t offset = 0; offset < reader.get_length();) {
+         *     const uint8_t *data;
+         *     uint16_t      length;
+         *     reader.borrow_sector(offset, &data, &length);
+         *     for (uint16_t i = 0; i < length; ++i)
+         *         checksum ^= data[i];
+         *     reader.release_sector();
+         *     offset += length;
+         * }
+         * @endcode
+         *
+         * @param[in]   offset      Byte of the file to start at; must be before the end of the file
+         * @param[out]  **data      The byte at `offset`, followed by the rest of its sector
+         * @param[out]  *length     Number of bytes at `*data` that may be read: up to the end of the sector or of the
+         *                          file, whichever comes first
+         *
+         * @return      0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode borrow_sector (const int32_t offset, const uint8_t **data, uint16_t *length) {
+            PropWare::ErrorCode err;
+
+            if (!this->m_open)
+                return FILE_NOT_OPEN;
+            else if (0 > offset || offset >= this->m_length)
+                return EOF_ERROR;
+
+            const int32_t filePointer = this->m_ptr;
+            this->m_ptr = offset;
+            if (this->m_readAheadBuffer)
+                err = this->load_sector_with_read_ahead();
+            else
+                err = this->load_sector_under_ptr();
+            this->m_ptr = filePointer;
+            check_errors(err);
+
+            *data = this->lend_sector(offset, this->m_length, length);
+            return NO_ERROR;
+        }
+
+        /**
+         * @brief   Give back the sector lent out by `FatFileReader::borrow_sector`
+         *
+         * @return  0 upon success, FatFile::SECTOR_NOT_BORROWED if no sector was borrowed or the buffer was used by
+         *          something else before the sector was returned (in which case the data read may not have been the
+         *          file's)
+         */
+        PropWare::ErrorCode release_sector () {
+            const bool intact = this->borrowed_sector_intact();
+            this->m_borrowedSector = NO_TIER1;
+            return intact ? NO_ERROR : SECTOR_NOT_BORROWED;
+        }
+
+        /**
+         * @brief       Wait for any outstanding read-ahead to finish
+         *
+         * @return      0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode flush () {
+            return this->cancel_read_ahead();
+        }
+
+        /**
+         * @brief       Enable or disable read-ahead
+         *
+         * @param[in]   buffer[]    Dedicated buffer, one sector in size, that the next sector of the file will be read
+         *                          into. Pass `NULL` to disable read-ahead. Note that `HALF_K_DATA_BUFFER1` is the
+         *                          default FAT buffer of `PropWare::FatFS` and must not be used here
+         *
+         * @return      0 upon success, error code otherwise (from an outstanding read-ahead being cancelled)
+         */
+        PropWare::ErrorCode set_read_ahead_buffer (uint8_t buffer[]) {
+            const PropWare::ErrorCode err = this->cancel_read_ahead();
+            this->m_readAheadBuffer = buffer;
+            return err;
+        }
+
+    private:
+        /**
+         * @brief   Find the file in the working directory (already set to the file's parent) and open it
+         */
+        PropWare::ErrorCode open_in_parent_directory () {
+            PropWare::ErrorCode err;
+            uint16_t            fileEntryOffset = 0;
+
+            // Attempt to find the file
+            if ((err = this->find(this->get_entry_name(), &fileEntryOffset)))
+                // Find returned an error; ensure it was EOC...
+                return FatFS::EOC_END == err ? FatFile::FILENAME_NOT_FOUND : err;
+
+            // `name` was found successfully
+            check_errors(this->open_existing_file(fileEntryOffset));
+            this->m_open = true;
+            return NO_ERROR;
+        }
+
+        /**
+         * @brief       Same as `FatFile::load_sector_under_ptr`, but take the sector from the read-ahead buffer when
+         *              possible and then start reading the sector after it
+         *
+         * @return      0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode load_sector_with_read_ahead () {
+            PropWare::ErrorCode err;
+            const uint32_t      requiredSector = (uint32_t) this->m_ptr >> this->m_driver->get_sector_size_shift();
+
+            if (this->m_buf->meta == &this->m_contentMeta && requiredSector == this->m_curTier1)
+                return NO_ERROR;
+
+            if (requiredSector == this->m_readAheadSector) {
+                // The sector we need is already on its way
+                check_errors(this->cancel_read_ahead());
+
+                if (this->m_buf->meta != &this->m_contentMeta) {
+                    check_errors(this->m_driver->flush(this->m_buf));
+                    this->m_buf->meta = &this->m_contentMeta;
+                }
+
+                // At most one step forward in the cluster chain, and the next cluster is already known
+                check_errors(this->move_to_sector(requiredSector, &this->m_contentMeta));
+                memcpy(this->m_buf->buf, this->m_readAheadBuffer, this->m_driver->get_sector_size());
+            } else {
+                check_errors(this->cancel_read_ahead());
+                check_errors(this->load_sector_under_ptr());
+            }
+
+            return this->start_read_ahead();
+        }
+
+        /**
+         * @brief       Request the sector following the one held in the file's buffer
+         *
+         * The device address is determined from the content metadata alone: either the next sector of the current
+         * cluster or the first sector of the next cluster in the chain (which is always looked up in advance)
+         *
+         * @pre         The file's buffer holds sector `m_curTier1` of the file
+         *
+         * @return      0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode start_read_ahead () {
+            PropWare::ErrorCode          err;
+            const BlockStorage::MetaData *meta          = &this->m_contentMeta;
+            const uint32_t               nextSector     = this->m_curTier1 + 1;
+            const unsigned int           tier1sPerTier2 = 1U << this->m_fs->get_tier1s_per_tier2_shift();
+            uint32_t                     address;
+
+            if ((int32_t) (nextSector << this->m_driver->get_sector_size_shift()) >= this->m_length)
+                return NO_ERROR;
+            else if (meta->curTier1Offset + 1 < tier1sPerTier2)
+                address = meta->curTier2Addr + meta->curTier1Offset + 1;
+            else if (this->m_fs->is_eoc(meta->nextTier2))
+                return NO_ERROR;
+            else
+                address = this->m_fs->compute_tier1_from_tier2(meta->nextTier2);
+
+            check_errors(this->m_driver->submit_read(address, this->m_readAheadBuffer));
+            this->m_readAheadSector = nextSector;
+            return NO_ERROR;
+        }
+
+        /**
+         * @brief       Wait for an outstanding read-ahead (if any) to complete
+         *
+         * @post        The read-ahead buffer is no longer in use by the storage device. Its contents are only valid if
+         *              `m_readAheadSector` was set before calling and 0 is returned.
+         *
+         * @return      0 upon success, error code of the read-ahead otherwise
+         */
+        PropWare::ErrorCode cancel_read_ahead () {
+            if (NO_TIER1 == this->m_readAheadSector)
+                return NO_ERROR;
+
+            this->m_readAheadSector = NO_TIER1;
+            return this->m_driver->wait();
+        }
+
+    private:
+        uint8_t  *m_readAheadBuffer;
+        /** Sector of the file (counted from the beginning of the file) requested into `m_readAheadBuffer` */
+        uint32_t m_readAheadSector;
 };
 
 }
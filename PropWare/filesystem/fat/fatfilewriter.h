@@ -33,15 +33,38 @@ namespace PropWare {
 extern BlockStorage::Buffer SHARED_BUFFER;
 
 /**
- * @brief   Concrete class for writing or modifying a FAT 16/32 file
+ * @brief   Concrete class for writing or modifying a FAT 16/32 or exFAT file
  */
 class FatFileWriter : public virtual FatFile, public virtual FileWriter {
+        friend class FatFS;
+
+    public:
+        /**
+         * @brief   How often a growing file's length is written to its directory entry
+         *
+         * Until the directory entry is updated, data written past the old end of the file would be lost (it is still
+         * on the device, but beyond the recorded length) if power failed. Updating the entry costs a directory sector
+         * read and write, so a writer that flushes often can trade some of that safety for throughput.
+         *
+         * @see PropWare::FatFileWriter::set_sync_policy
+         */
+        typedef enum {
+            /** Update the directory entry on every flush (the default) */
+            SYNC_ON_FLUSH,
+            /** Commit automatically once `interval` bytes have been written since the previous commit */
+            SYNC_EVERY_N_BYTES,
+            /** Commit automatically once `interval` milliseconds (measured with CNT) have passed since the previous
+             *  commit. The check is made whenever the file is written or flushed */
+            SYNC_EVERY_N_MILLISECONDS,
+            /** Only commit via PropWare::FatFileWriter::commit, PropWare::FatFS::sync or closing the file */
+            SYNC_EXPLICIT
+        } SyncPolicy;
 
     public:
         /**
          * @brief   Standard constructor
          *
-         * @param[in]   fs          A mounted FAT 16/32 filesystem
+         * @param[in]   fs          A mounted FAT 16/32 or exFAT filesystem
          * @param[in]   name[]      Character array with the file name
          * @param[in]   *buffer     If you don't want to use the globally shared buffer, a different buffer address can
          *                          be provided here
@@ -52,7 +75,11 @@ class FatFileWriter : public virtual FatFile, public virtual FileWriter {
                        const Printer &logger = pwOut)
                 : File(fs, name, buffer, logger),
                   FatFile(fs, name, buffer, logger),
-                  FileWriter(fs, name, buffer, logger) {
+                  FileWriter(fs, name, buffer, logger),
+                  m_syncPolicy(SYNC_ON_FLUSH),
+                  m_syncInterval(0),
+                  m_uncommittedBytes(0),
+                  m_nextPending(NULL) {
         }
 
         /**
@@ -60,29 +87,102 @@ class FatFileWriter : public virtual FatFile, public virtual FileWriter {
          */
         virtual ~FatFileWriter () {
             this->close();
+            // Only possible if closing failed, but the filesystem must never be left holding a dangling pointer
+            this->forget_pending_length();
         }
 
         PropWare::ErrorCode open () {
             PropWare::ErrorCode err;
-            uint16_t            fileEntryOffset = 0;
+            uint32_t            previousDirectory;
 
-            if ((err = this->find(this->get_name(), &fileEntryOffset))) {
-                switch (err) {
-                    case FatFS::EOC_END:
-                        check_errors(this->m_fs->extend_current_directory());
-                    case FatFile::FILENAME_NOT_FOUND:
-                        check_errors(this->create_new_file(fileEntryOffset));
-                        break;
-                    default:
-                        return err;
+            check_errors(this->enter_parent_directory(&previousDirectory));
+            err = this->open_in_parent_directory();
+            this->leave_parent_directory(previousDirectory);
+            check_errors(err);
+
+            this->m_open             = true;
+            this->m_uncommittedBytes = 0;
+            this->m_lastCommit       = CNT;
+            return NO_ERROR;
+        }
+
+        /**
+         * @brief       Open the file (creating it if it does not exist) with the file pointer at its end
+         *
+         * Equivalent to PropWare::FatFileWriter::open followed by a seek to the end of the file, but rather than
+         * walking the cluster chain one FAT entry at a time on the first write, the last cluster is found up front
+         * with PropWare::FatFS::walk_chain. Given a scratch buffer of several sectors, the FAT is read with
+         * multi-block reads, so the cost of opening a large log is a handful of device transactions.
+         *
+         * @param[in]   scratch[]       Optional buffer used only while the file is opened, such as a buffer that will
+         *                              later hold data to be appended
+         * @param[in]   scratchSectors  Size of `scratch`, in sectors
+         *
+         * @return      0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode open_append (uint8_t scratch[] = NULL, const uint16_t scratchSectors = 0) {
+            PropWare::ErrorCode    err;
+            BlockStorage::MetaData *meta        = &this->m_contentMeta;
+            const uint8_t          clusterShift = this->m_driver->get_sector_size_shift()
+                    + this->m_fs->m_tier1sPerTier2Shift;
+
+            check_errors(this->open());
+
+            // The cluster holding the byte just past the end - or the last cluster, if the file ends on a cluster
+            // boundary, in which case the next write extends the chain as usual
+            const uint32_t target = (uint32_t) this->m_length >> clusterShift;
+            if (this->m_noFatChain) {
+                // An exFAT file without a FAT chain is a single run, so its last cluster is known without a walk
+                const uint32_t last  = this->m_reservedEnd - 1 - this->firstTier2;
+                const uint32_t index = target < last ? target : last;
+                if (this->m_curTier2 < index) {
+                    check_errors(this->m_driver->flush(this->m_buf));
+                    meta->curTier2     = this->firstTier2 + index;
+                    meta->curTier2Addr = this->m_fs->compute_tier1_from_tier2(meta->curTier2);
+                    check_errors(this->get_next_tier2(meta->curTier2, &meta->nextTier2));
+                    this->m_curTier2 = index;
+                    this->m_curTier1 = NO_TIER1;
                 }
+            } else if (this->m_curTier2 < target) {
+                uint32_t cluster = meta->curTier2;
+                uint32_t taken;
+                check_errors(this->m_fs->walk_chain(&cluster, target - this->m_curTier2, &taken, &meta->nextTier2,
+                                                    scratch, scratchSectors));
+                check_errors(this->m_driver->flush(this->m_buf));
+
+                meta->curTier2     = cluster;
+                meta->curTier2Addr = this->m_fs->compute_tier1_from_tier2(cluster);
+                this->m_curTier2 += taken;
+                // The buffer no longer holds the sector the metadata points at
+                this->m_curTier1 = NO_TIER1;
             }
 
-            check_errors(this->open_existing_file(fileEntryOffset));
-            this->m_open = true;
+            this->m_ptr = this->m_length;
             return NO_ERROR;
         }
 
+        /**
+         * @brief   Save all content and write the file's length to its directory entry - regardless of the sync
+         *          policy - then close the file
+         *
+         * @return  0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode close () {
+            PropWare::ErrorCode err;
+
+            if (this->m_open && FatFS::EX_FAT == this->m_fs->m_filesystem) {
+                check_errors(this->release_unused_clusters());
+            }
+            if (this->m_fileMetadataModified) {
+                if (this->m_buf->meta == &this->m_contentMeta) {
+                    check_errors(this->m_driver->flush(this->m_buf));
+                }
+                check_errors(this->m_fs->flush_fat());
+                check_errors(this->m_fs->commit_pending_lengths());
+            }
+            return this->File::close();
+        }
+
         /**
          * @brief   Mark a file as delete and free its clusters in the FAT. File content will not be cleared unless
          *          overwritten by another file. File does not have to be opened prior to deleting
@@ -90,27 +190,44 @@ class FatFileWriter : public virtual FatFile, public virtual FileWriter {
         PropWare::ErrorCode remove () {
             PropWare::ErrorCode err;
 
-            // If the file hasn't been opened yet, open it
-            if (0 == this->m_dirTier1Addr) {
+            // If the file hasn't been opened yet, find its entry
+            if (!this->m_open) {
+                uint32_t previousDirectory;
                 uint16_t fileEntryOffset = 0;
-                if ((err = this->find(this->m_name, &fileEntryOffset))) {
-                    if (FatFS::EOC_END == err)
-                        return FatFile::FILENAME_NOT_FOUND;
-                    else
-                        return err;
-                } else {
-                    check_errors(this->open_existing_file(fileEntryOffset));
-                }
+
+                check_errors(this->enter_parent_directory(&previousDirectory));
+                err = this->find(this->get_entry_name(), &fileEntryOffset);
+                if (!err)
+                    err = this->open_existing_file(fileEntryOffset);
+                this->leave_parent_directory(previousDirectory);
+
+                if (FatFS::EOC_END == err)
+                    return FatFile::FILENAME_NOT_FOUND;
+                else if (err)
+                    return err;
             }
 
             check_errors(this->load_directory_sector());
 
-            this->m_buf->buf[this->fileEntryOffset] = DELETED_FILE_MARK;
-            this->m_buf->meta->mod = true;
+            if (FatFS::EX_FAT == this->m_fs->m_filesystem) {
+                check_errors(this->m_fs->delete_entry_set(this->m_buf, this->fileEntryOffset));
+                if (this->firstTier2) {
+                    check_errors(this->release_clusters());
+                }
+            } else {
+                this->m_buf->buf[this->fileEntryOffset] = DELETED_FILE_MARK;
+                this->m_buf->meta->mod = true;
+
+                check_errors(this->m_fs->clear_chain(this->firstTier2));
 
-            check_errors(this->m_fs->clear_chain(this->firstTier2));
+                FatFS::DirectoryIndexEntry location;
+                location.tier2       = this->m_dirEntryMeta.curTier2;
+                location.tier1Offset = (uint16_t) this->m_dirEntryMeta.curTier1Offset;
+                location.entryOffset = this->fileEntryOffset;
+                this->m_fs->unindex_directory_entry(FatFS::hash_filename(this->get_entry_name()), location);
+            }
 
-            this->m_fileMetadataModified = false; // This guy is for file length, not the directory entry or FAT
+            this->forget_pending_length(); // This guy is for file length, not the directory entry or FAT
 
             return NO_ERROR;
         }
@@ -123,20 +240,15 @@ class FatFileWriter : public virtual FatFile, public virtual FileWriter {
                 check_errors(this->m_driver->flush(this->m_buf));
             }
 
-            // If we modified any metadata for the file...
-            if (this->m_fileMetadataModified) {
-                this->load_directory_sector();
-
-                // Finally, edit the length of the file
-                this->m_buf->meta->mod = true;
-                this->m_driver->write_long(this->fileEntryOffset + FILE_LEN_OFFSET, this->m_buf->buf,
-                                           (const uint32_t) this->m_length);
-
-                check_errors(this->m_driver->flush(this->m_buf));
-                this->m_fileMetadataModified = false;
+            // If we modified the length of the file, and the sync policy allows it, update the directory entry. Any
+            // other writers with a pending length in the same directory sector are updated at the same time
+            if (this->m_fileMetadataModified && this->commit_due(true)) {
+                check_errors(this->m_fs->flush_fat());
+                check_errors(this->m_fs->commit_pending_lengths());
             }
 
-            return NO_ERROR;
+            // And make sure nothing is left behind in the driver (such as a write-back cache)
+            return this->m_driver->flush();
         }
 
         PropWare::ErrorCode safe_put_char (const char c) {
@@ -144,7 +256,7 @@ class FatFileWriter : public virtual FatFile, public virtual FileWriter {
 
             if (this->m_open) {
                 if (this->need_to_extend_fat()) {
-                    check_errors(this->m_fs->extend_fat(&this->m_contentMeta));
+                    check_errors(this->extend_chain(&this->m_contentMeta));
                 }
 
                 check_errors(this->load_sector_under_ptr());
@@ -157,18 +269,339 @@ class FatFileWriter : public virtual FatFile, public virtual FileWriter {
                 // If we extended the file, be sure to increment the length counter and make a note that the length changed
                 if (this->m_length == this->m_ptr) {
                     ++this->m_length;
-                    this->m_fileMetadataModified = true;
+                    this->mark_length_modified();
                 }
 
                 // Finally done. Increment the pointer
                 ++this->m_ptr;
+                ++this->m_uncommittedBytes;
 
-                return NO_ERROR;
+                return this->commit_if_due();
             } else {
                 return FILE_NOT_OPEN;
             }
         }
 
+        /**
+         * @brief       Write a block of bytes to the file
+         *
+         * Partial sectors at either end of the request are copied into the file's buffer with `memcpy`, while every
+         * whole, aligned sector in between is transferred straight from `src` to the storage device via
+         * `FatFileWriter::write_sectors`.
+         *
+         * @param[in]   *src    Data to be written
+         * @param[in]   len     Number of bytes to write
+         *
+         * @return      0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode write (const uint8_t *src, size_t len) {
+            PropWare::ErrorCode err;
+
+            if (!this->m_open)
+                return FILE_NOT_OPEN;
+
+            const uint16_t sectorSize  = this->m_driver->get_sector_size();
+            const uint8_t  sectorShift = this->m_driver->get_sector_size_shift();
+            while (len) {
+                const uint16_t bufferOffset = (uint16_t) (this->m_ptr & (sectorSize - 1));
+
+                if (0 == bufferOffset && sectorSize <= len) {
+                    const uint32_t sectors = len >> sectorShift;
+                    check_errors(this->write_sectors(src, sectors));
+                    src += sectors << sectorShift;
+                    len -= sectors << sectorShift;
+                } else {
+                    if (this->need_to_extend_fat()) {
+                        check_errors(this->extend_chain(&this->m_contentMeta));
+                    }
+                    check_errors(this->load_sector_under_ptr());
+
+                    const size_t remaining = (size_t) (sectorSize - bufferOffset);
+                    const size_t chunk     = len < remaining ? len : remaining;
+                    memcpy(&this->m_buf->buf[bufferOffset], src, chunk);
+                    this->m_buf->meta->mod = true;
+                    this->m_ptr += chunk;
+                    this->m_uncommittedBytes += chunk;
+                    src += chunk;
+                    len -= chunk;
+
+                    if (this->m_ptr > this->m_length) {
+                        this->m_length = this->m_ptr;
+                        this->mark_length_modified();
+                    }
+                }
+            }
+
+            return this->commit_if_due();
+        }
+
+        /**
+         * @brief       Write whole sectors directly from `buffer` to the file
+         *
+         * The file's own buffer is bypassed, the cluster chain is extended as needed and every run of physically
+         * contiguous sectors is sent to the storage device in a single transaction (such as an SD card's multi-block
+         * write).
+         *
+         * @param[in]   buffer[]    Data to be written - must contain `sectors` sectors
+         * @param[in]   sectors     Number of sectors to write
+         *
+         * @pre         The file pointer must be aligned to the beginning of a sector
+         *
+         * @post        The file pointer is advanced by the number of bytes written
+         *
+         * @return      0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode write_sectors (const uint8_t buffer[], uint32_t sectors) {
+            PropWare::ErrorCode    err;
+            BlockStorage::MetaData *meta = &this->m_contentMeta;
+
+            if (!this->m_open)
+                return FILE_NOT_OPEN;
+
+            const uint8_t sectorShift = this->m_driver->get_sector_size_shift();
+            if (this->m_ptr & (this->m_driver->get_sector_size() - 1))
+                return UNALIGNED_ACCESS;
+
+            // Any modifications must be saved before the content metadata is moved
+            if (this->m_buf->meta == meta)
+                check_errors(this->m_driver->flush(this->m_buf));
+
+            uint32_t sector = (uint32_t) this->m_ptr >> sectorShift;
+            while (sectors) {
+                uint32_t run;
+                check_errors(this->extend_to_sector(sector));
+                const uint32_t startAddress = meta->curTier2Addr + meta->curTier1Offset;
+                check_errors(this->measure_contiguous_run(sectors, true, &run));
+
+                check_errors(this->m_driver->write_data_blocks(startAddress, run, buffer));
+
+                buffer += run << sectorShift;
+                sector += run;
+                sectors -= run;
+            }
+
+            // The buffer does not hold any of the sectors that were just written
+            this->m_curTier1 = NO_TIER1;
+
+            this->m_uncommittedBytes += (sector << sectorShift) - this->m_ptr;
+            this->m_ptr = sector << sectorShift;
+            if (this->m_ptr > this->m_length) {
+                this->m_length = this->m_ptr;
+                this->mark_length_modified();
+            }
+
+            return this->commit_if_due();
+        }
+
+        /**
+         * @brief       Modify or append to the file in place, directly in the file's buffer
+         *
+         * The sector holding `offset` is loaded - after extending the cluster chain, when appending at a cluster
+         * boundary - and the caller is handed a pointer into the buffer to fill in, saving the copy made by
+         * `safe_put_char` or `write`. A sector that starts at the end of the file holds nothing worth reading, so it is
+         * not read from the storage device: the caller is handed a cleared buffer instead. The rest of the sector may
+         * be written, even beyond the end of the file. The pointer is valid until `FatFileWriter::release_sector` is
+         * called; in the meantime, neither this file nor any other file sharing its buffer may be used. The file
+         * pointer is not moved.
+         *
+         * @param[in]   offset      Byte of the file to start at; may be at most the file's length (to append)
+         * @param[out]  **data      The byte at `offset`, followed by the rest of its sector
+         * @param[out]  *length     Number of bytes at `*data` that may be written (up to the end of the sector)
+         *
+         * @return      0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode borrow_sector (const int32_t offset, uint8_t **data, uint16_t *length) {
+            PropWare::ErrorCode err;
+
+            if (!this->m_open)
+                return FILE_NOT_OPEN;
+            else if (0 > offset || offset > this->m_length)
+                return EOF_ERROR;
+
+            const uint16_t sectorSize  = this->m_driver->get_sector_size();
+            const int32_t  filePointer = this->m_ptr;
+            this->m_ptr = offset;
+            if (this->need_to_extend_fat())
+                err = this->extend_chain(&this->m_contentMeta);
+            else
+                err = NO_ERROR;
+            if (!err) {
+                if (offset & (sectorSize - 1) || offset < this->m_length)
+                    err = this->load_sector_under_ptr();
+                else
+                    err = this->clear_sector_under_ptr();
+            }
+            this->m_ptr = filePointer;
+            check_errors(err);
+
+            *data = this->lend_sector(offset, offset + sectorSize, length);
+            return NO_ERROR;
+        }
+
+        /**
+         * @brief       Give back the sector lent out by `FatFileWriter::borrow_sector`, keeping what was written to it
+         *
+         * The buffer is marked as modified (it is written to the storage device by the next flush, like any other
+         * data) and the file grows if the bytes written extend past its end.
+         *
+         * @param[in]   written     Number of bytes written, starting at the borrowed offset. Must not exceed the
+         *                          length handed out by `FatFileWriter::borrow_sector`
+         *
+         * @return      0 upon success, FatFile::SECTOR_NOT_BORROWED if no sector was borrowed or the buffer was used
+         *              by something else before the sector was returned (in which case nothing is kept), error code
+         *              otherwise
+         */
+        PropWare::ErrorCode release_sector (const uint16_t written) {
+            if (!this->borrowed_sector_intact()) {
+                this->m_borrowedSector = NO_TIER1;
+                return SECTOR_NOT_BORROWED;
+            }
+            this->m_borrowedSector = NO_TIER1;
+            if (!written)
+                return NO_ERROR;
+
+            this->m_buf->meta->mod = true;
+            this->m_uncommittedBytes += written;
+            if (this->m_borrowedOffset + written > this->m_length) {
+                this->m_length = this->m_borrowedOffset + written;
+                this->mark_length_modified();
+            }
+            return this->commit_if_due();
+        }
+
+        /**
+         * @brief       Reserve room for `bytes` more bytes at the end of the file
+         *
+         * Enough clusters are appended to the file's cluster chain - all at once, and preferably as a single run of
+         * consecutive clusters - that writing up to `bytes` bytes past the current end of the file never needs to
+         * allocate space. Within a run of consecutive clusters, moving from one cluster to the next does not even
+         * read the FAT, so writes into the reserved region take the same amount of time whether or not they cross a
+         * cluster boundary. If no run of the required length is free, the clusters are linked one by one instead.
+         *
+         * The file's length is not changed. Reserved clusters that are never written remain part of the file (beyond
+         * its length) until the file is removed.
+         *
+         * @param[in]   bytes   Number of bytes, counted from the current end of the file, to reserve room for
+         *
+         * @return      0 upon success, error code otherwise (FatFile::FILE_TOO_LARGE if the file could not grow by
+         *              `bytes`, or FatFS::FAT_FULL if the volume does not have enough free space, in which case the
+         *              chain may have been extended partially)
+         */
+        PropWare::ErrorCode preallocate (const uint32_t bytes) {
+            PropWare::ErrorCode    err;
+            BlockStorage::MetaData *meta        = &this->m_contentMeta;
+            const uint8_t          clusterShift = this->m_driver->get_sector_size_shift()
+                    + this->m_fs->m_tier1sPerTier2Shift;
+
+            if (!this->m_open)
+                return FILE_NOT_OPEN;
+            if (bytes > (uint32_t) INT32_MAX - this->m_length)
+                return FatFile::FILE_TOO_LARGE;
+
+            const uint32_t endOfData = (uint32_t) this->m_length + bytes;
+            const uint32_t clusters  = (endOfData >> clusterShift) + (endOfData & ((1 << clusterShift) - 1) ? 1 : 0);
+
+            // Find the end of the chain, starting from the cluster the content metadata points at
+            uint32_t tail        = meta->curTier2;
+            uint32_t next        = meta->nextTier2;
+            uint32_t chainLength = this->m_curTier2 + 1;
+            while (!this->m_fs->is_eoc(next)) {
+                tail = next;
+                ++chainLength;
+                check_errors(this->get_next_tier2(tail, &next));
+            }
+            if (clusters <= chainLength)
+                return NO_ERROR;
+
+            const uint32_t count = clusters - chainLength;
+            uint32_t       first;
+
+            // A contiguous exFAT file stays contiguous for as long as the clusters after it are free
+            if (this->m_noFatChain) {
+                err = this->m_fs->claim_run(tail + 1, count);
+                if (NO_ERROR == err) {
+                    if (tail == meta->curTier2)
+                        meta->nextTier2 = tail + 1;
+                    this->m_reservedEnd += count;
+                    return NO_ERROR;
+                } else if (FatFS::FAT_FULL == err) {
+                    check_errors(this->link_fat_chain());
+                } else
+                    return err;
+            }
+
+            err = this->m_fs->allocate_contiguous(tail + 1, count, &first);
+            if (NO_ERROR == err) {
+                check_errors(this->m_fs->set_fat_value(tail, first));
+                if (tail == meta->curTier2)
+                    meta->nextTier2 = first;
+                // Merge with the previous reservation if the new run directly continues it
+                if (first != this->m_reservedEnd || tail + 1 != first)
+                    this->m_reservedBegin = first;
+                this->m_reservedEnd = first + count;
+            } else if (FatFS::FAT_FULL == err) {
+                // No single run is long enough - settle for a fragmented (but still complete) chain
+                BlockStorage::MetaData chainEnd;
+                chainEnd.curTier2 = tail;
+                for (uint32_t i = 0; i < count; ++i) {
+                    check_errors(this->m_fs->extend_fat(&chainEnd));
+                    if (tail == meta->curTier2 && 0 == i)
+                        meta->nextTier2 = chainEnd.nextTier2;
+                    chainEnd.curTier2 = chainEnd.nextTier2;
+                }
+            } else
+                return err;
+
+            return NO_ERROR;
+        }
+
+        /**
+         * @brief       Choose how often the file's length is written to its directory entry
+         *
+         * With any policy but the default, PropWare::FatFileWriter::flush still writes the file's content to the
+         * device but only updates the directory entry when the policy says a commit is due, and the automatic
+         * policies also commit from within the write functions. Lengths that are due are committed for every open
+         * writer at once (see PropWare::FatFileWriter::commit), so that several files sharing a directory sector
+         * cost a single sector write per commit.
+         *
+         * @param[in]   policy      New sync policy
+         * @param[in]   interval    Bytes for PropWare::FatFileWriter::SYNC_EVERY_N_BYTES or milliseconds for
+         *                          PropWare::FatFileWriter::SYNC_EVERY_N_MILLISECONDS - must be shorter than the CNT
+         *                          rollover period (about 53 seconds at 80 MHz). Ignored by the other policies
+         */
+        void set_sync_policy (const SyncPolicy policy, const uint32_t interval = 0) {
+            this->m_syncPolicy       = policy;
+            this->m_syncInterval     = SYNC_EVERY_N_MILLISECONDS == policy ? interval * MILLISECOND : interval;
+            this->m_uncommittedBytes = 0;
+            this->m_lastCommit       = CNT;
+        }
+
+        /**
+         * @brief   Durability checkpoint: save this file's content, the FAT, and the length of every open writer on
+         *          the filesystem
+         *
+         * Lengths are written after the FAT, so a directory entry never claims clusters that are not yet linked to
+         * the file. Directory sectors are written once each, no matter how many writers have an entry in them.
+         * Whatever content each pending writer's buffer holds is written before that writer's length.
+         *
+         * @return  0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode commit () {
+            PropWare::ErrorCode err;
+
+            if (!this->m_open)
+                return FILE_NOT_OPEN;
+
+            if (this->m_buf->meta == &this->m_contentMeta) {
+                check_errors(this->m_driver->flush(this->m_buf));
+            }
+            check_errors(this->m_fs->flush_fat());
+            check_errors(this->m_fs->commit_pending_lengths());
+            this->m_uncommittedBytes = 0;
+            this->m_lastCommit       = CNT;
+            return this->m_driver->flush();
+        }
+
         void print_status (const bool printBlocks = false) const {
             this->File::print_status("FatFileWriter", printBlocks);
             this->FatFile::print_status(printBlocks, false);
@@ -192,8 +625,249 @@ class FatFileWriter : public virtual FatFile, public virtual FileWriter {
                 return false;
         }
 
+        /**
+         * @brief   Point the file's buffer at the sector under the file pointer and clear it, without reading the
+         *          sector from the storage device
+         *
+         * @pre     The cluster holding the sector must already be part of the file's cluster chain
+         *
+         * @return  0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode clear_sector_under_ptr () {
+            PropWare::ErrorCode err;
+
+            // Whatever the buffer holds - this file's data or another file's - must be saved before it is reused
+            check_errors(this->m_driver->flush(this->m_buf));
+            this->m_buf->meta = &this->m_contentMeta;
+            check_errors(this->move_to_sector((uint32_t) this->m_ptr >> this->m_driver->get_sector_size_shift(),
+                                              this->m_buf->meta));
+            memset(this->m_buf->buf, 0, this->m_driver->get_sector_size());
+            return NO_ERROR;
+        }
+
+        /**
+         * @brief       Point the file's content metadata at a sector, allocating new clusters if the sector lies
+         *              beyond the end of the cluster chain
+         *
+         * @param[in]   sector  Sector, counting from the beginning of the file
+         *
+         * @return      0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode extend_to_sector (const uint32_t sector) {
+            PropWare::ErrorCode    err;
+            BlockStorage::MetaData *meta        = &this->m_contentMeta;
+            const uint8_t          clusterShift = this->m_fs->m_tier1sPerTier2Shift;
+
+            while (this->m_curTier2 < (sector >> clusterShift)) {
+                if (this->m_fs->is_eoc(meta->nextTier2))
+                    check_errors(this->extend_chain(meta));
+                check_errors(this->move_to_sector((this->m_curTier2 + 1) << clusterShift, meta));
+            }
+
+            return this->move_to_sector(sector, meta);
+        }
+
     protected:
 
+        /**
+         * @brief   Record that the file's length changed, adding the file to the filesystem's list of writers with a
+         *          pending length
+         */
+        void mark_length_modified () {
+            if (!this->m_fileMetadataModified) {
+                this->m_fileMetadataModified = true;
+                this->m_nextPending          = this->m_fs->m_pendingWriters;
+                this->m_fs->m_pendingWriters = this;
+            }
+        }
+
+        /**
+         * @brief   Drop the file's pending length (if any) without writing it
+         */
+        void forget_pending_length () {
+            if (this->m_fileMetadataModified) {
+                FatFileWriter **link = &this->m_fs->m_pendingWriters;
+                while (this != *link)
+                    link = &(*link)->m_nextPending;
+                *link = this->m_nextPending;
+
+                this->m_nextPending          = NULL;
+                this->m_fileMetadataModified = false;
+            }
+        }
+
+        /**
+         * @brief       Determine whether the sync policy calls for a commit
+         *
+         * @param[in]   flushing    True when called by PropWare::FatFileWriter::flush
+         */
+        bool commit_due (const bool flushing) const {
+            switch (this->m_syncPolicy) {
+                case SYNC_ON_FLUSH:
+                    return flushing;
+                case SYNC_EVERY_N_BYTES:
+                    return this->m_syncInterval <= this->m_uncommittedBytes;
+                case SYNC_EVERY_N_MILLISECONDS:
+                    return this->m_syncInterval <= CNT - this->m_lastCommit;
+                default:
+                    return false;
+            }
+        }
+
+        PropWare::ErrorCode commit_if_due () {
+            if (this->commit_due(false))
+                return this->commit();
+            else
+                return NO_ERROR;
+        }
+
+        /**
+         * @brief   Find the file in the working directory (already set to the file's parent), creating it if it does
+         *          not exist, and load its first sector
+         */
+        PropWare::ErrorCode open_in_parent_directory () {
+            PropWare::ErrorCode err;
+            uint16_t            fileEntryOffset = 0;
+
+            const bool          exFat           = FatFS::EX_FAT == this->m_fs->m_filesystem;
+
+            if ((err = this->find(this->get_entry_name(), &fileEntryOffset))) {
+                switch (err) {
+                    case FatFS::EOC_END:
+                        this->m_fs->invalidate_directory_index();
+                        check_errors(this->m_fs->extend_directory(this->m_fs->m_dir_firstCluster, this->m_buf));
+                        fileEntryOffset = 0;
+                    case FatFile::FILENAME_NOT_FOUND:
+                        if (exFat) {
+                            check_errors(this->create_entry_set(&fileEntryOffset));
+                        } else {
+                            check_errors(this->create_new_file(fileEntryOffset));
+                        }
+                        break;
+                    default:
+                        return err;
+                }
+            }
+
+            check_errors(this->open_existing_file(fileEntryOffset));
+
+            // An empty exFAT file has no clusters at all, but there must be one for the content metadata to point at
+            if (exFat && !this->firstTier2)
+                return this->allocate_first_cluster();
+            return NO_ERROR;
+        }
+
+        /**
+         * @brief       Add an entry set for a new, empty file to the working directory
+         *
+         * @param[in,out]   *fileEntryOffset    Offset of the end of the directory's entries, as left by
+         *                                      PropWare::FatFile::find; offset of the new set upon return
+         */
+        PropWare::ErrorCode create_entry_set (uint16_t *fileEntryOffset) {
+            uint8_t       set[FatFS::EXFAT_MAX_SET_ENTRIES * FatFS::DIR_ENTRY_LENGTH];
+            const char    *name   = this->get_entry_name();
+            const uint8_t entries = this->m_fs->build_entry_set(set, name, (uint8_t) strlen(name), ARCHIVE,
+                                                                FatFS::EXFAT_ALLOC_POSSIBLE, 0, 0);
+            return this->m_fs->create_entry_set(this->m_buf, this->m_fs->m_dir_firstCluster, set, entries,
+                                                fileEntryOffset);
+        }
+
+        /**
+         * @brief   Give an empty exFAT file its first cluster, as a run without a FAT chain
+         *
+         * The cluster is returned by PropWare::FatFileWriter::close if nothing is written to it
+         */
+        PropWare::ErrorCode allocate_first_cluster () {
+            PropWare::ErrorCode err;
+
+            check_errors(this->m_fs->find_aligned_space(0, this->m_fs->m_nextFreeHint, &this->firstTier2));
+            this->m_noFatChain    = true;
+            this->m_reservedBegin = this->firstTier2;
+            this->m_reservedEnd   = this->firstTier2 + 1;
+            return this->load_first_cluster();
+        }
+
+        /**
+         * @brief   Give back the clusters which an exFAT file holds beyond its length
+         *
+         * exFAT records the length of a file rather than of its chain, so clusters past the end - reserved by
+         * PropWare::FatFileWriter::preallocate, or allocated when an empty file was opened - would otherwise be lost
+         * to the volume once the file is closed
+         */
+        PropWare::ErrorCode release_unused_clusters () {
+            PropWare::ErrorCode    err;
+            BlockStorage::MetaData *meta        = &this->m_contentMeta;
+            const uint8_t          clusterShift = this->m_driver->get_sector_size_shift()
+                    + this->m_fs->m_tier1sPerTier2Shift;
+
+            if (!this->firstTier2)
+                return NO_ERROR;
+
+            const uint32_t needed = (uint32_t) ((this->m_length + (1 << clusterShift) - 1) >> clusterShift);
+            if (!needed) {
+                check_errors(this->release_clusters());
+                this->firstTier2      = 0;
+                this->m_noFatChain    = false;
+                this->m_reservedBegin = 0;
+                this->m_reservedEnd   = 0;
+                this->m_curTier1      = NO_TIER1;
+                this->mark_length_modified();
+                return NO_ERROR;
+            } else if (this->m_noFatChain) {
+                const uint32_t end = this->firstTier2 + needed;
+                if (end < this->m_reservedEnd) {
+                    check_errors(this->m_fs->release_run(end, this->m_reservedEnd - end));
+                    this->m_reservedEnd = end;
+                }
+                return NO_ERROR;
+            }
+
+            // Find the last cluster that holds data - usually the one the content metadata already points at
+            uint32_t last = this->firstTier2;
+            uint32_t index = 0;
+            if (this->m_curTier2 < needed) {
+                last  = meta->curTier2;
+                index = this->m_curTier2;
+            }
+            for (; index + 1 < needed; ++index)
+                check_errors(this->get_next_tier2(last, &last));
+
+            uint32_t next;
+            check_errors(this->get_next_tier2(last, &next));
+            if (!this->m_fs->is_eoc(next)) {
+                check_errors(this->m_fs->set_fat_value(last, (uint32_t) FatFS::EOC_END));
+                check_errors(this->m_fs->clear_chain(next));
+                if (this->m_reservedBegin <= last && last < this->m_reservedEnd)
+                    this->m_reservedEnd = last + 1;
+            }
+            return NO_ERROR;
+        }
+
+        /**
+         * @brief   Write the file's first cluster and length to its exFAT stream extension entry
+         *
+         * @param[in]   *buffer     Buffer holding the sector with the file's entry set
+         */
+        PropWare::ErrorCode write_stream_extension (BlockStorage::Buffer *buffer) {
+            PropWare::ErrorCode err;
+            uint8_t             set[FatFS::EXFAT_MAX_SET_ENTRIES * FatFS::DIR_ENTRY_LENGTH];
+            uint8_t             entries;
+
+            check_errors(this->m_fs->read_entry_set(buffer, this->fileEntryOffset, set, &entries));
+
+            // exFAT requires that an empty file has no cluster, so one that is still held is left out of the entry
+            uint8_t *stream = &set[FatFS::DIR_ENTRY_LENGTH];
+            stream[FatFS::EXFAT_FLAGS] = (uint8_t) (FatFS::EXFAT_ALLOC_POSSIBLE
+                    | (this->m_noFatChain ? FatFS::EXFAT_NO_FAT_CHAIN : 0));
+            this->m_driver->write_long(FatFS::EXFAT_FIRST_CLUSTER, stream, this->m_length ? this->firstTier2 : 0);
+            this->m_driver->write_long(FatFS::EXFAT_VALID_DATA_LENGTH, stream, (uint32_t) this->m_length);
+            this->m_driver->write_long(FatFS::EXFAT_VALID_DATA_LENGTH + 4, stream, 0);
+            this->m_driver->write_long(FatFS::EXFAT_DATA_LENGTH, stream, (uint32_t) this->m_length);
+            this->m_driver->write_long(FatFS::EXFAT_DATA_LENGTH + 4, stream, 0);
+
+            return this->m_fs->write_entry_set(buffer, this->fileEntryOffset, set, entries);
+        }
+
         PropWare::ErrorCode create_new_file (const uint16_t fileEntryOffset) {
             PropWare::ErrorCode err;
 
@@ -207,26 +881,34 @@ class FatFileWriter : public virtual FatFile, public virtual FileWriter {
             // Archive flag should be set because the file is new
             this->m_buf->buf[fileEntryOffset + FILE_ATTRIBUTE_OFFSET] = ARCHIVE;
 
-            /* 3) Find a spot in the FAT (do not check for a full FAT, assume space is available) */
-            this->get_fat_location(fileEntryOffset);
+            /* 3) Find a spot in the FAT */
+            check_errors(this->get_fat_location(fileEntryOffset));
 
             /* 4) Write the size of the file (currently 0) */
             this->m_driver->write_long(fileEntryOffset + FILE_LEN_OFFSET, this->m_buf->buf, 0);
 
             this->m_buf->meta->mod = true;
+
+            /* 5) Keep the directory index in sync */
+            FatFS::DirectoryIndexEntry location;
+            location.tier2       = this->m_buf->meta->curTier2;
+            location.tier1Offset = (uint16_t) this->m_buf->meta->curTier1Offset;
+            location.entryOffset = fileEntryOffset;
+            this->m_fs->index_new_directory_entry(FatFS::hash_filename(this->get_entry_name()), location);
             return NO_ERROR;
         }
 
         inline PropWare::ErrorCode write_filename (const uint16_t fileEntryOffset) {
             PropWare::ErrorCode err;
+            const char          *name = this->get_entry_name();
             uint8_t             i;
 
             // Insert the base
-            for (i = 0; not_period_or_end(this->m_name[i]); ++i)
-                this->m_buf->buf[fileEntryOffset + i] = (uint8_t) this->m_name[i];
+            for (i = 0; not_period_or_end(name[i]); ++i)
+                this->m_buf->buf[fileEntryOffset + i] = (uint8_t) name[i];
 
             // Check if there is an extension
-            if (this->m_name[i]) {
+            if (name[i]) {
                 check_errors(this->write_filename_extension(fileEntryOffset, i));
             } else
                 this->pad_with_spaces(fileEntryOffset, i);
@@ -235,20 +917,21 @@ class FatFileWriter : public virtual FatFile, public virtual FileWriter {
         }
 
         inline PropWare::ErrorCode write_filename_extension (const uint16_t fileEntryOffset, uint8_t &i) {
-            uint8_t j;
+            const char *name = this->get_entry_name();
+            uint8_t    j;
 
             // There might be an extension - pad first name with spaces
             for (j = i; j < FILE_NAME_LEN; ++j)
                 this->m_buf->buf[fileEntryOffset + j] = ' ';
 
             // Check if there is a period, as one would expect for a file name with an extension
-            if ('.' == this->m_name[i]) {
+            if ('.' == name[i]) {
                 // Skip the period
                 ++i;
 
                 // Insert extension
-                while (this->m_name[i]) {
-                    this->m_buf->buf[fileEntryOffset + j] = (uint8_t) this->m_name[i];
+                while (name[i]) {
+                    this->m_buf->buf[fileEntryOffset + j] = (uint8_t) name[i];
                     ++i;
                     ++j;
                 }
@@ -270,13 +953,59 @@ class FatFileWriter : public virtual FatFile, public virtual FileWriter {
                 this->m_buf->buf[fileEntryOffset + i] = ' ';
         }
 
-        inline void get_fat_location (const uint16_t fileEntryOffset) {
-            const uint32_t allocUnit = this->m_fs->find_empty_space(0);
+        inline PropWare::ErrorCode get_fat_location (const uint16_t fileEntryOffset) {
+            PropWare::ErrorCode err;
+            uint32_t            allocUnit;
+
+            check_errors(this->m_fs->find_aligned_space(0, this->m_fs->m_nextFreeHint, &allocUnit));
             this->m_driver->write_short(fileEntryOffset + FILE_START_CLSTR_LOW, this->m_buf->buf, (uint16_t) allocUnit);
             if (FatFS::FAT_32 == this->m_fs->get_fs_type())
                 this->m_driver->write_short(fileEntryOffset + FILE_START_CLSTR_HIGH, this->m_buf->buf,
                                             (uint16_t) (allocUnit >> 16));
+            return NO_ERROR;
         }
+
+    private:
+        SyncPolicy    m_syncPolicy;
+        uint32_t      m_syncInterval;  // Bytes, or clock ticks for SYNC_EVERY_N_MILLISECONDS
+        uint32_t      m_uncommittedBytes;  // Bytes written since the last commit
+        uint32_t      m_lastCommit;  // Value of CNT at the last commit
+        FatFileWriter *m_nextPending;  // Next writer in the filesystem's list of writers with a pending length
 };
 
+inline PropWare::ErrorCode FatFS::commit_pending_lengths () {
+    PropWare::ErrorCode err;
+
+    while (NULL != this->m_pendingWriters) {
+        FatFileWriter  *owner = this->m_pendingWriters;
+        const uint32_t sector = owner->m_dirEntryMeta.curTier2Addr + owner->m_dirEntryMeta.curTier1Offset;
+        check_errors(this->m_driver->flush(owner->m_buf));
+        check_errors(owner->load_directory_sector());
+
+        FatFileWriter **link = &this->m_pendingWriters;
+        while (NULL != *link) {
+            FatFileWriter *writer = *link;
+            if (writer->m_buf == owner->m_buf
+                    && sector == writer->m_dirEntryMeta.curTier2Addr + writer->m_dirEntryMeta.curTier1Offset) {
+                if (EX_FAT == this->m_filesystem) {
+                    check_errors(writer->write_stream_extension(owner->m_buf));
+                } else
+                    this->m_driver->write_long(writer->fileEntryOffset + FatFile::FILE_LEN_OFFSET, owner->m_buf->buf,
+                                               (const uint32_t) writer->m_length);
+                writer->m_fileMetadataModified = false;
+                writer->m_uncommittedBytes     = 0;
+                writer->m_lastCommit           = CNT;
+                *link = writer->m_nextPending;
+                writer->m_nextPending = NULL;
+            } else
+                link = &writer->m_nextPending;
+        }
+
+        owner->m_buf->meta->mod = true;
+        check_errors(this->m_driver->flush(owner->m_buf));
+    }
+
+    return NO_ERROR;
+}
+
 }
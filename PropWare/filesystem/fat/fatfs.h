@@ -34,11 +34,27 @@
 
 namespace PropWare {
 
-extern uint8_t HALF_K_DATA_BUFFER1[];
-extern uint8_t HALF_K_DATA_BUFFER2[];
+extern uint8_t              HALF_K_DATA_BUFFER1[];
+extern uint8_t              HALF_K_DATA_BUFFER2[];
+extern BlockStorage::Buffer SHARED_BUFFER;
+
+class FatFileWriter;
 
 /**
- * FAT 16/32 filesystem driver - can be used with SD cards or any other PropWare::BlockStorage device
+ * FAT 16/32 and exFAT filesystem driver - can be used with SD cards or any other PropWare::BlockStorage device
+ *
+ * exFAT volumes (the default format of SDXC cards, 64 GB and larger) are supported with a few limitations:
+ *
+ * - Only names made of printable ASCII characters are supported, and a name must fit in
+ *   PropWare::File::MAX_FILENAME_LENGTH
+ * - New files are allocated as a single run of clusters and flagged as having no FAT chain (exFAT's "NoFatChain"),
+ *   so that reading, writing and seeking within them never touch the FAT. A file only gets a FAT chain once the
+ *   cluster after its end is taken by something else
+ * - A subdirectory only grows while it is the working directory or the directory most recently found by path (such
+ *   as the parent of a file being opened), because exFAT directories do not record their parent
+ * - Directories have no ".." entry, so ".." is only accepted in the root directory
+ * - The directory index and path cache are not used
+ * - Active FAT and allocation bitmap must be the first of their kind (TexFAT is not supported)
  */
 class FatFS : public Filesystem {
         friend class FatFile;
@@ -47,6 +63,8 @@ class FatFS : public Filesystem {
 
         friend class FatFileWriter;
 
+        friend class FatDirectoryIterator;
+
     public:
         typedef enum {
                                    NO_ERROR        = 0,
@@ -58,9 +76,68 @@ class FatFS : public Filesystem {
             /** FatFS Error 4 */   READING_PAST_EOC,
             /** FatFS Error 5 */   PARTITION_DOES_NOT_EXIST,
             /** FatFS Error 6 */   UNSUPPORTED_FILESYSTEM,
-            /** Last FatFS error */END_ERROR       = UNSUPPORTED_FILESYSTEM
+            /** FatFS Error 7 */   FAT_FULL,
+            /** FatFS Error 8 */   PATH_NOT_FOUND,
+            /** FatFS Error 9 */   NOT_A_DIRECTORY,
+            /** FatFS Error 10 */  ENTRY_EXISTS,
+            /** FatFS Error 11 */  INVALID_PATH,
+            /** FatFS Error 12 */  DIRECTORY_FULL,
+            /** FatFS Error 13 */  UNSUPPORTED_ENTRY_SET,
+            /** FatFS Error 14 */  FAT_CACHE_TOO_SMALL,
+            /** Last FatFS error */END_ERROR       = FAT_CACHE_TOO_SMALL
         }    ErrorCode;
 
+        /** Returned by PropWare::FatFS::get_free_cluster_count when the number of free clusters is not known */
+        static const uint32_t UNKNOWN_FREE_COUNT    = UINT32_MAX;
+        /** Size of a FAT sector held by a PropWare::FatFS::FatCacheSlot */
+        static const uint16_t FAT_CACHE_SECTOR_SIZE = 512;
+        /** Upper limit for PropWare::FatFS::set_mirror_sync_threshold */
+        static const uint8_t  MAX_STALE_MIRRORS     = 16;
+
+        /**
+         * @brief   A single sector of the FAT cache
+         */
+        struct FatCacheSlot {
+            /** Contents of the FAT sector */
+            uint8_t  buf[FAT_CACHE_SECTOR_SIZE];
+            /** Sector number, relative to the start of the FAT */
+            uint32_t fatSector;
+            /** Value of the access counter the last time this slot was used */
+            uint32_t lastUse;
+            /** Set when `buf` holds valid data */
+            bool     valid;
+            /** Set when `buf` has been modified since it was written to the primary FAT */
+            bool     dirty;
+        };
+
+        /**
+         * @brief   Location of a single entry in the current directory, as recorded by the directory index
+         */
+        struct DirectoryIndexEntry {
+            /** Cluster containing the entry */
+            uint32_t tier2;
+            /** Sector within the cluster containing the entry */
+            uint16_t tier1Offset;
+            /** Byte offset of the entry within its sector */
+            uint16_t entryOffset;
+            /** Hash of the entry's short (8.3) name; 0 marks an unused slot */
+            uint16_t hash;
+        };
+
+        /**
+         * @brief   A directory found while resolving a path, as recorded by the path cache
+         */
+        struct PathCacheEntry {
+            /** First cluster of the directory containing this one */
+            uint32_t parent;
+            /** First cluster of this directory; 0 marks an unused entry */
+            uint32_t cluster;
+            /** Value of the access counter the last time this entry was used */
+            uint32_t lastUse;
+            /** Name as stored in the directory entry: 8 characters of name and 3 of extension, padded with spaces */
+            uint8_t  name[11];
+        };
+
     public:
         /**
          * @brief       Constructor
@@ -81,17 +158,36 @@ class FatFS : public Filesystem {
         FatFS (const BlockStorage &driver, uint8_t fatBuffer[] = HALF_K_DATA_BUFFER1, const Printer &logger = pwOut)
                 : Filesystem(driver, logger),
                   m_fat(fatBuffer),
-                  m_fatMod(false) {
+                  m_fatMod(false),
+                  m_freeSummary(NULL),
+                  m_freeSummaryBits(0),
+                  m_fatCache(NULL),
+                  m_fatCacheSize(0),
+                  m_staleMirrorLimit(0),
+                  m_auSize(0),
+                  m_auClusters(0),
+                  m_volumeDirty(false),
+                  m_clearVolumeDirty(false),
+                  m_dirIndex(NULL),
+                  m_dirIndexCapacity(0),
+                  m_dirIndexValid(false),
+                  m_dirIndexOverflowCluster(NO_DIRECTORY),
+                  m_pathCache(NULL),
+                  m_pathCacheSize(0),
+                  m_pathCacheClock(0),
+                  m_pendingWriters(NULL) {
         }
 
         /**
          * @brief   Destructor. Unmounts the filesystem and flushes all buffers
          */
         ~FatFS () {
+            // Files use the shared buffer by default - don't leave it pointing at metadata that is going away
+            if (&this->m_dirMeta == SHARED_BUFFER.meta) {
+                this->m_driver->flush(&SHARED_BUFFER);
+                SHARED_BUFFER.meta = NULL;
+            }
             this->unmount();
-
-            if (NULL != this->m_fat)
-                free(this->m_fat);
         }
 
         /**
@@ -110,8 +206,12 @@ class FatFS : public Filesystem {
 
             // Start the driver
             check_errors(this->m_driver->start());
-            this->m_fatMod     = false;
-            this->m_nextFileId = 0;
+            this->m_fatMod           = false;
+            this->m_staleMirrorCount = 0;
+            this->m_nextFileId       = 0;
+            this->m_volumeDirty      = false;
+            this->m_clearVolumeDirty = false;
+            this->invalidate_fat_cache();
 
             this->m_dirMeta.name = "Current working directory";
 
@@ -119,12 +219,27 @@ class FatFS : public Filesystem {
             // starting with the section "FAT Type Determination"
             // https://staff.washington.edu/dittrich/misc/fatgen103.pdf
             check_errors(this->read_boot_sector(partition, buffer));
-            check_errors(this->common_boot_sector_parser(buffer));
-            this->partition_info_parser(buffer);
-            check_errors(this->determine_fat_type());
-            this->store_root_info(buffer);
+            if (this->is_exfat_boot_sector(buffer)) {
+                check_errors(this->exfat_boot_sector_parser(buffer));
+            } else {
+                check_errors(this->common_boot_sector_parser(buffer));
+                this->partition_info_parser(buffer);
+                check_errors(this->determine_fat_type());
+                this->store_root_info(buffer);
+            }
+            check_errors(this->read_fs_info(buffer));
             check_errors(this->read_fat_and_root_sectors(buffer));
-
+            if (EX_FAT == this->m_filesystem) {
+                check_errors(this->read_exfat_root_entries(buffer));
+            }
+            this->reset_free_space_summary();
+            this->compute_allocation_unit_layout();
+
+            this->invalidate_directory_index();
+            this->m_dirIndexOverflowCluster      = NO_DIRECTORY;
+            this->m_exfatWorkingDirEntry.cluster = NO_DIRECTORY;
+            this->m_exfatLastDirEntry.cluster    = NO_DIRECTORY;
+            this->invalidate_path_cache();
             this->m_mounted = true;
 
             return 0;
@@ -134,26 +249,367 @@ class FatFS : public Filesystem {
          * @see PropWare::Filesystem::unmount
          */
         PropWare::ErrorCode unmount () {
-            if (this->m_mounted)
-                return this->flush_fat();
-            else
+            PropWare::ErrorCode err;
+
+            if (!this->m_mounted)
                 return NO_ERROR;
+
+            check_errors(this->sync());
+            // exFAT volumes are marked dirty while they are being modified. A volume which was already dirty when it
+            // was mounted is left that way, so that a proper check of the volume is not skipped
+            if (this->m_clearVolumeDirty) {
+                check_errors(this->write_volume_flags(false));
+                this->m_volumeDirty      = false;
+                this->m_clearVolumeDirty = false;
+                return this->m_driver->flush();
+            }
+            return NO_ERROR;
+        }
+
+        /**
+         * @brief   Write every modified FAT sector to both copies of the FAT, update the FSInfo sector and flush the
+         *          storage device
+         *
+         * File lengths which open PropWare::FatFileWriter instances have not yet written to their directory entries
+         * (see PropWare::FatFileWriter::set_sync_policy) are written as well. Invoked automatically by
+         * PropWare::FatFS::unmount
+         *
+         * @return  0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode sync () {
+            PropWare::ErrorCode err;
+            check_errors(this->flush_fat());
+            if (NULL != this->m_pendingWriters) {
+                check_errors(this->commit_pending_lengths());
+            }
+            check_errors(this->sync_fat_mirrors());
+            check_errors(this->write_fs_info());
+            return this->m_driver->flush();
         }
 
         /**
-         * @brief   Determine whether the mounted filesystem is FAT16 or FAT32
+         * @brief   Determine whether the mounted filesystem is FAT16, FAT32 or exFAT
          *
          * @return  2 (also known as PropWare::FatFS::FAT16) for FAT16, 4 (also known as PropWare::FatFS::FAT32) for
-         *          FAT32
+         *          FAT32, 6 (also known as PropWare::FatFS::EX_FAT) for exFAT
          */
         uint8_t get_fs_type () {
             return this->m_filesystem;
         }
 
+        /**
+         * @brief       Provide storage for a summary of which FAT sectors still have free entries
+         *
+         * One bit is kept per FAT sector. A cleared bit marks a sector that was found to be full, allowing the
+         * allocator to skip it without reading it from the device; bits are set again when clusters in that sector are
+         * freed. FAT sectors beyond the end of the summary are always searched. The summary is optional - without one,
+         * only the next-free hint (loaded from the FSInfo sector on FAT32 volumes) is used to speed up allocation.
+         *
+         * @param[in]   summary     Statically allocated instance of an array, NOT a pointer. One byte covers eight
+         *                          FAT sectors
+         */
+        template<size_t N>
+        void set_free_space_summary (uint8_t (&summary)[N]) {
+            this->set_free_space_summary(summary, N);
+        }
+
+        /**
+         * @brief       Provide storage for a summary of which FAT sectors still have free entries
+         *
+         * @param[in]   *summary    Address where the array begins (i.e., allocated with `new` or `malloc`)
+         * @param[in]   length      Number of bytes allocated for the array
+         */
+        void set_free_space_summary (uint8_t *summary, const size_t length) {
+            this->m_freeSummary     = summary;
+            this->m_freeSummaryBits = length << 3;
+            this->reset_free_space_summary();
+        }
+
+        /**
+         * @brief   Retrieve the number of free clusters on the volume
+         *
+         * @return  Number of free clusters as recorded in the FSInfo sector (and maintained since mounting), or
+         *          PropWare::FatFS::UNKNOWN_FREE_COUNT if the volume does not provide a valid count
+         */
+        uint32_t get_free_cluster_count () const {
+            return this->m_freeCount;
+        }
+
+        /**
+         * @brief       Keep multiple sectors of the FAT in memory
+         *
+         * Without a cache, the single FAT buffer given to the constructor is written back every time a different FAT
+         * sector is needed, so interleaving lookups in one part of the FAT with allocations in another causes the
+         * same sectors to be written and read over and over. With a cache, the least recently used sector is replaced
+         * and modified sectors are only written when they are evicted or when the FAT is flushed. The constructor's
+         * FAT buffer is not used while a cache is in place.
+         *
+         * @param[in]   slots   Statically allocated instance of an array, NOT a pointer
+         *
+         * @pre         Must be invoked before mounting the filesystem
+         *
+         * @note        The storage device must use sectors of PropWare::FatFS::FAT_CACHE_SECTOR_SIZE bytes
+         */
+        template<size_t N>
+        void set_fat_cache (FatCacheSlot (&slots)[N]) {
+            this->set_fat_cache(slots, N);
+        }
+
+        /**
+         * @overload
+         *
+         * @param[in]   *slots      Address where the array begins
+         * @param[in]   slotCount   Number of slots allocated for the array
+         */
+        void set_fat_cache (FatCacheSlot *slots, const size_t slotCount) {
+            this->m_fatCache     = slots;
+            this->m_fatCacheSize = slotCount;
+        }
+
+        /**
+         * @brief       Allow the second (mirror) copy of the FAT to fall behind the first
+         *
+         * Every FAT sector is normally written twice: once to each copy of the FAT. Up to `sectors` FAT sectors may
+         * instead have only their primary copy written; their mirror copies are brought up to date by
+         * PropWare::FatFS::sync (or PropWare::FatFS::unmount). Once the limit is reached, further FAT sectors are
+         * written to both copies right away. A FAT sector that is modified repeatedly, such as the one tracking the
+         * clusters of a log file, therefore costs a single write each time it is flushed instead of two.
+         *
+         * Both copies are identical again after a sync, so a volume only needs repair if power is lost with mirror
+         * updates pending - and even then, the primary FAT (which every common implementation reads) is correct.
+         *
+         * @param[in]   sectors     Number of FAT sectors whose mirror may be stale, at most
+         *                          PropWare::FatFS::MAX_STALE_MIRRORS. 0 (the default) writes both copies every time
+         */
+        void set_mirror_sync_threshold (const uint8_t sectors) {
+            this->m_staleMirrorLimit = MAX_STALE_MIRRORS < sectors ? MAX_STALE_MIRRORS : sectors;
+        }
+
+        /**
+         * @brief       Place files according to the allocation units (erase blocks) of the storage device
+         *
+         * SD cards erase and program flash in large allocation units (AUs), typically 4 MB for SDHC cards. Writing
+         * sequentially through a whole AU is fast, but a card that sees writes scattered across several AUs must fall
+         * back to slow read-modify-write cycles. With an AU size set, the first cluster of every new file is taken
+         * from the start of an AU (preferably one that appears to be empty), and a growing file takes the next free
+         * cluster within its own AU - moving on to another empty AU once its own is full - rather than the first free
+         * cluster on the volume. When no suitable cluster exists, allocation falls back to the first free cluster.
+         *
+         * AU boundaries are computed from the device's sector addresses, so they remain correct for partitions that
+         * do not begin on an AU boundary.
+         *
+         * Files growing side by side in different AUs also have their clusters tracked by different FAT sectors. With
+         * only the constructor's FAT buffer, each switch between files writes one FAT sector back and reads another,
+         * which can cost more device writes than the policy saves (about 2.7 times those of first-free allocation for
+         * four interleaved streams in host/fat_allocation_benchmark). Provide a FAT cache with at least one slot per
+         * stream (see PropWare::FatFS::set_fat_cache) before writing more than one file at a time.
+         *
+         * @param[in]   bytes       Size of an allocation unit in bytes: a power of two, at least two clusters large.
+         *                          0 (the default) disables the policy
+         * @param[in]   streams     Number of files that will be written concurrently
+         *
+         * @pre         PropWare::FatFS::set_fat_cache must already have been invoked if `streams` is greater than 1
+         *
+         * @return      0 upon success, PropWare::FatFS::FAT_CACHE_TOO_SMALL (leaving the policy unchanged) if
+         *              `streams` is greater than 1 and the FAT cache has fewer than `streams` slots
+         */
+        PropWare::ErrorCode set_allocation_unit_size (const uint32_t bytes, const size_t streams = 1) {
+            if (bytes && 1 < streams && this->m_fatCacheSize < streams)
+                return FAT_CACHE_TOO_SMALL;
+
+            this->m_auSize = bytes;
+            if (this->m_mounted)
+                this->compute_allocation_unit_layout();
+            return NO_ERROR;
+        }
+
+        /**
+         * @brief   Determine whether a cluster begins on an allocation unit boundary
+         *
+         * @see     PropWare::FatFS::set_allocation_unit_size
+         *
+         * @return  True if the allocation unit policy is enabled and `cluster` is the first cluster of an allocation
+         *          unit
+         */
+        bool is_allocation_unit_start (const uint32_t cluster) const {
+            return this->m_auClusters && this->m_auPhase == (cluster & (this->m_auClusters - 1));
+        }
+
+        /**
+         * @brief       Provide storage for an index of the current directory
+         *
+         * The first search of a directory (such as opening a file) scans the whole directory and records the location
+         * of every entry, keyed by a hash of its name. Later searches read only the sector holding the matching entry
+         * - or, when no entry matches, the sector where a new entry would be created. Files created or removed through
+         * PropWare::FatFileWriter keep the index up to date. If the directory holds more entries than the index has
+         * room for, searches fall back to scanning the directory - and stopping at the match - until the working
+         * directory is changed or the filesystem is remounted.
+         *
+         * @param[in]   index   Statically allocated instance of an array, NOT a pointer. Allow for some spare room:
+         *                      lookups slow down as the index fills up
+         */
+        template<size_t N>
+        void set_directory_index (DirectoryIndexEntry (&index)[N]) {
+            this->set_directory_index(index, N);
+        }
+
+        /**
+         * @overload
+         *
+         * @param[in]   *index      Address where the array begins. Pass `NULL` to disable the index
+         * @param[in]   length      Number of entries allocated for the array
+         */
+        void set_directory_index (DirectoryIndexEntry *index, const size_t length) {
+            this->m_dirIndex                = index;
+            this->m_dirIndexCapacity        = length;
+            this->m_dirIndexOverflowCluster = NO_DIRECTORY;
+            this->invalidate_directory_index();
+        }
+
+        /**
+         * @brief   Discard the directory index; it will be rebuilt by the next search of the directory
+         *
+         * Only necessary if the directory is modified without going through PropWare::FatFileWriter
+         */
+        void invalidate_directory_index () {
+            this->m_dirIndexValid    = false;
+            this->m_dirIndexEndKnown = false;
+        }
+
+        /**
+         * @brief       Provide storage for a cache of recently resolved directories
+         *
+         * Every directory found while resolving a path (by PropWare::FatFS::chdir, PropWare::FatFS::mkdir or when
+         * opening a file such as `2026/10/16/run.csv`) is recorded along with the directory containing it. Resolving
+         * the same directories again - such as when opening a sibling file - then reads nothing but the final
+         * directory. When the cache is full, the least recently used entry is replaced.
+         *
+         * @param[in]   entries     Statically allocated instance of an array, NOT a pointer. One entry is needed per
+         *                          directory level, so a handful covers paths like `year/month/day`
+         */
+        template<size_t N>
+        void set_path_cache (PathCacheEntry (&entries)[N]) {
+            this->set_path_cache(entries, N);
+        }
+
+        /**
+         * @overload
+         *
+         * @param[in]   *entries    Address where the array begins. Pass `NULL` to disable the cache
+         * @param[in]   length      Number of entries allocated for the array
+         */
+        void set_path_cache (PathCacheEntry *entries, const size_t length) {
+            this->m_pathCache     = entries;
+            this->m_pathCacheSize = length;
+            this->invalidate_path_cache();
+        }
+
+        /**
+         * @brief   Forget every directory in the path cache
+         *
+         * Only necessary if directories are removed or moved by something other than this filesystem instance
+         */
+        void invalidate_path_cache () {
+            for (size_t i = 0; i < this->m_pathCacheSize; ++i)
+                this->m_pathCache[i].cluster = 0;
+            this->m_pathCacheClock = 0;
+        }
+
+        /**
+         * @brief       Change the current working directory
+         *
+         * Files opened by name alone, PropWare::FatDirectoryIterator and relative paths all start from the current
+         * working directory.
+         *
+         * @param[in]   path[]      Directory names separated by '/'. A leading '/' starts from the root directory,
+         *                          and "." and ".." are supported. Every name must be a short (8.3) name
+         * @param[in]   buffer      Buffer used to read directory sectors
+         *
+         * @return      0 upon success, error code otherwise. The working directory is unchanged upon failure
+         */
+        PropWare::ErrorCode chdir (const char path[], BlockStorage::Buffer &buffer = SHARED_BUFFER) {
+            PropWare::ErrorCode err;
+            uint32_t            cluster;
+
+            check_errors(this->resolve_directory(path, strlen(path), &buffer, &cluster));
+            this->m_dir_firstCluster        = cluster;
+            this->m_dirIndexOverflowCluster = NO_DIRECTORY;
+            if (cluster == this->m_exfatLastDirEntry.cluster)
+                this->m_exfatWorkingDirEntry = this->m_exfatLastDirEntry;
+            else if (cluster != this->m_exfatWorkingDirEntry.cluster)
+                this->m_exfatWorkingDirEntry.cluster = NO_DIRECTORY;
+            return NO_ERROR;
+        }
+
+        /**
+         * @brief       Create a new, empty directory
+         *
+         * @param[in]   path[]      Name of the new directory, optionally preceded by the path of an existing directory
+         *                          that should contain it (see PropWare::FatFS::chdir). Intermediate directories are
+         *                          not created
+         * @param[in]   buffer      Buffer used to read and write directory sectors
+         *
+         * @return      0 upon success, PropWare::FatFS::ENTRY_EXISTS if a file or directory by that name exists,
+         *              error code otherwise
+         */
+        PropWare::ErrorCode mkdir (const char path[], BlockStorage::Buffer &buffer = SHARED_BUFFER) {
+            PropWare::ErrorCode err;
+            uint8_t             name[SHORT_NAME_LENGTH];
+            uint32_t            parent;
+            uint32_t            cluster;
+            uint16_t            entryOffset;
+
+            // Everything before the final name is the path of the parent
+            size_t length = strlen(path);
+            while (length && '/' == path[length - 1])
+                --length;
+            size_t nameStart = length;
+            while (nameStart && '/' != path[nameStart - 1])
+                --nameStart;
+            if (EX_FAT == this->m_filesystem) {
+                if (!is_exfat_name(&path[nameStart], length - nameStart))
+                    return INVALID_PATH;
+                check_errors(this->resolve_directory(path, nameStart, &buffer, &parent));
+                return this->make_exfat_directory(&buffer, parent, &path[nameStart], (uint8_t) (length - nameStart));
+            } else if (!to_short_name(&path[nameStart], length - nameStart, name) || '.' == name[0])
+                return INVALID_PATH;
+            check_errors(this->resolve_directory(path, nameStart, &buffer, &parent));
+
+            err = this->find_directory_entry(&buffer, parent, name, &entryOffset);
+            if (NO_ERROR == err)
+                return ENTRY_EXISTS;
+            else if (EOC_END == err) {
+                if (parent == this->m_dirIndexCluster)
+                    this->invalidate_directory_index();
+                check_errors(this->extend_directory(parent, &buffer));
+                entryOffset = 0;
+            } else if (PATH_NOT_FOUND != err)
+                return err;
+
+            // Erase block starts are kept for files; a directory rarely outgrows one cluster
+            check_errors(this->find_empty_space(0, &cluster));
+
+            uint8_t *entry = &buffer.buf[entryOffset];
+            memset(entry, 0, DIR_ENTRY_LENGTH);
+            memcpy(entry, name, SHORT_NAME_LENGTH);
+            entry[DIR_ATTRIBUTE_OFFSET] = SUB_DIR_ATTRIBUTE;
+            this->write_entry_cluster(entry, cluster);
+            buffer.meta->mod = true;
+            check_errors(this->m_driver->flush(&buffer));
+            // Simpler than working out whether the new entry went where the index expected it
+            if (parent == this->m_dirIndexCluster)
+                this->invalidate_directory_index();
+
+            check_errors(this->write_empty_directory(&buffer, cluster, parent));
+            this->cache_path(parent, name, cluster);
+            return NO_ERROR;
+        }
+
     private:
         // Boot sector addresses/values
         static const uint8_t  FAT_16                 = 2;  // A FAT entry in FAT16 is 2-bytes
         static const uint8_t  FAT_32                 = 4;  // A FAT entry in FAT32 is 4-bytes
+        static const uint8_t  EX_FAT                 = 6;  // Not an entry size - exFAT entries are 4 bytes as well
         static const uint8_t  BOOT_SECTOR_ID         = 0xEB;
         static const uint8_t  BOOT_SECTOR_ID_ADDR    = 0;
         static const uint16_t PARTITION_TABLE_START  = 0x1BE;
@@ -170,9 +626,26 @@ class FatFS : public Filesystem {
         static const uint8_t  TOT_SCTR_32_ADDR       = 0x20;
         static const uint8_t  FAT_SIZE_32_ADDR       = 0x24;
         static const uint8_t  ROOT_CLUSTER_ADDR      = 0x2c;
+        static const uint8_t  FSINFO_SECTOR_ADDR     = 0x30;
         static const uint16_t FAT12_CLSTR_CNT        = 4085;
         static const uint16_t FAT16_CLSTR_CNT        = UINT16_MAX - 10;
 
+        // exFAT boot sector addresses/values
+        static const uint8_t  EXFAT_NAME_ADDR          = 0x03;
+        static const uint8_t  EXFAT_FAT_OFFSET_ADDR    = 0x50;
+        static const uint8_t  EXFAT_FAT_LENGTH_ADDR    = 0x54;
+        static const uint8_t  EXFAT_HEAP_OFFSET_ADDR   = 0x58;
+        static const uint8_t  EXFAT_CLUSTER_COUNT_ADDR = 0x5C;
+        static const uint8_t  EXFAT_ROOT_CLUSTER_ADDR  = 0x60;
+        static const uint8_t  EXFAT_VOLUME_FLAGS_ADDR  = 0x6A;
+        static const uint8_t  EXFAT_SECTOR_SHIFT_ADDR  = 0x6C;
+        static const uint8_t  EXFAT_CLUSTER_SHIFT_ADDR = 0x6D;
+        static const uint8_t  EXFAT_NUM_FATS_ADDR      = 0x6E;
+        static const uint8_t  EXFAT_PERCENT_USED_ADDR  = 0x70;
+        static const uint8_t  EXFAT_MAX_CLUSTER_SHIFT  = 25;  // Clusters are at most 32 MB
+        static const uint16_t EXFAT_VOLUME_DIRTY       = BIT_1;
+        static const uint8_t  EXFAT_PERCENT_UNKNOWN    = 0xFF;
+
         static const int8_t   FREE_CLUSTER       = 0;  // Cluster is unused
         static const int8_t   RESERVED_CLUSTER   = 1;
         static const int8_t   RSVD_CLSTR_VAL_BEG = -15;  // First reserved cluster value
@@ -182,6 +655,68 @@ class FatFS : public Filesystem {
         static const int32_t  EOC_END            = -1;  // Last marker for end-of-chain
         static const uint32_t EOC_MASK           = 0x0fffffff;
 
+        // Directory entry offsets/values needed for directories (files have more in PropWare::FatFile)
+        static const uint8_t DIR_ENTRY_LENGTH       = 32;
+        static const uint8_t SHORT_NAME_BASE_LENGTH = 8;
+        static const uint8_t SHORT_NAME_LENGTH      = 11;  // 8 characters of name and 3 of extension
+        static const uint8_t DIR_ATTRIBUTE_OFFSET   = 0x0B;
+        static const uint8_t DIR_CLUSTER_HIGH       = 0x14;  // FAT32 only
+        static const uint8_t DIR_CLUSTER_LOW        = 0x1A;
+        static const uint8_t DELETED_ENTRY_MARK     = 0xE5;
+        static const uint8_t VOLUME_ID_ATTRIBUTE    = BIT_3;  // Also set on every long file name entry
+        static const uint8_t SUB_DIR_ATTRIBUTE      = BIT_4;
+
+        // exFAT directory entries. Names are spread over the "File Name" entries of an entry set, 15 UTF-16 characters
+        // to an entry
+        static const uint8_t  EXFAT_END_OF_DIRECTORY   = 0x00;
+        static const uint8_t  EXFAT_IN_USE             = BIT_7;
+        static const uint8_t  EXFAT_BITMAP_ENTRY       = 0x81;
+        static const uint8_t  EXFAT_LABEL_ENTRY        = 0x83;
+        static const uint8_t  EXFAT_FILE_ENTRY         = 0x85;
+        static const uint8_t  EXFAT_STREAM_ENTRY       = 0xC0;
+        static const uint8_t  EXFAT_NAME_ENTRY         = 0xC1;
+        static const uint8_t  EXFAT_UNUSED_ENTRY       = EXFAT_FILE_ENTRY & ~EXFAT_IN_USE;
+        static const uint8_t  EXFAT_BITMAP_FLAGS       = 0x01;  // Bit 0 is set for the second (TexFAT) bitmap
+        static const uint8_t  EXFAT_LABEL_LENGTH       = 0x01;
+        static const uint8_t  EXFAT_LABEL              = 0x02;
+        static const uint8_t  EXFAT_SECONDARY_COUNT    = 0x01;
+        static const uint8_t  EXFAT_SET_CHECKSUM       = 0x02;
+        static const uint8_t  EXFAT_FILE_ATTRIBUTES    = 0x04;
+        static const uint8_t  EXFAT_TIMESTAMPS         = 0x08;  // Created, modified and accessed - 4 bytes each
+        static const uint8_t  EXFAT_FLAGS              = 0x01;
+        static const uint8_t  EXFAT_NAME_LENGTH        = 0x03;
+        static const uint8_t  EXFAT_NAME_HASH          = 0x04;
+        static const uint8_t  EXFAT_VALID_DATA_LENGTH  = 0x08;  // 64 bits
+        static const uint8_t  EXFAT_FIRST_CLUSTER      = 0x14;  // Also used by the allocation bitmap entry
+        static const uint8_t  EXFAT_DATA_LENGTH        = 0x18;  // 64 bits; also used by the allocation bitmap entry
+        static const uint8_t  EXFAT_NAME               = 0x02;
+        static const uint8_t  EXFAT_NAME_CHARACTERS    = 15;
+        static const uint8_t  EXFAT_ALLOC_POSSIBLE     = BIT_0;
+        static const uint8_t  EXFAT_NO_FAT_CHAIN       = BIT_1;
+        // File, stream extension and up to three name entries, enough for PropWare::File::MAX_FILENAME_LENGTH
+        static const uint8_t  EXFAT_MAX_SET_ENTRIES    = 5;
+        static const uint8_t  EXFAT_MAX_NAME_LENGTH    = 31;
+        // 2000-01-01 00:00:00, the earliest date this driver can claim for a new entry without a clock
+        static const uint32_t EXFAT_DEFAULT_TIMESTAMP  = 0x28210000;
+
+        // FSInfo sector addresses/values (FAT32 only)
+        static const uint32_t FSINFO_LEAD_SIG        = 0x41615252;
+        static const uint32_t FSINFO_STRUCT_SIG      = 0x61417272;
+        static const uint32_t FSINFO_TRAIL_SIG       = 0xAA550000;
+        static const uint16_t FSINFO_LEAD_SIG_ADDR   = 0;
+        static const uint16_t FSINFO_STRUCT_SIG_ADDR = 484;
+        static const uint16_t FSINFO_FREE_COUNT_ADDR = 488;
+        static const uint16_t FSINFO_NEXT_FREE_ADDR  = 492;
+        static const uint16_t FSINFO_TRAIL_SIG_ADDR  = 508;
+
+        // Marks a directory index slot whose entry has been removed
+        static const uint16_t DELETED_INDEX_ENTRY    = UINT16_MAX;
+        // Value of m_curFatSector while no FAT sector is loaded
+        static const uint32_t NO_FAT_SECTOR          = UINT32_MAX;
+        // Value of m_dirIndexOverflowCluster while no directory is known to overflow the index; no directory starts
+        // at cluster 0
+        static const uint32_t NO_DIRECTORY           = 0;
+
     private:
         typedef struct {
             uint8_t  numFATs;
@@ -195,6 +730,38 @@ class FatFS : public Filesystem {
             uint32_t clusterCount;
         }                     InitFATInfo;
 
+        /**
+         * @brief   A file or directory found in an exFAT directory
+         */
+        struct ExFatEntry {
+            /** Directory sector holding the set's File entry */
+            BlockStorage::MetaData location;
+            /** Offset of the File entry within its sector */
+            uint16_t               offset;
+            /** Number of entries in the set, including the File entry */
+            uint8_t                entries;
+            uint16_t               attributes;
+            /** Flags of the stream extension entry */
+            uint8_t                flags;
+            /** Length of the name, which may be longer than PropWare::FatFS::ExFatEntry::name can hold */
+            uint8_t                nameLength;
+            char                   name[EXFAT_MAX_NAME_LENGTH + 1];
+            uint32_t               firstCluster;
+            uint64_t               validDataLength;
+        };
+
+        /**
+         * @brief   Location of an exFAT directory's entry set, within its parent
+         */
+        struct ExFatDirectoryEntry {
+            /** First cluster of the directory, or PropWare::FatFS::NO_DIRECTORY if the record is unused */
+            uint32_t               cluster;
+            /** Parent's sector holding the set's File entry */
+            BlockStorage::MetaData location;
+            /** Offset of the File entry within its sector */
+            uint16_t               offset;
+        };
+
     private:
 
         /**
@@ -360,14 +927,80 @@ class FatFS : public Filesystem {
                     this->m_rootAddr    = this->compute_tier1_from_tier2(this->m_rootCluster);
                     break;
             }
+
+            // 0 and 0xFFFF both mean "no FSInfo sector"
+            const uint16_t fsInfoSector = FAT_32 == this->m_filesystem ?
+                    this->m_driver->get_short(FSINFO_SECTOR_ADDR, buffer) : (uint16_t) 0;
+            if (0 == fsInfoSector || UINT16_MAX == fsInfoSector)
+                this->m_fsInfoSector = 0;
+            else
+                this->m_fsInfoSector = bootSector + fsInfoSector;
+        }
+
+        /**
+         * @brief       Load the free cluster count and next-free hint from the FSInfo sector
+         *
+         * Both values are only hints, so a volume without a (valid) FSInfo sector simply starts with an unknown free
+         * count and begins searching for free clusters at the start of the FAT.
+         *
+         * @param[in]   buffer[]    Scratch buffer
+         *
+         * @return      0 upon success, error code otherwise
+         */
+        inline PropWare::ErrorCode read_fs_info (uint8_t buffer[]) {
+            PropWare::ErrorCode err;
+
+            this->m_freeCount    = UNKNOWN_FREE_COUNT;
+            this->m_nextFreeHint = this->first_allocatable_cluster();
+            this->m_fsInfoMod    = false;
+
+            if (this->m_fsInfoSector) {
+                check_errors(this->m_driver->read_data_block(this->m_fsInfoSector, buffer));
+                if (FSINFO_LEAD_SIG != this->m_driver->get_long(FSINFO_LEAD_SIG_ADDR, buffer)
+                        || FSINFO_STRUCT_SIG != this->m_driver->get_long(FSINFO_STRUCT_SIG_ADDR, buffer)
+                        || FSINFO_TRAIL_SIG != this->m_driver->get_long(FSINFO_TRAIL_SIG_ADDR, buffer)) {
+                    this->m_fsInfoSector = 0;
+                } else {
+                    const uint32_t freeCount = this->m_driver->get_long(FSINFO_FREE_COUNT_ADDR, buffer);
+                    const uint32_t nextFree  = this->m_driver->get_long(FSINFO_NEXT_FREE_ADDR, buffer);
+                    if (freeCount <= this->m_initFatInfo.clusterCount)
+                        this->m_freeCount = freeCount;
+                    if (this->first_allocatable_cluster() <= nextFree && nextFree <= this->last_allocatable_cluster())
+                        this->m_nextFreeHint = nextFree;
+                }
+            }
+
+            return 0;
+        }
+
+        /**
+         * @brief   Write the free cluster count and next-free hint back to the FSInfo sector, if either has changed
+         *
+         * The FAT buffer is borrowed as scratch space, so the FAT must be flushed first. The current FAT sector is
+         * reloaded afterwards.
+         *
+         * @return  0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode write_fs_info () {
+            PropWare::ErrorCode err;
+
+            if (this->m_fsInfoSector && this->m_fsInfoMod) {
+                check_errors(this->m_driver->read_data_block(this->m_fsInfoSector, this->m_fat));
+                this->m_driver->write_long(FSINFO_FREE_COUNT_ADDR, this->m_fat, this->m_freeCount);
+                this->m_driver->write_long(FSINFO_NEXT_FREE_ADDR, this->m_fat, this->m_nextFreeHint);
+                check_errors(this->m_driver->write_data_block(this->m_fsInfoSector, this->m_fat));
+                check_errors(this->m_driver->read_data_block(this->m_fatStart + this->m_curFatSector, this->m_fat));
+                this->m_fsInfoMod = false;
+            }
+
+            return 0;
         }
 
         inline PropWare::ErrorCode read_fat_and_root_sectors (uint8_t buffer[]) {
             PropWare::ErrorCode err;
 
             // Store the first sector of the FAT
-            check_errors(this->m_driver->read_data_block(this->m_fatStart, this->m_fat));
-            this->m_curFatSector = 0;
+            check_errors(this->load_fat_sector(0));
 
             // Read in the root directory, set root as current
             check_errors(this->m_driver->read_data_block(this->m_rootAddr, buffer));
@@ -385,6 +1018,164 @@ class FatFS : public Filesystem {
             return 0;
         }
 
+        inline bool is_exfat_boot_sector (const uint8_t buffer[]) const {
+            return 0 == memcmp(&buffer[EXFAT_NAME_ADDR], "EXFAT   ", 8);
+        }
+
+        /**
+         * @brief       Parse an exFAT boot sector
+         *
+         * exFAT describes the volume's layout directly rather than through BIOS parameters, so this replaces all of
+         * the FAT16/32 parsing steps. Only the active FAT and bitmap of a volume with a single FAT are used
+         *
+         * @param[in]   buffer[]    Buffer holding the boot sector
+         *
+         * @return      0 upon success, error code otherwise
+         */
+        inline PropWare::ErrorCode exfat_boot_sector_parser (const uint8_t buffer[]) {
+            InitFATInfo    *i           = &this->m_initFatInfo;
+            const uint8_t  sectorShift  = this->m_driver->get_byte(EXFAT_SECTOR_SHIFT_ADDR, buffer);
+            const uint8_t  clusterShift = this->m_driver->get_byte(EXFAT_CLUSTER_SHIFT_ADDR, buffer);
+
+            // Sectors are read exactly as the device provides them, so the volume must have been formatted for them
+            if (this->m_driver->get_sector_size_shift() != sectorShift)
+                return UNSUPPORTED_FILESYSTEM;
+            else if (EXFAT_MAX_CLUSTER_SHIFT < sectorShift + clusterShift)
+                return BAD_SECTORS_PER_CLUSTER;
+
+            i->numFATs = this->m_driver->get_byte(EXFAT_NUM_FATS_ADDR, buffer);
+            if (1 != i->numFATs)
+                return TOO_MANY_FATS;
+
+            this->m_filesystem                = EX_FAT;
+            this->m_entriesPerFatSector_Shift = (uint8_t) (sectorShift - 2);  // 4 bytes per entry
+            this->m_tier1sPerTier2Shift       = clusterShift;
+
+            i->rootEntryCount  = 0;
+            i->rootDirSectors  = 0;
+            i->rsvdSectorCount = this->m_driver->get_long(EXFAT_FAT_OFFSET_ADDR, buffer);
+            i->FATSize         = this->m_driver->get_long(EXFAT_FAT_LENGTH_ADDR, buffer);
+            i->clusterCount    = this->m_driver->get_long(EXFAT_CLUSTER_COUNT_ADDR, buffer);
+            i->dataSectors     = i->clusterCount << clusterShift;
+            i->totalSectors    = this->m_driver->get_long(EXFAT_HEAP_OFFSET_ADDR, buffer) + i->dataSectors;
+
+            this->m_fatStart       = i->bootSector + i->rsvdSectorCount;
+            this->m_fatSize        = i->FATSize;
+            this->m_firstDataAddr  = i->bootSector + this->m_driver->get_long(EXFAT_HEAP_OFFSET_ADDR, buffer);
+            this->m_rootDirSectors = 0;
+            this->m_rootCluster    = this->m_driver->get_long(EXFAT_ROOT_CLUSTER_ADDR, buffer);
+            this->m_rootAddr       = this->compute_tier1_from_tier2(this->m_rootCluster);
+            // exFAT has no FSInfo sector - the free cluster count is unknown and the allocation bitmap is searched from
+            // the beginning
+            this->m_fsInfoSector   = 0;
+
+            const uint16_t volumeFlags = this->m_driver->get_short(EXFAT_VOLUME_FLAGS_ADDR, buffer);
+            this->m_volumeDirty = 0 != (EXFAT_VOLUME_DIRTY & volumeFlags);
+            return NO_ERROR;
+        }
+
+        /**
+         * @brief       Find the allocation bitmap and volume label among the first entries of the exFAT root directory
+         *
+         * The bitmap is read and written through the FAT buffer (and FAT cache, if any), as though it were a part of
+         * the FAT stored after it. That requires its clusters to be consecutive, which every formatter ensures
+         *
+         * @param[in]   buffer[]    Buffer holding the first sector of the root directory
+         *
+         * @return      0 upon success, error code otherwise
+         */
+        inline PropWare::ErrorCode read_exfat_root_entries (const uint8_t buffer[]) {
+            PropWare::ErrorCode err;
+            uint32_t            bitmapCluster = 0;
+            uint32_t            bitmapLength  = 0;
+
+            this->m_label[0] = '\0';
+            for (uint16_t offset = 0; offset < this->m_sectorSize && EXFAT_END_OF_DIRECTORY != buffer[offset];
+                 offset += DIR_ENTRY_LENGTH) {
+                if (EXFAT_BITMAP_ENTRY == buffer[offset] && !(BIT_0 & buffer[offset + EXFAT_BITMAP_FLAGS])) {
+                    bitmapCluster = this->m_driver->get_long(offset + EXFAT_FIRST_CLUSTER, buffer);
+                    bitmapLength  = this->m_driver->get_long(offset + EXFAT_DATA_LENGTH, buffer);
+                } else if (EXFAT_LABEL_ENTRY == buffer[offset]) {
+                    // The label is stored in UTF-16; anything beyond ASCII is replaced
+                    uint8_t length = buffer[offset + EXFAT_LABEL_LENGTH];
+                    if (sizeof(this->m_label) - 1 < length)
+                        length = sizeof(this->m_label) - 1;
+                    for (uint8_t j = 0; j < length; ++j) {
+                        const uint16_t c = this->m_driver->get_short(offset + EXFAT_LABEL + (j << 1), buffer);
+                        this->m_label[j] = (char) (0x80 > c ? c : '?');
+                    }
+                    this->m_label[length] = '\0';
+                }
+            }
+
+            if (!bitmapCluster || (bitmapLength << 3) < this->m_initFatInfo.clusterCount)
+                return UNSUPPORTED_FILESYSTEM;
+
+            const uint8_t  clusterShift   = this->m_driver->get_sector_size_shift() + this->m_tier1sPerTier2Shift;
+            const uint32_t bitmapClusters = (bitmapLength + (1 << clusterShift) - 1) >> clusterShift;
+            uint32_t       cluster        = bitmapCluster;
+            for (uint32_t j = 1; j < bitmapClusters; ++j) {
+                uint32_t next;
+                check_errors(this->get_fat_value(cluster, &next));
+                if (cluster + 1 != next)
+                    return UNSUPPORTED_FILESYSTEM;
+                cluster = next;
+            }
+
+            this->m_bitmapStart = this->compute_tier1_from_tier2(bitmapCluster) - this->m_fatStart;
+            return NO_ERROR;
+        }
+
+        /**
+         * @brief   Mark an exFAT volume as being modified, before its first change since it was mounted (or cleaned)
+         *
+         * Until the volume is unmounted, other systems will know that the allocation bitmap and FAT may not agree
+         *
+         * @return  0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode mark_volume_dirty () {
+            PropWare::ErrorCode err;
+
+            if (EX_FAT != this->m_filesystem || this->m_volumeDirty)
+                return NO_ERROR;
+
+            check_errors(this->write_volume_flags(true));
+            this->m_volumeDirty      = true;
+            this->m_clearVolumeDirty = true;
+            return NO_ERROR;
+        }
+
+        /**
+         * @brief       Set or clear the "volume dirty" flag in the exFAT boot sector
+         *
+         * The FAT buffer is borrowed as scratch space, just like PropWare::FatFS::write_fs_info. The percentage of
+         * the volume in use is reported as unknown, because this driver does not keep track of it
+         *
+         * @param[in]   dirty   True to mark the volume dirty, false to mark it clean
+         *
+         * @return      0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode write_volume_flags (const bool dirty) {
+            PropWare::ErrorCode err;
+            const uint32_t      bootSector = this->m_initFatInfo.bootSector;
+
+            check_errors(this->flush_fat());
+            check_errors(this->m_driver->read_data_block(bootSector, this->m_fat));
+            uint16_t flags = this->m_driver->get_short(EXFAT_VOLUME_FLAGS_ADDR, this->m_fat);
+            if (dirty)
+                flags |= EXFAT_VOLUME_DIRTY;
+            else
+                flags &= ~EXFAT_VOLUME_DIRTY;
+            this->m_driver->write_short(EXFAT_VOLUME_FLAGS_ADDR, this->m_fat, flags);
+            this->m_fat[EXFAT_PERCENT_USED_ADDR] = EXFAT_PERCENT_UNKNOWN;
+            check_errors(this->m_driver->write_data_block(bootSector, this->m_fat));
+
+            if (NO_FAT_SECTOR != this->m_curFatSector) {
+                check_errors(this->m_driver->read_data_block(this->m_fatStart + this->m_curFatSector, this->m_fat));
+            }
+            return NO_ERROR;
+        }
+
         bool is_eoc (int32_t value) const {
             switch (this->m_filesystem) {
                 case FAT_16:
@@ -392,6 +1183,8 @@ class FatFS : public Filesystem {
                 case FAT_32:
                     value |= 0xf0000000;
                     return EOC_BEG <= value && EOC_END <= value;
+                case EX_FAT:
+                    return EOC_BEG <= value && value <= EOC_END;
                 default:
                     return false;
             }
@@ -411,11 +1204,7 @@ class FatFS : public Filesystem {
             uint32_t            firstAvailableCluster;
 
             // Do we need to load a new fat sector?
-            if ((fatEntry >> this->m_entriesPerFatSector_Shift) != this->m_curFatSector) {
-                this->flush_fat();
-                this->m_curFatSector = fatEntry >> this->m_entriesPerFatSector_Shift;
-                check_errors(this->m_driver->read_data_block(this->m_curFatSector + this->m_fatStart, this->m_fat));
-            }
+            check_errors(this->load_fat_sector(fatEntry >> this->m_entriesPerFatSector_Shift));
             firstAvailableCluster = this->m_curFatSector << this->m_entriesPerFatSector_Shift;
 
             // The necessary FAT sector has been loaded and the next cluster is known, proceed with loading
@@ -425,166 +1214,1883 @@ class FatFS : public Filesystem {
             if (FAT_16 == this->m_filesystem) {
                 *value = this->m_driver->get_short((uint16_t) ((fatEntry - firstAvailableCluster) << 1), this->m_fat);
                 *value &= WORD_0;
-            } else if (FAT_32 == this->m_filesystem) {
+            } else {
                 *value = this->m_driver->get_long((uint16_t) ((fatEntry - firstAvailableCluster) << 2), this->m_fat);
-                // Clear the highest 4 bits - they are always reserved
-                *value &= 0x0FFFFFFF;
+                // Clear the highest 4 bits - they are always reserved in FAT32
+                *value &= this->fat_entry_mask();
             }
 
             return 0;
         }
 
         /**
-         * @brief       Find and return the starting sector's address for a given cluster
+         * @brief       Follow a cluster chain for up to `steps` links
          *
-         * @param[in]   tier2   Cluster in FAT filesystem
+         * Every FAT sector along the way is read once. Without a scratch buffer, sectors are loaded one at a time
+         * through the FAT buffer (and FAT cache, if any). With one, runs of consecutive FAT sectors are read with a
+         * single multi-block read each, and the FAT buffer and cache are left untouched - walking a long chain does
+         * not evict sectors that are still useful.
          *
-         * @return      Returns sector address of the desired cluster
+         * @param[in,out]   *cluster        Cluster to start from; the cluster reached upon return
+         * @param[in]       steps           Largest number of links to follow
+         * @param[out]      *taken          Number of links followed - less than `steps` if the chain ends first
+         * @param[out]      *next           FAT entry of the cluster that was reached (its successor, or an
+         *                                  end-of-chain marker)
+         * @param[in]       scratch[]       Optional buffer for multi-block reads
+         * @param[in]       scratchSectors  Size of `scratch`, in sectors
+         *
+         * @return      Returns 0 upon success, error code otherwise
          */
-        uint32_t compute_tier1_from_tier2 (uint32_t tier2) const {
-            tier2 -= 2; // Magical offset, as described in section 6.7 of the MS FAT32 spec
-            tier2 <<= this->m_tier1sPerTier2Shift;
-            tier2 += this->m_firstDataAddr;
-            return tier2;
-        }
+        PropWare::ErrorCode walk_chain (uint32_t *cluster, const uint32_t steps, uint32_t *taken, uint32_t *next,
+                                        uint8_t scratch[] = NULL, const uint16_t scratchSectors = 0) {
+            PropWare::ErrorCode err;
+            uint32_t            current = *cluster;
+            uint32_t            value;
+            uint32_t            done    = 0;
+
+            if (NULL == scratch || 2 > scratchSectors) {
+                check_errors(this->get_fat_value(current, &value));
+                while (done < steps && !this->is_eoc(value)) {
+                    current = value;
+                    ++done;
+                    check_errors(this->get_fat_value(current, &value));
+                }
+            } else {
+                const uint8_t  sectorShift   = this->m_driver->get_sector_size_shift();
+                const uint32_t entryMask     = (1 << this->m_entriesPerFatSector_Shift) - 1;
+                uint32_t       windowStart   = 0;
+                uint32_t       windowSectors = 0;
+
+                // Reads bypass the FAT buffer and cache, so the device must be up to date
+                check_errors(this->flush_fat());
+
+                while (true) {
+                    const uint32_t fatSector = current >> this->m_entriesPerFatSector_Shift;
+                    if (fatSector < windowStart || windowStart + windowSectors <= fatSector) {
+                        if (this->m_fatSize <= fatSector)
+                            return READING_PAST_EOC;
+                        windowStart   = fatSector;
+                        windowSectors = this->m_fatSize - fatSector < scratchSectors ? this->m_fatSize - fatSector
+                                                                                      : scratchSectors;
+                        check_errors(this->m_driver->read_data_blocks(this->m_fatStart + windowStart, windowSectors,
+                                                                      scratch));
+                    }
 
-        /**
-         * @brief   Add more sectors to the directory to allow for new file and directory entries
-         */
-        PropWare::ErrorCode extend_current_directory () {
-            return this->extend_fat(&this->m_dirMeta);
+                    const uint8_t  *sector = &scratch[(fatSector - windowStart) << sectorShift];
+                    if (FAT_16 == this->m_filesystem)
+                        value = this->m_driver->get_short((uint16_t) ((current & entryMask) << 1), sector) & WORD_0;
+                    else
+                        value = this->m_driver->get_long((uint16_t) ((current & entryMask) << 2), sector)
+                                & this->fat_entry_mask();
+
+                    if (done == steps || this->is_eoc(value))
+                        break;
+                    current = value;
+                    ++done;
+                }
+            }
+
+            *cluster = current;
+            *taken   = done;
+            *next    = value;
+            return 0;
         }
 
         /**
-         * @brief       Enlarge a file or directory by one cluster
+         * @brief       Write an entry of the FAT
          *
-         * @param[in]   *bufferMetadata     Address of the buffer (containing information for a file or directory) to be
+         * @param[in]   fatEntry    Entry number (cluster) to modify
+         * @param[in]   value       New value of the entry (the next cluster, or an end-of-chain marker)
+         *
+         * @return      Returns 0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode set_fat_value (const uint32_t fatEntry, const uint32_t value) {
+            PropWare::ErrorCode err;
+
+            check_errors(this->mark_volume_dirty());
+            check_errors(this->load_fat_sector(fatEntry >> this->m_entriesPerFatSector_Shift));
+            const uint16_t entryOffset = (uint16_t) (fatEntry - (this->m_curFatSector
+                    << this->m_entriesPerFatSector_Shift));
+
+            if (FAT_16 == this->m_filesystem)
+                this->m_driver->write_short(entryOffset << 1, this->m_fat, (uint16_t) value);
+            else
+                this->m_driver->write_long(entryOffset << 2, this->m_fat, value & this->fat_entry_mask());
+            this->m_fatMod = true;
+
+            return 0;
+        }
+
+        /**
+         * @brief   Bits of a 32-bit FAT entry which hold its value: the highest 4 are reserved in FAT32 but not exFAT
+         */
+        uint32_t fat_entry_mask () const {
+            return EX_FAT == this->m_filesystem ? (uint32_t) EOC_END : EOC_MASK;
+        }
+
+        /**
+         * @brief       Find and return the starting sector's address for a given cluster
+         *
+         * @param[in]   tier2   Cluster in FAT filesystem
+         *
+         * @return      Returns sector address of the desired cluster
+         */
+        uint32_t compute_tier1_from_tier2 (uint32_t tier2) const {
+            tier2 -= 2; // Magical offset, as described in section 6.7 of the MS FAT32 spec
+            tier2 <<= this->m_tier1sPerTier2Shift;
+            tier2 += this->m_firstDataAddr;
+            return tier2;
+        }
+
+        /**
+         * @brief       Add a cluster to the directory whose final sector is in the buffer, to allow for new file and
+         *              directory entries
+         *
+         * The whole cluster is cleared, and the buffer is left holding its first sector - the directory's first free
+         * entry.
+         *
+         * @param[in]   directory   First cluster of the directory
+         * @param[in]   *buffer     Buffer holding the final sector of the directory (described by `m_dirMeta`)
+         *
+         * @return      0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode extend_directory (const uint32_t directory, BlockStorage::Buffer *buffer) {
+            PropWare::ErrorCode    err;
+            BlockStorage::MetaData *dirMeta       = &this->m_dirMeta;
+            const uint32_t         tier1sPerTier2 = (uint32_t) 1 << this->m_tier1sPerTier2Shift;
+
+            // The root directory of FAT16 can not grow
+            if (this->is_fat16_root(directory))
+                return DIRECTORY_FULL;
+
+            BlockStorage::MetaData end = *dirMeta;
+            check_errors(this->m_driver->flush(buffer));
+            if (EX_FAT == this->m_filesystem && this->m_rootCluster != directory) {
+                check_errors(this->extend_exfat_subdirectory(directory, buffer, &end));
+            } else
+                check_errors(this->extend_fat(&end));
+
+            dirMeta->curTier2       = end.nextTier2;
+            dirMeta->curTier2Addr   = this->compute_tier1_from_tier2(dirMeta->curTier2);
+            dirMeta->curTier1Offset = 0;
+            check_errors(this->get_fat_value(dirMeta->curTier2, &dirMeta->nextTier2));
+
+            memset(buffer->buf, 0, this->m_sectorSize);
+            for (uint32_t i = 1; i < tier1sPerTier2; ++i)
+                check_errors(this->m_driver->write_data_block(dirMeta->curTier2Addr + i, buffer->buf));
+            buffer->meta = dirMeta;
+            dirMeta->mod = true;
+            return NO_ERROR;
+        }
+
+        /**
+         * @brief       Add a cluster to an exFAT directory other than the root, whose size is recorded in the stream
+         *              extension entry of its parent
+         *
+         * The cluster is linked in the FAT, and written to the device along with the allocation bitmap, before the
+         * directory's DataLength and ValidDataLength grow. A directory written without a FAT chain is given one first.
+         *
+         * @param[in]       directory   First cluster of the directory
+         * @param[in]       *buffer     Buffer described by `m_dirMeta`, already flushed. It is left holding the
+         *                              parent's sector with the directory's entry set
+         * @param[in,out]   *end        The directory's final cluster; PropWare::BlockStorage::MetaData::nextTier2
+         *                              holds the new cluster upon return
+         *
+         * @return      0 upon success, PropWare::FatFS::DIRECTORY_FULL if the directory's entry set is not known,
+         *              error code otherwise
+         */
+        PropWare::ErrorCode extend_exfat_subdirectory (const uint32_t directory, BlockStorage::Buffer *buffer,
+                                                       BlockStorage::MetaData *end) {
+            PropWare::ErrorCode err;
+            uint8_t             set[EXFAT_MAX_SET_ENTRIES * DIR_ENTRY_LENGTH];
+            uint8_t             entries;
+
+            const ExFatDirectoryEntry *record = this->find_exfat_directory_entry(directory);
+            if (NULL == record)
+                return DIRECTORY_FULL;
+
+            check_errors(this->load_entry_location(buffer, &record->location));
+            // The parent may have grown since its sector was recorded
+            check_errors(this->get_fat_value(buffer->meta->curTier2, &buffer->meta->nextTier2));
+            check_errors(this->read_entry_set(buffer, record->offset, set, &entries));
+            uint8_t *stream = &set[DIR_ENTRY_LENGTH];
+
+            if (EXFAT_NO_FAT_CHAIN & stream[EXFAT_FLAGS]) {
+                check_errors(this->link_run(directory, this->clusters_for_length(stream)));
+                stream[EXFAT_FLAGS] &= ~EXFAT_NO_FAT_CHAIN;
+            }
+            check_errors(this->extend_fat(end));
+            check_errors(this->flush_fat());
+
+            const uint32_t clusterBytes = (uint32_t) 1 << (this->m_driver->get_sector_size_shift()
+                    + this->m_tier1sPerTier2Shift);
+            const uint32_t dataLength   = this->m_driver->get_long(EXFAT_DATA_LENGTH, stream) + clusterBytes;
+            this->m_driver->write_long(EXFAT_VALID_DATA_LENGTH, stream, dataLength);
+            this->m_driver->write_long(EXFAT_DATA_LENGTH, stream, dataLength);
+            check_errors(this->write_entry_set(buffer, record->offset, set, entries));
+            return this->m_driver->flush(buffer);
+        }
+
+        /**
+         * @brief       Find where the entry set of an exFAT directory was recorded while resolving a path
+         *
+         * @return      The record, or NULL if `directory` is neither the working directory nor the last directory found
+         */
+        const ExFatDirectoryEntry *find_exfat_directory_entry (const uint32_t directory) const {
+            if (directory == this->m_exfatLastDirEntry.cluster)
+                return &this->m_exfatLastDirEntry;
+            else if (directory == this->m_exfatWorkingDirEntry.cluster)
+                return &this->m_exfatWorkingDirEntry;
+            else
+                return NULL;
+        }
+
+        /**
+         * @brief       Enlarge a file or directory by one cluster
+         *
+         * @param[in]   *bufferMetadata     Address of the buffer (containing information for a file or directory) to be
          *                                  enlarged
          *
-         * @return      Returns 0 upon success, error code otherwise
+         * @return      Returns 0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode extend_fat (BlockStorage::MetaData *bufferMetadata) {
+            PropWare::ErrorCode err;
+            uint32_t            newAllocUnit;
+
+            if (EX_FAT == this->m_filesystem) {
+                uint32_t nextAllocUnit;
+                check_errors(this->get_fat_value(bufferMetadata->curTier2, &nextAllocUnit));
+                if (!this->is_eoc(nextAllocUnit))
+                    return INVALID_FAT_APPEND;
+                check_errors(this->find_space_after(bufferMetadata->curTier2, &newAllocUnit));
+                // Unlike FAT16/32, claiming a cluster only marks it in the allocation bitmap
+                check_errors(this->set_fat_value(newAllocUnit, (uint32_t) EOC_END));
+                check_errors(this->set_fat_value(bufferMetadata->curTier2, newAllocUnit));
+                bufferMetadata->nextTier2 = newAllocUnit;
+                return 0;
+            }
+
+            // Do we need to load a different sector of the FAT or is the correct one currently loaded? (Correct means
+            // the sector currently containing the EOC marker)
+            check_errors(this->load_fat_sector(bufferMetadata->curTier2 >> this->m_entriesPerFatSector_Shift));
+
+            // This function should only be called when a file or directory has
+            // reached the end of its cluster chain
+            const uint16_t entriesPerFatSector = (uint16_t) (1 << this->m_entriesPerFatSector_Shift);
+            const uint16_t allocUnitOffset     = (uint16_t) (bufferMetadata->curTier2 % entriesPerFatSector);
+            const uint16_t fatPointerAddress   = allocUnitOffset * this->m_filesystem;
+            const uint32_t nextSector          = this->m_driver->get_long(fatPointerAddress, this->m_fat);
+            if (!this->is_eoc(nextSector))
+                return INVALID_FAT_APPEND;
+
+            // Find where the next cluster of the file should be stored...
+            check_errors(this->find_space_after(bufferMetadata->curTier2, &newAllocUnit));
+
+            // Now that we know the allocation unit, write it to the FAT buffer
+            const uint16_t sectorOffset = (uint16_t) ((bufferMetadata->curTier2 %
+                    (1 << this->m_entriesPerFatSector_Shift)) * this->m_filesystem);
+            if (FAT_16 == this->m_filesystem)
+                this->m_driver->write_short(sectorOffset, this->m_fat, (uint16_t) newAllocUnit);
+            else
+                this->m_driver->write_long(sectorOffset, this->m_fat, newAllocUnit);
+            bufferMetadata->nextTier2 = newAllocUnit;
+            this->m_fatMod            = true;  // And mark the buffer as modified
+
+            return 0;
+        }
+
+        /**
+         * @brief       Find the first empty allocation unit in the FAT
+         *
+         * The search begins at the next-free hint (initialized from the FSInfo sector on FAT32 volumes and advanced
+         * with every allocation) and wraps around the end of the FAT. FAT sectors which the free space summary marks as
+         * full are skipped without being read. Once found, the new entry will contain the end-of-chain marker,
+         * SD_EOC_END.
+         *
+         * NOTE: It is important to realize that, though the new entry now contains an EOC marker, this function
+         * does not know what cluster is being extended and therefore the calling function must modify the previous
+         * EOC to contain the return value
+         *
+         * @param[in]   restore     If non-zero, the original fat-sector will be restored to m_fat before returning;
+         *                          if zero, the last-used sector will remain loaded
+         * @param[out]  *allocUnit  Number of the first unused allocation unit
+         *
+         * @return      Returns 0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode find_empty_space (const uint8_t restore, uint32_t *allocUnit) {
+            PropWare::ErrorCode err;
+            const uint32_t      originalFatSector = this->m_curFatSector;
+            const uint32_t      firstAllocUnit    = this->first_allocatable_cluster();
+            const uint32_t      lastAllocUnit     = this->last_allocatable_cluster();
+            const uint32_t      lastFatSector     = lastAllocUnit >> this->m_entriesPerFatSector_Shift;
+
+            uint32_t candidate = this->m_nextFreeHint;
+            if (candidate < firstAllocUnit || lastAllocUnit < candidate)
+                candidate = firstAllocUnit;
+            uint32_t fatSector = candidate >> this->m_entriesPerFatSector_Shift;
+
+            // The sector containing the hint is visited twice: once from the hint onwards, and once more from its
+            // beginning after wrapping around
+            for (uint32_t visited = 0; visited <= lastFatSector + 1; ++visited) {
+                const uint32_t sectorStart = fatSector << this->m_entriesPerFatSector_Shift;
+                const uint32_t scanStart   = sectorStart < firstAllocUnit ? firstAllocUnit : sectorStart;
+                if (candidate < scanStart)
+                    candidate = scanStart;
+
+                if (this->fat_sector_may_have_free(fatSector)) {
+                    const bool     wholeSector = candidate == scanStart;
+                    const uint32_t nextSector  = sectorStart + (1 << this->m_entriesPerFatSector_Shift);
+                    const uint32_t sectorEnd   = nextSector <= lastAllocUnit ? nextSector : lastAllocUnit + 1;
+
+                    for (; candidate < sectorEnd; ++candidate) {
+                        bool isFree;
+                        check_errors(this->cluster_is_free(candidate, &isFree));
+                        if (isFree) {
+                            check_errors(this->claim_empty_space(candidate, restore, originalFatSector));
+                            *allocUnit = candidate;
+                            return 0;
+                        }
+                    }
+
+                    // Only a complete scan can prove that a sector is full
+                    if (wholeSector)
+                        this->mark_fat_sector(fatSector, false);
+                }
+
+                fatSector = lastFatSector == fatSector ? 0 : fatSector + 1;
+                candidate = 0;
+            }
+
+            if (restore)
+                check_errors(this->load_fat_sector(originalFatSector));
+            return FAT_FULL;
+        }
+
+        /**
+         * @brief       Find an allocation unit for the first cluster of a new chain
+         *
+         * With the allocation unit policy enabled (see PropWare::FatFS::set_allocation_unit_size), the first
+         * cluster of an erase block is chosen, starting from `preferred`. Erase blocks whose first and last clusters
+         * are both free are assumed to be empty and are taken first; otherwise, the first erase block with a free
+         * first cluster is used. Without the policy, or if no erase block begins with a free cluster, this is
+         * identical to PropWare::FatFS::find_empty_space.
+         *
+         * @param[in]   restore     If non-zero, the original fat-sector will be restored to m_fat before returning;
+         *                          if zero, the last-used sector will remain loaded
+         * @param[in]   preferred   Allocation unit where the search should begin
+         * @param[out]  *allocUnit  Number of the new chain's first allocation unit, which now holds the end-of-chain
+         *                          marker
+         *
+         * @return      Returns 0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode find_aligned_space (const uint8_t restore, const uint32_t preferred,
+                                                uint32_t *allocUnit) {
+            PropWare::ErrorCode err;
+            const uint32_t      originalFatSector = this->m_curFatSector;
+            const uint32_t      firstAllocUnit    = this->first_allocatable_cluster();
+            const uint32_t      lastAllocUnit     = this->last_allocatable_cluster();
+
+            if (!this->m_auClusters)
+                return this->find_empty_space(restore, allocUnit);
+
+            uint32_t candidate = preferred;
+            if (candidate < firstAllocUnit || lastAllocUnit < candidate)
+                candidate = firstAllocUnit;
+            candidate = this->next_allocation_unit_start(candidate);
+
+            bool     fallbackFound = false;
+            uint32_t fallback      = 0;
+            for (uint32_t visited = 0; visited <= (lastAllocUnit - firstAllocUnit) / this->m_auClusters + 1;
+                 ++visited) {
+                if (lastAllocUnit < candidate)
+                    candidate = this->next_allocation_unit_start(firstAllocUnit);
+
+                if (this->fat_sector_may_have_free(candidate >> this->m_entriesPerFatSector_Shift)) {
+                    const uint32_t auLast = candidate + this->m_auClusters - 1;
+                    bool           tailFree;
+                    bool           isFree;
+                    check_errors(this->cluster_is_free(auLast < lastAllocUnit ? auLast : lastAllocUnit, &tailFree));
+
+                    // Read the first cluster last, so that its FAT sector is loaded when the cluster is claimed
+                    check_errors(this->cluster_is_free(candidate, &isFree));
+                    if (isFree) {
+                        if (tailFree) {
+                            check_errors(this->claim_empty_space(candidate, restore, originalFatSector));
+                            *allocUnit = candidate;
+                            return 0;
+                        } else if (!fallbackFound) {
+                            fallbackFound = true;
+                            fallback      = candidate;
+                        }
+                    }
+                }
+
+                candidate += this->m_auClusters;
+            }
+
+            if (fallbackFound) {
+                check_errors(this->claim_empty_space(fallback, restore, originalFatSector));
+                *allocUnit = fallback;
+                return 0;
+            }
+
+            if (restore)
+                check_errors(this->load_fat_sector(originalFatSector));
+            return this->find_empty_space(restore, allocUnit);
+        }
+
+        /**
+         * @brief       Find an allocation unit with which to extend a chain
+         *
+         * With the allocation unit policy enabled (see PropWare::FatFS::set_allocation_unit_size), the first free
+         * cluster after `previous` within the same erase block is chosen. Once that erase block is full, a new one is
+         * found with PropWare::FatFS::find_aligned_space, starting with the erase block that directly follows. Without
+         * the policy, this is identical to PropWare::FatFS::find_empty_space. The FAT sector which was loaded before
+         * the call is loaded again before returning.
+         *
+         * @param[in]   previous    Allocation unit at the end of the chain being extended
+         * @param[out]  *allocUnit  Number of the new allocation unit, which now holds the end-of-chain marker
+         *
+         * @return      Returns 0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode find_space_after (const uint32_t previous, uint32_t *allocUnit) {
+            PropWare::ErrorCode err;
+            const uint32_t      originalFatSector = this->m_curFatSector;
+            const uint32_t      lastAllocUnit     = this->last_allocatable_cluster();
+            const uint32_t      sectorMask        = (1 << this->m_entriesPerFatSector_Shift) - 1;
+
+            if (!this->m_auClusters)
+                return this->find_empty_space(1, allocUnit);
+
+            const uint32_t auEnd = this->next_allocation_unit_start(previous + 1);
+            for (uint32_t candidate = previous + 1; candidate < auEnd && candidate <= lastAllocUnit; ++candidate) {
+                if (this->fat_sector_may_have_free(candidate >> this->m_entriesPerFatSector_Shift)) {
+                    bool isFree;
+                    check_errors(this->cluster_is_free(candidate, &isFree));
+                    if (isFree) {
+                        check_errors(this->claim_empty_space(candidate, 1, originalFatSector));
+                        *allocUnit = candidate;
+                        return 0;
+                    }
+                } else
+                    // Skip the rest of a full FAT sector
+                    candidate |= sectorMask;
+            }
+
+            check_errors(this->load_fat_sector(originalFatSector));
+            return this->find_aligned_space(1, auEnd, allocUnit);
+        }
+
+        /**
+         * @brief       Find `count` consecutive free allocation units and link them into a single chain
+         *
+         * The search begins at `preferred` (so that the run can directly follow an existing chain) and wraps around
+         * the end of the FAT, skipping any FAT sectors which the free space summary marks as full. Since this may
+         * read the entire FAT, it is meant to be done ahead of time rather than in the middle of time-critical work.
+         *
+         * @param[in]   preferred   Allocation unit where the search should begin
+         * @param[in]   count       Number of allocation units needed; must be at least 1
+         * @param[out]  *first      First allocation unit of the run. Each unit of the run points to the one after it,
+         *                          and the last one holds the end-of-chain marker
+         *
+         * @return      Returns 0 upon success, FatFS::FAT_FULL if there is no run of `count` free units, or another
+         *              error code otherwise
+         */
+        PropWare::ErrorCode allocate_contiguous (const uint32_t preferred, const uint32_t count, uint32_t *first) {
+            PropWare::ErrorCode err;
+            const uint32_t      firstAllocUnit = this->first_allocatable_cluster();
+            const uint32_t      lastAllocUnit  = this->last_allocatable_cluster();
+            const uint32_t      sectorMask     = (1 << this->m_entriesPerFatSector_Shift) - 1;
+
+            uint32_t candidate = preferred;
+            if (candidate < firstAllocUnit || lastAllocUnit < candidate)
+                candidate = firstAllocUnit;
+
+            // Every allocation unit is visited once, plus enough to complete a run that straddles the starting point
+            uint32_t runStart  = 0;
+            uint32_t runLength = 0;
+            for (uint32_t visited = 0; runLength < count && visited <= lastAllocUnit - firstAllocUnit + count;) {
+                if (lastAllocUnit < candidate) {
+                    // A run can not wrap around the end of the FAT
+                    candidate = firstAllocUnit;
+                    runLength = 0;
+                }
+
+                const uint32_t fatSector = candidate >> this->m_entriesPerFatSector_Shift;
+                if (this->fat_sector_may_have_free(fatSector)) {
+                    bool isFree;
+                    check_errors(this->cluster_is_free(candidate, &isFree));
+                    if (!isFree)
+                        runLength = 0;
+                    else if (runLength++ == 0)
+                        runStart = candidate;
+                    ++candidate;
+                    ++visited;
+                } else {
+                    // Skip the rest of a full FAT sector
+                    const uint32_t skipped = (sectorMask + 1) - (candidate & sectorMask);
+                    candidate += skipped;
+                    visited += skipped;
+                    runLength = 0;
+                }
+            }
+
+            if (runLength < count)
+                return FAT_FULL;
+
+            if (EX_FAT == this->m_filesystem) {
+                check_errors(this->set_bitmap_run(runStart, count, true));
+            }
+            check_errors(this->link_run(runStart, count));
+            this->take_free_clusters(runStart, count);
+
+            *first = runStart;
+            return 0;
+        }
+
+        /**
+         * @brief       Claim a run of clusters at a fixed position, if every one of them is free
+         *
+         * Only the allocation bitmap is updated, which is all an exFAT file without a FAT chain needs in order to grow
+         * in place
+         *
+         * @param[in]   first   First cluster of the run
+         * @param[in]   count   Number of clusters
+         *
+         * @return      0 upon success, FatFS::FAT_FULL if any of the clusters is taken (or beyond the end of the
+         *              volume), or another error code otherwise
+         */
+        PropWare::ErrorCode claim_run (const uint32_t first, const uint32_t count) {
+            PropWare::ErrorCode err;
+
+            if (first < this->first_allocatable_cluster() || this->last_allocatable_cluster() - first < count - 1)
+                return FAT_FULL;
+            for (uint32_t cluster = first; cluster < first + count; ++cluster) {
+                bool isFree;
+                check_errors(this->cluster_is_free(cluster, &isFree));
+                if (!isFree)
+                    return FAT_FULL;
+            }
+
+            check_errors(this->set_bitmap_run(first, count, true));
+            this->take_free_clusters(first, count);
+            return NO_ERROR;
+        }
+
+        /**
+         * @brief       Return a run of clusters which were claimed in the allocation bitmap but never linked in the FAT
+         *              (exFAT only)
+         *
+         * @param[in]   first   First cluster of the run
+         * @param[in]   count   Number of clusters
+         *
+         * @return      0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode release_run (const uint32_t first, const uint32_t count) {
+            PropWare::ErrorCode err;
+
+            check_errors(this->set_bitmap_run(first, count, false));
+            for (uint32_t cluster = first; cluster < first + count; ++cluster)
+                this->mark_fat_sector(cluster >> this->m_entriesPerFatSector_Shift, true);
+            if (first < this->m_nextFreeHint)
+                this->m_nextFreeHint = first;
+            if (UNKNOWN_FREE_COUNT != this->m_freeCount)
+                this->m_freeCount += count;
+            this->m_fsInfoMod = true;
+            return NO_ERROR;
+        }
+
+        /**
+         * @brief       Link a run of consecutive clusters into a single chain, ending with the end-of-chain marker
+         *
+         * @param[in]   first   First cluster of the run
+         * @param[in]   count   Number of clusters; must be at least 1
+         *
+         * @return      0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode link_run (const uint32_t first, const uint32_t count) {
+            PropWare::ErrorCode err;
+
+            for (uint32_t allocUnit = first; allocUnit < first + count - 1; ++allocUnit)
+                check_errors(this->set_fat_value(allocUnit, allocUnit + 1));
+            return this->set_fat_value(first + count - 1, (uint32_t) EOC_END);
+        }
+
+        /**
+         * @brief   Update the allocator's bookkeeping after a run of clusters has been claimed
+         */
+        void take_free_clusters (const uint32_t first, const uint32_t count) {
+            this->m_nextFreeHint = first + count;
+            if (UNKNOWN_FREE_COUNT != this->m_freeCount)
+                this->m_freeCount = count < this->m_freeCount ? this->m_freeCount - count : 0;
+            this->m_fsInfoMod = true;
+        }
+
+        /**
+         * @brief       Determine whether a cluster is free: from the FAT on FAT16/32, or the allocation bitmap on exFAT
+         *
+         * On FAT16/32, the cluster's FAT sector is left loaded
+         *
+         * @param[in]   cluster     Cluster to check
+         * @param[out]  *isFree     True if the cluster is not in use
+         *
+         * @return      0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode cluster_is_free (const uint32_t cluster, bool *isFree) {
+            PropWare::ErrorCode err;
+
+            if (EX_FAT == this->m_filesystem) {
+                uint8_t *byte;
+                check_errors(this->load_bitmap_byte(cluster, &byte));
+                *isFree = !(*byte & (1 << ((cluster - 2) & 7)));
+            } else {
+                uint32_t value;
+                check_errors(this->get_fat_value(cluster, &value));
+                *isFree = FREE_CLUSTER == value;
+            }
+            return NO_ERROR;
+        }
+
+        /**
+         * @brief       Load the sector of the exFAT allocation bitmap which holds a cluster's bit
+         *
+         * The bitmap is loaded through the FAT buffer, exactly like a FAT sector
+         *
+         * @param[in]   cluster     Cluster whose bit is needed
+         * @param[out]  **byte      Address of the byte, within the FAT buffer, holding the cluster's bit
+         *
+         * @return      0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode load_bitmap_byte (const uint32_t cluster, uint8_t **byte) {
+            PropWare::ErrorCode err;
+            const uint32_t      index = (cluster - 2) >> 3;
+            const uint8_t       shift = this->m_driver->get_sector_size_shift();
+
+            check_errors(this->load_fat_sector(this->m_bitmapStart + (index >> shift)));
+            *byte = &this->m_fat[index & (this->m_sectorSize - 1)];
+            return NO_ERROR;
+        }
+
+        /**
+         * @brief       Mark a run of clusters as allocated or free in the exFAT allocation bitmap
+         *
+         * @param[in]   first       First cluster of the run
+         * @param[in]   count       Number of clusters
+         * @param[in]   allocated   True to mark the clusters as in use, false to mark them as free
+         *
+         * @return      0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode set_bitmap_run (const uint32_t first, const uint32_t count, const bool allocated) {
+            PropWare::ErrorCode err;
+
+            check_errors(this->mark_volume_dirty());
+            for (uint32_t cluster = first; cluster < first + count; ++cluster) {
+                uint8_t       *byte;
+                const uint8_t mask = (uint8_t) (1 << ((cluster - 2) & 7));
+                check_errors(this->load_bitmap_byte(cluster, &byte));
+                if (allocated)
+                    *byte |= mask;
+                else
+                    *byte &= ~mask;
+                this->m_fatMod = true;
+            }
+            return NO_ERROR;
+        }
+
+        /**
+         * @brief       Mark a free allocation unit as the end of a chain and update the free space bookkeeping
+         *
+         * On exFAT, the allocation unit is only marked in the allocation bitmap - its FAT entry is left alone
+         */
+        PropWare::ErrorCode claim_empty_space (const uint32_t allocUnit, const uint8_t restore,
+                                               const uint32_t originalFatSector) {
+            PropWare::ErrorCode err;
+
+            if (EX_FAT == this->m_filesystem) {
+                check_errors(this->set_bitmap_run(allocUnit, 1, true));
+            } else {
+                check_errors(this->load_fat_sector(allocUnit >> this->m_entriesPerFatSector_Shift));
+                const uint16_t entryOffset = (uint16_t) (allocUnit - (this->m_curFatSector
+                        << this->m_entriesPerFatSector_Shift));
+                if (FAT_16 == this->m_filesystem)
+                    this->m_driver->write_short(entryOffset << 1, this->m_fat, (uint16_t) EOC_END);
+                else
+                    this->m_driver->write_long(entryOffset << 2, this->m_fat, ((uint32_t) EOC_END) & EOC_MASK);
+                this->m_fatMod = true;
+            }
+
+            this->m_nextFreeHint = allocUnit + 1;
+            if (UNKNOWN_FREE_COUNT != this->m_freeCount && this->m_freeCount)
+                --this->m_freeCount;
+            this->m_fsInfoMod = true;
+
+            // If a different FAT sector was loaded (and then modified directly above), it is written before the original
+            // is re-loaded
+            if (restore)
+                return this->load_fat_sector(originalFatSector);
+            else
+                return 0;
+        }
+
+        /**
+         * @brief       Ensure that the requested sector of the FAT is loaded into the FAT buffer, flushing the
+         *              previous one if it was modified
+         *
+         * @param[in]   fatSector   Sector number, relative to the start of the FAT
+         *
+         * @return      Returns 0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode load_fat_sector (const uint32_t fatSector) {
+            PropWare::ErrorCode err;
+            if (fatSector != this->m_curFatSector) {
+                if (NULL == this->m_fatCache) {
+                    check_errors(this->flush_fat());
+                    this->m_curFatSector = fatSector;
+                    check_errors(this->m_driver->read_data_block(this->m_curFatSector + this->m_fatStart, this->m_fat));
+                } else
+                    check_errors(this->load_cached_fat_sector(fatSector));
+            }
+            return 0;
+        }
+
+        /**
+         * @brief       Make the cache slot holding `fatSector` the current FAT buffer, replacing the least recently
+         *              used slot (and writing it back, if modified) on a miss
+         *
+         * @param[in]   fatSector   Sector number, relative to the start of the FAT
+         *
+         * @return      Returns 0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode load_cached_fat_sector (const uint32_t fatSector) {
+            PropWare::ErrorCode err;
+            FatCacheSlot        *victim = this->m_fatCache;
+
+            // Modifications to the current sector are tracked by m_fatMod until a different sector is needed
+            if (this->m_fatMod) {
+                this->m_curFatSlot->dirty = true;
+                this->m_fatMod            = false;
+            }
+
+            for (size_t i = 0; i < this->m_fatCacheSize; ++i) {
+                FatCacheSlot *candidate = &this->m_fatCache[i];
+                if (candidate->valid && fatSector == candidate->fatSector) {
+                    victim = candidate;
+                    break;
+                } else if (victim->valid && (!candidate->valid || candidate->lastUse < victim->lastUse))
+                    victim = candidate;
+            }
+
+            if (!victim->valid || fatSector != victim->fatSector) {
+                if (victim->valid && victim->dirty)
+                    check_errors(this->write_fat_sector(victim->fatSector, victim->buf));
+
+                victim->valid = false;
+                check_errors(this->m_driver->read_data_block(fatSector + this->m_fatStart, victim->buf));
+                victim->fatSector = fatSector;
+                victim->valid     = true;
+                victim->dirty     = false;
+            }
+
+            victim->lastUse      = ++this->m_fatCacheClock;
+            this->m_curFatSlot   = victim;
+            this->m_curFatSector = fatSector;
+            this->m_fat          = victim->buf;
+            return 0;
+        }
+
+        void invalidate_fat_cache () {
+            for (size_t i = 0; i < this->m_fatCacheSize; ++i)
+                this->m_fatCache[i].valid = false;
+            this->m_fatCacheClock = 0;
+            this->m_curFatSector  = NO_FAT_SECTOR;
+        }
+
+        /**
+         * @brief       Write a FAT sector to the primary FAT and, unless it can be deferred, to the mirror as well
+         *
+         * @param[in]   fatSector   Sector number, relative to the start of the FAT
+         * @param[in]   buf[]       Contents of the sector
+         *
+         * @return      Returns 0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode write_fat_sector (const uint32_t fatSector, const uint8_t buf[]) {
+            PropWare::ErrorCode err;
+
+            check_errors(this->m_driver->write_data_block(this->m_fatStart + fatSector, buf));
+            // exFAT volumes normally have a single FAT - and the allocation bitmap, which is written through here too,
+            // is never mirrored
+            if (EX_FAT == this->m_filesystem)
+                return NO_ERROR;
+
+            for (uint8_t i = 0; i < this->m_staleMirrorCount; ++i)
+                if (fatSector == this->m_staleMirrors[i])
+                    return NO_ERROR;
+
+            if (this->m_staleMirrorCount < this->m_staleMirrorLimit) {
+                this->m_staleMirrors[this->m_staleMirrorCount++] = fatSector;
+                return NO_ERROR;
+            } else
+                return this->m_driver->write_data_block(this->m_fatStart + this->m_fatSize + fatSector, buf);
+        }
+
+        /**
+         * @brief   Copy every FAT sector whose mirror update was deferred from the primary FAT to the mirror
+         *
+         * Sectors that are no longer cached are read back from the primary FAT into the FAT buffer, which is then
+         * reloaded with the current FAT sector.
+         *
+         * @pre     The FAT must have been flushed
+         *
+         * @return  0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode sync_fat_mirrors () {
+            PropWare::ErrorCode err;
+            bool                borrowed = false;
+
+            for (uint8_t i = 0; i < this->m_staleMirrorCount; ++i) {
+                const uint32_t fatSector = this->m_staleMirrors[i];
+                const uint8_t  *buf      = NULL;
+
+                if (fatSector == this->m_curFatSector)
+                    buf = this->m_fat;
+                for (size_t j = 0; NULL == buf && j < this->m_fatCacheSize; ++j)
+                    if (this->m_fatCache[j].valid && fatSector == this->m_fatCache[j].fatSector)
+                        buf = this->m_fatCache[j].buf;
+
+                // The FAT buffer can not be trusted once it has been borrowed for another sector
+                if (NULL == buf || (borrowed && this->m_fat == buf)) {
+                    check_errors(this->m_driver->read_data_block(this->m_fatStart + fatSector, this->m_fat));
+                    buf      = this->m_fat;
+                    borrowed = true;
+                }
+                check_errors(this->m_driver->write_data_block(this->m_fatStart + this->m_fatSize + fatSector, buf));
+            }
+            this->m_staleMirrorCount = 0;
+
+            if (borrowed && NO_FAT_SECTOR != this->m_curFatSector)
+                check_errors(this->m_driver->read_data_block(this->m_fatStart + this->m_curFatSector, this->m_fat));
+            return NO_ERROR;
+        }
+
+        /**
+         * @brief   First cluster that may be handed out by the allocator
+         */
+        uint32_t first_allocatable_cluster () const {
+            // In FAT32, the first 7 usable clusters seem to be un-officially reserved for the root directory. 9 comes
+            // from the 7 un-officially reserved + 2 for the standard reservation. exFAT has no such custom
+            return FAT_32 == this->m_filesystem ? 9 : 2;
+        }
+
+        /**
+         * @brief   Last cluster on the volume - the final FAT sector may hold entries beyond this one
+         */
+        uint32_t last_allocatable_cluster () const {
+            return this->m_initFatInfo.clusterCount + 1;
+        }
+
+        /**
+         * @brief   Derive the allocation unit geometry, in clusters, from PropWare::FatFS::m_auSize
+         */
+        void compute_allocation_unit_layout () {
+            const uint32_t auSectors      = this->m_auSize >> this->m_driver->get_sector_size_shift();
+            const uint32_t clusterSectors = (uint32_t) 1 << this->m_tier1sPerTier2Shift;
+
+            if (auSectors & (auSectors - 1) || auSectors < (clusterSectors << 1)) {
+                this->m_auClusters = 0;
+            } else {
+                // Cluster 2 begins at m_firstDataAddr; find the first cluster that begins on (or, for a misaligned
+                // data region, just after) an allocation unit boundary
+                const uint32_t gap = (auSectors - (this->m_firstDataAddr & (auSectors - 1))) & (auSectors - 1);
+                this->m_auClusters = auSectors >> this->m_tier1sPerTier2Shift;
+                this->m_auPhase    = (2 + (gap + clusterSectors - 1) / clusterSectors) & (this->m_auClusters - 1);
+            }
+        }
+
+        /**
+         * @brief   First cluster of an allocation unit at or after `cluster` (only valid with the policy enabled)
+         */
+        uint32_t next_allocation_unit_start (const uint32_t cluster) const {
+            return cluster + ((this->m_auPhase - cluster) & (this->m_auClusters - 1));
+        }
+
+        bool fat_sector_may_have_free (const uint32_t fatSector) const {
+            if (fatSector < this->m_freeSummaryBits)
+                return (bool) (this->m_freeSummary[fatSector >> 3] & (1 << (fatSector & 7)));
+            else
+                return true;
+        }
+
+        void mark_fat_sector (const uint32_t fatSector, const bool mayHaveFree) {
+            if (fatSector < this->m_freeSummaryBits) {
+                if (mayHaveFree)
+                    this->m_freeSummary[fatSector >> 3] |= (1 << (fatSector & 7));
+                else
+                    this->m_freeSummary[fatSector >> 3] &= ~(1 << (fatSector & 7));
+            }
+        }
+
+        /**
+         * @brief   Assume every FAT sector may have free entries; sectors are marked full as they are scanned
+         */
+        void reset_free_space_summary () {
+            if (NULL != this->m_freeSummary)
+                memset(this->m_freeSummary, 0xff, this->m_freeSummaryBits >> 3);
+        }
+
+        /**
+         * @brief       Compute the directory index hash for a short (8.3) file name
+         *
+         * @param[in]   filename[]  Null-terminated name, as produced by FatFile::get_filename
+         *
+         * @return      16-bit FNV-1a hash, never 0
+         */
+        static uint16_t hash_filename (const char filename[]) {
+            uint32_t hash = 2166136261U;
+            while (*filename) {
+                hash ^= (uint8_t) *filename++;
+                hash *= 16777619U;
+            }
+            hash = (hash >> 16) ^ (hash & WORD_0);
+            return (uint16_t) (hash ? hash : 1);
+        }
+
+        /**
+         * @brief   Determine whether the directory index is complete for the current working directory
+         */
+        bool directory_index_ready () const {
+            return this->m_dirIndexValid && this->m_dirIndexCluster == this->m_dir_firstCluster;
+        }
+
+        /**
+         * @brief   Determine whether the current working directory was found to hold more entries than the directory
+         *          index has room for
+         */
+        bool directory_index_overflowed () const {
+            return this->m_dirIndexOverflowCluster == this->m_dir_firstCluster;
+        }
+
+        /**
+         * @brief   Clear the directory index in preparation for a scan of the current working directory
+         */
+        void begin_directory_index () {
+            memset(this->m_dirIndex, 0, this->m_dirIndexCapacity * sizeof(this->m_dirIndex[0]));
+            this->m_dirIndexValid    = true;
+            this->m_dirIndexEndKnown = false;
+            this->m_dirIndexCluster  = this->m_dir_firstCluster;
+        }
+
+        /**
+         * @brief       Record the location of an entry of the current working directory
+         *
+         * If the index is full, it is marked incomplete and the directory is remembered as too large, so that searches
+         * scan it instead of rebuilding the index every time
+         *
+         * @param[in]   hash        Hash of the entry's name (see FatFS::hash_filename)
+         * @param[in]   location    Where the entry can be found; the `hash` field is ignored
+         */
+        void index_directory_entry (const uint16_t hash, const DirectoryIndexEntry &location) {
+            if (!this->m_dirIndexValid)
+                return;
+
+            for (size_t i = 0; i < this->m_dirIndexCapacity; ++i) {
+                DirectoryIndexEntry *slot = &this->m_dirIndex[(hash + i) % this->m_dirIndexCapacity];
+                if (!slot->hash) {
+                    *slot = location;
+                    slot->hash = hash;
+                    return;
+                }
+            }
+
+            this->m_dirIndexValid           = false;
+            this->m_dirIndexOverflowCluster = this->m_dirIndexCluster;
+        }
+
+        /**
+         * @brief       Record an entry that was just created in the directory's first free slot
+         *
+         * @param[in]   hash        Hash of the entry's name (see FatFS::hash_filename)
+         * @param[in]   location    Where the entry was created; the `hash` field is ignored
+         */
+        void index_new_directory_entry (const uint16_t hash, const DirectoryIndexEntry &location) {
+            DirectoryIndexEntry *end = &this->m_dirIndexEnd;
+
+            if (!this->directory_index_ready())
+                return;
+            else if (!this->m_dirIndexEndKnown || location.tier2 != end->tier2
+                    || location.tier1Offset != end->tier1Offset || location.entryOffset != end->entryOffset) {
+                // Not where the index expected - better to start over
+                this->invalidate_directory_index();
+                return;
+            }
+
+            this->index_directory_entry(hash, location);
+
+            // The following (32-byte) slot is free too, unless it is in another sector
+            end->entryOffset += 32;
+            if (this->m_sectorSize <= end->entryOffset)
+                this->m_dirIndexEndKnown = false;
+        }
+
+        /**
+         * @brief       Forget the entry at `location`, if it is in the index
+         *
+         * @param[in]   hash        Hash of the entry's name (see FatFS::hash_filename)
+         * @param[in]   location    Where the entry was found; the `hash` field is ignored
+         */
+        void unindex_directory_entry (const uint16_t hash, const DirectoryIndexEntry &location) {
+            for (size_t i = 0; this->m_dirIndexValid && i < this->m_dirIndexCapacity; ++i) {
+                DirectoryIndexEntry *slot = &this->m_dirIndex[(hash + i) % this->m_dirIndexCapacity];
+                if (!slot->hash)
+                    return;
+                else if (hash == slot->hash && location.tier2 == slot->tier2
+                        && location.tier1Offset == slot->tier1Offset && location.entryOffset == slot->entryOffset) {
+                    // Leave the hash in place so that probing continues past this slot
+                    slot->entryOffset = DELETED_INDEX_ENTRY;
+                    return;
+                }
+            }
+        }
+
+        /**
+         * @brief   First cluster of the root directory, as stored in `m_dir_firstCluster`
+         */
+        uint32_t root_directory () const {
+            return FAT_16 == this->m_filesystem ? (uint32_t) -1 : this->m_rootCluster;
+        }
+
+        /**
+         * @brief   Determine whether `cluster` stands for the root directory of a FAT16 volume, which lives outside of
+         *          the data region
+         */
+        bool is_fat16_root (const uint32_t cluster) const {
+            return FAT_16 == this->m_filesystem && (uint32_t) -1 == cluster;
+        }
+
+        /**
+         * @brief       Convert one component of a path to the name stored in a directory entry
+         *
+         * @param[in]   name[]          Component of a path (not null-terminated)
+         * @param[in]   length          Number of characters in `name`
+         * @param[out]  shortName[]     Eight characters of name and three of extension, upper case and padded with
+         *                              spaces
+         *
+         * @return      True if `name` is a valid short (8.3) name, "." or ".."
+         */
+        static bool to_short_name (const char name[], const size_t length, uint8_t shortName[]) {
+            size_t  i = 0;
+            uint8_t j = 0;
+
+            memset(shortName, ' ', SHORT_NAME_LENGTH);
+            if ((1 == length || 2 == length) && '.' == name[0] && '.' == name[length - 1]) {
+                memset(shortName, '.', length);
+                return true;
+            }
+
+            for (; i < length && '.' != name[i]; ++i) {
+                if (SHORT_NAME_BASE_LENGTH == j)
+                    return false;
+                shortName[j++] = (uint8_t) to_upper(name[i]);
+            }
+            if (!j)
+                return false;
+
+            if (i < length) {
+                // Skip the period
+                for (++i, j = SHORT_NAME_BASE_LENGTH; i < length; ++i) {
+                    if (SHORT_NAME_LENGTH == j || '.' == name[i])
+                        return false;
+                    shortName[j++] = (uint8_t) to_upper(name[i]);
+                }
+            }
+            return true;
+        }
+
+        static char to_upper (const char c) {
+            return 'a' <= c && c <= 'z' ? (char) (c - 'a' + 'A') : c;
+        }
+
+        /**
+         * @brief       Find the directory named by a path
+         *
+         * @param[in]   path[]      Directory names separated by '/' (see PropWare::FatFS::chdir); need not be
+         *                          null-terminated
+         * @param[in]   length      Number of characters of `path` to use
+         * @param[in]   *buffer     Buffer used to read directory sectors
+         * @param[out]  *cluster    First cluster of the directory
+         *
+         * @return      0 upon success, error code otherwise
          */
-        PropWare::ErrorCode extend_fat (BlockStorage::MetaData *bufferMetadata) {
+        PropWare::ErrorCode resolve_directory (const char path[], const size_t length, BlockStorage::Buffer *buffer,
+                                               uint32_t *cluster) {
             PropWare::ErrorCode err;
-            uint32_t            newAllocUnit;
+            uint32_t            current = this->m_dir_firstCluster;
 
-            // Do we need to load a different sector of the FAT or is the correct one currently loaded? (Correct means
-            // the sector currently containing the EOC marker)
-            if ((bufferMetadata->curTier2 >> this->m_entriesPerFatSector_Shift) != this->m_curFatSector) {
-                this->flush_fat();
-                this->m_curFatSector = bufferMetadata->curTier2 >> this->m_entriesPerFatSector_Shift;
-                check_errors(this->m_driver->read_data_block(this->m_curFatSector + this->m_fatStart, this->m_fat));
+            if (length && '/' == path[0])
+                current = this->root_directory();
+
+            for (size_t i = 0; i < length; ++i) {
+                size_t end = i;
+                while (end < length && '/' != path[end])
+                    ++end;
+
+                // Empty names (as in "a//b" or a trailing '/') and "." do not move anywhere
+                if (end > i && !(1 == end - i && '.' == path[i])) {
+                    check_errors(this->find_subdirectory(current, &path[i], end - i, buffer, &current));
+                }
+                i = end;
             }
 
-            // This function should only be called when a file or directory has
-            // reached the end of its cluster chain
-            const uint16_t entriesPerFatSector = (uint16_t) (1 << this->m_entriesPerFatSector_Shift);
-            const uint16_t allocUnitOffset     = (uint16_t) (bufferMetadata->curTier2 % entriesPerFatSector);
-            const uint16_t fatPointerAddress   = allocUnitOffset * this->m_filesystem;
-            const uint32_t nextSector          = this->m_driver->get_long(fatPointerAddress, this->m_fat);
-            if (!this->is_eoc(nextSector))
-                return INVALID_FAT_APPEND;
+            *cluster = current;
+            return NO_ERROR;
+        }
 
-            // Find where the next cluster of the file should be stored...
-            newAllocUnit = this->find_empty_space(1);
+        /**
+         * @brief       Find a directory within another, checking the path cache first
+         *
+         * @param[in]   parent      First cluster of the directory to search
+         * @param[in]   name[]      Name of the directory to find (not null-terminated)
+         * @param[in]   length      Number of characters in `name`
+         * @param[in]   *buffer     Buffer used to read directory sectors
+         * @param[out]  *cluster    First cluster of the directory that was found
+         *
+         * @return      0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode find_subdirectory (const uint32_t parent, const char name[], const size_t length,
+                                               BlockStorage::Buffer *buffer, uint32_t *cluster) {
+            PropWare::ErrorCode err;
+            uint8_t             shortName[SHORT_NAME_LENGTH];
+            uint16_t            entryOffset;
+
+            if (EX_FAT == this->m_filesystem)
+                return this->find_exfat_subdirectory(parent, name, length, buffer, cluster);
+            else if (!to_short_name(name, length, shortName))
+                return INVALID_PATH;
+            else if (this->find_cached_path(parent, shortName, cluster))
+                return NO_ERROR;
+            else if ('.' == shortName[0] && parent == this->root_directory()) {
+                // The root directory has no "." or ".." entries - it is its own parent
+                *cluster = parent;
+                return NO_ERROR;
+            }
 
-            // Now that we know the allocation unit, write it to the FAT buffer
-            const uint16_t sectorOffset = (uint16_t) ((bufferMetadata->curTier2 %
-                    (1 << this->m_entriesPerFatSector_Shift)) * this->m_filesystem);
-            if (FAT_16 == this->m_filesystem)
-                this->m_driver->write_short(sectorOffset, this->m_fat, (uint16_t) newAllocUnit);
-            else
-                this->m_driver->write_long(sectorOffset, this->m_fat, newAllocUnit);
-            bufferMetadata->nextTier2 = newAllocUnit;
-            this->m_fatMod            = true;  // And mark the buffer as modified
+            err = this->find_directory_entry(buffer, parent, shortName, &entryOffset);
+            if (EOC_END == err)
+                return PATH_NOT_FOUND;
+            else if (err)
+                return err;
+
+            const uint8_t *entry = &buffer->buf[entryOffset];
+            if (!(SUB_DIR_ATTRIBUTE & entry[DIR_ATTRIBUTE_OFFSET]))
+                return NOT_A_DIRECTORY;
+            *cluster = this->m_driver->get_short(DIR_CLUSTER_LOW, entry);
+            if (FAT_32 == this->m_filesystem)
+                *cluster |= ((uint32_t) this->m_driver->get_short(DIR_CLUSTER_HIGH, entry) << 16) & EOC_MASK;
+            // A ".." entry pointing at the root directory holds cluster 0
+            if (!*cluster)
+                *cluster = this->root_directory();
+
+            this->cache_path(parent, shortName, *cluster);
+            return NO_ERROR;
+        }
 
-            return 0;
+        /**
+         * @brief       Search a directory for an entry, one sector at a time
+         *
+         * The buffer is left holding the sector with the entry (described by `m_dirMeta`)
+         *
+         * @param[in]   *buffer         Buffer used to read directory sectors
+         * @param[in]   directory       First cluster of the directory to search
+         * @param[in]   shortName[]     Name of the entry, as produced by PropWare::FatFS::to_short_name
+         * @param[out]  *entryOffset    Offset of the entry within the buffer - or of the directory's first free entry,
+         *                              if it was not found
+         *
+         * @return      0 if the entry was found, PropWare::FatFS::PATH_NOT_FOUND if the directory's first free entry
+         *              was found instead, PropWare::FatFS::EOC_END if the directory has no free entries left, or
+         *              another error code
+         */
+        PropWare::ErrorCode find_directory_entry (BlockStorage::Buffer *buffer, const uint32_t directory,
+                                                  const uint8_t shortName[], uint16_t *entryOffset) {
+            PropWare::ErrorCode err;
+            uint16_t            offset = 0;
+
+            check_errors(this->load_directory_start(buffer, directory));
+            while (buffer->buf[offset]) {
+                const uint8_t *entry = &buffer->buf[offset];
+                if (DELETED_ENTRY_MARK != entry[0] && !(VOLUME_ID_ATTRIBUTE & entry[DIR_ATTRIBUTE_OFFSET])
+                        && !memcmp(entry, shortName, SHORT_NAME_LENGTH)) {
+                    *entryOffset = offset;
+                    return NO_ERROR;
+                }
+
+                offset += DIR_ENTRY_LENGTH;
+                if (this->m_sectorSize == offset) {
+                    offset = 0;
+                    check_errors(this->load_next_directory_sector(buffer));
+                }
+            }
+
+            *entryOffset = offset;
+            return PATH_NOT_FOUND;
         }
 
         /**
-         * @brief       Find the first empty allocation unit in the FAT
+         * @brief       Load the first sector of a directory into the buffer (described by `m_dirMeta`), unless it is
+         *              already there
          *
-         * The value of the first empty allocation unit is returned and its location will contain the end-of-chain
-         * marker, SD_EOC_END.
+         * @param[in]   *buffer     Buffer used to read directory sectors
+         * @param[in]   directory   First cluster of the directory
          *
-         * NOTE: It is important to realize that, though the new entry now contains an EOC marker, this function
-         * does not know what cluster is being extended and therefore the calling function must modify the previous
-         * EOC to contain the return value
+         * @return      0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode load_directory_start (BlockStorage::Buffer *buffer, const uint32_t directory) {
+            PropWare::ErrorCode    err;
+            BlockStorage::MetaData *dirMeta = &this->m_dirMeta;
+
+            if (buffer->meta != dirMeta || directory != dirMeta->curTier2 || dirMeta->curTier1Offset) {
+                check_errors(this->m_driver->flush(buffer));
+                dirMeta->curTier2       = directory;
+                dirMeta->curTier1Offset = 0;
+                if (this->is_fat16_root(directory))
+                    dirMeta->curTier2Addr = this->m_rootAddr;
+                else {
+                    dirMeta->curTier2Addr = this->compute_tier1_from_tier2(directory);
+                    check_errors(this->get_fat_value(directory, &dirMeta->nextTier2));
+                }
+                buffer->meta = dirMeta;
+                check_errors(this->m_driver->reload_buffer(buffer));
+            }
+            return NO_ERROR;
+        }
+
+        /**
+         * @brief       Move the buffer on to the next sector of the directory described by `buffer->meta`
          *
-         * @param[in]   restore     If non-zero, the original fat-sector will be restored to m_fat before returning;
-         *                          if zero, the last-used sector will remain loaded
+         * @return      0 upon success, PropWare::FatFS::EOC_END (leaving the buffer on the directory's final sector)
+         *              if there are no more sectors, error code otherwise
+         */
+        PropWare::ErrorCode load_next_directory_sector (BlockStorage::Buffer *buffer) {
+            PropWare::ErrorCode    err;
+            BlockStorage::MetaData *dirMeta = buffer->meta;
+
+            if (this->is_fat16_root(dirMeta->curTier2)) {
+                if (this->m_rootDirSectors <= dirMeta->curTier1Offset + 1)
+                    return EOC_END;
+                check_errors(this->m_driver->flush(buffer));
+                ++dirMeta->curTier1Offset;
+            } else if ((1U << this->m_tier1sPerTier2Shift) == dirMeta->curTier1Offset + 1) {
+                if (this->is_eoc(dirMeta->nextTier2))
+                    return EOC_END;
+                check_errors(this->m_driver->flush(buffer));
+                dirMeta->curTier2       = dirMeta->nextTier2;
+                dirMeta->curTier2Addr   = this->compute_tier1_from_tier2(dirMeta->curTier2);
+                dirMeta->curTier1Offset = 0;
+                check_errors(this->get_fat_value(dirMeta->curTier2, &dirMeta->nextTier2));
+            } else {
+                check_errors(this->m_driver->flush(buffer));
+                ++dirMeta->curTier1Offset;
+            }
+
+            return this->m_driver->reload_buffer(buffer);
+        }
+
+        /**
+         * @brief       Store the first cluster of a file or directory in its directory entry
+         */
+        void write_entry_cluster (uint8_t entry[], const uint32_t cluster) const {
+            this->m_driver->write_short(DIR_CLUSTER_LOW, entry, (uint16_t) cluster);
+            if (FAT_32 == this->m_filesystem)
+                this->m_driver->write_short(DIR_CLUSTER_HIGH, entry, (uint16_t) (cluster >> 16));
+        }
+
+        /**
+         * @brief       Fill a newly allocated cluster with an empty directory: "." and ".." (FAT16/32 only) followed by
+         *              free entries
+         *
+         * The buffer is left holding the directory's first sector
          *
-         * @return      Returns the number of the first unused allocation unit
+         * @param[in]   *buffer     Buffer to build the sectors in
+         * @param[in]   cluster     The new directory's (only) cluster
+         * @param[in]   parent      First cluster of the directory containing the new one
+         *
+         * @return      0 upon success, error code otherwise
          */
-        uint32_t find_empty_space (const uint8_t restore) {
-            uint16_t allocOffset   = 0;
-            uint32_t fatSectorAddr = this->m_curFatSector + this->m_fatStart;
-            uint32_t retVal;
-            // NOTE: this->m_curFatSector is not modified until end of function - it is used throughout this function as
-            // the original starting point
+        PropWare::ErrorCode write_empty_directory (BlockStorage::Buffer *buffer, const uint32_t cluster,
+                                                   const uint32_t parent) {
+            PropWare::ErrorCode    err;
+            BlockStorage::MetaData *dirMeta = &this->m_dirMeta;
+
+            check_errors(this->m_driver->flush(buffer));
+            dirMeta->curTier2       = cluster;
+            dirMeta->curTier2Addr   = this->compute_tier1_from_tier2(cluster);
+            dirMeta->curTier1Offset = 0;
+            dirMeta->nextTier2      = (uint32_t) EOC_END;
+            buffer->meta            = dirMeta;
+
+            memset(buffer->buf, 0, this->m_sectorSize);
+            for (uint32_t i = 1; i < ((uint32_t) 1 << this->m_tier1sPerTier2Shift); ++i)
+                check_errors(this->m_driver->write_data_block(dirMeta->curTier2Addr + i, buffer->buf));
+
+            // exFAT directories hold neither "." nor ".."
+            if (EX_FAT == this->m_filesystem) {
+                dirMeta->mod = true;
+                return this->m_driver->flush(buffer);
+            }
 
-            // Find the first empty allocation unit and write the EOC marker
-            if (FAT_16 == this->m_filesystem) {
-                // Loop until we find an empty cluster
-                while (this->m_driver->get_short(allocOffset, this->m_fat)) {
-                    // Stop when we either reach the end of the current block or find an empty cluster
-                    while (this->m_driver->get_short(allocOffset, this->m_fat) && (this->m_sectorSize > allocOffset))
-                        allocOffset += FAT_16;
-                    // If we reached the end of a sector...
-                    if (this->m_sectorSize <= allocOffset) {
-                        // Read the next fat sector
-                        this->flush_fat();
-                        this->m_driver->read_data_block(++fatSectorAddr, this->m_fat);
-                    }
+            uint8_t *dot = buffer->buf;
+            memset(dot, ' ', SHORT_NAME_LENGTH);
+            dot[0]                    = '.';
+            dot[DIR_ATTRIBUTE_OFFSET] = SUB_DIR_ATTRIBUTE;
+            this->write_entry_cluster(dot, cluster);
+
+            uint8_t *dotDot = &buffer->buf[DIR_ENTRY_LENGTH];
+            memcpy(dotDot, dot, DIR_ENTRY_LENGTH);
+            dotDot[1] = '.';
+            // The root directory is always referred to as cluster 0
+            this->write_entry_cluster(dotDot, parent == this->root_directory() ? 0 : parent);
+
+            dirMeta->mod = true;
+            return this->m_driver->flush(buffer);
+        }
+
+        /**
+         * @brief       Find a directory within an exFAT directory
+         *
+         * @see         PropWare::FatFS::find_subdirectory
+         */
+        PropWare::ErrorCode find_exfat_subdirectory (const uint32_t parent, const char name[], const size_t length,
+                                                     BlockStorage::Buffer *buffer, uint32_t *cluster) {
+            PropWare::ErrorCode err;
+            uint8_t             set[EXFAT_MAX_SET_ENTRIES * DIR_ENTRY_LENGTH];
+            uint8_t             entries;
+            uint16_t            entryOffset;
+
+            if (2 == length && '.' == name[0] && '.' == name[1]) {
+                // exFAT directories have no ".." entry, and finding the parent any other way would mean searching the
+                // whole volume. Only the root directory's parent - itself - is known
+                if (parent != this->m_rootCluster)
+                    return INVALID_PATH;
+                *cluster = parent;
+                return NO_ERROR;
+            } else if (!is_exfat_name(name, length))
+                return INVALID_PATH;
+
+            err = this->find_entry_set(buffer, parent, name, (uint8_t) length, &entryOffset);
+            if (EOC_END == err)
+                return PATH_NOT_FOUND;
+            else if (err)
+                return err;
+
+            check_errors(this->read_entry_set(buffer, entryOffset, set, &entries));
+            if (!(SUB_DIR_ATTRIBUTE & set[EXFAT_FILE_ATTRIBUTES]))
+                return NOT_A_DIRECTORY;
+            uint8_t *stream = &set[DIR_ENTRY_LENGTH];
+            *cluster = this->m_driver->get_long(EXFAT_FIRST_CLUSTER, stream);
+            if (*cluster < this->first_allocatable_cluster() || this->last_allocatable_cluster() < *cluster)
+                return UNSUPPORTED_ENTRY_SET;
+
+            // Directories are always read by following the FAT, so one that was written without a FAT chain gets one
+            if (EXFAT_NO_FAT_CHAIN & stream[EXFAT_FLAGS]) {
+                check_errors(this->link_run(*cluster, this->clusters_for_length(stream)));
+                stream[EXFAT_FLAGS] &= ~EXFAT_NO_FAT_CHAIN;
+                check_errors(this->write_entry_set(buffer, entryOffset, set, entries));
+            }
+
+            // The directory has no ".." entry to find its parent by, so remember where its size is kept in case it
+            // needs to grow
+            this->m_exfatLastDirEntry.cluster  = *cluster;
+            this->m_exfatLastDirEntry.location = *buffer->meta;
+            this->m_exfatLastDirEntry.offset   = entryOffset;
+            return NO_ERROR;
+        }
+
+        /**
+         * @brief       Create a directory within an exFAT directory
+         *
+         * The new directory is given a FAT chain, so that it can be searched like any other directory. Unlike
+         * FAT16/32, it holds no "." or ".." entries
+         *
+         * @see         PropWare::FatFS::mkdir
+         */
+        PropWare::ErrorCode make_exfat_directory (BlockStorage::Buffer *buffer, const uint32_t parent,
+                                                  const char name[], const uint8_t length) {
+            PropWare::ErrorCode err;
+            uint8_t             set[EXFAT_MAX_SET_ENTRIES * DIR_ENTRY_LENGTH];
+            uint32_t            cluster;
+            uint16_t            entryOffset;
+
+            err = this->find_entry_set(buffer, parent, name, length, &entryOffset);
+            if (NO_ERROR == err)
+                return ENTRY_EXISTS;
+            else if (EOC_END == err) {
+                check_errors(this->extend_directory(parent, buffer));
+                entryOffset = 0;
+            } else if (PATH_NOT_FOUND != err)
+                return err;
+
+            // Like PropWare::FatFS::mkdir, leave erase block starts for files
+            check_errors(this->find_empty_space(0, &cluster));
+            check_errors(this->set_fat_value(cluster, (uint32_t) EOC_END));
+
+            const uint32_t clusterBytes = (uint32_t) 1 << (this->m_driver->get_sector_size_shift()
+                    + this->m_tier1sPerTier2Shift);
+            const uint8_t  entries      = this->build_entry_set(set, name, length, SUB_DIR_ATTRIBUTE,
+                                                                EXFAT_ALLOC_POSSIBLE, cluster, clusterBytes);
+            check_errors(this->create_entry_set(buffer, parent, set, entries, &entryOffset));
+            check_errors(this->m_driver->flush(buffer));
+
+            return this->write_empty_directory(buffer, cluster, parent);
+        }
+
+        /**
+         * @brief       Determine whether a name can be stored in an exFAT directory by this driver
+         *
+         * @param[in]   name[]      Component of a path (not null-terminated)
+         * @param[in]   length      Number of characters in `name`
+         *
+         * @return      True if `name` is short enough and made only of printable ASCII characters which exFAT allows
+         */
+        static bool is_exfat_name (const char name[], const size_t length) {
+            if (!length || EXFAT_MAX_NAME_LENGTH < length)
+                return false;
+            else if ('.' == name[0] && (1 == length || (2 == length && '.' == name[1])))
+                return false;
+
+            for (size_t i = 0; i < length; ++i) {
+                const char c = name[i];
+                if (' ' > c || '~' < c || strchr("\"*/:<>?\\|", c))
+                    return false;
+            }
+            return true;
+        }
+
+        /**
+         * @brief       Compute the hash of a name stored in an exFAT stream extension entry
+         *
+         * The hash covers the up-cased name as UTF-16, whose high bytes are always 0 for the ASCII names supported
+         * here
+         */
+        static uint16_t exfat_name_hash (const char name[], const size_t length) {
+            uint16_t hash = 0;
+            for (size_t i = 0; i < length; ++i) {
+                hash = (uint16_t) (((hash & 1) ? 0x8000 : 0) + (hash >> 1) + (uint8_t) to_upper(name[i]));
+                hash = (uint16_t) (((hash & 1) ? 0x8000 : 0) + (hash >> 1));
+            }
+            return hash;
+        }
+
+        /**
+         * @brief       Compute the checksum of an exFAT entry set, which covers every byte but the checksum itself
+         *
+         * @param[in]   set[]       Entry set, beginning with the File entry
+         * @param[in]   entries     Number of entries in the set
+         */
+        static uint16_t exfat_set_checksum (const uint8_t set[], const uint8_t entries) {
+            uint16_t checksum = 0;
+            for (uint16_t i = 0; i < entries * DIR_ENTRY_LENGTH; ++i)
+                if (EXFAT_SET_CHECKSUM != i && EXFAT_SET_CHECKSUM + 1 != i)
+                    checksum = (uint16_t) (((checksum & 1) ? 0x8000 : 0) + (checksum >> 1) + set[i]);
+            return checksum;
+        }
+
+        /**
+         * @brief       Build the entry set of a new file or directory: a File entry, a stream extension entry and as
+         *              many name entries as the name needs
+         *
+         * Timestamps are set to 2000-01-01, as no clock is available. The checksum is filled in when the set is written
+         *
+         * @param[out]  set[]           Room for PropWare::FatFS::EXFAT_MAX_SET_ENTRIES entries
+         * @param[in]   name[]          Name, as accepted by PropWare::FatFS::is_exfat_name
+         * @param[in]   length          Number of characters in `name`
+         * @param[in]   attributes      File attributes, such as PropWare::FatFS::SUB_DIR_ATTRIBUTE
+         * @param[in]   flags           Stream extension flags
+         * @param[in]   firstCluster    First cluster, or 0 if nothing is allocated
+         * @param[in]   dataLength      Length, in bytes
+         *
+         * @return      Number of entries in the set
+         */
+        uint8_t build_entry_set (uint8_t set[], const char name[], const uint8_t length, const uint8_t attributes,
+                                 const uint8_t flags, const uint32_t firstCluster, const uint32_t dataLength) const {
+            const uint8_t entries = (uint8_t) (2 + (length + EXFAT_NAME_CHARACTERS - 1) / EXFAT_NAME_CHARACTERS);
+            memset(set, 0, entries * DIR_ENTRY_LENGTH);
+
+            uint8_t *file = set;
+            file[0]                     = EXFAT_FILE_ENTRY;
+            file[EXFAT_SECONDARY_COUNT] = (uint8_t) (entries - 1);
+            file[EXFAT_FILE_ATTRIBUTES] = attributes;
+            for (uint8_t i = 0; i < 3; ++i)
+                this->m_driver->write_long(EXFAT_TIMESTAMPS + (i << 2), file, EXFAT_DEFAULT_TIMESTAMP);
+
+            uint8_t *stream = &set[DIR_ENTRY_LENGTH];
+            stream[0]                 = EXFAT_STREAM_ENTRY;
+            stream[EXFAT_FLAGS]       = flags;
+            stream[EXFAT_NAME_LENGTH] = length;
+            this->m_driver->write_short(EXFAT_NAME_HASH, stream, exfat_name_hash(name, length));
+            this->m_driver->write_long(EXFAT_VALID_DATA_LENGTH, stream, dataLength);
+            this->m_driver->write_long(EXFAT_FIRST_CLUSTER, stream, firstCluster);
+            this->m_driver->write_long(EXFAT_DATA_LENGTH, stream, dataLength);
+
+            for (uint8_t i = 0; i < length; ++i) {
+                uint8_t *nameEntry = &set[(2 + i / EXFAT_NAME_CHARACTERS) * DIR_ENTRY_LENGTH];
+                nameEntry[0] = EXFAT_NAME_ENTRY;
+                this->m_driver->write_short(EXFAT_NAME + ((i % EXFAT_NAME_CHARACTERS) << 1), nameEntry,
+                                            (uint8_t) name[i]);
+            }
+
+            return entries;
+        }
+
+        /**
+         * @brief       Number of clusters allocated to a file or directory, according to its stream extension entry
+         */
+        uint32_t clusters_for_length (const uint8_t stream[]) const {
+            const uint8_t  clusterShift = this->m_driver->get_sector_size_shift() + this->m_tier1sPerTier2Shift;
+            const uint32_t dataLength   = this->m_driver->get_long(EXFAT_DATA_LENGTH, stream);
+            const uint64_t roundedUp    = (uint64_t) dataLength + (1 << clusterShift) - 1;
+            const uint32_t clusters     = (uint32_t) (roundedUp >> clusterShift);
+            return clusters ? clusters : 1;
+        }
+
+        /**
+         * @brief       Read the next entry set of an exFAT directory, skipping everything that is not a file or
+         *              directory
+         *
+         * @param[in]       *buffer     Buffer holding a sector of the directory (described by `buffer->meta`)
+         * @param[in,out]   *offset     Where to start reading, within the buffer; just past the set upon return, or the
+         *                              end of the directory if no more sets were found
+         * @param[out]      *entry      The set that was found. Characters of the name beyond ASCII are replaced with
+         *                              '?'
+         *
+         * @return      0 if a set was found, PropWare::FatFS::PATH_NOT_FOUND at the end of the directory's entries,
+         *              PropWare::FatFS::EOC_END if the directory has no more sectors, or another error code
+         */
+        PropWare::ErrorCode next_entry_set (BlockStorage::Buffer *buffer, uint16_t *offset, ExFatEntry *entry) {
+            PropWare::ErrorCode err;
+            uint8_t             secondary = 0;  // Index of the next entry within the set; 0 while between sets
+            uint8_t             nameRead  = 0;
+
+            while (true) {
+                if (this->m_sectorSize == *offset) {
+                    check_errors(this->load_next_directory_sector(buffer));
+                    *offset = 0;
                 }
-                this->m_driver->write_short(allocOffset, this->m_fat, (uint16_t) EOC_END);
-                this->m_fatMod = true;
-            } else /* Implied: "if (FAT_32 == this->m_filesystem)" */{
-                // In FAT32, the first 7 usable clusters seem to be un-officially reserved for the root directory
-                if (0 == this->m_curFatSector)
-                    // 9 comes from the 7 un-officially reserved + 2 for the standard reservation
-                    allocOffset = (uint16_t) (9 * FAT_32);
-
-                // Loop until we find an empty cluster
-                while (this->m_driver->get_long(allocOffset, this->m_fat) & EOC_MASK) {
-                    // Stop when we either reach the end of the current block or find an empty cluster
-                    while ((this->m_driver->get_long(allocOffset, this->m_fat) & EOC_MASK)
-                            && (this->m_sectorSize > allocOffset))
-                        allocOffset += FAT_32;
-
-                    // If we reached the end of a sector...
-                    if (this->m_sectorSize <= allocOffset) {
-                        // Read the next fat sector
-                        this->flush_fat();
-                        this->m_driver->read_data_block(++fatSectorAddr, this->m_fat);
-                        allocOffset = 0;
+
+                const uint8_t *dirEntry = &buffer->buf[*offset];
+                const uint8_t type      = dirEntry[0];
+                if (EXFAT_END_OF_DIRECTORY == type)
+                    return PATH_NOT_FOUND;
+                *offset += DIR_ENTRY_LENGTH;
+
+                if (!secondary) {
+                    // A file needs at least a stream extension and one name entry
+                    if (EXFAT_FILE_ENTRY == type && 2 <= dirEntry[EXFAT_SECONDARY_COUNT]) {
+                        entry->location   = *buffer->meta;
+                        entry->offset     = (uint16_t) (*offset - DIR_ENTRY_LENGTH);
+                        entry->entries    = (uint8_t) (1 + dirEntry[EXFAT_SECONDARY_COUNT]);
+                        entry->attributes = this->m_driver->get_short(EXFAT_FILE_ATTRIBUTES, dirEntry);
+                        secondary         = 1;
+                        nameRead          = 0;
+                    }
+                } else if (1 == secondary) {
+                    if (EXFAT_STREAM_ENTRY != type) {
+                        // An incomplete set; the entry may begin the next one
+                        *offset -= DIR_ENTRY_LENGTH;
+                        secondary = 0;
+                        continue;
+                    }
+                    entry->flags           = dirEntry[EXFAT_FLAGS];
+                    entry->nameLength      = dirEntry[EXFAT_NAME_LENGTH];
+                    entry->firstCluster    = this->m_driver->get_long(EXFAT_FIRST_CLUSTER, dirEntry);
+                    entry->validDataLength = this->m_driver->get_long(EXFAT_VALID_DATA_LENGTH, dirEntry)
+                            | ((uint64_t) this->m_driver->get_long(EXFAT_VALID_DATA_LENGTH + 4, dirEntry) << 32);
+                    ++secondary;
+                } else if (!(EXFAT_IN_USE & type) || EXFAT_FILE_ENTRY == type) {
+                    *offset -= DIR_ENTRY_LENGTH;
+                    secondary = 0;
+                    continue;
+                } else {
+                    if (EXFAT_NAME_ENTRY == type) {
+                        for (uint8_t i = 0; i < EXFAT_NAME_CHARACTERS && nameRead < entry->nameLength; ++i) {
+                            const uint16_t c = this->m_driver->get_short(EXFAT_NAME + (i << 1), dirEntry);
+                            if (nameRead < EXFAT_MAX_NAME_LENGTH)
+                                entry->name[nameRead] = (char) (0x80 > c ? c : '?');
+                            ++nameRead;
+                        }
+                    }
+                    if (entry->entries == ++secondary) {
+                        entry->name[nameRead < EXFAT_MAX_NAME_LENGTH ? nameRead : EXFAT_MAX_NAME_LENGTH] = '\0';
+                        return NO_ERROR;
                     }
                 }
+            }
+        }
 
-                this->m_driver->write_long(allocOffset, this->m_fat, ((uint32_t) EOC_END) & EOC_MASK);
-                this->m_fatMod = true;
+        /**
+         * @brief       Search an exFAT directory for a file or directory, ignoring case
+         *
+         * The buffer is left holding the sector with the set's File entry (described by `m_dirMeta`)
+         *
+         * @param[in]   *buffer         Buffer used to read directory sectors
+         * @param[in]   directory       First cluster of the directory to search
+         * @param[in]   name[]          Name of the entry, as accepted by PropWare::FatFS::is_exfat_name (not
+         *                              null-terminated)
+         * @param[in]   length          Number of characters in `name`
+         * @param[out]  *entryOffset    Offset of the set's File entry within the buffer - or of the end of the
+         *                              directory's entries, if it was not found
+         *
+         * @return      0 if the entry was found, PropWare::FatFS::PATH_NOT_FOUND if the end of the directory's entries
+         *              was found instead, PropWare::FatFS::EOC_END if the directory has no room left, or another error
+         *              code
+         */
+        PropWare::ErrorCode find_entry_set (BlockStorage::Buffer *buffer, const uint32_t directory, const char name[],
+                                            const uint8_t length, uint16_t *entryOffset) {
+            PropWare::ErrorCode err;
+            ExFatEntry          entry;
+            uint16_t            offset = 0;
+
+            check_errors(this->load_directory_start(buffer, directory));
+            while (true) {
+                err = this->next_entry_set(buffer, &offset, &entry);
+                if (err) {
+                    *entryOffset = offset;
+                    return err;
+                }
+
+                bool match = entry.nameLength == length;
+                for (uint8_t i = 0; match && i < length; ++i)
+                    match = to_upper(entry.name[i]) == to_upper(name[i]);
+                if (match) {
+                    check_errors(this->load_entry_location(buffer, &entry.location));
+                    *entryOffset = entry.offset;
+                    return NO_ERROR;
+                }
             }
+        }
 
-            // If we loaded a new fat sector (and then modified it directly
-            // above), write the sector before re-loading the original
-            if ((fatSectorAddr != (this->m_curFatSector + this->m_fatStart)) && this->m_fatMod) {
-                this->flush_fat();
-                this->m_driver->read_data_block(this->m_curFatSector + this->m_fatStart, this->m_fat);
-            } else
-                this->m_curFatSector = fatSectorAddr - this->m_fatStart;
+        /**
+         * @brief       Point a buffer back at a directory sector which it held earlier, reading it again if necessary
+         *
+         * @param[in]   *buffer     Buffer whose metadata describes a directory
+         * @param[in]   *location   Copy of the buffer's metadata, taken while it held the wanted sector
+         *
+         * @return      0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode load_entry_location (BlockStorage::Buffer *buffer,
+                                                 const BlockStorage::MetaData *location) {
+            PropWare::ErrorCode    err;
+            BlockStorage::MetaData *meta = buffer->meta;
+
+            if (location->curTier2 == meta->curTier2 && location->curTier1Offset == meta->curTier1Offset)
+                return NO_ERROR;
+
+            check_errors(this->m_driver->flush(buffer));
+            *meta     = *location;
+            meta->mod = false;
+            return this->m_driver->reload_buffer(buffer);
+        }
+
+        /**
+         * @brief       Copy an exFAT entry set (a File entry and its secondary entries) out of a directory
+         *
+         * @param[in]   *buffer     Buffer holding the sector with the File entry (described by `buffer->meta`). A set
+         *                          which continues into the next sector is followed, and the buffer is then restored
+         * @param[in]   offset      Offset of the File entry within the buffer
+         * @param[out]  set[]       Room for PropWare::FatFS::EXFAT_MAX_SET_ENTRIES entries
+         * @param[out]  *entries    Number of entries in the set, including the File entry
+         *
+         * @return      0 upon success, PropWare::FatFS::UNSUPPORTED_ENTRY_SET if the set is too large, error code
+         *              otherwise
+         */
+        PropWare::ErrorCode read_entry_set (BlockStorage::Buffer *buffer, const uint16_t offset, uint8_t set[],
+                                            uint8_t *entries) {
+            *entries = (uint8_t) (1 + buffer->buf[offset + EXFAT_SECONDARY_COUNT]);
+            if (EXFAT_MAX_SET_ENTRIES < *entries)
+                return UNSUPPORTED_ENTRY_SET;
+            return this->copy_entry_set(buffer, offset, set, *entries, false);
+        }
+
+        /**
+         * @brief       Write an exFAT entry set back to its directory, with a new checksum
+         *
+         * @param[in]   *buffer     Buffer holding the sector with the File entry (described by `buffer->meta`)
+         * @param[in]   offset      Offset of the File entry within the buffer
+         * @param[in]   set[]       Entry set, as read by PropWare::FatFS::read_entry_set
+         * @param[in]   entries     Number of entries in the set
+         *
+         * @return      0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode write_entry_set (BlockStorage::Buffer *buffer, const uint16_t offset, uint8_t set[],
+                                             const uint8_t entries) {
+            PropWare::ErrorCode err;
+
+            check_errors(this->mark_volume_dirty());
+            this->m_driver->write_short(EXFAT_SET_CHECKSUM, set, exfat_set_checksum(set, entries));
+            return this->copy_entry_set(buffer, offset, set, entries, true);
+        }
+
+        PropWare::ErrorCode copy_entry_set (BlockStorage::Buffer *buffer, const uint16_t offset, uint8_t set[],
+                                            const uint8_t entries, const bool toDirectory) {
+            PropWare::ErrorCode err;
+            const uint16_t      setSize = entries * DIR_ENTRY_LENGTH;
+            const uint16_t      inFirst = setSize < this->m_sectorSize - offset ? setSize
+                                                                                 : this->m_sectorSize - offset;
+
+            copy_bytes(&buffer->buf[offset], set, inFirst, toDirectory);
+            buffer->meta->mod |= toDirectory;
+
+            if (inFirst < setSize) {
+                const BlockStorage::MetaData primary = *buffer->meta;
+                err = this->load_next_directory_sector(buffer);
+                if (EOC_END == err)
+                    return UNSUPPORTED_ENTRY_SET;
+                else if (err)
+                    return err;
+                copy_bytes(buffer->buf, &set[inFirst], setSize - inFirst, toDirectory);
+                buffer->meta->mod |= toDirectory;
+                check_errors(this->load_entry_location(buffer, &primary));
+            }
+            return NO_ERROR;
+        }
+
+        static void copy_bytes (uint8_t directory[], uint8_t set[], const uint16_t length, const bool toDirectory) {
+            if (toDirectory)
+                memcpy(directory, set, length);
+            else
+                memcpy(set, directory, length);
+        }
+
+        /**
+         * @brief       Mark every entry of an exFAT entry set as unused
+         *
+         * @param[in]   *buffer     Buffer holding the sector with the File entry (described by `buffer->meta`)
+         * @param[in]   offset      Offset of the File entry within the buffer
+         *
+         * @return      0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode delete_entry_set (BlockStorage::Buffer *buffer, const uint16_t offset) {
+            PropWare::ErrorCode err;
+            uint8_t             set[EXFAT_MAX_SET_ENTRIES * DIR_ENTRY_LENGTH];
+            uint8_t             entries;
+
+            check_errors(this->read_entry_set(buffer, offset, set, &entries));
+            for (uint8_t i = 0; i < entries; ++i)
+                set[i * DIR_ENTRY_LENGTH] &= ~EXFAT_IN_USE;
+            return this->write_entry_set(buffer, offset, set, entries);
+        }
+
+        /**
+         * @brief       Add a new entry set to the end of an exFAT directory
+         *
+         * Sets are kept within a single sector: if the rest of the current sector is too small, it is filled with
+         * unused entries and the set goes at the start of the next sector - extending the directory if necessary
+         *
+         * @param[in]       *buffer         Buffer holding the directory sector with the end of its entries, as left by
+         *                                  PropWare::FatFS::find_entry_set
+         * @param[in]       directory       First cluster of the directory
+         * @param[in]       set[]           Entry set, as built by PropWare::FatFS::build_entry_set
+         * @param[in]       entries         Number of entries in the set
+         * @param[in,out]   *entryOffset    Offset of the end of the directory's entries; offset of the new set's File
+         *                                  entry upon return
+         *
+         * @return      0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode create_entry_set (BlockStorage::Buffer *buffer, const uint32_t directory, uint8_t set[],
+                                              const uint8_t entries, uint16_t *entryOffset) {
+            PropWare::ErrorCode err;
+
+            if (this->m_sectorSize - *entryOffset < entries * DIR_ENTRY_LENGTH) {
+                for (uint16_t offset = *entryOffset; offset < this->m_sectorSize; offset += DIR_ENTRY_LENGTH) {
+                    memset(&buffer->buf[offset], 0, DIR_ENTRY_LENGTH);
+                    buffer->buf[offset] = EXFAT_UNUSED_ENTRY;
+                }
+                buffer->meta->mod = true;
+
+                err = this->load_next_directory_sector(buffer);
+                if (EOC_END == err) {
+                    check_errors(this->extend_directory(directory, buffer));
+                } else if (err)
+                    return err;
+                *entryOffset = 0;
+            }
+
+            return this->write_entry_set(buffer, *entryOffset, set, entries);
+        }
+
+        /**
+         * @brief       Look up a directory in the path cache
+         *
+         * @return      True if the directory was found, in which case `*cluster` holds its first cluster
+         */
+        bool find_cached_path (const uint32_t parent, const uint8_t shortName[], uint32_t *cluster) {
+            for (size_t i = 0; i < this->m_pathCacheSize; ++i) {
+                PathCacheEntry *entry = &this->m_pathCache[i];
+                if (entry->cluster && parent == entry->parent && !memcmp(shortName, entry->name, SHORT_NAME_LENGTH)) {
+                    entry->lastUse = ++this->m_pathCacheClock;
+                    *cluster       = entry->cluster;
+                    return true;
+                }
+            }
+            return false;
+        }
 
-            // Return new address to end-of-chain
-            retVal = this->m_curFatSector << this->m_entriesPerFatSector_Shift;
-            retVal += allocOffset / this->m_filesystem;
-            return retVal;
+        /**
+         * @brief   Record a directory in the path cache, replacing the least recently used entry if it is full
+         */
+        void cache_path (const uint32_t parent, const uint8_t shortName[], const uint32_t cluster) {
+            PathCacheEntry *victim = NULL;
+
+            for (size_t i = 0; i < this->m_pathCacheSize; ++i) {
+                PathCacheEntry *entry = &this->m_pathCache[i];
+                if (!entry->cluster) {
+                    victim = entry;
+                    break;
+                } else if (NULL == victim || entry->lastUse < victim->lastUse)
+                    victim = entry;
+            }
+
+            if (NULL != victim) {
+                victim->parent  = parent;
+                victim->cluster = cluster;
+                victim->lastUse = ++this->m_pathCacheClock;
+                memcpy(victim->name, shortName, SHORT_NAME_LENGTH);
+            }
         }
 
+        /**
+         * @brief   Write the length of every writer with one pending, writing each directory sector once
+         *
+         * Writers sharing a buffer (usually PropWare::SHARED_BUFFER) and a directory sector are committed together;
+         * a writer with a private buffer is committed through that buffer, so that it never holds a stale copy of
+         * its directory sector. The content held in that buffer is written first, so a failed content write is never
+         * followed by a committed length.
+         *
+         * Defined in fatfilewriter.h, once PropWare::FatFileWriter is complete (fatfile.h includes it)
+         *
+         * @return  0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode commit_pending_lengths ();
+
+        /**
+         * @brief   Write every modified FAT sector to the device
+         *
+         * Mirror updates may be deferred; see PropWare::FatFS::set_mirror_sync_threshold
+         *
+         * @return  0 upon success, error code otherwise
+         */
         PropWare::ErrorCode flush_fat () {
             PropWare::ErrorCode err;
-            if (m_fatMod) {
-                check_errors(m_driver->write_data_block(this->m_fatStart + this->m_curFatSector, this->m_fat));
-                check_errors(m_driver->write_data_block(this->m_fatStart + this->m_curFatSector + this->m_fatSize,
-                                                        m_fat));
-                m_fatMod = false;
+            if (this->m_fatMod) {
+                check_errors(this->write_fat_sector(this->m_curFatSector, this->m_fat));
+                this->m_fatMod = false;
+                if (NULL != this->m_fatCache)
+                    this->m_curFatSlot->dirty = false;
+            }
+
+            for (size_t i = 0; i < this->m_fatCacheSize; ++i) {
+                FatCacheSlot *slot = &this->m_fatCache[i];
+                if (slot->valid && slot->dirty) {
+                    check_errors(this->write_fat_sector(slot->fatSector, slot->buf));
+                    slot->dirty = false;
+                }
             }
 
             return NO_ERROR;
@@ -600,6 +3106,22 @@ class FatFS : public Filesystem {
         PropWare::ErrorCode clear_chain (const uint32_t head) {
             PropWare::ErrorCode err;
 
+            // exFAT keeps track of free clusters in the allocation bitmap alone; stale FAT entries are harmless
+            if (EX_FAT == this->m_filesystem) {
+                uint32_t runStart = head;
+                uint32_t current  = head;
+                uint32_t next;
+                do {
+                    check_errors(this->get_fat_value(current, &next));
+                    if (current + 1 != next || this->is_eoc(next)) {
+                        check_errors(this->release_run(runStart, current - runStart + 1));
+                        runStart = next;
+                    }
+                    current = next;
+                } while (!this->is_eoc(next));
+                return NO_ERROR;
+            }
+
             uint32_t next = head;
             do {
                 const uint32_t current = next;
@@ -612,20 +3134,29 @@ class FatFS : public Filesystem {
                     this->m_driver->write_short(sectorOffset << 1, this->m_fat, 0);
                 else if (FAT_32 == this->m_filesystem)
                     this->m_driver->write_long(sectorOffset << 2, this->m_fat, 0);
+                this->m_fatMod = true;
+
+                // Keep the allocator's bookkeeping in sync
+                this->mark_fat_sector(this->m_curFatSector, true);
+                if (current < this->m_nextFreeHint)
+                    this->m_nextFreeHint = current;
+                if (UNKNOWN_FREE_COUNT != this->m_freeCount)
+                    ++this->m_freeCount;
             } while (!this->is_eoc(next));
 
-            this->m_fatMod = true;
+            this->m_fsInfoMod = true;
 
             return NO_ERROR;
         }
 
         void print_status (const bool printBlocks = false) const {
             this->m_logger->println("######################################################");
-            this->m_logger->printf("# FAT Filesystem Status - PropWare::FatFS@0x%08X #\n", (unsigned int) this);
+            this->m_logger->printf("# FAT Filesystem Status - PropWare::FatFS@0x%08X #\n",
+                                   (unsigned int) (uintptr_t) this);
             // DRIVER
             this->m_logger->println("Driver");
             this->m_logger->println("======");
-            this->m_logger->printf("Driver address: 0x%08X\n", (unsigned int) this->m_driver);
+            this->m_logger->printf("Driver address: 0x%08X\n", (unsigned int) (uintptr_t) this->m_driver);
             this->m_logger->printf("Block size: %u\n", this->m_sectorSize);
             this->m_logger->printf("Blocks-per-cluster shift: %u\n", this->m_tier1sPerTier2Shift);
             this->m_logger->println();
@@ -668,6 +3199,12 @@ class FatFS : public Filesystem {
                     case FAT_16:
                         this->m_logger->printf("\tFilesystem: FAT 16\n");
                         break;
+                    case EX_FAT:
+                        this->m_logger->printf("\tFilesystem: exFAT\n");
+                        this->m_logger->printf("\tAllocation bitmap sector: 0x%08X\n",
+                                               this->m_fatStart + this->m_bitmapStart);
+                        this->m_logger->printf("\tVolume dirty: %s\n", this->m_volumeDirty ? "yes" : "no");
+                        break;
                     default:
                         this->m_logger->printf("\tFilesystem: unknown (%d)\n", this->m_filesystem);
                 }
@@ -678,6 +3215,14 @@ class FatFS : public Filesystem {
                 this->m_logger->printf("\tRoot directory sector: 0x%08X\n", this->m_rootAddr);
                 this->m_logger->printf("\tRoot directory size (in sectors): %u\n", this->m_rootDirSectors);
                 this->m_logger->printf("\tFirst data sector: 0x%08X\n", this->m_firstDataAddr);
+                this->m_logger->printf("\tFSInfo sector: 0x%08X\n", this->m_fsInfoSector);
+                this->m_logger->printf("\tFree clusters: 0x%08X/%u\n", this->m_freeCount, this->m_freeCount);
+                this->m_logger->printf("\tNext free cluster hint: 0x%08X/%u\n", this->m_nextFreeHint,
+                                       this->m_nextFreeHint);
+                this->m_logger->printf("\tFAT cache slots: %u\n", (unsigned int) this->m_fatCacheSize);
+                this->m_logger->printf("\tStale mirror FAT sectors: %u/%u\n", this->m_staleMirrorCount,
+                                       this->m_staleMirrorLimit);
+                this->m_logger->printf("\tClusters per allocation unit: %u\n", this->m_auClusters);
                 this->m_logger->println();
             } else {
                 this->m_logger->println("\nNot mounted");
@@ -706,7 +3251,7 @@ class FatFS : public Filesystem {
 
     private:
         InitFATInfo            m_initFatInfo;
-        uint8_t                m_filesystem;  // File system type - one of FAT_16 or FAT_32
+        uint8_t                m_filesystem;  // File system type - one of FAT_16, FAT_32 or EX_FAT
         char                   m_label[9]; // Filesystem label
         uint32_t               m_fatStart;  // Starting block address of the FAT
         uint32_t               m_rootCluster;  // Cluster of root directory/first data sector (FAT32 only)
@@ -717,9 +3262,45 @@ class FatFS : public Filesystem {
         uint16_t               m_entriesPerFatSector_Shift;  // How many FAT entries are in a single sector of the FAT
         uint8_t                *m_fat;  // Buffer for FAT entries only
         bool                   m_fatMod;
+        uint32_t               m_fsInfoSector;  // Block address of the FSInfo sector, or 0 if the volume has none
+        bool                   m_fsInfoMod;  // Set when the free count or next-free hint must be written to FSInfo
+        uint32_t               m_freeCount;  // Number of free clusters, or UNKNOWN_FREE_COUNT
+        uint32_t               m_nextFreeHint;  // Cluster where the search for free space will begin
+        uint8_t                *m_freeSummary;  // One bit per FAT sector - cleared once a sector is known to be full
+        uint32_t               m_freeSummaryBits;  // Number of FAT sectors covered by the free space summary
+        FatCacheSlot           *m_fatCache;  // Optional; m_fat points into the current slot while a cache is in use
+        size_t                 m_fatCacheSize;
+        FatCacheSlot           *m_curFatSlot;
+        uint32_t               m_fatCacheClock;
+        uint32_t               m_staleMirrors[MAX_STALE_MIRRORS];  // FAT sectors whose mirror has not been written
+        uint8_t                m_staleMirrorCount;
+        uint8_t                m_staleMirrorLimit;
+        uint32_t               m_auSize;  // Allocation unit (erase block) size in bytes, as requested by the user
+        uint32_t               m_auClusters;  // Clusters per allocation unit, or 0 when the policy is disabled
+        uint32_t               m_auPhase;  // First cluster of every allocation unit, modulo m_auClusters
+        uint32_t               m_bitmapStart;  // exFAT allocation bitmap's first sector, relative to the FAT
+        bool                   m_volumeDirty;  // exFAT only: set while the boot sector marks the volume dirty
+        bool                   m_clearVolumeDirty;  // Set if the dirty flag was set by this driver, not found on mount
 
         uint32_t m_curFatSector;  // Store the current FAT sector loaded into m_fat
         uint32_t m_dir_firstCluster;  // Store the current directory's starting cluster
+
+        DirectoryIndexEntry *m_dirIndex;  // Open-addressed hash table of the current directory's entries
+        size_t              m_dirIndexCapacity;
+        bool                m_dirIndexValid;  // Set while the index holds every entry of the directory
+        uint32_t            m_dirIndexCluster;  // First cluster of the directory the index was built for
+        uint32_t            m_dirIndexOverflowCluster;  // First cluster of a directory too large for the index
+        bool                m_dirIndexEndKnown;  // Set when `m_dirIndexEnd` holds the directory's first free entry
+        DirectoryIndexEntry m_dirIndexEnd;
+
+        PathCacheEntry      *m_pathCache;  // Optional cache of directories found while resolving paths
+        size_t              m_pathCacheSize;
+        uint32_t            m_pathCacheClock;
+
+        ExFatDirectoryEntry m_exfatWorkingDirEntry;  // Entry set of the working directory, if an exFAT subdirectory
+        ExFatDirectoryEntry m_exfatLastDirEntry;  // Entry set of the exFAT directory most recently found by path
+
+        FatFileWriter       *m_pendingWriters;  // Writers whose length is not yet in their directory entry
 };
 
 }
@@ -172,21 +172,21 @@ class File {
          * @param[in]   printBlocks     Determine whether or not to print the content of the file's buffer
          */
         void print_status (const char classStr[] = "File", const bool printBlocks = false) const {
-            this->m_logger->printf("File Status - PropWare::%s@0x%08X\n", classStr, (unsigned int) this);
+            this->m_logger->printf("File Status - PropWare::%s@0x%08X\n", classStr, (unsigned int) (uintptr_t) this);
             this->m_logger->println("=========================================");
             this->m_logger->println("Common");
             this->m_logger->println("------");
             this->m_logger->printf("\tFile name: %s\n", this->m_name);
-            this->m_logger->printf("\tLogger: 0x%08X\n", (unsigned int) this->m_logger);
-            this->m_logger->printf("\tDriver: 0x%08X\n", (unsigned int) this->m_driver);
-            this->m_logger->printf("\tBuffer: 0x%08X\n", (unsigned int) this->m_buf);
+            this->m_logger->printf("\tLogger: 0x%08X\n", (unsigned int) (uintptr_t) this->m_logger);
+            this->m_logger->printf("\tDriver: 0x%08X\n", (unsigned int) (uintptr_t) this->m_driver);
+            this->m_logger->printf("\tBuffer: 0x%08X\n", (unsigned int) (uintptr_t) this->m_buf);
             this->m_logger->printf("\tLength: 0x%08X/%d\n", this->m_length, this->m_length);
 
             if (NULL != this->m_buf) {
                 this->m_logger->println("Buffer");
                 this->m_logger->println("------");
-                this->m_logger->printf("\tData address: 0x%08X\n", (unsigned int) this->m_buf->buf);
-                this->m_logger->printf("\tMeta address: 0x%08X\n", (unsigned int) this->m_buf->meta);
+                this->m_logger->printf("\tData address: 0x%08X\n", (unsigned int) (uintptr_t) this->m_buf->buf);
+                this->m_logger->printf("\tMeta address: 0x%08X\n", (unsigned int) (uintptr_t) this->m_buf->meta);
                 if (NULL != this->m_buf->buf && NULL != this->m_buf->meta) {
                     this->m_logger->printf("\tID: %d\n", this->m_buf->meta->id);
                     this->m_logger->printf("\tModdified: %s\n", Utility::to_string(this->m_buf->meta->mod));
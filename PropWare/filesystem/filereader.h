@@ -67,6 +67,29 @@ class FileReader : virtual public File, virtual public ScanCapable {
                 return c;
         }
 
+        /**
+         * @brief       Read a block of bytes from the file
+         *
+         * The default implementation reads one character at a time; concrete files should override it with
+         * something faster.
+         *
+         * @param[out]  *dst    Location in memory with room for `len` bytes
+         * @param[in]   len     Number of bytes to read
+         *
+         * @return      0 upon success, error code otherwise
+         */
+        virtual PropWare::ErrorCode read (uint8_t *dst, size_t len) {
+            PropWare::ErrorCode err;
+
+            if (this->m_ptr + (int32_t) len > this->m_length)
+                return EOF_ERROR;
+
+            while (len--)
+                check_errors(this->safe_get_char(*((char *) dst++)));
+
+            return NO_ERROR;
+        }
+
         /**
          * @brief       Determine whether the read pointer has reached the end of the file
          *
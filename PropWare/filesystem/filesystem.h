@@ -52,6 +52,9 @@ class Filesystem {
         static const int FOLDER_ID = INT32_MAX;
 
     public:
+        virtual ~Filesystem () {
+        }
+
         /**
          * @brief       Prepare a filesystem for use; All filesystems must be mounted before files can be listed or
          *              opened
@@ -58,6 +58,26 @@ class FileWriter : virtual public File, public PrintCapable {
             this->safe_put_char(c);
         }
 
+        /**
+         * @brief       Write a block of bytes to the file
+         *
+         * The default implementation writes one character at a time; concrete files should override it with
+         * something faster.
+         *
+         * @param[in]   *src    Data to be written
+         * @param[in]   len     Number of bytes to write
+         *
+         * @return      0 upon success, error code otherwise
+         */
+        virtual PropWare::ErrorCode write (const uint8_t *src, size_t len) {
+            PropWare::ErrorCode err;
+
+            while (len--)
+                check_errors(this->safe_put_char((char) *src++));
+
+            return NO_ERROR;
+        }
+
         /**
          * @brief       Write a character array to the file
          *
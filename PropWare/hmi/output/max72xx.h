@@ -25,7 +25,7 @@
 
 #pragma once
 
-#include <PropWare/serial/spi/spi.h>
+#include <PropWare/serial/spi/staticspi.h>
 
 namespace PropWare {
 
@@ -107,11 +107,12 @@ class MAX72xx {
         /**
          * The MAX72xx family uses SPI's mode 1 - that is, a low clock polarity and rising-edge phase.
          */
-        static const SPI::Mode SPI_MODE                = SPI::Mode::MODE_1;
-        static const uint8_t   DEFAULT_INTENSITY       = 15;
-        static const uint8_t   DEFAULT_SCAN_LIMIT      = 7;
-        static const uint8_t   DEFAULT_BCD_DECODE_BITS = 0xFF;
-        static const uint8_t   DECIMAL_POINT           = BIT_7;
+        static const SPI::Mode    SPI_MODE                = SPI::Mode::MODE_1;
+        static const SPI::BitMode SPI_BITMODE             = SPI::BitMode::MSB_FIRST;
+        static const uint8_t      DEFAULT_INTENSITY       = 15;
+        static const uint8_t      DEFAULT_SCAN_LIMIT      = 7;
+        static const uint8_t      DEFAULT_BCD_DECODE_BITS = 0xFF;
+        static const uint8_t      DECIMAL_POINT           = BIT_7;
 
     public:
         /**
@@ -134,11 +135,11 @@ class MAX72xx {
          * @param[in]   alwaysSetSPIMode    When true, the SPI bus's mode will always be set prior to communication
          */
         MAX72xx (SPI &bus, const Pin::Mask csMask, const bool alwaysSetSPIMode = false)
-            : m_bus(&bus),
+            : m_bus(bus),
               m_cs(csMask, Pin::Dir::OUT),
               m_alwaysSetMode(alwaysSetSPIMode) {
             if (!alwaysSetSPIMode)
-                this->m_bus->set_mode(SPI_MODE);
+                this->m_bus.configure_bus();
             this->m_cs.set();
         }
 
@@ -149,11 +150,11 @@ class MAX72xx {
          * @param[in]   alwaysSetSPIMode    When true, the SPI bus's mode will always be set prior to communication
          */
         MAX72xx (const Pin::Mask csMask, const bool alwaysSetSPIMode = true)
-            : m_bus(&SPI::get_instance()),
+            : m_bus(SPI::get_instance()),
               m_cs(csMask, Pin::Dir::OUT),
               m_alwaysSetMode(alwaysSetSPIMode) {
             if (!alwaysSetSPIMode)
-                this->m_bus->set_mode(SPI::Mode::MODE_1);
+                this->m_bus.configure_bus();
             this->m_cs.set();
         }
 
@@ -300,21 +301,21 @@ class MAX72xx {
          */
         void write (const Register address, const uint8_t value, const bool decimal = false) const {
             if (this->m_alwaysSetMode)
-                this->m_bus->set_mode(SPI_MODE);
+                this->m_bus.configure_bus();
 
             this->m_cs.clear();
-            this->m_bus->shift_out(8, static_cast<uint32_t>(address));
+            this->m_bus.shift_out(8, static_cast<uint32_t>(address));
             if (decimal)
-                this->m_bus->shift_out(8, value | DECIMAL_POINT);
+                this->m_bus.shift_out(8, value | DECIMAL_POINT);
             else
-                this->m_bus->shift_out(8, value);
+                this->m_bus.shift_out(8, value);
             this->m_cs.set();
         }
 
     private:
-        SPI       *m_bus;
-        const Pin m_cs;
-        bool      m_alwaysSetMode;
+        const StaticSPI<SPI_MODE, SPI_BITMODE> m_bus;
+        const Pin                              m_cs;
+        bool                                   m_alwaysSetMode;
 };
 
 }
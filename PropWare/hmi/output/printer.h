@@ -532,14 +532,14 @@ class Printer {
                         switch (c) {
                             case 'i':
                             case 'd':
-                                this->print((int) first, format);
+                                this->print((int) (intptr_t) first, format);
                                 break;
                             case 'X':
                             case 'b':
                                 format.radix = static_cast<uint8_t>('b' == c ? 2 : 16);
                                 // No "break;" after 'X' - let it flow into 'u'
                             case 'u':
-                                this->print((unsigned int) first, format);
+                                this->print((unsigned int) (uintptr_t) first, format);
                                 break;
                             case 'f':
                             case 's':
@@ -62,6 +62,7 @@ class BlockStorage {
 
             MetaData () {
                 this->name = "";
+                this->mod  = false;
             }
         };
 
@@ -115,7 +116,7 @@ class BlockStorage {
 
             for (uint_fast16_t line = 0; line < lines; ++line) {
                 const uint_fast16_t baseAddress = line * wordsPerLine;
-                printer.printf("0x%04X: ", baseAddress);
+                printer.printf("0x%04X: ", (unsigned int) baseAddress);
 
                 // Print hex values
                 for (uint_fast8_t offset = 0; offset < wordsPerLine; ++offset) {
@@ -167,6 +168,56 @@ class BlockStorage {
             return this->read_data_block(address, buffer->buf);
         }
 
+        /**
+         * @brief       Read consecutive blocks of data from the device into RAM
+         *
+         * The default implementation simply reads one block at a time. Devices which are capable of streaming
+         * multiple blocks with a single command (such as SD cards) should override this method.
+         *
+         * @param[in]   address     Address of the first block on the storage device
+         * @param[in]   count       Number of consecutive blocks to read
+         * @param[out]  buf[]       Location in memory to store the blocks - must have room for `count` blocks
+         *
+         * @return      0 upon success, error code otherwise
+         */
+        virtual ErrorCode read_data_blocks (uint32_t address, uint32_t count, uint8_t buf[]) const {
+            PropWare::ErrorCode err;
+            const uint16_t      sectorSize = this->get_sector_size();
+            while (count--) {
+                check_errors(this->read_data_block(address++, buf));
+                buf += sectorSize;
+            }
+            return 0;
+        }
+
+        /**
+         * @brief       Start reading consecutive blocks of data without waiting for them to arrive
+         *
+         * Completion must be confirmed with BlockStorage::wait() before the data is used. Only one request may be
+         * outstanding at a time. The default implementation has no helper to hand the work to, so it simply performs
+         * the read before returning; drivers that run transfers in the background (such as PropWare::SDCog) override
+         * this.
+         *
+         * @param[in]   address     Address of the first block on the storage device
+         * @param[out]  buf[]       Location in memory to store the blocks - must remain valid until the request
+         *                          completes
+         * @param[in]   count       Number of consecutive blocks to read
+         *
+         * @return      0 upon success, error code otherwise
+         */
+        virtual ErrorCode submit_read (uint32_t address, uint8_t buf[], uint32_t count = 1) const {
+            return this->read_data_blocks(address, count, buf);
+        }
+
+        /**
+         * @brief       Block until the request started with BlockStorage::submit_read() has finished
+         *
+         * @return      0 upon success, error code otherwise
+         */
+        virtual ErrorCode wait () const {
+            return 0;
+        }
+
         /**
          * @brief       Use a buffer's metadata to determine the address and read data from the storage device into
          *              memory
@@ -204,6 +255,28 @@ class BlockStorage {
             return this->write_data_block(address, buffer->buf);
         }
 
+        /**
+         * @brief       Write consecutive blocks of data to a storage device
+         *
+         * The default implementation simply writes one block at a time. Devices which are capable of streaming
+         * multiple blocks with a single command (such as SD cards) should override this method.
+         *
+         * @param[in]   address     Address of the first block on the storage device
+         * @param[in]   count       Number of consecutive blocks to write
+         * @param[in]   dat[]       Array of data to be written - must contain `count` blocks
+         *
+         * @return      0 upon success, error code otherwise
+         */
+        virtual ErrorCode write_data_blocks (uint32_t address, uint32_t count, const uint8_t dat[]) const {
+            PropWare::ErrorCode err;
+            const uint16_t      sectorSize = this->get_sector_size();
+            while (count--) {
+                check_errors(this->write_data_block(address++, dat));
+                dat += sectorSize;
+            }
+            return 0;
+        }
+
         /**
          * @brief       Flush the contents of a buffer and mark as unmodified
          *
@@ -221,6 +294,17 @@ class BlockStorage {
             return 0;
         }
 
+        /**
+         * @brief       Write any data held back by the driver itself (such as a write-back cache) to the device
+         *
+         * The default implementation does nothing, since most drivers write straight through to the hardware.
+         *
+         * @return      0 upon success, error code otherwise
+         */
+        virtual ErrorCode flush () const {
+            return 0;
+        }
+
         /**
          * @brief       Read a byte from a buffer
          *
@@ -0,0 +1,329 @@
+/**
+ * @file        PropWare/memory/cachedblockstorage.h
+ *
+ * @author      David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <PropWare/PropWare.h>
+#include <PropWare/memory/blockstorage.h>
+
+namespace PropWare {
+
+/**
+ * @brief   Write-back sector cache which can be layered on top of any other PropWare::BlockStorage device
+ *
+ * The FAT driver funnels everything through a single shared buffer, so switching between directory, FAT and file
+ * sectors often means rereading a block that was read moments ago. Wrapping the driver in a CachedBlockStorage turns
+ * those rereads into a `memcpy`:
+ *
+ * @code
+ * PropWare::SD                        driver;
+ * PropWare::CachedBlockStorage::Slot  slots[4];
+ * PropWare::CachedBlockStorage        cache(driver, slots);
+ * PropWare::FatFS                     filesystem(cache);
+ * @endcode
+ *
+ * The least recently used slot is replaced on a miss. Writes only mark a slot as dirty; data reaches the device when
+ * the slot is evicted or when PropWare::CachedBlockStorage::flush() is invoked (PropWare::FatFS::unmount() and
+ * PropWare::FatFileWriter::flush() do so automatically). Multi-block transfers bypass the cache entirely so that
+ * large, sequential reads and writes do not evict the working set.
+ *
+ * @note    The underlying device must use sectors of CachedBlockStorage::SECTOR_SIZE bytes
+ */
+class CachedBlockStorage : public BlockStorage {
+    public:
+        static const uint16_t SECTOR_SIZE       = 512;
+        static const uint8_t  SECTOR_SIZE_SHIFT = 9;
+
+        /**
+         * @brief   A single cached sector
+         */
+        struct Slot {
+            /** Contents of the sector */
+            uint8_t  buf[SECTOR_SIZE];
+            /** Address of the sector on the underlying device */
+            uint32_t address;
+            /** Value of the access counter the last time this slot was used */
+            uint32_t lastUse;
+            /** Set when `buf` holds valid data */
+            bool     valid;
+            /** Set when `buf` has been modified since it was read from (or written to) the device */
+            bool     dirty;
+        };
+
+    public:
+        /**
+         * @brief       Construct a cache using the given statically-allocated array of slots
+         *
+         * @param[in]   driver  Device being cached
+         * @param[in]   slots   Statically allocated instance of an array, NOT a pointer
+         */
+        template<size_t N>
+        CachedBlockStorage (const BlockStorage &driver, Slot (&slots)[N])
+                : m_driver(&driver),
+                  m_slots(slots),
+                  m_slotCount(N) {
+            static_assert(0 < N, "A cache needs at least one slot");
+            this->invalidate();
+            this->reset_statistics();
+        }
+
+        /**
+         * @brief       Construct a cache using the given dynamically allocated array of slots (i.e., with `new` or
+         *              `malloc`)
+         *
+         * @param[in]   driver      Device being cached
+         * @param[in]   *slots      Address where the array begins
+         * @param[in]   slotCount   Number of slots allocated for the array. With no slots, every access goes straight
+         *                          to the device
+         */
+        CachedBlockStorage (const BlockStorage &driver, Slot *slots, const size_t slotCount)
+                : m_driver(&driver),
+                  m_slots(slots),
+                  m_slotCount(slotCount) {
+            this->invalidate();
+            this->reset_statistics();
+        }
+
+        /**
+         * @brief   Write any dirty sectors back to the device and (re)start it
+         *
+         * @see PropWare::BlockStorage::start
+         */
+        PropWare::ErrorCode start () const {
+            PropWare::ErrorCode err;
+            check_errors(this->flush());
+            this->invalidate();
+            return this->m_driver->start();
+        }
+
+        PropWare::ErrorCode read_data_block (const uint32_t address, uint8_t buf[]) const {
+            PropWare::ErrorCode err;
+            Slot                *slot;
+
+            if (!this->m_slotCount)
+                return this->m_driver->read_data_block(address, buf);
+
+            check_errors(this->load(address, true, &slot));
+            memcpy(buf, slot->buf, SECTOR_SIZE);
+            return 0;
+        }
+
+        /**
+         * @brief       Read consecutive blocks directly from the device without disturbing the cache
+         *
+         * Any dirty slots in the requested range are written back first so that the device holds the latest data.
+         *
+         * @see PropWare::BlockStorage::read_data_blocks
+         */
+        PropWare::ErrorCode read_data_blocks (const uint32_t address, const uint32_t count, uint8_t buf[]) const {
+            PropWare::ErrorCode err;
+
+            for (size_t i = 0; i < this->m_slotCount; ++i) {
+                Slot *slot = &this->m_slots[i];
+                if (slot->valid && slot->dirty && address <= slot->address && slot->address - address < count)
+                    check_errors(this->write_back(slot));
+            }
+
+            return this->m_driver->read_data_blocks(address, count, buf);
+        }
+
+        PropWare::ErrorCode write_data_block (const uint32_t address, const uint8_t dat[]) const {
+            PropWare::ErrorCode err;
+            Slot                *slot;
+
+            if (!this->m_slotCount)
+                return this->m_driver->write_data_block(address, dat);
+
+            // The whole sector is about to be replaced, so there is no need to read it from the device on a miss
+            check_errors(this->load(address, false, &slot));
+            memcpy(slot->buf, dat, SECTOR_SIZE);
+            slot->dirty = true;
+            return 0;
+        }
+
+        /**
+         * @brief       Write consecutive blocks directly to the device
+         *
+         * Slots in the requested range are dropped, since their contents would be stale.
+         *
+         * @see PropWare::BlockStorage::write_data_blocks
+         */
+        PropWare::ErrorCode write_data_blocks (const uint32_t address, const uint32_t count,
+                                               const uint8_t dat[]) const {
+            for (size_t i = 0; i < this->m_slotCount; ++i) {
+                Slot *slot = &this->m_slots[i];
+                if (slot->valid && address <= slot->address && slot->address - address < count)
+                    slot->valid = false;
+            }
+
+            return this->m_driver->write_data_blocks(address, count, dat);
+        }
+
+        using BlockStorage::flush;
+
+        /**
+         * @brief   Write every dirty slot back to the device
+         *
+         * Slots remain valid, so subsequent reads will still hit the cache.
+         *
+         * @return  0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode flush () const {
+            PropWare::ErrorCode err;
+            for (size_t i = 0; i < this->m_slotCount; ++i)
+                if (this->m_slots[i].valid && this->m_slots[i].dirty)
+                    check_errors(this->write_back(&this->m_slots[i]));
+            return 0;
+        }
+
+        /**
+         * @brief   Drop the contents of every slot, without writing anything to the device
+         */
+        void invalidate () const {
+            for (size_t i = 0; i < this->m_slotCount; ++i) {
+                this->m_slots[i].valid = false;
+                this->m_slots[i].dirty = false;
+            }
+            this->m_accessCounter = 0;
+        }
+
+        /**
+         * @brief   Number of sector reads and writes that were satisfied by the cache
+         */
+        uint32_t get_hits () const {
+            return this->m_hits;
+        }
+
+        /**
+         * @brief   Number of sector reads and writes that required a slot to be (re)filled
+         */
+        uint32_t get_misses () const {
+            return this->m_misses;
+        }
+
+        /**
+         * @brief   Number of dirty slots that have been written back to the device
+         */
+        uint32_t get_write_backs () const {
+            return this->m_writeBacks;
+        }
+
+        /**
+         * @brief   Reset the hit, miss and write-back counters to zero
+         */
+        void reset_statistics () const {
+            this->m_hits       = 0;
+            this->m_misses     = 0;
+            this->m_writeBacks = 0;
+        }
+
+        size_t get_slot_count () const {
+            return this->m_slotCount;
+        }
+
+        uint16_t get_sector_size () const {
+            return SECTOR_SIZE;
+        }
+
+        uint8_t get_sector_size_shift () const {
+            return SECTOR_SIZE_SHIFT;
+        }
+
+        uint16_t get_short (const uint16_t offset, const uint8_t buf[]) const {
+            return this->m_driver->get_short(offset, buf);
+        }
+
+        uint32_t get_long (const uint16_t offset, const uint8_t buf[]) const {
+            return this->m_driver->get_long(offset, buf);
+        }
+
+        void write_short (const uint16_t offset, uint8_t buf[], const uint16_t value) const {
+            this->m_driver->write_short(offset, buf, value);
+        }
+
+        void write_long (const uint16_t offset, uint8_t buf[], const uint32_t value) const {
+            this->m_driver->write_long(offset, buf, value);
+        }
+
+    private:
+        /**
+         * @brief       Find the slot holding a sector, or claim the least recently used slot for it. The cache must
+         *              have at least one slot
+         *
+         * @param[in]   address     Address of the sector on the device
+         * @param[in]   fill        When set, the sector is read from the device on a miss
+         * @param[out]  **slot      Slot now assigned to `address`
+         *
+         * @return      0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode load (const uint32_t address, const bool fill, Slot **slot) const {
+            PropWare::ErrorCode err;
+            Slot                *victim = this->m_slots;
+
+            for (size_t i = 0; i < this->m_slotCount; ++i) {
+                Slot *candidate = &this->m_slots[i];
+                if (candidate->valid && address == candidate->address) {
+                    ++this->m_hits;
+                    candidate->lastUse = ++this->m_accessCounter;
+                    *slot = candidate;
+                    return 0;
+                } else if (victim->valid && (!candidate->valid || candidate->lastUse < victim->lastUse))
+                    victim = candidate;
+            }
+
+            ++this->m_misses;
+            if (victim->valid && victim->dirty)
+                check_errors(this->write_back(victim));
+
+            victim->valid = false;
+            if (fill)
+                check_errors(this->m_driver->read_data_block(address, victim->buf));
+            victim->address = address;
+            victim->valid   = true;
+            victim->dirty   = false;
+            victim->lastUse = ++this->m_accessCounter;
+            *slot = victim;
+            return 0;
+        }
+
+        PropWare::ErrorCode write_back (Slot *slot) const {
+            PropWare::ErrorCode err;
+            check_errors(this->m_driver->write_data_block(slot->address, slot->buf));
+            slot->dirty = false;
+            ++this->m_writeBacks;
+            return 0;
+        }
+
+    private:
+        const BlockStorage *m_driver;
+        Slot               *m_slots;
+        const size_t       m_slotCount;
+        mutable uint32_t   m_accessCounter;
+        mutable uint32_t   m_hits;
+        mutable uint32_t   m_misses;
+        mutable uint32_t   m_writeBacks;
+};
+
+}
@@ -174,6 +174,35 @@ class SD : public BlockStorage {
             return err;
         }
 
+        /**
+         * @brief       Read consecutive blocks with a single READ_MULTIPLE_BLOCK (CMD18) transaction
+         *
+         * Only one command and response is exchanged with the card regardless of the number of blocks, followed by a
+         * STOP_TRANSMISSION (CMD12) once the last block has been received.
+         *
+         * @see PropWare::BlockStorage::read_data_blocks
+         */
+        PropWare::ErrorCode read_data_blocks (const uint32_t address, const uint32_t count, uint8_t buf[]) const {
+            PropWare::ErrorCode err;
+            uint8_t             temp = 0;
+
+            if (1 == count)
+                return this->read_data_block(address, buf);
+            else if (0 == count)
+                return NO_ERROR;
+
+            // Wait until the SD card is no longer busy
+            while (!temp)
+                temp = (uint8_t) this->m_spi->shift_in(8);
+
+            this->m_cs.clear();
+            this->send_command(CMD_RD_MULTIPLE_BLOCKS, address, CRC_OTHER);
+            err = this->read_blocks(count, buf);
+            this->m_cs.set();
+
+            return err;
+        }
+
         PropWare::ErrorCode write_data_block (uint32_t address, const uint8_t dat[]) const {
             PropWare::ErrorCode err;
             uint8_t             temp = 0;
@@ -191,6 +220,55 @@ class SD : public BlockStorage {
             return NO_ERROR;
         }
 
+        /**
+         * @brief       Write consecutive blocks with a single WRITE_MULTIPLE_BLOCK (CMD25) transaction
+         *
+         * The card is told how many blocks are coming (SET_WR_BLK_ERASE_COUNT, ACMD23) so that it may pre-erase them.
+         *
+         * @see PropWare::BlockStorage::write_data_blocks
+         */
+        PropWare::ErrorCode write_data_blocks (const uint32_t address, const uint32_t count,
+                                               const uint8_t dat[]) const {
+            return this->write_data_blocks(address, count, dat, true);
+        }
+
+        /**
+         * @overload
+         *
+         * @param[in]   address     Address of the first block on the storage device
+         * @param[in]   count       Number of consecutive blocks to write
+         * @param[in]   dat[]       Array of data to be written - must contain `count` blocks
+         * @param[in]   preErase    When set, the block count is sent to the card with SET_WR_BLK_ERASE_COUNT (ACMD23)
+         *                          ahead of the data, allowing the card to pre-erase the blocks
+         */
+        PropWare::ErrorCode write_data_blocks (const uint32_t address, const uint32_t count, const uint8_t dat[],
+                                               const bool preErase) const {
+            PropWare::ErrorCode err;
+            uint8_t             temp = 0;
+
+            if (1 == count)
+                return this->write_data_block(address, dat);
+            else if (0 == count)
+                return NO_ERROR;
+
+            // Wait until the SD card is no longer busy
+            while (!temp)
+                temp = (uint8_t) this->m_spi->shift_in(8);
+
+            this->m_cs.clear();
+            if (preErase)
+                err = this->set_write_block_erase_count(count);
+            else
+                err = NO_ERROR;
+            if (!err) {
+                this->send_command(CMD_WR_MULTIPLE_BLOCKS, address, CRC_OTHER);
+                err = this->write_blocks(count, dat);
+            }
+            this->m_cs.set();
+
+            return err;
+        }
+
         uint16_t get_short (const uint16_t offset, const uint8_t buf[]) const {
             return (buf[offset + 1] << 8) + buf[offset];
         }
@@ -515,6 +593,130 @@ class SD : public BlockStorage {
             return NO_ERROR;
         }
 
+        /**
+         * @brief       Receive a stream of data blocks from the SD card after a READ_MULTIPLE_BLOCK command
+         *
+         * @param[in]   count   Number of blocks to receive
+         * @param[out]  dat[]   Location in memory with enough space to store `count` blocks of data
+         *
+         * @pre         Chip select must be activated prior to invocation
+         *
+         * @return      Returns 0 for success, else error code
+         */
+        PropWare::ErrorCode read_blocks (uint32_t count, uint8_t dat[]) const {
+            PropWare::ErrorCode err;
+            uint32_t            timeout;
+            uint8_t             firstByte;
+
+            // Read first byte - the R1 response
+            timeout = RESPONSE_TIMEOUT + CNT;
+            do {
+                firstByte = (uint8_t) this->m_spi->shift_in(8);
+
+                // Check for timeout
+                if (abs(timeout - CNT) < SINGLE_BYTE_WIGGLE_ROOM)
+                    return READ_TIMEOUT;
+
+                // wait for transmission end
+            } while (0xff == firstByte);
+
+            if (RESPONSE_ACTIVE != firstByte) {
+                _sd_firstByteResponse = firstByte;
+                return INVALID_RESPONSE;
+            }
+
+            // The card will continue sending blocks until told to stop, so be sure to stop it even if a block fails
+            while (count--) {
+                if ((err = this->read_data_packet(dat))) {
+                    this->stop_transmission();
+                    return err;
+                }
+                dat += SECTOR_SIZE;
+            }
+
+            return this->stop_transmission();
+        }
+
+        /**
+         * @brief       Receive a single data packet (start token, block of data and CRC) from the SD card
+         *
+         * @param[out]  dat[]   Location in memory with enough space to store one block of data
+         *
+         * @pre         Chip select must be activated prior to invocation
+         *
+         * @return      Returns 0 for success, else error code
+         */
+        PropWare::ErrorCode read_data_packet (uint8_t dat[]) const {
+            uint32_t timeout;
+            uint8_t  token;
+
+            // Ignore blank data until the start token (or an error token) arrives
+            timeout = RESPONSE_TIMEOUT + CNT;
+            do {
+                token = (uint8_t) this->m_spi->shift_in(8);
+
+                // Check for timeout
+                if (abs(timeout - CNT) < SINGLE_BYTE_WIGGLE_ROOM)
+                    return READ_TIMEOUT;
+            } while (0xff == token);
+
+            if (DATA_START_ID != token) {
+                _sd_firstByteResponse = token;
+                return INVALID_DAT_START_ID;
+            }
+
+            this->m_spi->shift_in_block_mode0_msb_first_fast(dat, SECTOR_SIZE);
+
+            // Discard the 16-bit CRC. Don't clock any further, because the next packet may follow immediately
+            this->m_spi->shift_in(16);
+
+            return NO_ERROR;
+        }
+
+        /**
+         * @brief       End a multi-block read with STOP_TRANSMISSION (CMD12) and wait for the card to become ready
+         *
+         * @pre         Chip select must be activated prior to invocation
+         *
+         * @return      Returns 0 for success, else error code
+         */
+        PropWare::ErrorCode stop_transmission () const {
+            uint32_t timeout;
+            uint8_t  response;
+
+            this->send_command(CMD_STOP_TRANSMISSION, 0, CRC_OTHER);
+
+            // The byte immediately following CMD12 is a stuff byte and must be discarded
+            this->m_spi->shift_in(8);
+
+            // Wait for the R1 response - the card may still be clocking out data, so look for a cleared MSB
+            timeout = RESPONSE_TIMEOUT + CNT;
+            do {
+                response = (uint8_t) this->m_spi->shift_in(8);
+
+                // Check for timeout
+                if (abs(timeout - CNT) < SINGLE_BYTE_WIGGLE_ROOM)
+                    return READ_TIMEOUT;
+            } while (BIT_7 & response);
+
+            if (RESPONSE_ACTIVE != response) {
+                _sd_firstByteResponse = response;
+                return INVALID_RESPONSE;
+            }
+
+            // R1b response - the card holds MISO low until it is no longer busy
+            timeout = RESPONSE_TIMEOUT + CNT;
+            do {
+                response = (uint8_t) this->m_spi->shift_in(8);
+
+                // Check for timeout
+                if (abs(timeout - CNT) < SINGLE_BYTE_WIGGLE_ROOM)
+                    return READ_TIMEOUT;
+            } while (0xff != response);
+
+            return NO_ERROR;
+        }
+
         /**
          * @brief       Write data to SD card via SPI
          *
@@ -586,6 +788,137 @@ class SD : public BlockStorage {
             return NO_ERROR;
         }
 
+        /**
+         * @brief       Inform the card of how many blocks the next multi-block write will contain (ACMD23)
+         *
+         * @param[in]   count   Number of blocks to be pre-erased
+         *
+         * @pre         Chip select must be activated prior to invocation
+         *
+         * @return      Returns 0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode set_write_block_erase_count (const uint32_t count) const {
+            PropWare::ErrorCode err;
+            uint8_t             firstByte;
+            uint8_t             response;
+
+            this->send_command(CMD_APP, 0, CRC_OTHER);
+            check_errors(this->get_response(RESPONSE_LEN_R1, firstByte, &response));
+
+            this->send_command(CMD_WR_BLK_ERASE_CNT, count, CRC_OTHER);
+            return this->get_response(RESPONSE_LEN_R1, firstByte, &response);
+        }
+
+        /**
+         * @brief       Send a stream of data blocks to the SD card after a WRITE_MULTIPLE_BLOCK command
+         *
+         * @param[in]   count   Number of blocks to send
+         * @param[in]   dat[]   Location in memory where `count` blocks of data reside
+         *
+         * @pre         Chip select must be activated prior to invocation
+         *
+         * @return      Returns 0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode write_blocks (uint32_t count, const uint8_t dat[]) const {
+            PropWare::ErrorCode err;
+            uint32_t            timeout;
+            uint8_t             firstByte;
+
+            // Read first byte - the R1 response
+            timeout = RESPONSE_TIMEOUT + CNT;
+            do {
+                firstByte = (uint8_t) this->m_spi->shift_in(8);
+
+                // Check for timeout
+                if (abs(timeout - CNT) < SINGLE_BYTE_WIGGLE_ROOM)
+                    return READ_TIMEOUT;
+
+                // wait for transmission end
+            } while (0xff == firstByte);
+
+            if (RESPONSE_ACTIVE != firstByte) {
+                _sd_firstByteResponse = firstByte;
+                return INVALID_RESPONSE;
+            }
+
+            while (count--) {
+                if ((err = this->write_data_packet(dat))) {
+                    // A rejected block ends the write with CMD12 rather than the stop token. The write error is
+                    // what the caller needs to see, so it is returned even if the card accepts CMD12
+                    this->stop_transmission();
+                    this->wait_while_busy();
+                    return err;
+                }
+                dat += SECTOR_SIZE;
+            }
+
+            this->m_spi->shift_out(8, STOP_TRAN_TOKEN);
+
+            // One byte of padding is required before the card signals that it is busy
+            this->m_spi->shift_in(8);
+            return this->wait_while_busy();
+        }
+
+        /**
+         * @brief       Send a single data packet (start token, block of data and CRC) as part of a multi-block write
+         *
+         * @param[in]   dat[]   Location in memory where one block of data resides
+         *
+         * @pre         Chip select must be activated prior to invocation
+         *
+         * @return      Returns 0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode write_data_packet (const uint8_t dat[]) const {
+            uint32_t timeout;
+            uint8_t  response;
+
+            this->m_spi->shift_out(8, MULTI_START_ID);
+            this->m_spi->shift_out_block_msb_first_fast(dat, SECTOR_SIZE);
+
+            // The CRC is ignored in SPI mode, but it still must be sent
+            this->m_spi->shift_out(16, 0xffff);
+
+            // Receive and digest response token
+            timeout = RESPONSE_TIMEOUT + CNT;
+            do {
+                response = (uint8_t) this->m_spi->shift_in(8);
+
+                // Check for timeout
+                if (abs(timeout - CNT) < SINGLE_BYTE_WIGGLE_ROOM)
+                    return READ_TIMEOUT;
+            } while (0xff == response);
+            if (RSPNS_TKN_ACCPT != (response & (uint8_t) RSPNS_TKN_BITS)) {
+                _sd_firstByteResponse = response;
+                return INVALID_RESPONSE;
+            }
+
+            // Wait for the card to finish programming the block before sending the next one
+            return this->wait_while_busy();
+        }
+
+        /**
+         * @brief       Provide the card with clock signals until it releases MISO (stops signaling busy)
+         *
+         * @pre         Chip select must be activated prior to invocation
+         *
+         * @return      Returns 0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode wait_while_busy () const {
+            uint32_t timeout;
+            uint8_t  temp;
+
+            timeout = RESPONSE_TIMEOUT + CNT;
+            do {
+                temp = (uint8_t) this->m_spi->shift_in(8);
+
+                // Check for timeout
+                if (abs(timeout - CNT) < SINGLE_BYTE_WIGGLE_ROOM)
+                    return READ_TIMEOUT;
+            } while (0xff != temp);
+
+            return NO_ERROR;
+        }
+
         void first_byte_expansion (const Printer &printer) {
             if (BIT_0 & _sd_firstByteResponse)
                 printer.puts("\t0: Idle\n");
@@ -650,15 +983,19 @@ class SD : public BlockStorage {
         static const uint32_t SINGLE_BYTE_WIGGLE_ROOM;
 
         // SD Commands
-        static const uint8_t CMD_IDLE           = 0x40 + 0;   // Send card into idle state
-        static const uint8_t CMD_INTERFACE_COND = 0x40 + 8;   // Send interface condition and host voltage range
-        static const uint8_t CMD_RD_CSD         = 0x40 + 9;   // Request "Card Specific Data" block contents
-        static const uint8_t CMD_RD_CID         = 0x40 + 10;  // Request "Card Identification" block contents
-        static const uint8_t CMD_RD_BLOCK       = 0x40 + 17;  // Request data block
-        static const uint8_t CMD_WR_BLOCK       = 0x40 + 24;  // Write data block
-        static const uint8_t CMD_WR_OP          = 0x40 + 41;  // Send operating conditions for SDC
-        static const uint8_t CMD_APP            = 0x40 + 55;  // Inform card that following instruction is app specific
-        static const uint8_t CMD_READ_OCR       = 0x40 + 58;  // Request "Operating Conditions Register" contents
+        static const uint8_t CMD_IDLE               = 0x40 + 0;   // Send card into idle state
+        static const uint8_t CMD_INTERFACE_COND     = 0x40 + 8;   // Send interface condition and host voltage range
+        static const uint8_t CMD_RD_CSD             = 0x40 + 9;   // Request "Card Specific Data" block contents
+        static const uint8_t CMD_RD_CID             = 0x40 + 10;  // Request "Card Identification" block contents
+        static const uint8_t CMD_STOP_TRANSMISSION  = 0x40 + 12;  // Stop a multi-block read
+        static const uint8_t CMD_RD_BLOCK           = 0x40 + 17;  // Request data block
+        static const uint8_t CMD_RD_MULTIPLE_BLOCKS = 0x40 + 18;  // Request a stream of data blocks
+        static const uint8_t CMD_WR_BLK_ERASE_CNT   = 0x40 + 23;  // Pre-erase blocks (must follow CMD_APP)
+        static const uint8_t CMD_WR_BLOCK           = 0x40 + 24;  // Write data block
+        static const uint8_t CMD_WR_MULTIPLE_BLOCKS = 0x40 + 25;  // Write a stream of data blocks
+        static const uint8_t CMD_WR_OP              = 0x40 + 41;  // Send operating conditions for SDC
+        static const uint8_t CMD_APP                = 0x40 + 55;  // Inform card that next instruction is app specific
+        static const uint8_t CMD_READ_OCR           = 0x40 + 58;  // Request "Operating Conditions Register" contents
 
         // SD Arguments
         static const uint32_t HOST_VOLTAGE_3V3 = 0x01;
@@ -677,6 +1014,8 @@ class SD : public BlockStorage {
         static const uint8_t RESPONSE_IDLE   = 0x01;
         static const uint8_t RESPONSE_ACTIVE = 0x00;
         static const uint8_t DATA_START_ID   = 0xFE;
+        static const uint8_t MULTI_START_ID  = 0xFC;  // Start token for each block of a multi-block write
+        static const uint8_t STOP_TRAN_TOKEN = 0xFD;  // Ends a multi-block write
         static const uint8_t RESPONSE_LEN_R1 = 1;
         static const uint8_t RESPONSE_LEN_R3 = 5;
         static const uint8_t RESPONSE_LEN_R7 = 5;
@@ -0,0 +1,322 @@
+/**
+ * @file    PropWare/memory/sdcog.cpp
+ *
+ * @author  David Zemon
+ *
+ * Assembly code for the PropWare::SDCog driver cog
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdint.h>
+
+
+extern uint8_t _load_start_SDCog_cog[];
+
+namespace PropWare {
+
+void *get_sd_cog_driver () {
+    return _load_start_SDCog_cog;
+}
+
+}
+
+/*
+ * The mailbox pointed to by PAR is laid out as follows (one long each):
+ *   0: command (0 = idle, 1 = read, 2 = write) - cleared by the cog once the request is complete
+ *   1: address of the first block
+ *   2: number of blocks
+ *   3: hub address of the data
+ *   4: status of the last request
+ *   5-8: MOSI, MISO, SCLK and CS pin masks
+ *   9: timeout in clock ticks
+ */
+__asm__ (
+"            .section .SDCog.cog, \"ax\"                              \n"
+"            .compress off                                            \n"
+"                                                                     \n"
+"            .equ    CMD_WRITE, 2                                     \n"
+"            .equ    CMD_RD_BLOCK, $40 + 17                           \n"
+"            .equ    CMD_WR_BLOCK, $40 + 24                           \n"
+"            .equ    CRC_OTHER, $01                                   \n"
+"            .equ    RESPONSE_ACTIVE, $00                             \n"
+"            .equ    DATA_START_ID, $fe                               \n"
+"            .equ    RSPNS_TKN_BITS, $0f                              \n"
+"            .equ    RSPNS_TKN_ACCPT, $05                             \n"
+"            .equ    STATUS_OK, 0                                     \n"
+"            .equ    STATUS_TIMEOUT, 1                                \n"
+"            .equ    STATUS_BAD_RESPONSE, 2                           \n"
+"            .equ    STATUS_BAD_TOKEN, 3                              \n"
+"            .equ    STATUS_REJECTED, 4                               \n"
+"                                                                     \n"
+"..start                                                              \n"
+"            .org    0                                                \n"
+"                                                                     \n"
+"entry                                                                \n"
+"            mov     t1, PAR                                          \n"
+"            add     t1, #(5 << 2)                                    \n"
+"            rdlong  mosi, t1                                         \n"
+"            add     t1, #4                                           \n"
+"            rdlong  miso, t1                                         \n"
+"            add     t1, #4                                           \n"
+"            rdlong  sclk, t1                                         \n"
+"            add     t1, #4                                           \n"
+"            rdlong  cs, t1                                           \n"
+"            add     t1, #4                                           \n"
+"            rdlong  timeout, t1                                      \n"
+"            or      OUTA, cs                                         \n"
+"            or      OUTA, mosi                                       \n"
+"            andn    OUTA, sclk                                       \n"
+"            or      DIRA, cs                                         \n"
+"            or      DIRA, mosi                                       \n"
+"            or      DIRA, sclk                                       \n"
+"                                                                     \n"
+"idle                                                                 \n"
+"            rdlong  cmd, PAR    wz                                   \n"
+"  if_z      jmp     #idle                                            \n"
+"            mov     t1, PAR                                          \n"
+"            add     t1, #4                                           \n"
+"            rdlong  addr, t1                                         \n"
+"            add     t1, #4                                           \n"
+"            rdlong  count, t1                                        \n"
+"            add     t1, #4                                           \n"
+"            rdlong  hubptr, t1                                       \n"
+"            mov     status, #STATUS_OK                               \n"
+"                                                                     \n"
+"next_block                                                           \n"
+"            andn    OUTA, cs                                         \n"
+"            jmpret  wait_ff_ret, #wait_ff                            \n"
+"            cmp     status, #STATUS_OK    wz                         \n"
+"  if_nz     jmp     #end_block                                       \n"
+"            cmp     cmd, #CMD_WRITE    wz                            \n"
+"  if_nz     mov     data, #CMD_RD_BLOCK                              \n"
+"  if_z      mov     data, #CMD_WR_BLOCK                              \n"
+"            jmpret  send_cmd_ret, #send_cmd                          \n"
+"            cmp     status, #STATUS_OK    wz                         \n"
+"  if_nz     jmp     #end_block                                       \n"
+"            cmp     cmd, #CMD_WRITE    wz                            \n"
+"  if_z      jmp     #write_block                                     \n"
+"                                                                     \n"
+"read_block                                                           \n"
+"            jmpret  wait_token_ret, #wait_token                      \n"
+"            cmp     status, #STATUS_OK    wz                         \n"
+"  if_nz     jmp     #end_block                                       \n"
+"            cmp     data, #DATA_START_ID    wz                       \n"
+"  if_nz     mov     status, #STATUS_BAD_TOKEN                        \n"
+"  if_nz     jmp     #reject                                          \n"
+"            mov     bytes, sector_size                               \n"
+"                                                                     \n"
+"read_byte                                                            \n"
+"            jmpret  recv_ret, #recv                                  \n"
+"            wrbyte  data, hubptr                                     \n"
+"            add     hubptr, #1                                       \n"
+"            djnz    bytes, #read_byte                                \n"
+"            jmpret  recv_ret, #recv                                  \n"
+"            jmpret  recv_ret, #recv                                  \n"
+"            jmp     #end_block                                       \n"
+"                                                                     \n"
+"write_block                                                          \n"
+"            mov     data, #$ff                                       \n"
+"            jmpret  xmit_ret, #xmit                                  \n"
+"            mov     data, #DATA_START_ID                             \n"
+"            jmpret  xmit_ret, #xmit                                  \n"
+"            mov     bytes, sector_size                               \n"
+"                                                                     \n"
+"write_byte                                                           \n"
+"            rdbyte  data, hubptr                                     \n"
+"            add     hubptr, #1                                       \n"
+"            jmpret  xmit_ret, #xmit                                  \n"
+"            djnz    bytes, #write_byte                               \n"
+"            mov     data, #$ff                                       \n"
+"            jmpret  xmit_ret, #xmit                                  \n"
+"            jmpret  xmit_ret, #xmit                                  \n"
+"            jmpret  wait_token_ret, #wait_token                      \n"
+"            cmp     status, #STATUS_OK    wz                         \n"
+"  if_nz     jmp     #end_block                                       \n"
+"            and     data, #RSPNS_TKN_BITS                            \n"
+"            cmp     data, #RSPNS_TKN_ACCPT    wz                     \n"
+"  if_nz     mov     status, #STATUS_REJECTED                         \n"
+"  if_nz     jmp     #reject                                          \n"
+"            jmpret  wait_ff_ret, #wait_ff                            \n"
+"            jmp     #end_block                                       \n"
+"                                                                     \n"
+"reject                                                               \n"
+"            shl     data, #8                                         \n"
+"            or      status, data                                     \n"
+"                                                                     \n"
+"end_block                                                            \n"
+"            or      OUTA, cs                                         \n"
+"            mov     data, #$ff                                       \n"
+"            jmpret  xmit_ret, #xmit                                  \n"
+"            cmp     status, #STATUS_OK    wz                         \n"
+"  if_nz     jmp     #done                                            \n"
+"            add     addr, #1                                         \n"
+"            djnz    count, #next_block                               \n"
+"                                                                     \n"
+"done                                                                 \n"
+"            mov     t1, PAR                                          \n"
+"            add     t1, #(4 << 2)                                    \n"
+"            wrlong  status, t1                                       \n"
+"            wrlong  zero, PAR                                        \n"
+"            jmp     #idle                                            \n"
+"                                                                     \n"
+"send_cmd                                                             \n"
+"            jmpret  xmit_ret, #xmit                                  \n"
+"            mov     arg, addr                                        \n"
+"            mov     t2, #4                                           \n"
+"                                                                     \n"
+"send_arg                                                             \n"
+"            rol     arg, #8                                          \n"
+"            mov     data, arg                                        \n"
+"            jmpret  xmit_ret, #xmit                                  \n"
+"            djnz    t2, #send_arg                                    \n"
+"            mov     data, #CRC_OTHER                                 \n"
+"            jmpret  xmit_ret, #xmit                                  \n"
+"            jmpret  wait_token_ret, #wait_token                      \n"
+"            cmp     status, #STATUS_OK    wz                         \n"
+"  if_nz     jmp     #send_cmd_ret                                    \n"
+"            cmp     data, #RESPONSE_ACTIVE    wz                     \n"
+"  if_z      jmp     #send_cmd_ret                                    \n"
+"            shl     data, #8                                         \n"
+"            mov     status, #STATUS_BAD_RESPONSE                     \n"
+"            or      status, data                                     \n"
+"send_cmd_ret                                                         \n"
+"            ret                                                      \n"
+"                                                                     \n"
+"wait_token                                                           \n"
+"            mov     start, CNT                                       \n"
+"                                                                     \n"
+"wait_token_loop                                                      \n"
+"            jmpret  recv_ret, #recv                                  \n"
+"            cmp     data, #$ff    wz                                 \n"
+"  if_nz     jmp     #wait_token_ret                                  \n"
+"            mov     t1, CNT                                          \n"
+"            sub     t1, start                                        \n"
+"            cmp     t1, timeout    wc                                \n"
+"  if_c      jmp     #wait_token_loop                                 \n"
+"            mov     status, #STATUS_TIMEOUT                          \n"
+"wait_token_ret                                                       \n"
+"            ret                                                      \n"
+"                                                                     \n"
+"wait_ff                                                              \n"
+"            mov     start, CNT                                       \n"
+"                                                                     \n"
+"wait_ff_loop                                                         \n"
+"            jmpret  recv_ret, #recv                                  \n"
+"            cmp     data, #$ff    wz                                 \n"
+"  if_z      jmp     #wait_ff_ret                                     \n"
+"            mov     t1, CNT                                          \n"
+"            sub     t1, start                                        \n"
+"            cmp     t1, timeout    wc                                \n"
+"  if_c      jmp     #wait_ff_loop                                    \n"
+"            mov     status, #STATUS_TIMEOUT                          \n"
+"wait_ff_ret                                                          \n"
+"            ret                                                      \n"
+"                                                                     \n"
+"xmit                                                                 \n"
+"            mov     t3, data                                         \n"
+"            shl     t3, #24                                          \n"
+"            mov     bits, #8                                         \n"
+"                                                                     \n"
+"xmit_bit                                                             \n"
+"            shl     t3, #1    wc                                     \n"
+"            muxc    OUTA, mosi                                       \n"
+"            or      OUTA, sclk                                       \n"
+"            andn    OUTA, sclk                                       \n"
+"            djnz    bits, #xmit_bit                                  \n"
+"            or      OUTA, mosi                                       \n"
+"xmit_ret                                                             \n"
+"            ret                                                      \n"
+"                                                                     \n"
+"recv                                                                 \n"
+"            mov     bits, #8                                         \n"
+"            mov     data, #0                                         \n"
+"                                                                     \n"
+"recv_bit                                                             \n"
+"            or      OUTA, sclk                                       \n"
+"            test    miso, INA    wc                                  \n"
+"            rcl     data, #1                                         \n"
+"            andn    OUTA, sclk                                       \n"
+"            djnz    bits, #recv_bit                                  \n"
+"recv_ret                                                             \n"
+"            ret                                                      \n"
+"                                                                     \n"
+"zero                                                                 \n"
+"            .long   0                                                \n"
+"                                                                     \n"
+"sector_size                                                          \n"
+"            .long   512                                              \n"
+"                                                                     \n"
+"t1                                                                   \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"t2                                                                   \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"t3                                                                   \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"mosi                                                                 \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"miso                                                                 \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"sclk                                                                 \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"cs                                                                   \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"timeout                                                              \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"cmd                                                                  \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"addr                                                                 \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"arg                                                                  \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"count                                                                \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"hubptr                                                               \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"status                                                               \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"data                                                                 \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"bits                                                                 \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"bytes                                                                \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"start                                                                \n"
+"            .res    1                                                \n"
+"            .compress default                                        \n"
+"            .text                                                    \n"
+);
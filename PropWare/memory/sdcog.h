@@ -0,0 +1,350 @@
+/**
+ * @file        PropWare/memory/sdcog.h
+ *
+ * @author      David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <PropWare/PropWare.h>
+#include <PropWare/memory/sd.h>
+
+namespace PropWare {
+
+void *get_sd_cog_driver ();
+
+/**
+ * @brief   SD card driver which moves all block transfers into a dedicated PASM cog
+ *
+ * Card initialization is performed by the calling cog, exactly as in PropWare::SD. Once the card is up and running,
+ * ownership of the SPI pins is handed to the driver cog and all block reads and writes are exchanged with it through
+ * a small mailbox in hub RAM. The calling cog is therefore free to do other work while a transfer is in flight:
+ *
+ * @code
+ * sd.submit_write(address, bufferA);
+ * fill(bufferB);                                  // Runs while bufferA is being written
+ * err = sd.submit_write(address + 1, bufferB);    // Waits for bufferA and returns its status
+ * ...
+ * err = sd.wait();
+ * @endcode
+ *
+ * The blocking methods of PropWare::BlockStorage are implemented as a submission immediately followed by a wait, so
+ * an instance can be handed to PropWare::FatFS like any other block storage device.
+ *
+ * @note    While the driver cog is running, the SPI instance must not be used on the SD card's pins from any other
+ *          cog
+ */
+class SDCog : public SD {
+    public:
+        /**
+         * Error codes - preceded by SD
+         */
+        typedef enum {
+            /** No error */              NO_ERROR          = 0,
+            /** First SDCog error code */BEG_ERROR         = SD::END_ERROR + 1,
+            /** SDCog Error 0 */         NOT_STARTED       = BEG_ERROR,
+            /** SDCog Error 1 */         COG_START_FAILURE,
+            /** SDCog Error 2 */         WRITE_REJECTED,
+            /** Last SDCog error code */ END_ERROR         = WRITE_REJECTED
+        } ErrorCode;
+
+    public:
+        /**
+         * @brief   Use the default SPI instance and pins for connecting to the SD card
+         *
+         * @param[in]   spi     SPI instance used during card initialization. Its pins, clock frequency and mode will
+         *                      be modified to fit the SD card's needs
+         */
+        SDCog (SPI &spi = SPI::get_instance())
+                : SD(spi),
+                  m_cogID(-1),
+                  m_command(IDLE),
+                  m_status(STATUS_OK),
+                  m_mosiMask(config_pin(_cfg_sdspi_config1, 24)),
+                  m_misoMask(config_pin(_cfg_sdspi_config1, 16)),
+                  m_sclkMask(config_pin(_cfg_sdspi_config1, 8)),
+                  m_csMask(config_pin(_cfg_sdspi_config2, 24)),
+                  m_timeout(BUSY_TIMEOUT) {
+        }
+
+        /**
+         * @brief       Construct an SDCog object with the given SPI parameters
+         *
+         * @param[in]   spi     SPI instance used during card initialization. Its clock frequency and mode will be
+         *                      modified to fit the SD card's needs
+         * @param[in]   mosi    Pin mask for data line leaving the Propeller
+         * @param[in]   miso    Pin mask for data line going in to the Propeller
+         * @param[in]   sclk    Pin mask for clock line
+         * @param[in]   cs      Pin mask for chip select
+         */
+        SDCog (SPI &spi, const Port::Mask mosi, const Port::Mask miso, const Port::Mask sclk, const Port::Mask cs)
+                : SD(spi, mosi, miso, sclk, cs),
+                  m_cogID(-1),
+                  m_command(IDLE),
+                  m_status(STATUS_OK),
+                  m_mosiMask(mosi),
+                  m_misoMask(miso),
+                  m_sclkMask(sclk),
+                  m_csMask(cs),
+                  m_timeout(BUSY_TIMEOUT) {
+        }
+
+        /**
+         * @brief   Stop the driver cog
+         */
+        ~SDCog () {
+            this->stop();
+        }
+
+        /**
+         * @brief       Initialize the SD card and then start the driver cog
+         *
+         * If the driver cog is already running, it is stopped first so that the card can be re-initialized
+         *
+         * @return      Returns 0 upon success, error code otherwise
+         */
+        PropWare::ErrorCode start () const {
+            PropWare::ErrorCode err;
+            const Port          outputs(this->m_mosiMask | this->m_sclkMask | this->m_csMask);
+
+            this->stop();
+            check_errors(SD::start());
+
+            // Hand the bus over to the driver cog
+            outputs.set_dir_in();
+            this->m_command = IDLE;
+            this->m_status  = STATUS_OK;
+            this->m_cogID   = cognew(get_sd_cog_driver(), (int32_t) &this->m_command);
+            if (-1 == this->m_cogID) {
+                outputs.set_dir_out();
+                return COG_START_FAILURE;
+            }
+
+            return NO_ERROR;
+        }
+
+        /**
+         * @brief   Wait for any outstanding request to finish, stop the driver cog and reclaim the SPI pins
+         */
+        void stop () const {
+            if (-1 != this->m_cogID) {
+                this->wait();
+                cogstop(this->m_cogID);
+                this->m_cogID = -1;
+                Port(this->m_mosiMask | this->m_sclkMask | this->m_csMask).set_dir_out();
+            }
+        }
+
+        /**
+         * @brief       Ask the driver cog to read consecutive blocks into hub RAM and return without waiting
+         *
+         * If a previous request is still in flight, this method first waits for it to finish.
+         *
+         * @param[in]   address     Address of the first block on the SD card
+         * @param[out]  buf[]       Location in memory to store the blocks - must remain valid until the request
+         *                          completes
+         * @param[in]   count       Number of consecutive blocks to read
+         *
+         * @return      0 upon success, otherwise the error code of the previous request
+         */
+        PropWare::ErrorCode submit_read (const uint32_t address, uint8_t buf[], const uint32_t count = 1) const {
+            return this->submit(READ, address, count, buf);
+        }
+
+        /**
+         * @brief       Ask the driver cog to write consecutive blocks from hub RAM and return without waiting
+         *
+         * If a previous request is still in flight, this method first waits for it to finish.
+         *
+         * @param[in]   address     Address of the first block on the SD card
+         * @param[in]   dat[]       Data to be written - must not be modified until the request completes
+         * @param[in]   count       Number of consecutive blocks to write
+         *
+         * @return      0 upon success, otherwise the error code of the previous request
+         */
+        PropWare::ErrorCode submit_write (const uint32_t address, const uint8_t dat[],
+                                          const uint32_t count = 1) const {
+            return this->submit(WRITE, address, count, dat);
+        }
+
+        /**
+         * @brief   Determine whether the driver cog is still working on a request
+         *
+         * @return  True if a request is in flight, false otherwise
+         */
+        bool is_busy () const {
+            return IDLE != this->m_command;
+        }
+
+        /**
+         * @brief   Block until the driver cog has finished the outstanding request (if any)
+         *
+         * @return  0 if the request completed successfully, error code otherwise
+         */
+        PropWare::ErrorCode wait () const {
+            while (this->is_busy());
+
+            const uint32_t status = this->m_status;
+            this->m_status = STATUS_OK;
+            switch (status & BYTE_0) {
+                case STATUS_OK:
+                    return NO_ERROR;
+                case STATUS_TIMEOUT:
+                    return SD::READ_TIMEOUT;
+                case STATUS_BAD_RESPONSE:
+                    _sd_firstByteResponse = (uint8_t) (status >> 8);
+                    return SD::INVALID_RESPONSE;
+                case STATUS_BAD_TOKEN:
+                    _sd_firstByteResponse = (uint8_t) (status >> 8);
+                    return SD::INVALID_DAT_START_ID;
+                default:
+                    _sd_firstByteResponse = (uint8_t) (status >> 8);
+                    return WRITE_REJECTED;
+            }
+        }
+
+        PropWare::ErrorCode read_data_block (const uint32_t address, uint8_t buf[]) const {
+            return this->read_data_blocks(address, 1, buf);
+        }
+
+        /**
+         * @brief       Read consecutive blocks through the driver cog and wait for them to arrive
+         *
+         * The driver cog issues a single-block READ_BLOCK (CMD17) for each block.
+         *
+         * @see PropWare::BlockStorage::read_data_blocks
+         */
+        PropWare::ErrorCode read_data_blocks (const uint32_t address, const uint32_t count, uint8_t buf[]) const {
+            PropWare::ErrorCode err;
+            check_errors(this->submit_read(address, buf, count));
+            return this->wait();
+        }
+
+        PropWare::ErrorCode write_data_block (const uint32_t address, const uint8_t dat[]) const {
+            return this->write_data_blocks(address, 1, dat);
+        }
+
+        /**
+         * @brief       Write consecutive blocks through the driver cog and wait for them to be programmed
+         *
+         * The driver cog issues a single-block WRITE_BLOCK (CMD24) for each block.
+         *
+         * @see PropWare::BlockStorage::write_data_blocks
+         */
+        PropWare::ErrorCode write_data_blocks (const uint32_t address, const uint32_t count,
+                                               const uint8_t dat[]) const {
+            PropWare::ErrorCode err;
+            check_errors(this->submit_write(address, dat, count));
+            return this->wait();
+        }
+
+        /**
+         * @brief   Create a human-readable error string
+         *
+         * @param[in]   printer     Printer used for logging the message
+         * @param[in]   err         Error number used to determine error string
+         */
+        void print_error_str (const Printer &printer, const ErrorCode err) {
+            const uint8_t relativeError = err - BEG_ERROR;
+
+            switch (err) {
+                case NOT_STARTED:
+                    printer << "SDCog Error " << relativeError << ": Driver cog has not been started\n";
+                    break;
+                case COG_START_FAILURE:
+                    printer << "SDCog Error " << relativeError << ": No cog available for the driver\n";
+                    break;
+                case WRITE_REJECTED:
+                    printer << "SDCog Error " << relativeError << ": Write rejected by the card\n";
+                    printer << "\tResponse: " << _sd_firstByteResponse << '\n';
+                    break;
+                default:
+                    SD::print_error_str(printer, (SD::ErrorCode) err);
+            }
+        }
+
+    private:
+        typedef enum {
+            IDLE,
+            READ,
+            WRITE
+        } Command;
+
+        /**
+         * Status codes written back by the driver cog. Bits 8-15 hold the offending byte received from the card.
+         */
+        typedef enum {
+            STATUS_OK,
+            STATUS_TIMEOUT,
+            STATUS_BAD_RESPONSE,
+            STATUS_BAD_TOKEN,
+            STATUS_REJECTED
+        } Status;
+
+    private:
+        static Port::Mask config_pin (const int config, const uint8_t shift) {
+            return (Port::Mask) (1 << ((config >> shift) & BYTE_0));
+        }
+
+        PropWare::ErrorCode submit (const Command command, const uint32_t address, const uint32_t count,
+                                    const uint8_t *buf) const {
+            PropWare::ErrorCode err;
+
+            if (-1 == this->m_cogID)
+                return NOT_STARTED;
+
+            check_errors(this->wait());
+
+            if (count) {
+                this->m_address = address;
+                this->m_count   = count;
+                this->m_buffer  = (uint32_t) buf;
+                // Must be written last - the driver cog starts working as soon as it sees a command
+                this->m_command = command;
+            }
+
+            return NO_ERROR;
+        }
+
+    private:
+        /** Ticks to wait for the card before giving up (writes may keep the card busy for up to 250 ms) */
+        static const uint32_t BUSY_TIMEOUT;
+
+    private:
+        mutable int32_t m_cogID;
+
+        // These variables must appear in this order. The assembly code relies on the exact order
+        mutable volatile uint32_t m_command;
+        mutable volatile uint32_t m_address;
+        mutable volatile uint32_t m_count;
+        mutable volatile uint32_t m_buffer;
+        mutable volatile uint32_t m_status;
+        const uint32_t            m_mosiMask;
+        const uint32_t            m_misoMask;
+        const uint32_t            m_sclkMask;
+        const uint32_t            m_csMask;
+        const uint32_t            m_timeout;
+};
+
+const uint32_t SDCog::BUSY_TIMEOUT = 250 * MILLISECOND;
+
+}
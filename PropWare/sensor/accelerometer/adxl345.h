@@ -25,7 +25,7 @@
 
 #pragma once
 
-#include <PropWare/serial/spi/spi.h>
+#include <PropWare/serial/spi/staticspi.h>
 
 namespace PropWare {
 
@@ -575,7 +575,8 @@ class ADXL345 {
         };
 
     public:
-        static const SPI::Mode SPI_MODE = SPI::Mode::MODE_3;
+        static const SPI::Mode    SPI_MODE    = SPI::Mode::MODE_3;
+        static const SPI::BitMode SPI_BITMODE = SPI::BitMode::MSB_FIRST;
 
         /**
          * @brief   The ADXL345 is hardwired for a device ID of `0xE5`
@@ -613,11 +614,11 @@ class ADXL345 {
          * @param[in]   alwaysSetSPIMode    When true, the SPI bus's mode will always be set prior to communication
          */
         ADXL345 (SPI &bus, const Pin::Mask csMask, const bool alwaysSetSPIMode = false)
-            : m_bus(&bus),
+            : m_bus(bus),
               m_cs(csMask, Pin::Dir::OUT),
               m_alwaysSetMode(alwaysSetSPIMode) {
             if (!alwaysSetSPIMode)
-                this->m_bus->set_mode(SPI_MODE);
+                this->m_bus.configure_bus();
             this->m_cs.set();
         }
 
@@ -628,11 +629,11 @@ class ADXL345 {
          * @param[in]   alwaysSetSPIMode    When true, the SPI bus's mode will always be set prior to communication
          */
         ADXL345 (const Pin::Mask csMask, const bool alwaysSetSPIMode = true)
-            : m_bus(&SPI::get_instance()),
+            : m_bus(SPI::get_instance()),
               m_cs(csMask, Pin::Dir::OUT),
               m_alwaysSetMode(alwaysSetSPIMode) {
             if (!alwaysSetSPIMode)
-                this->m_bus->set_mode(SPI::Mode::MODE_1);
+                this->m_bus.configure_bus();
             this->m_cs.set();
         }
 
@@ -727,11 +728,11 @@ class ADXL345 {
          */
         void write (const Register address, const uint8_t value) const {
             if (this->m_alwaysSetMode)
-                this->m_bus->set_mode(SPI_MODE);
+                this->m_bus.configure_bus();
 
             this->m_cs.clear();
-            this->m_bus->shift_out(8, static_cast<uint32_t>(address));
-            this->m_bus->shift_out(8, value);
+            this->m_bus.shift_out(8, static_cast<uint32_t>(address));
+            this->m_bus.shift_out(8, value);
             this->m_cs.set();
         }
 
@@ -744,11 +745,11 @@ class ADXL345 {
          */
         uint8_t read (const Register address) const {
             if (this->m_alwaysSetMode)
-                this->m_bus->set_mode(SPI_MODE);
+                this->m_bus.configure_bus();
 
             this->m_cs.clear();
-            this->m_bus->shift_out(8, BIT_7 | static_cast<uint32_t>(address));
-            const uint8_t result = static_cast<const uint8_t>(this->m_bus->shift_in(8));
+            this->m_bus.shift_out(8, BIT_7 | static_cast<uint32_t>(address));
+            const uint8_t result = static_cast<const uint8_t>(this->m_bus.shift_in(8));
             this->m_cs.set();
             return result;
         }
@@ -762,14 +763,17 @@ class ADXL345 {
          */
         void read (const Register startingAddress, const size_t words, int16_t *result) const {
             if (this->m_alwaysSetMode)
-                this->m_bus->set_mode(SPI_MODE);
+                this->m_bus.configure_bus();
 
             this->m_cs.clear();
-            this->m_bus->shift_out(8, BIT_7 | BIT_6 | static_cast<uint32_t>(startingAddress));
-            for (size_t i = 0; i < words; ++i) {
-                const uint8_t lowByte  = static_cast<const uint8_t>(this->m_bus->shift_in(8));
-                const uint8_t highByte = static_cast<const uint8_t>(this->m_bus->shift_in(8));
-                result[i] = highByte << 8 | lowByte;
+            this->m_bus.shift_out(8, BIT_7 | BIT_6 | static_cast<uint32_t>(startingAddress));
+            // Words are little-endian, so each burst is read as a block of bytes and assembled afterwards
+            uint8_t buffer[2 * AXES];
+            for (size_t i = 0; i < words;) {
+                const size_t burst = words - i < AXES ? words - i : AXES;
+                this->m_bus.shift_in_block(buffer, 2 * burst);
+                for (size_t j = 0; j < burst; ++i, ++j)
+                    result[i] = buffer[2 * j + 1] << 8 | buffer[2 * j];
             }
             this->m_cs.set();
         }
@@ -803,9 +807,9 @@ class ADXL345 {
         }
 
     private:
-        SPI       *m_bus;
-        const Pin m_cs;
-        bool      m_alwaysSetMode;
+        const StaticSPI<SPI_MODE, SPI_BITMODE> m_bus;
+        const Pin                              m_cs;
+        bool                                   m_alwaysSetMode;
 };
 
 }
@@ -27,7 +27,7 @@
 #pragma once
 
 #include <PropWare/PropWare.h>
-#include <PropWare/serial/spi/spi.h>
+#include <PropWare/serial/spi/staticspi.h>
 
 namespace PropWare {
 
@@ -92,11 +92,10 @@ class MCP3xxx {
          */
         MCP3xxx (SPI &spi, const PropWare::Pin::Mask cs, MCP3xxx::PartNumber partNumber,
                  const bool alwaysSetSPIMode = false)
-                : m_spi(&spi),
+                : m_spi(spi),
                   m_alwaysSetMode(alwaysSetSPIMode),
                   m_dataWidth(static_cast<uint8_t>(partNumber)) {
-            this->m_spi->set_mode(SPI_MODE);
-            this->m_spi->set_bit_mode(SPI_BITMODE);
+            this->m_spi.configure_bus();
 
             this->m_cs.set_mask(cs);
             this->m_cs.set();
@@ -130,14 +129,12 @@ class MCP3xxx {
             // Two dead bits between output and input - see page 19 of datasheet
             options <<= 2;
 
-            if (this->m_alwaysSetMode) {
-                this->m_spi->set_mode(MCP3xxx::SPI_MODE);
-                this->m_spi->set_bit_mode(MCP3xxx::SPI_BITMODE);
-            }
+            if (this->m_alwaysSetMode)
+                this->m_spi.configure_bus();
 
             this->m_cs.clear();
-            this->m_spi->shift_out(OPTION_WIDTH, (uint32_t) options);
-            dat = (uint16_t) this->m_spi->shift_in(this->m_dataWidth);
+            this->m_spi.shift_out(OPTION_WIDTH, (uint32_t) options);
+            dat = (uint16_t) this->m_spi.shift_in(this->m_dataWidth);
             this->m_cs.set();
 
             return dat;
@@ -161,14 +158,12 @@ class MCP3xxx {
             // Two dead bits between output and input - see page 19 of datasheet
             options <<= 2;
 
-            if (this->m_alwaysSetMode) {
-                this->m_spi->set_mode(SPI_MODE);
-                this->m_spi->set_bit_mode(SPI_BITMODE);
-            }
+            if (this->m_alwaysSetMode)
+                this->m_spi.configure_bus();
 
             this->m_cs.clear();
-            this->m_spi->shift_out(OPTION_WIDTH, (uint32_t) options);
-            dat = (uint16_t) this->m_spi->shift_in(this->m_dataWidth);
+            this->m_spi.shift_out(OPTION_WIDTH, (uint32_t) options);
+            dat = (uint16_t) this->m_spi.shift_in(this->m_dataWidth);
             this->m_cs.set();
 
             return dat;
@@ -184,10 +179,10 @@ class MCP3xxx {
         static const uint8_t OPTION_WIDTH = 7;
 
     private:
-        SPI           *m_spi;
-        PropWare::Pin m_cs;
-        bool          m_alwaysSetMode;
-        uint8_t       m_dataWidth;
+        const StaticSPI<SPI_MODE, SPI_BITMODE> m_spi;
+        PropWare::Pin                          m_cs;
+        bool                                   m_alwaysSetMode;
+        uint8_t                                m_dataWidth;
 };
 
 }
@@ -27,7 +27,7 @@
 #pragma once
 
 #include <PropWare/PropWare.h>
-#include <PropWare/serial/spi/spi.h>
+#include <PropWare/serial/spi/staticspi.h>
 
 namespace PropWare {
 
@@ -118,7 +118,7 @@ class L3G {
          *                              or write operation
          */
         L3G (SPI &spi, const Port::Mask cs, const bool alwaysSetMode = false)
-            : m_spi(&spi),
+            : m_spi(spi),
               m_cs(cs, Pin::Dir::OUT),
               m_alwaysSetMode(alwaysSetMode) {
             this->m_cs.set();
@@ -149,20 +149,14 @@ class L3G {
             this->maybe_set_spi_mode();
 
             this->m_cs.clear();
-            this->m_spi->shift_out(8, addr);
-            values[Axis::X]        = static_cast<int16_t>(this->m_spi->shift_in(16));
-            values[Axis::Y]        = static_cast<int16_t>(this->m_spi->shift_in(16));
-            values[Axis::Z]        = static_cast<int16_t>(this->m_spi->shift_in(16));
+            this->m_spi.shift_out(8, addr);
+            uint8_t buffer[2 * AXES];
+            this->m_spi.shift_in_block(buffer, sizeof(buffer));
             this->m_cs.set();
 
-            // err is useless at this point and will be used as a temporary
-            // 8-bit variable
-            uint32_t          temp;
-            for (unsigned int axis = 0; axis < AXES; ++axis) {
-                temp = (uint32_t) (values[axis] >> 8);
-                values[axis] <<= 8;
-                values[axis] |= temp;
-            }
+            // Each axis is sent low byte first
+            for (unsigned int axis = 0; axis < AXES; ++axis)
+                values[axis] = static_cast<int16_t>(buffer[2 * axis + 1] << 8 | buffer[2 * axis]);
         }
 
         /**
@@ -234,7 +228,7 @@ class L3G {
             this->maybe_set_spi_mode();
 
             this->m_cs.clear();
-            this->m_spi->shift_out(16, combinedWord);
+            this->m_spi.shift_out(16, combinedWord);
             this->m_cs.set();
         }
 
@@ -252,8 +246,8 @@ class L3G {
             this->maybe_set_spi_mode();
 
             this->m_cs.clear();
-            this->m_spi->shift_out(8, commandByte);
-            const auto registerValue = static_cast<uint8_t>(this->m_spi->shift_in(8));
+            this->m_spi.shift_out(8, commandByte);
+            const auto registerValue = static_cast<uint8_t>(this->m_spi.shift_in(8));
             this->m_cs.set();
 
             return registerValue;
@@ -302,8 +296,8 @@ class L3G {
             this->maybe_set_spi_mode();
 
             this->m_cs.clear();
-            this->m_spi->shift_out(8, commandByte);
-            uint16_t registerValue = static_cast<uint16_t>(this->m_spi->shift_in(16));
+            this->m_spi.shift_out(8, commandByte);
+            uint16_t registerValue = static_cast<uint16_t>(this->m_spi.shift_in(16));
             this->m_cs.set();
 
             uint_fast8_t temp = registerValue >> 8;
@@ -317,16 +311,14 @@ class L3G {
          * @return  Returns 0 upon success, error code otherwise
          */
         void maybe_set_spi_mode () const {
-            if (this->m_alwaysSetMode) {
-                this->m_spi->set_mode(SPI_MODE);
-                this->m_spi->set_bit_mode(SPI_BITMODE);
-            }
+            if (this->m_alwaysSetMode)
+                this->m_spi.configure_bus();
         }
 
     private:
-        SPI       *m_spi;
-        const Pin m_cs;
-        bool      m_alwaysSetMode;
+        const StaticSPI<SPI_MODE, SPI_BITMODE> m_spi;
+        const Pin                              m_cs;
+        bool                                   m_alwaysSetMode;
 };
 
 }
@@ -91,7 +91,9 @@ class SPI : public PrintCapable,
         } ErrorCode;
 
     public:
-        static const int32_t DEFAULT_FREQUENCY = 100000;
+        static const int32_t  DEFAULT_FREQUENCY = 100000;
+        /** SCLK runs at CLKFREQ / NCO_CLOCK_DIVISOR (10 MHz at 80 MHz) in the counter-clocked block transfers */
+        static const uint32_t NCO_CLOCK_DIVISOR = 8;
 
     public:
         /**
@@ -352,6 +354,90 @@ class SPI : public PrintCapable,
 #undef ASMVAR
         }
 
+        /**
+         * @brief       Send an array of bytes at max transmit speed, in the current mode and bit order
+         *
+         * Unlike PropWare::SPI::shift_out, the mode and bit order are only checked once per block rather than once per
+         * word, and the whole transfer runs from fcache. Each bit takes seven instructions, so the clock runs at no
+         * more than CLKFREQ/28 (about 2.9 MHz at 80 MHz) within a byte, and is paused between bytes while HUB memory
+         * is accessed, regardless of PropWare::SPI::set_clock. That is slower than the MODE_0, MSB-first
+         * PropWare::SPI::shift_out_block_msb_first_fast, which is still the better choice when it fits the device
+         *
+         * @param[in]   buffer[]        Address where data is stored
+         * @param[in]   numberOfBytes   Number of bytes to send
+         */
+        void shift_out_block (const uint8_t buffer[], const size_t numberOfBytes) const {
+            uint8_t discarded;
+            this->transfer_block(buffer, 1, &discarded, 0, numberOfBytes, this->m_mode, this->m_bitmode);
+        }
+
+        /**
+         * @brief       Receive an array of bytes at max transmit speed, in the current mode and bit order. MOSI is held
+         *              high
+         *
+         * @see         PropWare::SPI::shift_out_block
+         *
+         * @param[out]  buffer[]        Address to store data
+         * @param[in]   numberOfBytes   Number of bytes to receive
+         */
+        void shift_in_block (uint8_t buffer[], const size_t numberOfBytes) const {
+            static const uint8_t IDLE = 0xFF;
+            this->transfer_block(&IDLE, 0, buffer, 1, numberOfBytes, this->m_mode, this->m_bitmode);
+        }
+
+        /**
+         * @brief       Send and receive an array of bytes simultaneously (full duplex) at max transmit speed, in the
+         *              current mode and bit order
+         *
+         * Each byte received is the one clocked in while the byte at the same index of `txBuffer` was clocked out
+         *
+         * @see         PropWare::SPI::shift_out_block
+         *
+         * @param[in]   txBuffer[]      Data to send
+         * @param[out]  rxBuffer[]      Address to store received data. May be the same as `txBuffer`
+         * @param[in]   numberOfBytes   Number of bytes to exchange
+         */
+        void exchange_block (const uint8_t txBuffer[], uint8_t rxBuffer[], const size_t numberOfBytes) const {
+            this->transfer_block(txBuffer, 1, rxBuffer, 1, numberOfBytes, this->m_mode, this->m_bitmode);
+        }
+
+        /**
+         * @brief       Send an array of bytes with SCLK generated by counter A, in the current mode and bit order
+         *
+         * The clock runs at CLKFREQ / PropWare::SPI::NCO_CLOCK_DIVISOR (10 MHz at 80 MHz), regardless of
+         * PropWare::SPI::set_clock, and is paused between bytes while the next one is fetched from HUB. Counter A of
+         * the calling cog is borrowed for the duration of the call and restored afterwards
+         *
+         * @param[in]   buffer[]        Address where data is stored
+         * @param[in]   numberOfBytes   Number of bytes to send
+         */
+        void shift_out_block_nco (const uint8_t buffer[], const size_t numberOfBytes) const {
+            this->nco_shift_out_block(buffer, numberOfBytes, this->m_mode, this->m_bitmode);
+        }
+
+        /**
+         * @brief       Receive an array of bytes with SCLK generated by counter A, in the current mode and bit order.
+         *              MOSI is held high
+         *
+         * @see         PropWare::SPI::shift_out_block_nco
+         *
+         * @param[out]  buffer[]        Address to store data
+         * @param[in]   numberOfBytes   Number of bytes to receive
+         */
+        void shift_in_block_nco (uint8_t buffer[], const size_t numberOfBytes) const {
+            this->nco_shift_in_block(buffer, numberOfBytes, this->m_mode, this->m_bitmode);
+        }
+
+        /**
+         * @brief       Retrieve the SCLK frequency used by PropWare::SPI::shift_out_block_nco and
+         *              PropWare::SPI::shift_in_block_nco
+         *
+         * @return      Frequency, in hertz
+         */
+        static uint32_t get_nco_clock () {
+            return CLKFREQ / NCO_CLOCK_DIVISOR;
+        }
+
         virtual void put_char (const char c) {
             this->shift_out(8, (uint32_t) c);
         }
@@ -392,6 +478,288 @@ class SPI : public PrintCapable,
 
     protected:
 
+        /**
+         * @brief       Full-duplex block transfer behind PropWare::SPI::shift_out_block, PropWare::SPI::shift_in_block
+         *              and PropWare::SPI::exchange_block
+         *
+         * Clock polarity needs no special handling, as SCLK already idles at the right level and is only ever
+         * toggled. Clock phase is held in the Z flag for the whole block and picks one of two bit loops for each byte:
+         * with CPHA 1, the leading edge comes before MOSI is updated instead of after MISO is sampled. Neither loop
+         * tests the phase, so each bit takes seven instructions. LSB-first bytes are bit-reversed on their way in and
+         * out of the shift registers, so the bit loops are the same for both bit orders.
+         *
+         * @param[in]   txBuffer    First byte to send
+         * @param[in]   txStep      Bytes to advance `txBuffer` by after each byte (0 to send the same byte repeatedly)
+         * @param[out]  rxBuffer    Where to store the first byte received
+         * @param[in]   rxStep      Bytes to advance `rxBuffer` by after each byte (0 to discard all but the last byte)
+         * @param[in]   bytes       Number of bytes to transfer
+         * @param[in]   mode        Clock phase and polarity
+         * @param[in]   bitmode     Bit order
+         */
+        void transfer_block (const uint8_t *txBuffer, const unsigned int txStep, uint8_t *rxBuffer,
+                             const unsigned int rxStep, size_t bytes, const Mode mode, const BitMode bitmode) const {
+            const unsigned int clockPhase = static_cast<unsigned int>(mode) & 0x01;
+            const unsigned int lsbFirst   = BitMode::LSB_FIRST == bitmode;
+
+            if (!bytes)
+                return;
+
+            __asm__ volatile (
+#define ASMVAR(name) FC_ADDR(#name "%=", "SpiBlockTransferStart%=")
+            FC_START("SpiBlockTransferStart%=", "SpiBlockTransferEnd%=")
+                    "       jmp #" FC_ADDR("begin%=", "SpiBlockTransferStart%=") "                              \n\t"
+
+                    // Temporary variables
+                    "bitIdx%=:                                                                                  \n\t"
+                    "       nop                                                                                 \n\t"
+                    "txData%=:                                                                                  \n\t"
+                    "       nop                                                                                 \n\t"
+                    "rxData%=:                                                                                  \n\t"
+                    "       nop                                                                                 \n\t"
+
+                    "begin%=:                                                                                   \n\t"
+                    "       test %[_clockPhase], #1 wz              '' Z clear for CPHA 1                       \n\t"
+
+                    "loopOverBytes%=:                                                                           \n\t"
+                    "       rdbyte " ASMVAR(txData) ", %[_txAdr]                                                \n\t"
+                    "       test %[_lsbFirst], #1 wc                                                            \n\t"
+                    "if_c   rev " ASMVAR(txData) ", #24                                                         \n\t"
+                    "       shl " ASMVAR(txData) ", #24             '' first bit out in bit 31                  \n\t"
+                    "       mov " ASMVAR(bitIdx) ", #8                                                          \n\t"
+
+                    "if_nz  jmp #" FC_ADDR("cpha1Bits%=", "SpiBlockTransferStart%=") "                          \n\t"
+
+                    // CPHA 0: MOSI is valid and MISO sampled before the leading edge
+                    "cpha0Bits%=:                                                                               \n\t"
+                    "       shl " ASMVAR(txData) ", #1 wc                                                       \n\t"
+                    "       muxc outa, %[_mosi]                                                                 \n\t"
+                    "       test %[_miso], ina wc                                                               \n\t"
+                    "       rcl " ASMVAR(rxData) ", #1                                                          \n\t"
+                    "       xor outa, %[_sclk]                      '' Leading edge                             \n\t"
+                    "       xor outa, %[_sclk]                      '' Trailing edge                            \n\t"
+                    "       djnz " ASMVAR(bitIdx) ", #" FC_ADDR("cpha0Bits%=", "SpiBlockTransferStart%=") "     \n\t"
+                    "       jmp #" FC_ADDR("byteDone%=", "SpiBlockTransferStart%=") "                           \n\t"
+
+                    // CPHA 1: MOSI changes after the leading edge, and MISO is sampled before the trailing edge
+                    "cpha1Bits%=:                                                                               \n\t"
+                    "       xor outa, %[_sclk]                      '' Leading edge                             \n\t"
+                    "       shl " ASMVAR(txData) ", #1 wc                                                       \n\t"
+                    "       muxc outa, %[_mosi]                                                                 \n\t"
+                    "       test %[_miso], ina wc                                                               \n\t"
+                    "       rcl " ASMVAR(rxData) ", #1                                                          \n\t"
+                    "       xor outa, %[_sclk]                      '' Trailing edge                            \n\t"
+                    "       djnz " ASMVAR(bitIdx) ", #" FC_ADDR("cpha1Bits%=", "SpiBlockTransferStart%=") "     \n\t"
+
+                    // Write the word back to the buffer in HUB memory
+                    "byteDone%=:                                                                                \n\t"
+                    "       test %[_lsbFirst], #1 wc                                                            \n\t"
+                    "if_c   rev " ASMVAR(rxData) ", #24                                                         \n\t"
+                    "       wrbyte " ASMVAR(rxData) ", %[_rxAdr]                                                \n\t"
+                    "       add %[_txAdr], %[_txStep]                                                           \n\t"
+                    "       add %[_rxAdr], %[_rxStep]                                                           \n\t"
+
+                    "       djnz %[_bytes], #" FC_ADDR("loopOverBytes%=", "SpiBlockTransferStart%=") "          \n\t"
+
+                    "       or outa, %[_mosi]                                                                   \n\t"
+                    FC_END("SpiBlockTransferEnd%=")
+#undef ASMVAR
+            : [_txAdr] "+r"(txBuffer),
+            [_rxAdr] "+r"(rxBuffer),
+            [_bytes] "+r"(bytes)
+            : [_txStep] "r"(txStep),
+            [_rxStep] "r"(rxStep),
+            [_clockPhase] "r"(clockPhase),
+            [_lsbFirst] "r"(lsbFirst),
+            [_mosi] "r"(this->m_mosi.get_mask()),
+            [_miso] "r"(this->m_miso.get_mask()),
+            [_sclk] "r"(this->m_sclk.get_mask())
+            : "memory"
+            );
+        }
+
+        /**
+         * @brief   Put counter A in NCO mode on SCLK, stopped at the idle level and 1/4 period before a leading edge
+         *
+         * The pin is the OR of OUTA and the counter, so SCLK's OUTA bit has to be low while the counter drives it
+         */
+        void start_nco_clock (const Mode mode) const {
+            FRQA = 0;
+            PHSA = clock_polarity(mode) ? NCO_PHASE_CPOL_1 : NCO_PHASE_CPOL_0;
+            CTRA = NCO_SINGLE_ENDED | this->m_sclk.get_pin_number();
+            this->m_sclk.clear();
+        }
+
+        /**
+         * @brief   Give SCLK back to OUTA and restore counter A
+         */
+        void stop_nco_clock (const Mode mode, const uint32_t ctra, const uint32_t frqa, const uint32_t phsa) const {
+            if (clock_polarity(mode))
+                this->m_sclk.set();
+            CTRA = ctra;
+            FRQA = frqa;
+            PHSA = phsa;
+        }
+
+        /**
+         * @brief   Counter-clocked transmit loop behind PropWare::SPI::shift_out_block_nco
+         *
+         * SCLK's period is exactly two instructions, so each bit gets one `shl` and one `muxc`. Counting from the
+         * instruction slot S after `mov frqa`, the leading and trailing edges of bit k land at clock 4S + 8k + 2 and
+         * 4S + 8k + 6, while MOSI changes at 4S + 8k. Both edges are therefore two clocks away from a data change,
+         * which holds for either clock phase, and the `mov frqa, #0` in slot S + 15 freezes the counter at the idle
+         * level two clocks after the last trailing edge, leaving PHSA where start_nco_clock put it for the next byte
+         */
+        void nco_shift_out_block (const uint8_t *buffer, size_t numberOfBytes, const Mode mode,
+                                  const BitMode bitmode) const {
+            const unsigned int lsbFirst = BitMode::LSB_FIRST == bitmode;
+
+            if (!numberOfBytes)
+                return;
+
+            const uint32_t ctra = CTRA;
+            const uint32_t frqa = FRQA;
+            const uint32_t phsa = PHSA;
+            this->start_nco_clock(mode);
+
+            __asm__ volatile (
+#define ASMVAR(name) FC_ADDR(#name "%=", "SpiNcoWriteStart%=")
+            FC_START("SpiNcoWriteStart%=", "SpiNcoWriteEnd%=")
+                    "       jmp #" FC_ADDR("loopOverBytes%=", "SpiNcoWriteStart%=") "                           \n\t"
+
+                    // Temporary variables
+                    "data%=:                                                                                    \n\t"
+                    "       nop                                                                                 \n\t"
+
+                    "loopOverBytes%=:                                                                           \n\t"
+                    "       rdbyte " ASMVAR(data) ", %[_bufAdr]                                                 \n\t"
+                    "       test %[_lsbFirst], #1 wc                                                            \n\t"
+                    "if_c   rev " ASMVAR(data) ", #24                                                           \n\t"
+                    "       shl " ASMVAR(data) ", #24                                                           \n\t"
+                    "       shl " ASMVAR(data) ", #1 wc                                                         \n\t"
+                    "       muxc outa, %[_mosi]                     '' bit 0                                    \n\t"
+                    "       mov frqa, %[_frq]                       '' start the clock                          \n\t"
+                    "       shl " ASMVAR(data) ", #1 wc                                                         \n\t"
+                    "       muxc outa, %[_mosi]                     '' bit 1                                    \n\t"
+                    "       shl " ASMVAR(data) ", #1 wc                                                         \n\t"
+                    "       muxc outa, %[_mosi]                     '' bit 2                                    \n\t"
+                    "       shl " ASMVAR(data) ", #1 wc                                                         \n\t"
+                    "       muxc outa, %[_mosi]                     '' bit 3                                    \n\t"
+                    "       shl " ASMVAR(data) ", #1 wc                                                         \n\t"
+                    "       muxc outa, %[_mosi]                     '' bit 4                                    \n\t"
+                    "       shl " ASMVAR(data) ", #1 wc                                                         \n\t"
+                    "       muxc outa, %[_mosi]                     '' bit 5                                    \n\t"
+                    "       shl " ASMVAR(data) ", #1 wc                                                         \n\t"
+                    "       muxc outa, %[_mosi]                     '' bit 6                                    \n\t"
+                    "       shl " ASMVAR(data) ", #1 wc                                                         \n\t"
+                    "       muxc outa, %[_mosi]                     '' bit 7                                    \n\t"
+                    "       add %[_bufAdr], #1                                                                  \n\t"
+                    "       mov frqa, #0                            '' stop the clock                           \n\t"
+
+                    "       djnz %[_numberOfBytes], #" FC_ADDR("loopOverBytes%=", "SpiNcoWriteStart%=") "       \n\t"
+
+                    "       or outa, %[_mosi]                                                                   \n\t"
+                    FC_END("SpiNcoWriteEnd%=")
+#undef ASMVAR
+            : [_bufAdr] "+r"(buffer),
+            [_numberOfBytes] "+r"(numberOfBytes)
+            : [_lsbFirst] "r"(lsbFirst),
+            [_frq] "r"(NCO_FREQUENCY),
+            [_mosi] "r"(this->m_mosi.get_mask())
+            );
+
+            this->stop_nco_clock(mode, ctra, frqa, phsa);
+        }
+
+        /**
+         * @brief   Counter-clocked receive loop behind PropWare::SPI::shift_in_block_nco
+         *
+         * MISO is sampled in every other instruction slot, 4 clocks after a change of the slave's data (trailing edges
+         * for CPHA 0, leading edges for CPHA 1). To get there, the clock starts one slot earlier for CPHA 1, which
+         * moves its stop one slot earlier too: onto the slot that samples the last bit for CPHA 0. The last bit's
+         * sample and the stop are therefore patched into place, in whichever order the phase needs, before the loop
+         * starts. With CPHA 1 the last bit can safely be sampled after the clock stops, as no further leading edge
+         * will come to change it
+         */
+        void nco_shift_in_block (uint8_t *buffer, size_t numberOfBytes, const Mode mode, const BitMode bitmode) const {
+            const unsigned int clockPhase = static_cast<unsigned int>(mode) & 0x01;
+            const unsigned int lsbFirst   = BitMode::LSB_FIRST == bitmode;
+
+            if (!numberOfBytes)
+                return;
+
+            const uint32_t ctra = CTRA;
+            const uint32_t frqa = FRQA;
+            const uint32_t phsa = PHSA;
+            this->start_nco_clock(mode);
+
+            __asm__ volatile (
+#define ASMVAR(name) FC_ADDR(#name "%=", "SpiNcoReadStart%=")
+            FC_START("SpiNcoReadStart%=", "SpiNcoReadEnd%=")
+                    "       jmp #" FC_ADDR("begin%=", "SpiNcoReadStart%=") "                                    \n\t"
+
+                    // Temporary variables
+                    "data%=:                                                                                    \n\t"
+                    "       nop                                                                                 \n\t"
+
+                    // Instruction templates for the last two slots of the clock, never executed in place
+                    "sampleInstr%=:                                                                             \n\t"
+                    "       test %[_miso], ina wc                                                               \n\t"
+                    "stopInstr%=:                                                                               \n\t"
+                    "       mov frqa, #0                                                                        \n\t"
+
+                    "begin%=:                                                                                   \n\t"
+                    "       or outa, %[_mosi]                                                                   \n\t"
+                    "       test %[_clockPhase], #1 wz              '' Z clear for CPHA 1                       \n\t"
+                    "if_z   mov " ASMVAR(slot14) ", " ASMVAR(sampleInstr) "                                     \n\t"
+                    "if_z   mov " ASMVAR(slot15) ", " ASMVAR(stopInstr) "                                       \n\t"
+                    "if_nz  mov " ASMVAR(slot14) ", " ASMVAR(stopInstr) "                                       \n\t"
+                    "if_nz  mov " ASMVAR(slot15) ", " ASMVAR(sampleInstr) "                                     \n\t"
+
+                    "loopOverBytes%=:                                                                           \n\t"
+                    "if_nz  mov frqa, %[_frq]                       '' CPHA 1: start the clock                  \n\t"
+                    "       mov frqa, %[_frq]                       '' CPHA 0: start the clock                  \n\t"
+                    "       test %[_miso], ina wc                   '' bit 0                                    \n\t"
+                    "       rcl " ASMVAR(data) ", #1                                                            \n\t"
+                    "       test %[_miso], ina wc                   '' bit 1                                    \n\t"
+                    "       rcl " ASMVAR(data) ", #1                                                            \n\t"
+                    "       test %[_miso], ina wc                   '' bit 2                                    \n\t"
+                    "       rcl " ASMVAR(data) ", #1                                                            \n\t"
+                    "       test %[_miso], ina wc                   '' bit 3                                    \n\t"
+                    "       rcl " ASMVAR(data) ", #1                                                            \n\t"
+                    "       test %[_miso], ina wc                   '' bit 4                                    \n\t"
+                    "       rcl " ASMVAR(data) ", #1                                                            \n\t"
+                    "       test %[_miso], ina wc                   '' bit 5                                    \n\t"
+                    "       rcl " ASMVAR(data) ", #1                                                            \n\t"
+                    "       test %[_miso], ina wc                   '' bit 6                                    \n\t"
+                    "       rcl " ASMVAR(data) ", #1                                                            \n\t"
+                    "slot14%=:                                                                                  \n\t"
+                    "       nop                                     '' bit 7 (CPHA 0) or stop (CPHA 1)          \n\t"
+                    "slot15%=:                                                                                  \n\t"
+                    "       nop                                     '' stop (CPHA 0) or bit 7 (CPHA 1)          \n\t"
+                    "       rcl " ASMVAR(data) ", #1                                                            \n\t"
+
+                    // Write the word back to the buffer in HUB memory
+                    "       test %[_lsbFirst], #1 wc                                                            \n\t"
+                    "if_c   rev " ASMVAR(data) ", #24                                                           \n\t"
+                    "       wrbyte " ASMVAR(data) ", %[_bufAdr]                                                 \n\t"
+                    "       add %[_bufAdr], #1                                                                  \n\t"
+
+                    "       djnz %[_numberOfBytes], #" FC_ADDR("loopOverBytes%=", "SpiNcoReadStart%=") "        \n\t"
+                    FC_END("SpiNcoReadEnd%=")
+#undef ASMVAR
+            : [_bufAdr] "+r"(buffer),
+            [_numberOfBytes] "+r"(numberOfBytes)
+            : [_clockPhase] "r"(clockPhase),
+            [_lsbFirst] "r"(lsbFirst),
+            [_frq] "r"(NCO_FREQUENCY),
+            [_mosi] "r"(this->m_mosi.get_mask()),
+            [_miso] "r"(this->m_miso.get_mask())
+            : "memory"
+            );
+
+            this->stop_nco_clock(mode, ctra, frqa, phsa);
+        }
+
         void shift_out_msb_first (uint32_t bits, uint32_t data) const {
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wuninitialized"
@@ -580,6 +948,9 @@ class SPI : public PrintCapable,
         }
 
     private:
+        static bool clock_polarity (const Mode mode) {
+            return static_cast<bool>(static_cast<unsigned int>(mode) & 0x02);
+        }
 
         static void reset_pin_mask (Pin &pin, const Port::Mask mask) {
             pin.set_dir_in();
@@ -588,6 +959,19 @@ class SPI : public PrintCapable,
             pin.set_dir_out();
         }
 
+    protected:
+        /** CTRMODE for NCO, single-ended: APIN follows PHSA[31] */
+        static const uint32_t NCO_SINGLE_ENDED = 0x04 << 26;
+        /** Added to PHSA every clock: a full period of SCLK every NCO_CLOCK_DIVISOR clocks */
+        static const uint32_t NCO_FREQUENCY    = UINT32_MAX / NCO_CLOCK_DIVISOR + 1;
+        /** PHSA[31] is low, with the (rising) leading edge 1/4 period away */
+        static const uint32_t NCO_PHASE_CPOL_0 = NCO_FREQUENCY * (NCO_CLOCK_DIVISOR / 4);
+        /** PHSA[31] is high, with the (falling) leading edge 1/4 period away */
+        static const uint32_t NCO_PHASE_CPOL_1 = NCO_PHASE_CPOL_0 | BIT_31;
+
+        template<Mode MODE, BitMode BITMODE>
+        friend class StaticSPI;
+
     protected:
         PropWare::Pin m_mosi;
         PropWare::Pin m_miso;
@@ -0,0 +1,312 @@
+/**
+ * @file        PropWare/serial/spi/spibusmaster.h
+ *
+ * @author      David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <PropWare/PropWare.h>
+#include <PropWare/concurrent/runnable.h>
+#include <PropWare/gpio/pin.h>
+#include <PropWare/serial/spi/spi.h>
+#include <PropWare/utility/utility.h>
+
+namespace PropWare {
+
+/**
+ * @brief   SPI engine in its own cog: client cogs queue up transactions and the bus master performs them one at a time
+ *
+ * PropWare::SPI runs every transfer in the calling cog, so two cogs talking to different devices on the same bus will
+ * interleave their clocks and chip selects. With an SPIBusMaster, only the master cog ever drives MOSI, SCLK and the
+ * chip select pins; clients describe each transfer with a PropWare::SPIBusMaster::Transaction, submit it, and either
+ * carry on with other work or wait for it to complete. Each transaction selects its device, switches the bus to that
+ * device's mode and bit order, and moves its whole buffer with PropWare::SPI's block routines before the device is
+ * deselected again. Those routines clock the bus at a fixed rate of at most CLKFREQ/28, pausing between bytes (see
+ * PropWare::SPI::shift_out_block), so every device on the bus must be able to keep up with it.
+ *
+ * A single client needs no lock at all - clients only ever move the head of the queue and the master only ever moves
+ * the tail. When several cogs submit to the same master, pass a hardware lock to the constructor. It is held only
+ * while a transaction is added to the queue, never during a transfer.
+ *
+ * Because a cog's outputs are ORed with every other cog's, the pins given to the master - and the chip select of
+ * every transaction - must be left as inputs (or low) in every other cog.
+ *
+ * @code
+ * #include <PropWare/PropWare.h>
+ * #include <PropWare/serial/spi/spibusmaster.h>
+ *
+ * using PropWare::Port;
+ * using PropWare::SPI;
+ * using PropWare::SPIBusMaster;
+ *
+ * SPIBusMaster::Transaction *queue[8];
+ * uint32_t                  stack[128];
+ *
+ * int main () {
+ *     SPIBusMaster master(Port::P0, Port::P1, Port::P2, queue, stack, locknew());
+ *     PropWare::Runnable::invoke(master);
+ *
+ *     const uint8_t             command[] = {0x80 | 0x32, 0xFF, 0xFF};
+ *     uint8_t                   response[sizeof(command)];
+ *     SPIBusMaster::Transaction read(Port::P3, SPI::Mode::MODE_3, SPI::BitMode::MSB_FIRST, command, response,
+ *                                   sizeof(command));
+ *     master.transfer(read);
+ *     pwOut.printf("0x%02X 0x%02X\n", response[1], response[2]);
+ * }
+ * @endcode
+ */
+class SPIBusMaster : public Runnable {
+    public:
+        /** Pass as the lock number when only a single cog submits transactions */
+        static const int NO_LOCK = -1;
+
+        /**
+         * @brief   Description of a single chip-select-framed transfer
+         *
+         * The transaction, and both of its buffers, must stay in place until it is complete (see
+         * Transaction::is_complete).
+         */
+        class Transaction {
+            public:
+                /**
+                 * @brief       Describe a transfer
+                 *
+                 * @param[in]   cs          Chip select pin, asserted (low) for the length of the transfer. Use
+                 *                          Port::NULL_PIN for a device that is always selected
+                 * @param[in]   mode        Clock polarity and phase of the device
+                 * @param[in]   bitMode     Bit order of the device
+                 * @param[in]   txBuffer[]  Bytes to be sent, or NULL to send 0xFF
+                 * @param[out]  rxBuffer[]  Receives the bytes read while sending, or NULL to discard them
+                 * @param[in]   length      Number of bytes in each buffer
+                 */
+                Transaction (const Pin::Mask cs, const SPI::Mode mode, const SPI::BitMode bitMode,
+                             const uint8_t txBuffer[], uint8_t rxBuffer[], const size_t length)
+                        : cs(cs),
+                          mode(mode),
+                          bitMode(bitMode),
+                          txBuffer(txBuffer),
+                          rxBuffer(rxBuffer),
+                          length(length),
+                          m_complete(true) {
+                }
+
+                /**
+                 * @brief   Determine whether the bus master has finished with this transaction. True before the
+                 *          transaction is first submitted
+                 */
+                bool is_complete () const {
+                    return this->m_complete;
+                }
+
+                /**
+                 * @brief   Block until the bus master has finished with this transaction
+                 */
+                void wait () const {
+                    while (!this->m_complete);
+                }
+
+            public:
+                Pin::Mask     cs;
+                SPI::Mode     mode;
+                SPI::BitMode  bitMode;
+                const uint8_t *txBuffer;
+                uint8_t       *rxBuffer;
+                size_t        length;
+
+            private:
+                volatile bool m_complete;
+
+                friend class SPIBusMaster;
+        };
+
+    public:
+        /**
+         * @brief       Construct a bus master; Nothing is transferred until it is started with
+         *              PropWare::Runnable::invoke
+         *
+         * @param[in]   mosi            Pin mask for MOSI
+         * @param[in]   miso            Pin mask for MISO
+         * @param[in]   sclk            Pin mask for SCLK
+         * @param[in]   queue[]         Statically-allocated queue of pending transactions. Its size must be a power
+         *                              of two
+         * @param[in]   stack[]         Stack for the bus master cog
+         * @param[in]   lockNumber      Hardware lock that serializes clients, or SPIBusMaster::NO_LOCK when only a
+         *                              single cog calls SPIBusMaster::submit
+         */
+        template<size_t QUEUE_SIZE, size_t STACK_SIZE>
+        SPIBusMaster (const Pin::Mask mosi, const Pin::Mask miso, const Pin::Mask sclk,
+                      Transaction *(&queue)[QUEUE_SIZE], const uint32_t (&stack)[STACK_SIZE],
+                      const int lockNumber = NO_LOCK)
+                : Runnable(stack),
+                  m_mosi(mosi),
+                  m_miso(miso),
+                  m_sclk(sclk),
+                  m_queue(queue),
+                  m_queueMask(QUEUE_SIZE - 1),
+                  m_lock(lockNumber),
+                  m_head(0),
+                  m_tail(0),
+                  m_stopRequested(false),
+                  m_running(false) {
+            static_assert(0 == (QUEUE_SIZE & (QUEUE_SIZE - 1)), "Queue size must be a power of two");
+            if (NO_LOCK != this->m_lock)
+                lockclr(this->m_lock);
+        }
+
+        /**
+         * @brief       Add a transaction to the end of the queue without waiting for it to be performed
+         *
+         * @param[in]   transaction     Transfer to perform. It must not already be waiting in the queue
+         *
+         * @return      True if the transaction was queued, false if the queue was full
+         */
+        bool submit (Transaction &transaction) {
+            if (NO_LOCK != this->m_lock)
+                while (lockset(this->m_lock));
+
+            const uint32_t head     = this->m_head;
+            const bool     accepted = head - this->m_tail <= this->m_queueMask;
+            if (accepted) {
+                transaction.m_complete                  = false;
+                this->m_queue[head & this->m_queueMask] = &transaction;
+
+                // The slot must be filled before the master can see the new head
+                Utility::memory_barrier();
+                this->m_head = head + 1;
+            }
+
+            if (NO_LOCK != this->m_lock)
+                lockclr(this->m_lock);
+            return accepted;
+        }
+
+        /**
+         * @brief       Queue a transaction, waiting for room if need be, and block until it has been performed
+         *
+         * @param[in]   transaction     Transfer to perform
+         */
+        void transfer (Transaction &transaction) {
+            while (!this->submit(transaction));
+            transaction.wait();
+        }
+
+        /**
+         * @brief   Ask the master to perform every transaction already queued and then return from
+         *          SPIBusMaster::run
+         */
+        void stop () {
+            this->m_stopRequested = true;
+        }
+
+        /**
+         * @brief   Determine whether the master cog is still running
+         */
+        bool is_running () const {
+            return this->m_running;
+        }
+
+        /**
+         * @brief   Number of transactions queued but not yet completed
+         */
+        uint32_t get_pending () const {
+            return this->m_head - this->m_tail;
+        }
+
+        /**
+         * @brief   Master loop: perform queued transactions, in order, until asked to stop
+         */
+        void run () {
+            {
+                // Pin directions belong to the cog that sets them, so the bus must be set up by the master itself
+                SPI bus(this->m_mosi, this->m_miso, this->m_sclk);
+                this->m_running = true;
+
+                while (true) {
+                    // Read the request before the head, so that everything submitted before a stop is still performed
+                    const bool     stopping = this->m_stopRequested;
+                    Utility::memory_barrier();
+                    const uint32_t tail     = this->m_tail;
+
+                    if (tail != this->m_head) {
+                        Transaction *transaction = this->m_queue[tail & this->m_queueMask];
+                        this->perform(bus, *transaction);
+
+                        // Release the slot before the client is told, so that a client waiting on this transaction
+                        // can submit again immediately
+                        Utility::memory_barrier();
+                        this->m_tail            = tail + 1;
+                        transaction->m_complete = true;
+                    } else if (stopping)
+                        break;
+                }
+            }
+
+            // Only once the bus is gone, so that a caller seeing the master stop may reuse its pins and stack
+            this->m_running = false;
+        }
+
+    private:
+        static void perform (SPI &bus, const Transaction &transaction) {
+            const Pin cs(transaction.cs);
+
+            // Move SCLK to the device's idle level before the device is selected
+            bus.set_mode(transaction.mode);
+            bus.set_bit_mode(transaction.bitMode);
+            cs.clear();
+            cs.set_dir_out();
+
+            if (NULL != transaction.txBuffer && NULL != transaction.rxBuffer)
+                bus.exchange_block(transaction.txBuffer, transaction.rxBuffer, transaction.length);
+            else if (NULL != transaction.txBuffer)
+                bus.shift_out_block(transaction.txBuffer, transaction.length);
+            else if (NULL != transaction.rxBuffer)
+                bus.shift_in_block(transaction.rxBuffer, transaction.length);
+            else {
+                // shift_in_block holds MOSI high, so receiving into a scratch buffer sends 0xFF at the block rate
+                uint8_t discarded[16];
+                for (size_t remaining = transaction.length; remaining;) {
+                    const size_t chunk = remaining < sizeof(discarded) ? remaining : sizeof(discarded);
+                    bus.shift_in_block(discarded, chunk);
+                    remaining -= chunk;
+                }
+            }
+
+            cs.set();
+        }
+
+    private:
+        const Pin::Mask   m_mosi;
+        const Pin::Mask   m_miso;
+        const Pin::Mask   m_sclk;
+        Transaction       **m_queue;
+        const uint32_t    m_queueMask;
+        const int         m_lock;
+        /** Total number of transactions ever submitted; only moved by clients */
+        volatile uint32_t m_head;
+        /** Total number of transactions ever completed; only moved by the master */
+        volatile uint32_t m_tail;
+        volatile bool     m_stopRequested;
+        volatile bool     m_running;
+};
+
+}
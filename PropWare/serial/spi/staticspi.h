@@ -0,0 +1,152 @@
+/**
+ * @file        PropWare/serial/spi/staticspi.h
+ *
+ * @author      David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <PropWare/serial/spi/spi.h>
+
+namespace PropWare {
+
+/**
+ * @brief   An SPI bus with its mode and bit order fixed at compile time
+ *
+ * Every transfer goes straight to the routine for `MODE` and `BITMODE`, rather than through the checks of
+ * PropWare::SPI::m_mode and PropWare::SPI::m_bitmode that PropWare::SPI::shift_out and PropWare::SPI::shift_in make
+ * for every word. Pins and clock frequency still come from the PropWare::SPI instance that is wrapped, so any number
+ * of StaticSPI objects with different configurations can share one bus:
+ *
+ * @code
+ * using PropWare::SPI;
+ *
+ * SPI &bus = SPI::get_instance();
+ * const PropWare::StaticSPI<SPI::Mode::MODE_2, SPI::BitMode::MSB_FIRST> adc(bus);
+ * const PropWare::StaticSPI<SPI::Mode::MODE_3, SPI::BitMode::LSB_FIRST> display(bus);
+ *
+ * adc.configure_bus();
+ * adcCs.clear();
+ * adc.shift_out(7, options);
+ * const uint32_t reading = adc.shift_in(10);
+ * adcCs.set();
+ * @endcode
+ *
+ * Only PropWare::StaticSPI::configure_bus touches the shared bus's state, and it must be called before chip select is
+ * asserted whenever another device may have left SCLK idling at the other level.
+ */
+template<SPI::Mode MODE, SPI::BitMode BITMODE>
+class StaticSPI {
+    public:
+        /**
+         * @brief       Wrap an SPI bus; Its pins and clock frequency are used as-is
+         *
+         * @param[in]   bus     Bus to communicate over
+         */
+        StaticSPI (SPI &bus = SPI::get_instance())
+                : m_bus(&bus) {
+        }
+
+        /**
+         * @brief   Retrieve the underlying bus
+         */
+        SPI &get_bus () const {
+            return *this->m_bus;
+        }
+
+        /**
+         * @brief   Write `MODE` and `BITMODE` to the bus, which also moves SCLK to the idle level of `MODE`
+         *
+         * Only needed when other devices on the same bus use a different clock polarity, or when the bus is also used
+         * through its own (runtime-configured) methods
+         */
+        void configure_bus () const {
+            this->m_bus->set_mode(MODE);
+            this->m_bus->set_bit_mode(BITMODE);
+        }
+
+        /**
+         * @see PropWare::SPI::shift_out
+         */
+        void shift_out (const uint8_t bits, const uint32_t value) const {
+            if (LSB_FIRST)
+                this->m_bus->shift_out_lsb_first(bits, value);
+            else
+                this->m_bus->shift_out_msb_first(bits, value);
+        }
+
+        /**
+         * @see PropWare::SPI::shift_in
+         */
+        uint32_t shift_in (const unsigned int bits) const {
+            if (CLOCK_PHASE)
+                return LSB_FIRST ? this->m_bus->shift_in_lsb_phs1(bits) : this->m_bus->shift_in_msb_phs1(bits);
+            else
+                return LSB_FIRST ? this->m_bus->shift_in_lsb_phs0(bits) : this->m_bus->shift_in_msb_phs0(bits);
+        }
+
+        /**
+         * @see PropWare::SPI::shift_out_block
+         */
+        void shift_out_block (const uint8_t buffer[], const size_t numberOfBytes) const {
+            uint8_t discarded;
+            this->m_bus->transfer_block(buffer, 1, &discarded, 0, numberOfBytes, MODE, BITMODE);
+        }
+
+        /**
+         * @see PropWare::SPI::shift_in_block
+         */
+        void shift_in_block (uint8_t buffer[], const size_t numberOfBytes) const {
+            static const uint8_t IDLE = 0xFF;
+            this->m_bus->transfer_block(&IDLE, 0, buffer, 1, numberOfBytes, MODE, BITMODE);
+        }
+
+        /**
+         * @see PropWare::SPI::exchange_block
+         */
+        void exchange_block (const uint8_t txBuffer[], uint8_t rxBuffer[], const size_t numberOfBytes) const {
+            this->m_bus->transfer_block(txBuffer, 1, rxBuffer, 1, numberOfBytes, MODE, BITMODE);
+        }
+
+        /**
+         * @see PropWare::SPI::shift_out_block_nco
+         */
+        void shift_out_block_nco (const uint8_t buffer[], const size_t numberOfBytes) const {
+            this->m_bus->nco_shift_out_block(buffer, numberOfBytes, MODE, BITMODE);
+        }
+
+        /**
+         * @see PropWare::SPI::shift_in_block_nco
+         */
+        void shift_in_block_nco (uint8_t buffer[], const size_t numberOfBytes) const {
+            this->m_bus->nco_shift_in_block(buffer, numberOfBytes, MODE, BITMODE);
+        }
+
+    private:
+        static const bool CLOCK_PHASE = static_cast<unsigned int>(MODE) & 0x01;
+        static const bool LSB_FIRST   = SPI::BitMode::LSB_FIRST == BITMODE;
+
+    private:
+        SPI *m_bus;
+};
+
+}
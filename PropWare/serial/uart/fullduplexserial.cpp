@@ -61,8 +61,12 @@ __asm__ (
 "            rdlong  bitticks, t1                                     \n"
 "            add     t1, #4                                           \n"
 "            rdlong  rxbuff, t1                                       \n"
-"            mov     txbuff, rxbuff                                   \n"
-"            add     txbuff, #$10                                     \n"
+"            add     t1, #4                                           \n"
+"            rdlong  txbuff, t1                                       \n"
+"            add     t1, #4                                           \n"
+"            rdlong  rxwrap, t1                                       \n"
+"            add     t1, #4                                           \n"
+"            rdlong  txwrap, t1                                       \n"
 "            test    rxtxmode, #4    wz                               \n"
 "            test    rxtxmode, #2    wc                               \n"
 "  if_z_ne_c or      OUTA, txmask                                     \n"
@@ -101,7 +105,7 @@ __asm__ (
 "            wrbyte  rxdata, t2                                       \n"
 "            sub     t2, rxbuff                                       \n"
 "            add     t2, #1                                           \n"
-"            and     t2, #$f                                          \n"
+"            and     t2, rxwrap                                       \n"
 "            wrlong  t2, PAR                                          \n"
 "            jmp     #receive                                         \n"
 "                                                                     \n"
@@ -118,7 +122,7 @@ __asm__ (
 "            rdbyte  txdata, t3                                       \n"
 "            sub     t3, txbuff                                       \n"
 "            add     t3, #1                                           \n"
-"            and     t3, #$f                                          \n"
+"            and     t3, txwrap                                       \n"
 "            wrlong  t3, t1                                           \n"
 "            or      txdata, #$100                                    \n"
 "            shl     txdata, #2                                       \n"
@@ -177,6 +181,9 @@ __asm__ (
 "rxcnt                                                                \n"
 "            .res    1                                                \n"
 "                                                                     \n"
+"rxwrap                                                               \n"
+"            .res    1                                                \n"
+"                                                                     \n"
 "rxcode                                                               \n"
 "            .res    1                                                \n"
 "                                                                     \n"
@@ -195,6 +202,9 @@ __asm__ (
 "txcnt                                                                \n"
 "            .res    1                                                \n"
 "                                                                     \n"
+"txwrap                                                               \n"
+"            .res    1                                                \n"
+"                                                                     \n"
 "txcode                                                               \n"
 "            .res    1                                                \n"
 "            .compress default                                        \n"
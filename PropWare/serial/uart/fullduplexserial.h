@@ -27,10 +27,12 @@
 
 #pragma once
 
+#include <string.h>
 #include <PropWare/PropWare.h>
 #include <PropWare/serial/uart/uartcommondata.h>
 #include <PropWare/hmi/output/printcapable.h>
 #include <PropWare/hmi/input/scancapable.h>
+#include <PropWare/utility/utility.h>
 
 namespace PropWare {
 
@@ -38,6 +40,26 @@ void *get_full_duplex_serial_driver ();
 
 /**
  * @brief   Converted to C++ using spin2cpp and then modified to become a PrintCapable object in PropWare's arsenal.
+ *
+ * By default, the receive and transmit buffers are each FullDuplexSerial::BUFFER_SIZE bytes. At high baud rates,
+ * supply larger buffers to the constructor so that bursts are not lost while the receiving cog is busy elsewhere:
+ *
+ * @code
+ * char receiveBuffer[512];
+ * char transmitBuffer[64];
+ *
+ * int main () {
+ *     PropWare::FullDuplexSerial serial(receiveBuffer, transmitBuffer, 31, 30, 0, 230400);
+ *     serial.start();
+ *
+ *     char         line[32];
+ *     const size_t received = serial.read(line, sizeof(line), CLKFREQ / 10);
+ *     serial.write(line, received);
+ * }
+ * @endcode
+ *
+ * One slot of each buffer is always left empty, so a buffer of N bytes holds at most N - 1 bytes. Any number of cogs
+ * may transmit, but only one cog may receive.
  */
 class FullDuplexSerial : public PrintCapable,
                          public ScanCapable {
@@ -49,11 +71,12 @@ class FullDuplexSerial : public PrintCapable,
             IGNORE_TX_ECHO_ON_RX = BIT_3
         } Mode;
 
+        /** Size of the receive and transmit buffers when none are given to the constructor */
         static const size_t BUFFER_SIZE = 16;
 
     public:
         /**
-         * Construct a full-duplex, buffered UART instance
+         * Construct a full-duplex, buffered UART instance with buffers of FullDuplexSerial::BUFFER_SIZE bytes
          *
          * This object requires a dedicated cog to run the driver code. The driver must be started by invoking
          * PropWare::FullDuplexSerial::start() on this object.
@@ -69,11 +92,53 @@ class FullDuplexSerial : public PrintCapable,
                 : m_transmitLock(locknew()),
                   m_stringLock(locknew()),
                   m_cogID(-1),
+                  m_receiveHead(0),
+                  m_receiveTail(0),
+                  m_transmitHead(0),
+                  m_transmitTail(0),
                   m_receivePinNumber(rxPinNumber),
                   m_transmitPinNumber(txPinNumber),
                   m_mode(mode),
                   m_bitTicks(CLKFREQ / baudrate),
-                  m_bufferPointer((uint32_t) this->m_receiveBuffer) {
+                  m_receiveBuffer(this->m_defaultReceiveBuffer),
+                  m_transmitBuffer(this->m_defaultTransmitBuffer),
+                  m_receiveMask(BUFFER_SIZE - 1),
+                  m_transmitMask(BUFFER_SIZE - 1) {
+        }
+
+        /**
+         * Construct a full-duplex, buffered UART instance with user-supplied buffers
+         *
+         * @param receiveBuffer     Statically-allocated buffer for received bytes. Its size must be a power of two
+         * @param transmitBuffer    Statically-allocated buffer for bytes waiting to be sent. Its size must be a power
+         *                          of two
+         * @param rxPinNumber       Pin number to receive data
+         * @param txPinNumber       Pin number to transmit data
+         * @param mode              Combination of some, none, or all of the Mode values which can change the behavior
+         *                          of the device
+         * @param baudrate          Baudrate to run the transmit and recieve routines
+         */
+        template<size_t RX_SIZE, size_t TX_SIZE>
+        FullDuplexSerial (char (&receiveBuffer)[RX_SIZE], char (&transmitBuffer)[TX_SIZE],
+                          const int rxPinNumber = _cfg_rxpin, const int txPinNumber = _cfg_txpin,
+                          const uint32_t mode = 0, const int baudrate = _cfg_baudrate)
+                : m_transmitLock(locknew()),
+                  m_stringLock(locknew()),
+                  m_cogID(-1),
+                  m_receiveHead(0),
+                  m_receiveTail(0),
+                  m_transmitHead(0),
+                  m_transmitTail(0),
+                  m_receivePinNumber(rxPinNumber),
+                  m_transmitPinNumber(txPinNumber),
+                  m_mode(mode),
+                  m_bitTicks(CLKFREQ / baudrate),
+                  m_receiveBuffer(receiveBuffer),
+                  m_transmitBuffer(transmitBuffer),
+                  m_receiveMask(RX_SIZE - 1),
+                  m_transmitMask(TX_SIZE - 1) {
+            static_assert(1 < RX_SIZE && 0 == (RX_SIZE & (RX_SIZE - 1)), "Receive buffer size must be a power of two");
+            static_assert(1 < TX_SIZE && 0 == (TX_SIZE & (TX_SIZE - 1)), "Transmit buffer size must be a power of two");
         }
 
         /**
@@ -99,8 +164,7 @@ class FullDuplexSerial : public PrintCapable,
          * @brief   Empty the receive buffer
          */
         void truncate () {
-            char c;
-            while (this->get_char_non_blocking(c));
+            this->m_receiveTail = this->m_receiveHead;
         }
 
         /**
@@ -112,6 +176,13 @@ class FullDuplexSerial : public PrintCapable,
             return this->m_receiveHead != this->m_receiveTail;
         }
 
+        /**
+         * @brief   Find out how many bytes are waiting in the receive buffer
+         */
+        size_t available () const {
+            return (this->m_receiveHead - this->m_receiveTail) & this->m_receiveMask;
+        }
+
         /**
          * @brief       Check if byte received (never waits)
          *
@@ -121,8 +192,9 @@ class FullDuplexSerial : public PrintCapable,
          */
         bool get_char_non_blocking (char &c) {
             if (this->receive_ready()) {
-                c = this->m_receiveBuffer[this->m_receiveTail];
-                this->m_receiveTail = (this->m_receiveTail + 1) & 0xf;
+                const uint32_t tail = this->m_receiveTail;
+                c = this->m_receiveBuffer[tail];
+                this->m_receiveTail = (tail + 1) & this->m_receiveMask;
                 return true;
             } else
                 return false;
@@ -150,31 +222,101 @@ class FullDuplexSerial : public PrintCapable,
             return c;
         }
 
+        /**
+         * @brief       Receive up to `length` bytes, copying each span out of the receive buffer at once
+         *
+         * @param[out]  *buffer     Destination for the received bytes
+         * @param[in]   length      Number of bytes wanted
+         * @param[in]   timeout     Timeout (in clock ticks) before returning with fewer than `length` bytes
+         *
+         * @return      Number of bytes received
+         */
+        size_t read (void *buffer, const size_t length, const unsigned int timeout) {
+            const unsigned int startTime = CNT;
+            char               *destination = (char *) buffer;
+            size_t             received     = 0;
+
+            while (received < length) {
+                const uint32_t tail    = this->m_receiveTail;
+                const uint32_t waiting = (this->m_receiveHead - tail) & this->m_receiveMask;
+                if (waiting) {
+                    // Data is only valid once the head has been read
+                    Utility::memory_barrier();
+                    const size_t span = Utility::min(Utility::min((size_t) waiting, length - received),
+                                                     (size_t) (this->m_receiveMask + 1 - tail));
+                    memcpy(&destination[received], &this->m_receiveBuffer[tail], span);
+                    Utility::memory_barrier();
+                    this->m_receiveTail = (tail + span) & this->m_receiveMask;
+                    received += span;
+                } else if ((CNT - startTime) >= timeout)
+                    break;
+            }
+            return received;
+        }
+
         void put_char (const char c) {
             // Send byte (may wait for room in buffer)
             while (lockset(this->m_transmitLock));
-            while (this->m_transmitTail == ((this->m_transmitHead + 1) & 0xf));
-            this->m_transmitBuffer[this->m_transmitHead] = c;
-            this->m_transmitHead = (this->m_transmitHead + 1) & 0xf;
+            const uint32_t head = this->m_transmitHead;
+            const uint32_t next = (head + 1) & this->m_transmitMask;
+            while (this->m_transmitTail == next);
+            this->m_transmitBuffer[head] = c;
+            Utility::memory_barrier();
+            this->m_transmitHead = next;
             lockclr(this->m_transmitLock);
             if (this->m_mode & IGNORE_TX_ECHO_ON_RX)
                 this->get_char();
         }
 
+        /**
+         * @brief       Send `length` bytes, copying each span into the transmit buffer at once (may wait for room
+         *              in the buffer)
+         *
+         * Bytes from other calls to write or puts are never interleaved with these.
+         *
+         * @param[in]   *buffer     Bytes to be sent
+         * @param[in]   length      Number of bytes to send
+         */
+        void write (const void *buffer, const size_t length) {
+            const char *source = (const char *) buffer;
+
+            // Each echo must be consumed as it arrives, or a long span would overrun the receive buffer. put_char
+            // only holds the transmit lock for one byte, so the string lock keeps the whole buffer together
+            if (this->m_mode & IGNORE_TX_ECHO_ON_RX) {
+                while (lockset(this->m_stringLock));
+                for (size_t i = 0; i < length; ++i)
+                    this->put_char(source[i]);
+                lockclr(this->m_stringLock);
+                return;
+            }
+
+            while (lockset(this->m_transmitLock));
+            size_t sent = 0;
+            while (sent < length) {
+                const uint32_t head = this->m_transmitHead;
+                const uint32_t room = (this->m_transmitTail - head - 1) & this->m_transmitMask;
+                if (room) {
+                    const size_t span = Utility::min(Utility::min((size_t) room, length - sent),
+                                                     (size_t) (this->m_transmitMask + 1 - head));
+                    memcpy(&this->m_transmitBuffer[head], &source[sent], span);
+                    Utility::memory_barrier();
+                    this->m_transmitHead = (head + span) & this->m_transmitMask;
+                    sent += span;
+                }
+            }
+            lockclr(this->m_transmitLock);
+        }
+
         void puts (const char string[]) {
-            const unsigned int length = strlen(string);
-            while (lockset(this->m_stringLock));
-            for (unsigned int i = 0; i < length; i++)
-                this->put_char((string++)[0]);
-            lockclr(this->m_stringLock);
+            this->write(string, strlen(string));
         }
 
     protected:
         const uint8_t m_transmitLock;
         const uint8_t m_stringLock;
         int32_t       m_cogID;
-        char          m_receiveBuffer[BUFFER_SIZE];
-        char          m_transmitBuffer[BUFFER_SIZE];
+        char          m_defaultReceiveBuffer[BUFFER_SIZE];
+        char          m_defaultTransmitBuffer[BUFFER_SIZE];
 
         // These variables must appear in this order. The assembly code relies on the exact order
         volatile uint32_t m_receiveHead;
@@ -185,7 +327,10 @@ class FullDuplexSerial : public PrintCapable,
         const int         m_transmitPinNumber;
         const uint32_t    m_mode;
         const uint32_t    m_bitTicks;
-        const uint32_t    m_bufferPointer;
+        char *const       m_receiveBuffer;
+        char *const       m_transmitBuffer;
+        const uint32_t    m_receiveMask;
+        const uint32_t    m_transmitMask;
 };
 
 }
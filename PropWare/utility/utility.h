@@ -196,7 +196,7 @@ class Utility {
 
             for (exp = 31; x > 0; exp--)
                 x <<= 1;
-            ptr      = (unsigned short *) ((((unsigned int) x) >> 19) + 0xb000);
+            ptr      = (unsigned short *) (uintptr_t) ((((unsigned int) x) >> 19) + 0xb000);
             return (exp << 16) | *ptr;
         }
 
@@ -233,6 +233,28 @@ class Utility {
             return N;
         }
 
+        /**
+         * @brief       Determine the smaller of two values
+         */
+        template<typename T>
+        static inline T min (const T a, const T b) {
+            return a < b ? a : b;
+        }
+
+        /**
+         * @brief   Keep the compiler (and, on a host, the CPU) from reordering memory accesses across this point
+         *
+         * Use it between a shared buffer and the index that hands it to another cog. Hub RAM is accessed in order, so
+         * nothing more than a compiler barrier is needed on the Propeller
+         */
+        static inline void memory_barrier () {
+#ifdef __PROPELLER__
+            __asm__ volatile ("" : : : "memory");
+#else
+            __sync_synchronize();
+#endif
+        }
+
         /**
          * @brief   Perform hard reboot
          *
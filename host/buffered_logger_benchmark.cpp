@@ -0,0 +1,193 @@
+/**
+ * @file    buffered_logger_benchmark.cpp
+ *
+ * @author  David Zemon
+ *
+ * Runs on the host (see host/CMakeLists.txt) against a freshly formatted disk image
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <unistd.h>
+#include <thread>
+#include <PropWare/PropWare.h>
+#include <diskimage.h>
+#include <fatimage.h>
+#include <PropWare/filesystem/fat/fatfs.h>
+#include <PropWare/filesystem/fat/fatfilewriter.h>
+#include <PropWare/filesystem/bufferedfilelogger.h>
+
+using PropWare::DiskImage;
+using PropWare::FatImage;
+using PropWare::FatFS;
+using PropWare::FatFileWriter;
+using PropWare::BufferedFileLogger;
+
+/*
+ * Reports how long a producer waits to log a record, and how many records are lost, when it writes to a file directly
+ * and when it goes through a BufferedFileLogger drained by a second thread (standing in for the flusher cog). The disk
+ * image injects card latency: every write command takes a little while and every so often one stalls the way an SD
+ * card does while it erases a block.
+ *
+ *     cmake -S host -B build-host && cmake --build build-host && build-host/buffered_logger_benchmark
+ */
+
+static const char     IMAGE_PATH[]      = "buffered_logger_benchmark.img";
+static const char     LOG_NAME[]        = "bench.log";
+static const uint32_t IMAGE_SECTORS     = 70000;
+static const uint32_t WRITE_LATENCY_US  = 200;
+static const uint32_t STALL_US          = 50000;
+static const uint32_t STALL_EVERY       = 64;  // Write commands between stalls
+static const uint16_t RECORD_LENGTH     = 32;
+static const uint32_t RECORDS           = 20000;
+static const uint32_t RECORD_PERIOD_US  = 100;  // 320 kB/s
+
+/**
+ * @brief   DiskImage that takes as long to write as a (slow) SD card
+ */
+class SlowDiskImage : public DiskImage {
+    public:
+        SlowDiskImage (const char path[], const uint32_t sectors)
+                : DiskImage(path, sectors),
+                  m_injectLatency(false),
+                  m_writes(0) {
+        }
+
+        void inject_latency (const bool inject) {
+            this->m_injectLatency = inject;
+            this->m_writes        = 0;
+        }
+
+        PropWare::ErrorCode write_data_blocks (const uint32_t address, const uint32_t count,
+                                               const uint8_t dat[]) const {
+            if (this->m_injectLatency)
+                usleep(++this->m_writes % STALL_EVERY ? WRITE_LATENCY_US : STALL_US);
+            return DiskImage::write_data_blocks(address, count, dat);
+        }
+
+    private:
+        bool             m_injectLatency;
+        mutable uint32_t m_writes;
+};
+
+static SlowDiskImage g_image(IMAGE_PATH, IMAGE_SECTORS);
+static uint8_t       g_fatBuffer[DiskImage::SECTOR_SIZE];
+static uint8_t       g_buffer[DiskImage::SECTOR_SIZE];
+static uint32_t      g_stack[1];  // The flusher runs on a host thread, which brings its own stack
+
+typedef struct {
+    uint32_t worstTicks;
+    uint32_t dropped;
+} ProducerResult;
+
+/**
+ * @brief   Produce one record per period, timing every call to `log`
+ */
+template<typename Log>
+static ProducerResult produce (Log log) {
+    ProducerResult result = {0, 0};
+    char           record[RECORD_LENGTH + 1];
+    uint32_t       next   = CNT;
+
+    for (uint32_t i = 0; i < RECORDS; ++i) {
+        snprintf(record, sizeof(record), "%010u,%020u\n", i, next);
+
+        const uint32_t start = CNT;
+        if (!log(record))
+            ++result.dropped;
+        const uint32_t ticks = CNT - start;
+        if (ticks > result.worstTicks)
+            result.worstTicks = ticks;
+
+        // Keep a steady rate, unless the producer has already fallen behind
+        next += RECORD_PERIOD_US * MICROSECOND;
+        if ((int32_t) (next - CNT) > 0)
+            waitcnt(next);
+        else
+            next = CNT;
+    }
+    return result;
+}
+
+static PropWare::ErrorCode run_direct (FatFS &fs) {
+    PropWare::ErrorCode err;
+    FatFileWriter       writer(fs, LOG_NAME);
+    check_errors(writer.open());
+
+    g_image.inject_latency(true);
+    const ProducerResult result = produce([&writer] (const char record[]) {
+        return !writer.write((const uint8_t *) record, RECORD_LENGTH);
+    });
+    g_image.inject_latency(false);
+
+    pwOut.printf("\tDirect writes     %10u %9u %15s\n", result.worstTicks / MICROSECOND, result.dropped, "-");
+    check_errors(writer.close());
+    check_errors(writer.remove());
+    return writer.flush();
+}
+
+template<size_t RING_SIZE>
+static PropWare::ErrorCode run_buffered (FatFS &fs) {
+    PropWare::ErrorCode err;
+    static char         ring[RING_SIZE];
+    FatFileWriter       writer(fs, LOG_NAME);
+    check_errors(writer.open());
+
+    BufferedFileLogger logger(writer, ring, g_stack);
+    g_image.inject_latency(true);
+    std::thread flusher([&logger] () {
+        logger.run();
+    });
+    const ProducerResult result = produce([&logger] (const char record[]) {
+        return logger.append(record, RECORD_LENGTH);
+    });
+    logger.stop();
+    flusher.join();
+    g_image.inject_latency(false);
+    check_errors(logger.get_error());
+
+    pwOut.printf("\t%5u byte ring   %10u %9u %15u\n", (unsigned int) RING_SIZE, result.worstTicks / MICROSECOND,
+                 logger.get_dropped_records(), logger.get_high_water_mark());
+    check_errors(writer.close());
+    check_errors(writer.remove());
+    return writer.flush();
+}
+
+int main () {
+    PropWare::ErrorCode err;
+
+    if (!(err = g_image.start()) && !(err = FatImage::format_fat32(g_image, IMAGE_SECTORS))) {
+        FatFS fs(g_image, g_fatBuffer);
+        if (!(err = fs.mount(g_buffer))) {
+            pwOut.printf("%u records of %u bytes every %u us; writes take %u us, and every %uth stalls for %u ms\n",
+                         RECORDS, RECORD_LENGTH, RECORD_PERIOD_US, WRITE_LATENCY_US, STALL_EVERY,
+                         STALL_US / 1000);
+            pwOut.printf("\tLogging to       Worst (us)  Dropped  High-water mark\n");
+            if (!(err = run_direct(fs)) && !(err = run_buffered<4096>(fs)) && !(err = run_buffered<16384>(fs)))
+                err = run_buffered<65536>(fs);
+        }
+    }
+    unlink(IMAGE_PATH);
+
+    if (err)
+        pwOut.printf("Error: %u\n", err);
+    return err;
+}
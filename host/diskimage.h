@@ -0,0 +1,286 @@
+/**
+ * @file        host/diskimage.h
+ *
+ * @author      David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <PropWare/PropWare.h>
+#include <PropWare/memory/blockstorage.h>
+#include <PropWare/hmi/output/printer.h>
+
+#define DISK_IMAGE_ERRORS_BASE 192
+
+namespace PropWare {
+
+/**
+ * @brief   PropWare::BlockStorage backed by a disk image on the host, for running the filesystem code on a PC
+ *
+ * Every read and write is counted, making it easy to measure how many sectors a filesystem operation really touches:
+ *
+ * @code
+ * PropWare::DiskImage image("sdcard.img");
+ * PropWare::FatFS     filesystem(image);
+ * filesystem.mount();
+ *
+ * image.reset_statistics();
+ * PropWare::FatFileReader reader(filesystem, "data.txt");
+ * reader.open();
+ * printf("Opening a file read %u sectors\n", image.get_sectors_read());
+ * @endcode
+ *
+ * @note    Only available when building for the host (see host/CMakeLists.txt)
+ */
+class DiskImage : public BlockStorage {
+    public:
+        static const uint16_t SECTOR_SIZE       = 512;
+        static const uint8_t  SECTOR_SIZE_SHIFT = 9;
+
+        typedef enum {
+            /** No error */                     NO_ERROR    = 0,
+            /** First DiskImage error code */   BEG_ERROR   = DISK_IMAGE_ERRORS_BASE,
+            /** DiskImage Error 0 */            OPEN_FAILED = BEG_ERROR,
+            /** DiskImage Error 1 */            IO_FAILED,
+            /** DiskImage Error 2 */            OUT_OF_RANGE,
+            /** Last DiskImage error code */    END_ERROR   = OUT_OF_RANGE
+        } ErrorCode;
+
+    public:
+        /**
+         * @brief       Use an existing disk image
+         *
+         * @param[in]   path[]  Path to the image on the host's filesystem. It is opened by DiskImage::start
+         */
+        DiskImage (const char path[])
+                : m_path(path),
+                  m_fd(-1),
+                  m_createSectors(0) {
+            this->reset_statistics();
+        }
+
+        /**
+         * @brief       Create a blank (zero-filled) disk image of the given size, replacing any existing file
+         *
+         * @param[in]   path[]      Path to the image on the host's filesystem. It is created by DiskImage::start
+         * @param[in]   sectors     Size of the image, in sectors. The file is sparse, so large images are cheap
+         */
+        DiskImage (const char path[], const uint32_t sectors)
+                : m_path(path),
+                  m_fd(-1),
+                  m_createSectors(sectors) {
+            this->reset_statistics();
+        }
+
+        ~DiskImage () {
+            if (0 <= this->m_fd)
+                close(this->m_fd);
+        }
+
+        PropWare::ErrorCode start () const {
+            if (0 <= this->m_fd)
+                return NO_ERROR;
+
+            if (this->m_createSectors) {
+                this->m_fd = open(this->m_path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+                if (0 > this->m_fd)
+                    return OPEN_FAILED;
+                if (ftruncate(this->m_fd, (off_t) this->m_createSectors << SECTOR_SIZE_SHIFT))
+                    return IO_FAILED;
+                this->m_sectors = this->m_createSectors;
+            } else {
+                struct stat status;
+                this->m_fd = open(this->m_path, O_RDWR);
+                if (0 > this->m_fd || fstat(this->m_fd, &status))
+                    return OPEN_FAILED;
+                this->m_sectors = (uint32_t) (status.st_size >> SECTOR_SIZE_SHIFT);
+            }
+
+            return NO_ERROR;
+        }
+
+        PropWare::ErrorCode read_data_block (const uint32_t address, uint8_t buf[]) const {
+            return this->read_data_blocks(address, 1, buf);
+        }
+
+        PropWare::ErrorCode read_data_blocks (const uint32_t address, const uint32_t count, uint8_t buf[]) const {
+            PropWare::ErrorCode err;
+            check_errors(this->check_range(address, count));
+
+            const size_t bytes = (size_t) count << SECTOR_SIZE_SHIFT;
+            if ((ssize_t) bytes != pread(this->m_fd, buf, bytes, (off_t) address << SECTOR_SIZE_SHIFT))
+                return IO_FAILED;
+
+            ++this->m_readCommands;
+            this->m_sectorsRead += count;
+            return NO_ERROR;
+        }
+
+        PropWare::ErrorCode write_data_block (const uint32_t address, const uint8_t dat[]) const {
+            return this->write_data_blocks(address, 1, dat);
+        }
+
+        PropWare::ErrorCode write_data_blocks (const uint32_t address, const uint32_t count,
+                                               const uint8_t dat[]) const {
+            PropWare::ErrorCode err;
+            check_errors(this->check_range(address, count));
+
+            const size_t bytes = (size_t) count << SECTOR_SIZE_SHIFT;
+            if ((ssize_t) bytes != pwrite(this->m_fd, dat, bytes, (off_t) address << SECTOR_SIZE_SHIFT))
+                return IO_FAILED;
+
+            ++this->m_writeCommands;
+            this->m_sectorsWritten += count;
+            return NO_ERROR;
+        }
+
+        using BlockStorage::flush;
+
+        /**
+         * @brief   Ask the host to commit the image to disk
+         */
+        PropWare::ErrorCode flush () const {
+            if (0 <= this->m_fd && fsync(this->m_fd))
+                return IO_FAILED;
+            return NO_ERROR;
+        }
+
+        /**
+         * @brief   Number of sectors in the image (only valid once started)
+         */
+        uint32_t get_sector_count () const {
+            return this->m_sectors;
+        }
+
+        /**
+         * @brief   Number of sectors read since construction or the last call to DiskImage::reset_statistics
+         */
+        uint32_t get_sectors_read () const {
+            return this->m_sectorsRead;
+        }
+
+        /**
+         * @brief   Number of sectors written since construction or the last call to DiskImage::reset_statistics
+         */
+        uint32_t get_sectors_written () const {
+            return this->m_sectorsWritten;
+        }
+
+        /**
+         * @brief   Number of read transactions (single- or multi-block) since the statistics were last reset
+         */
+        uint32_t get_read_commands () const {
+            return this->m_readCommands;
+        }
+
+        /**
+         * @brief   Number of write transactions (single- or multi-block) since the statistics were last reset
+         */
+        uint32_t get_write_commands () const {
+            return this->m_writeCommands;
+        }
+
+        /**
+         * @brief   Reset all read and write counters to zero
+         */
+        void reset_statistics () const {
+            this->m_sectorsRead    = 0;
+            this->m_sectorsWritten = 0;
+            this->m_readCommands   = 0;
+            this->m_writeCommands  = 0;
+        }
+
+        uint16_t get_sector_size () const {
+            return SECTOR_SIZE;
+        }
+
+        uint8_t get_sector_size_shift () const {
+            return SECTOR_SIZE_SHIFT;
+        }
+
+        uint16_t get_short (const uint16_t offset, const uint8_t buf[]) const {
+            return (buf[offset + 1] << 8) + buf[offset];
+        }
+
+        uint32_t get_long (const uint16_t offset, const uint8_t buf[]) const {
+            return (buf[offset + 3] << 24) + (buf[offset + 2] << 16) + (buf[offset + 1] << 8) + buf[offset];
+        }
+
+        void write_short (const uint16_t offset, uint8_t buf[], const uint16_t value) const {
+            buf[offset + 1] = (uint8_t) (value >> 8);
+            buf[offset]     = (uint8_t) value;
+        }
+
+        void write_long (const uint16_t offset, uint8_t buf[], const uint32_t value) const {
+            buf[offset + 3] = (uint8_t) (value >> 24);
+            buf[offset + 2] = (uint8_t) (value >> 16);
+            buf[offset + 1] = (uint8_t) (value >> 8);
+            buf[offset]     = (uint8_t) value;
+        }
+
+        /**
+         * @brief       Describe an error code returned by a DiskImage method
+         *
+         * @param[in]   printer     Where the error should be printed
+         * @param[in]   err         The error code that was returned
+         */
+        void print_error_str (const Printer &printer, const ErrorCode err) const {
+            switch (err) {
+                case OPEN_FAILED:
+                    printer << "Unable to open disk image: " << this->m_path << '\n';
+                    break;
+                case IO_FAILED:
+                    printer << "Disk image read or write failed\n";
+                    break;
+                case OUT_OF_RANGE:
+                    printer << "Sector address beyond the end of the disk image\n";
+                    break;
+                default:
+                    printer << "Unknown error: " << (unsigned int) err << '\n';
+            }
+        }
+
+    private:
+        PropWare::ErrorCode check_range (const uint32_t address, const uint32_t count) const {
+            if (0 > this->m_fd)
+                return OPEN_FAILED;
+            else if (address >= this->m_sectors || count > this->m_sectors - address)
+                return OUT_OF_RANGE;
+            else
+                return NO_ERROR;
+        }
+
+    private:
+        const char       *m_path;
+        mutable int      m_fd;
+        const uint32_t   m_createSectors;
+        mutable uint32_t m_sectors;
+        mutable uint32_t m_sectorsRead;
+        mutable uint32_t m_sectorsWritten;
+        mutable uint32_t m_readCommands;
+        mutable uint32_t m_writeCommands;
+};
+
+}
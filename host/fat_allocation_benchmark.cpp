@@ -0,0 +1,195 @@
+/**
+ * @file    fat_allocation_benchmark.cpp
+ *
+ * @author  David Zemon
+ *
+ * Runs on the host (see host/CMakeLists.txt) against a freshly formatted disk image
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <unistd.h>
+#include <PropWare/PropWare.h>
+
+// The report walks cluster chains, which only FatFS and FatFile have access to
+#define protected public
+#define private   public
+
+#include <diskimage.h>
+#include <fatimage.h>
+#include <PropWare/filesystem/fat/fatfs.h>
+#include <PropWare/filesystem/fat/fatfilereader.h>
+#include <PropWare/filesystem/fat/fatfilewriter.h>
+
+using PropWare::DiskImage;
+using PropWare::FatImage;
+using PropWare::FatFS;
+using PropWare::FatFileReader;
+using PropWare::FatFileWriter;
+
+/*
+ * Reports how the cluster allocator lays out files on an aged volume: a few small files are created, every other one
+ * is removed to leave holes, and then several "logs" are streamed to side by side, one sector at a time. The same
+ * workload is run with first-free allocation and with the allocation unit (erase block) policy.
+ *
+ *     cmake -S host -B build-host && cmake --build build-host && build-host/fat_allocation_benchmark
+ */
+
+static const char     IMAGE_PATH[]    = "fat_allocation_benchmark.img";
+static const uint32_t IMAGE_SECTORS   = 70000;
+static const uint32_t AU_SIZE         = 64 * 1024;  // Scaled down from the 4 MB of a real SDHC card with the image
+static const uint32_t AU_SECTORS      = AU_SIZE / DiskImage::SECTOR_SIZE;
+static const uint8_t  SMALL_FILES     = 16;
+static const uint8_t  STREAMS         = 4;
+static const uint32_t STREAM_CLUSTERS = 1000;
+
+static DiskImage g_image(IMAGE_PATH, IMAGE_SECTORS);
+static uint8_t   g_fatBuffer[DiskImage::SECTOR_SIZE];
+static uint8_t   g_buffer[DiskImage::SECTOR_SIZE];
+
+static PropWare::ErrorCode age_volume (FatFS &fs) {
+    PropWare::ErrorCode err;
+    uint8_t             sector[DiskImage::SECTOR_SIZE];
+    char                name[13];
+
+    memset(sector, 's', sizeof(sector));
+    for (uint8_t i = 0; i < SMALL_FILES; ++i) {
+        sprintf(name, "small%02u.txt", i);
+        FatFileWriter writer(fs, name);
+        check_errors(writer.open());
+        for (uint8_t j = 0; j <= i % 3; ++j)
+            check_errors(writer.write(sector, sizeof(sector)));
+        check_errors(writer.close());
+    }
+    for (uint8_t i = 0; i < SMALL_FILES; i += 2) {
+        sprintf(name, "small%02u.txt", i);
+        FatFileWriter writer(fs, name);
+        check_errors(writer.remove());
+        check_errors(writer.flush());
+    }
+    return fs.sync();
+}
+
+static PropWare::ErrorCode stream (FatFS &fs) {
+    PropWare::ErrorCode err;
+    uint8_t             sector[DiskImage::SECTOR_SIZE];
+    FatFileWriter       *writers[STREAMS];
+    char                names[STREAMS][13];
+
+    memset(sector, 'L', sizeof(sector));
+    for (uint8_t i = 0; i < STREAMS; ++i) {
+        sprintf(names[i], "stream%u.log", i);
+        writers[i] = new FatFileWriter(fs, names[i]);
+        check_errors(writers[i]->open());
+    }
+    for (uint32_t cluster = 0; cluster < STREAM_CLUSTERS; ++cluster)
+        for (uint8_t i = 0; i < STREAMS; ++i)
+            check_errors(writers[i]->write(sector, sizeof(sector)));
+    for (uint8_t i = 0; i < STREAMS; ++i) {
+        check_errors(writers[i]->close());
+        delete writers[i];
+    }
+    return fs.sync();
+}
+
+static PropWare::ErrorCode report (FatFS &fs) {
+    PropWare::ErrorCode err;
+    char                name[13];
+    unsigned int        totalFragments = 0;
+    unsigned int        totalAus       = 0;
+    unsigned int        alignedStarts  = 0;
+
+    pwOut.printf("\tFile         Fragments  Erase blocks  Aligned start\n");
+    for (uint8_t i = 0; i < STREAMS; ++i) {
+        sprintf(name, "stream%u.log", i);
+        FatFileReader reader(fs, name);
+        check_errors(reader.open());
+
+        uint32_t     cluster   = reader.firstTier2;
+        uint32_t     au        = fs.compute_tier1_from_tier2(cluster) / AU_SECTORS;
+        unsigned int fragments = 1;
+        unsigned int aus       = 1;
+        const bool   aligned   = 0 == fs.compute_tier1_from_tier2(cluster) % AU_SECTORS;
+        uint32_t     next;
+        check_errors(fs.get_fat_value(cluster, &next));
+        while (!fs.is_eoc(next)) {
+            if (cluster + 1 != next)
+                ++fragments;
+            // Fragments may revisit an erase block, but every change of erase block is counted
+            const uint32_t nextAu = fs.compute_tier1_from_tier2(next) / AU_SECTORS;
+            if (nextAu != au)
+                ++aus;
+            au      = nextAu;
+            cluster = next;
+            check_errors(fs.get_fat_value(cluster, &next));
+        }
+
+        pwOut.printf("\t%s%11u%14u  %s\n", name, fragments, aus, aligned ? "yes" : "no");
+        totalFragments += fragments;
+        totalAus += aus;
+        alignedStarts += aligned;
+    }
+    pwOut.printf("\tTotal      %11u%14u  %u/%u\n", totalFragments, totalAus, alignedStarts, STREAMS);
+    pwOut.printf("\t(a stream of %u clusters needs at least %u erase blocks)\n", STREAM_CLUSTERS,
+                 (STREAM_CLUSTERS + AU_SECTORS - 1) / AU_SECTORS);
+    return 0;
+}
+
+static PropWare::ErrorCode run (const uint32_t auSize, const bool cacheFat) {
+    PropWare::ErrorCode         err;
+    static FatFS::FatCacheSlot fatCache[STREAMS + 1];
+
+    check_errors(FatImage::format_fat32(g_image, IMAGE_SECTORS));
+    FatFS fs(g_image, g_fatBuffer);
+    if (cacheFat)
+        fs.set_fat_cache(fatCache);
+    check_errors(fs.mount(g_buffer));
+    // Without a cache, the streams are deliberately passed off as one to measure what the policy costs
+    check_errors(fs.set_allocation_unit_size(auSize, cacheFat ? STREAMS : 1));
+
+    check_errors(age_volume(fs));
+    g_image.reset_statistics();
+    check_errors(stream(fs));
+    pwOut.printf("\tStreaming wrote %u sectors in %u commands\n", g_image.get_sectors_written(),
+                 g_image.get_write_commands());
+    return report(fs);
+}
+
+int main () {
+    PropWare::ErrorCode err;
+
+    if (!(err = g_image.start())) {
+        pwOut.printf("First-free allocation:\n");
+        if (!(err = run(0, false))) {
+            pwOut.printf("Erase block aligned allocation (%u byte erase blocks):\n", AU_SIZE);
+            // Streams in different erase blocks also use different FAT sectors
+            if (!(err = run(AU_SIZE, false))) {
+                pwOut.printf("Erase block aligned allocation with one FAT cache slot per stream:\n");
+                err = run(AU_SIZE, true);
+            }
+        }
+    }
+    unlink(IMAGE_PATH);
+
+    if (err)
+        pwOut.printf("Error: %u\n", err);
+    return err;
+}
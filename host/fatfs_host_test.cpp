@@ -0,0 +1,1467 @@
+/**
+ * @file    fatfs_host_test.cpp
+ *
+ * @author  David Zemon
+ *
+ * Runs on the host (see host/CMakeLists.txt) against a freshly formatted disk image
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "PropWareTests.h"
+#include <stdio.h>
+#include <diskimage.h>
+#include <fatimage.h>
+#include <PropWare/filesystem/fat/fatfs.h>
+#include <PropWare/filesystem/fat/fatfilereader.h>
+#include <PropWare/filesystem/fat/fatfilewriter.h>
+#include <PropWare/filesystem/fat/fatdirectoryiterator.h>
+#include <PropWare/filesystem/bufferedfilelogger.h>
+
+using PropWare::DiskImage;
+using PropWare::FatImage;
+using PropWare::FatFS;
+using PropWare::FatFileReader;
+using PropWare::FatFileWriter;
+using PropWare::FatDirectoryIterator;
+using PropWare::BlockStorage;
+using PropWare::BufferedFileLogger;
+
+static const char     IMAGE_PATH[]  = "fatfs_host_test.img";
+static const char     FILE_NAME[]   = "host.txt";
+static const char     LOG_NAME[]    = "log.txt";
+static const uint32_t IMAGE_SECTORS = 70000;  // Just large enough for FAT32 with one sector per cluster
+
+static DiskImage g_image(IMAGE_PATH, IMAGE_SECTORS);
+static FatFS     *testable;
+static uint8_t   g_fatBuffer[DiskImage::SECTOR_SIZE];
+static uint8_t   g_buffer[DiskImage::SECTOR_SIZE];
+
+void error_checker (const PropWare::ErrorCode err) {
+    if (DiskImage::BEG_ERROR <= err && err <= DiskImage::END_ERROR)
+        g_image.print_error_str(pwOut, (DiskImage::ErrorCode) err);
+    else if (err)
+        pwOut << "Error: " << err << '\n';
+}
+
+SETUP {
+    testable = new FatFS(g_image, g_fatBuffer);
+    const PropWare::ErrorCode err = testable->mount(g_buffer);
+    if (err) {
+        MESSAGE("Setup failed!");
+        error_checker(err);
+    }
+};
+
+TEARDOWN {
+    delete testable;
+}
+
+TEST(Mount) {
+    setUp();
+
+    ASSERT_TRUE(testable->m_mounted);
+    ASSERT_EQ_MSG(FatFS::FAT_32, testable->get_fs_type());
+    ASSERT_NEQ_MSG(0, testable->m_fsInfoSector);
+    ASSERT_NEQ_MSG(FatFS::UNKNOWN_FREE_COUNT, testable->get_free_cluster_count());
+
+    tearDown();
+}
+
+TEST(WriteThenRead) {
+    const unsigned int LENGTH = 3 * DiskImage::SECTOR_SIZE + 100;
+    PropWare::ErrorCode err;
+    uint8_t             expected[LENGTH];
+    uint8_t             actual[LENGTH];
+    setUp();
+
+    for (unsigned int i = 0; i < LENGTH; ++i)
+        expected[i] = (uint8_t) ('a' + i % 26);
+
+    const uint32_t freeCount = testable->get_free_cluster_count();
+    {
+        FatFileWriter writer(*testable, FILE_NAME);
+        err = writer.open();
+        error_checker(err);
+        ASSERT_EQ_MSG(0, err);
+        err = writer.write(expected, LENGTH);
+        error_checker(err);
+        ASSERT_EQ_MSG(0, err);
+        err = writer.close();
+        error_checker(err);
+        ASSERT_EQ_MSG(0, err);
+    }
+    ASSERT_EQ_MSG(freeCount - 4, testable->get_free_cluster_count());
+
+    g_image.reset_statistics();
+    {
+        FatFileReader reader(*testable, FILE_NAME);
+        err = reader.open();
+        error_checker(err);
+        ASSERT_EQ_MSG(0, err);
+        ASSERT_EQ_MSG(LENGTH, reader.get_length());
+        err = reader.read(actual, LENGTH);
+        error_checker(err);
+        ASSERT_EQ_MSG(0, err);
+        ASSERT_EQ_MSG(0, memcmp(expected, actual, LENGTH));
+    }
+    MESSAGE("Opening and reading %u bytes read %u sectors in %u commands", LENGTH, g_image.get_sectors_read(),
+            g_image.get_read_commands());
+    ASSERT_EQ_MSG(0, g_image.get_sectors_written());
+
+    {
+        FatFileWriter writer(*testable, FILE_NAME);
+        err = writer.remove();
+        error_checker(err);
+        ASSERT_EQ_MSG(0, err);
+        err = writer.flush();
+        error_checker(err);
+        ASSERT_EQ_MSG(0, err);
+        ASSERT_FALSE(writer.exists());
+    }
+    ASSERT_EQ_MSG(freeCount, testable->get_free_cluster_count());
+
+    tearDown();
+}
+
+TEST(Remount_keepsFreeCount) {
+    setUp();
+
+    const uint32_t freeCount = testable->get_free_cluster_count();
+    {
+        FatFileWriter writer(*testable, FILE_NAME);
+        ASSERT_EQ_MSG(0, writer.open());
+        ASSERT_EQ_MSG(0, writer.safe_put_char('x'));
+        ASSERT_EQ_MSG(0, writer.close());
+    }
+    delete testable;
+
+    // FSInfo must have been written back during unmount
+    setUp();
+    ASSERT_EQ_MSG(freeCount - 1, testable->get_free_cluster_count());
+    {
+        FatFileReader reader(*testable, FILE_NAME);
+        ASSERT_EQ_MSG(0, reader.open());
+        ASSERT_EQ_MSG('x', reader.get_char());
+    }
+    tearDown();
+}
+
+/**
+ * Append to a log while walking the cluster chain of another file - the pattern that made the single FAT buffer swap
+ * between two FAT sectors (writing the modified one back, twice) for every cluster
+ */
+static PropWare::ErrorCode append_while_walking (FatFS &fs, const uint32_t otherFile, const unsigned int clusters) {
+    PropWare::ErrorCode err;
+    uint8_t             sector[DiskImage::SECTOR_SIZE];
+    uint32_t            cluster = otherFile;
+
+    memset(sector, 'L', sizeof(sector));
+    FatFileWriter writer(fs, LOG_NAME);
+    check_errors(writer.open());
+    for (unsigned int i = 0; i < clusters; ++i) {
+        check_errors(writer.write(sector, sizeof(sector)));
+        check_errors(fs.get_fat_value(cluster, &cluster));
+        if (fs.is_eoc(cluster))
+            cluster = otherFile;
+    }
+    return writer.close();
+}
+
+static PropWare::ErrorCode remove_log (FatFS &fs) {
+    PropWare::ErrorCode err;
+    FatFileWriter       writer(fs, LOG_NAME);
+    check_errors(writer.remove());
+    check_errors(writer.flush());
+    return fs.sync();
+}
+
+static bool fat_mirror_matches (const FatFS &fs, const uint32_t fatSector) {
+    uint8_t primary[DiskImage::SECTOR_SIZE];
+    uint8_t mirror[DiskImage::SECTOR_SIZE];
+    g_image.read_data_block(fs.m_fatStart + fatSector, primary);
+    g_image.read_data_block(fs.m_fatStart + fs.m_fatSize + fatSector, mirror);
+    return 0 == memcmp(primary, mirror, sizeof(primary));
+}
+
+TEST(FatCache_defersMirrorUntilSync) {
+    const unsigned int     CLUSTERS      = 64;
+    const unsigned int     PADDING       = 300;  // Moves the log's clusters into a different FAT sector
+    static FatFS::FatCacheSlot slots[4];
+    PropWare::ErrorCode    err;
+    uint8_t                sector[DiskImage::SECTOR_SIZE];
+    uint32_t               otherFile;
+
+    // A short file at the beginning of the FAT and padding after it
+    setUp();
+    memset(sector, 'p', sizeof(sector));
+    {
+        FatFileWriter writer(*testable, FILE_NAME);
+        ASSERT_EQ_MSG(0, writer.open());
+        for (unsigned int i = 0; i < PADDING; ++i)
+            ASSERT_EQ_MSG(0, writer.write(sector, sizeof(sector)));
+        ASSERT_EQ_MSG(0, writer.close());
+        otherFile = writer.firstTier2;
+    }
+    delete testable;
+
+    // Baseline: single FAT buffer, both copies of the FAT written every time
+    testable = new FatFS(g_image, g_fatBuffer);
+    ASSERT_EQ_MSG(0, testable->mount(g_buffer));
+    g_image.reset_statistics();
+    err = append_while_walking(*testable, otherFile, CLUSTERS);
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+    ASSERT_EQ_MSG(0, testable->sync());
+    const uint32_t baselineWrites = g_image.get_sectors_written();
+    ASSERT_EQ_MSG(0, remove_log(*testable));
+    delete testable;
+
+    // Cached, with the mirror allowed to fall behind
+    testable = new FatFS(g_image, g_fatBuffer);
+    testable->set_fat_cache(slots);
+    testable->set_mirror_sync_threshold(2);
+    ASSERT_EQ_MSG(0, testable->mount(g_buffer));
+    g_image.reset_statistics();
+    err = append_while_walking(*testable, otherFile, CLUSTERS);
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+
+    FatFileReader reader(*testable, LOG_NAME);
+    ASSERT_EQ_MSG(0, reader.open());
+    const uint32_t logFatSector = reader.firstTier2 >> testable->m_entriesPerFatSector_Shift;
+    reader.close();
+    ASSERT_EQ_MSG(0, testable->flush_fat());
+    ASSERT_NEQ_MSG(0, testable->m_staleMirrorCount);
+    ASSERT_FALSE(fat_mirror_matches(*testable, logFatSector));
+
+    ASSERT_EQ_MSG(0, testable->sync());
+    const uint32_t cachedWrites = g_image.get_sectors_written();
+    ASSERT_EQ_MSG(0, testable->m_staleMirrorCount);
+    ASSERT_TRUE(fat_mirror_matches(*testable, logFatSector));
+    ASSERT_TRUE(fat_mirror_matches(*testable, 0));
+
+    MESSAGE("Appending %u clusters wrote %u sectors with a single FAT buffer, %u with a cache", CLUSTERS,
+            baselineWrites, cachedWrites);
+    ASSERT_TRUE(cachedWrites + CLUSTERS < baselineWrites);
+
+    ASSERT_EQ_MSG(0, remove_log(*testable));
+    {
+        FatFileWriter writer(*testable, FILE_NAME);
+        ASSERT_EQ_MSG(0, writer.remove());
+        ASSERT_EQ_MSG(0, writer.flush());
+    }
+    tearDown();
+}
+
+TEST(Preallocate_writesWithoutTouchingFat) {
+    const unsigned int  CLUSTERS = 64;
+    const unsigned int  PADDING  = 300;  // Moves the log's clusters into a different FAT sector
+    PropWare::ErrorCode err;
+    uint8_t             sector[DiskImage::SECTOR_SIZE];
+    uint32_t            otherFile;
+
+    setUp();
+    memset(sector, 'p', sizeof(sector));
+    {
+        FatFileWriter writer(*testable, FILE_NAME);
+        ASSERT_EQ_MSG(0, writer.open());
+        for (unsigned int i = 0; i < PADDING; ++i)
+            ASSERT_EQ_MSG(0, writer.write(sector, sizeof(sector)));
+        ASSERT_EQ_MSG(0, writer.close());
+        otherFile = writer.firstTier2;
+    }
+
+    const uint32_t freeCount = testable->get_free_cluster_count();
+    memset(sector, 'L', sizeof(sector));
+    {
+        FatFileWriter writer(*testable, LOG_NAME);
+        ASSERT_EQ_MSG(0, writer.open());
+        // A request that would take the length past INT32_MAX is refused instead of wrapping around to a small one
+        const uint32_t freeAfterOpen = testable->get_free_cluster_count();
+        ASSERT_EQ_MSG(FatFileWriter::FILE_TOO_LARGE, writer.preallocate(UINT32_MAX));
+        ASSERT_EQ_MSG(freeAfterOpen, testable->get_free_cluster_count());
+        err = writer.preallocate(CLUSTERS * DiskImage::SECTOR_SIZE);
+        error_checker(err);
+        ASSERT_EQ_MSG(0, err);
+        ASSERT_EQ_MSG(freeCount - CLUSTERS, testable->get_free_cluster_count());
+        ASSERT_EQ_MSG(0, testable->flush_fat());
+
+        // Every cluster crossing would otherwise swap the FAT buffer away from the sector being walked
+        uint32_t cluster = otherFile;
+        ASSERT_EQ_MSG(0, testable->get_fat_value(cluster, &cluster));
+        g_image.reset_statistics();
+        for (unsigned int i = 0; i < CLUSTERS - 1; ++i) {
+            ASSERT_EQ_MSG(0, writer.write(sector, sizeof(sector)));
+            ASSERT_EQ_MSG(0, testable->get_fat_value(cluster, &cluster));
+        }
+        MESSAGE("Writing %u preallocated clusters read %u sectors and wrote %u", CLUSTERS - 1,
+                g_image.get_sectors_read(), g_image.get_sectors_written());
+        ASSERT_EQ_MSG(0, g_image.get_sectors_read());
+        ASSERT_EQ_MSG(CLUSTERS - 1, g_image.get_sectors_written());
+
+        // Leaving the reserved run is the first time the FAT is consulted again
+        ASSERT_EQ_MSG(0, writer.write(sector, sizeof(sector)));
+        ASSERT_EQ_MSG(0, writer.close());
+    }
+    ASSERT_EQ_MSG(freeCount - CLUSTERS, testable->get_free_cluster_count());
+
+    // The whole log is one run of consecutive clusters
+    {
+        FatFileReader reader(*testable, LOG_NAME);
+        ASSERT_EQ_MSG(0, reader.open());
+        ASSERT_EQ_MSG(CLUSTERS * DiskImage::SECTOR_SIZE, reader.get_length());
+        uint32_t cluster = reader.firstTier2;
+        for (unsigned int i = 1; i < CLUSTERS; ++i) {
+            uint32_t next;
+            ASSERT_EQ_MSG(0, testable->get_fat_value(cluster, &next));
+            ASSERT_EQ_MSG(cluster + 1, next);
+            cluster = next;
+        }
+        ASSERT_EQ_MSG(0, testable->get_fat_value(cluster, &cluster));
+        ASSERT_TRUE(testable->is_eoc(cluster));
+    }
+
+    ASSERT_EQ_MSG(0, remove_log(*testable));
+    {
+        FatFileWriter writer(*testable, FILE_NAME);
+        ASSERT_EQ_MSG(0, writer.remove());
+        ASSERT_EQ_MSG(0, writer.flush());
+    }
+    ASSERT_EQ_MSG(freeCount + PADDING, testable->get_free_cluster_count());
+    tearDown();
+}
+
+TEST(CreateFile_extendsFullDirectory) {
+    const uint8_t FILES = 40;  // More entries than fit in the root directory's first (single-sector) cluster
+    char          name[13];
+    setUp();
+
+    for (uint8_t i = 0; i < FILES; ++i) {
+        sprintf(name, "file%02u.txt", i);
+        FatFileWriter writer(*testable, name);
+        const PropWare::ErrorCode err = writer.open();
+        error_checker(err);
+        ASSERT_EQ_MSG(0, err);
+        ASSERT_EQ_MSG(0, writer.safe_put_char((char) ('0' + i % 10)));
+        ASSERT_EQ_MSG(0, writer.close());
+    }
+
+    for (uint8_t i = 0; i < FILES; ++i) {
+        sprintf(name, "file%02u.txt", i);
+        FatFileReader reader(*testable, name);
+        ASSERT_EQ_MSG(0, reader.open());
+        ASSERT_EQ_MSG('0' + i % 10, reader.get_char());
+    }
+
+    for (uint8_t i = 0; i < FILES; ++i) {
+        sprintf(name, "file%02u.txt", i);
+        FatFileWriter writer(*testable, name);
+        ASSERT_EQ_MSG(0, writer.remove());
+        ASSERT_EQ_MSG(0, writer.flush());
+    }
+    tearDown();
+}
+
+TEST(DirectoryIterator_readsEachDirectorySectorOnce) {
+    const uint8_t FILES = 40;
+    char          name[13];
+    bool          listed[FILES];
+    uint32_t      firstClusters[FILES];
+    setUp();
+
+    for (uint8_t i = 0; i < FILES; ++i) {
+        sprintf(name, "list%02u.txt", i);
+        FatFileWriter writer(*testable, name);
+        ASSERT_EQ_MSG(0, writer.open());
+        for (uint8_t j = 0; j < i; ++j)
+            ASSERT_EQ_MSG(0, writer.safe_put_char('l'));
+        ASSERT_EQ_MSG(0, writer.close());
+        firstClusters[i] = writer.firstTier2;
+        listed[i]        = false;
+    }
+    // Leave deleted entries behind for the iterator to skip
+    for (uint8_t i = 0; i < FILES; i += 4) {
+        sprintf(name, "list%02u.txt", i);
+        FatFileWriter writer(*testable, name);
+        ASSERT_EQ_MSG(0, writer.remove());
+        ASSERT_EQ_MSG(0, writer.flush());
+    }
+
+    // Earlier tests have left deleted entries as well, so count the directory's sectors to know what to expect
+    uint32_t directorySectors = 0;
+    uint32_t cluster          = testable->m_dir_firstCluster;
+    while (!testable->is_eoc(cluster)) {
+        directorySectors += 1 << testable->get_tier1s_per_tier2_shift();
+        ASSERT_EQ_MSG(0, testable->get_fat_value(cluster, &cluster));
+    }
+
+    g_image.reset_statistics();
+    FatDirectoryIterator        iterator(*testable);
+    FatDirectoryIterator::Entry entry;
+    PropWare::ErrorCode         err;
+    unsigned int                entries = 0;
+    while (!(err = iterator.next(&entry))) {
+        unsigned int i;
+        ++entries;
+        ASSERT_EQ_MSG(1, sscanf(entry.name, "LIST%02u.TXT", &i));
+        ASSERT_TRUE(i < FILES && i % 4);
+        ASSERT_FALSE(listed[i]);
+        ASSERT_FALSE(entry.is_directory());
+        ASSERT_EQ_MSG(i, entry.size);
+        ASSERT_EQ_MSG(firstClusters[i], entry.firstCluster);
+        listed[i] = true;
+    }
+    ASSERT_EQ_MSG(FatFS::EOC_END, err);
+    ASSERT_EQ_MSG(FatFS::EOC_END, iterator.next(&entry));
+    ASSERT_EQ_MSG(FILES - FILES / 4, entries);
+    ASSERT_TRUE(g_image.get_sectors_read() <= directorySectors);
+    const uint32_t iteratorReads = g_image.get_sectors_read();
+
+    g_image.reset_statistics();
+    for (uint8_t i = 1; i < FILES; ++i) {
+        if (i % 4) {
+            sprintf(name, "list%02u.txt", i);
+            FatFileReader reader(*testable, name);
+            ASSERT_TRUE(reader.exists());
+        }
+    }
+    MESSAGE("Listing %u files read %u sectors with the iterator and %u with FatFile::find", entries, iteratorReads,
+            g_image.get_sectors_read());
+
+    for (uint8_t i = 1; i < FILES; ++i) {
+        if (i % 4) {
+            sprintf(name, "list%02u.txt", i);
+            FatFileWriter writer(*testable, name);
+            ASSERT_EQ_MSG(0, writer.remove());
+            ASSERT_EQ_MSG(0, writer.flush());
+        }
+    }
+    tearDown();
+}
+
+TEST(DirectoryIndex_scansWhenDirectoryOutgrowsIt) {
+    const uint8_t              FILES = 40;
+    FatFS::DirectoryIndexEntry index[8];  // Fewer slots than entries in a single directory sector
+    char                       name[13];
+    uint32_t                   sectorsRead[2];
+    setUp();
+
+    ASSERT_EQ_MSG(0, testable->mkdir("crowded"));
+    ASSERT_EQ_MSG(0, testable->chdir("crowded"));
+    for (uint8_t i = 0; i < FILES; ++i) {
+        sprintf(name, "full%02u.txt", i);
+        FatFileWriter writer(*testable, name);
+        ASSERT_EQ_MSG(0, writer.open());
+        ASSERT_EQ_MSG(0, writer.close());
+    }
+
+    // Look every file up twice, first without an index and then with one that is too small for the directory
+    for (uint8_t indexed = 0; indexed < 2; ++indexed) {
+        if (indexed)
+            testable->set_directory_index(index);
+        g_image.reset_statistics();
+        for (uint8_t round = 0; round < 2; ++round)
+            for (uint8_t i = 0; i < FILES; ++i) {
+                sprintf(name, "full%02u.txt", i);
+                FatFileReader reader(*testable, name);
+                ASSERT_TRUE(reader.exists());
+            }
+        sectorsRead[indexed] = g_image.get_sectors_read();
+    }
+    MESSAGE("Finding %u files twice read %u sectors without an index and %u with one too small for the directory",
+            FILES, sectorsRead[0], sectorsRead[1]);
+    ASSERT_TRUE(sectorsRead[1] <= sectorsRead[0]);
+
+    for (uint8_t i = 0; i < FILES; ++i) {
+        sprintf(name, "full%02u.txt", i);
+        FatFileWriter writer(*testable, name);
+        ASSERT_EQ_MSG(0, writer.remove());
+        ASSERT_EQ_MSG(0, writer.flush());
+    }
+    testable->set_directory_index(NULL, 0);
+    ASSERT_EQ_MSG(0, testable->chdir("/"));
+    tearDown();
+}
+
+TEST(Subdirectories_openFilesByPath) {
+    const char            CONTENT[] = "time,value\n";
+    FatFS::PathCacheEntry pathCache[4];
+    char                  c;
+    setUp();
+
+    const uint32_t root = testable->m_dir_firstCluster;
+    ASSERT_EQ_MSG(0, testable->mkdir("2026"));
+    ASSERT_EQ_MSG(0, testable->mkdir("2026/10"));
+    ASSERT_EQ_MSG(0, testable->mkdir("/2026/10/16/"));
+    ASSERT_EQ_MSG(FatFS::ENTRY_EXISTS, testable->mkdir("2026/10"));
+    ASSERT_EQ_MSG(FatFS::PATH_NOT_FOUND, testable->mkdir("2027/01"));
+    ASSERT_EQ_MSG(FatFS::INVALID_PATH, testable->mkdir("2026/longerthan8"));
+    ASSERT_EQ_MSG(FatFS::INVALID_PATH, testable->mkdir("2026/.."));
+    ASSERT_EQ_MSG(root, testable->m_dir_firstCluster);
+
+    FatFileWriter writer(*testable, "2026/10/16/run.csv");
+    ASSERT_EQ_MSG(0, writer.open());
+    for (const char *p = CONTENT; *p; ++p)
+        ASSERT_EQ_MSG(0, writer.safe_put_char(*p));
+    ASSERT_EQ_MSG(0, writer.close());
+    ASSERT_EQ_MSG(root, testable->m_dir_firstCluster);
+
+    FatFileReader notInRoot(*testable, "run.csv");
+    ASSERT_FALSE(notInRoot.exists());
+    FatFileReader reader(*testable, "2026/10/16/RUN.CSV");
+    ASSERT_EQ_MSG(0, reader.open());
+    ASSERT_EQ_MSG((unsigned int) strlen(CONTENT), reader.get_length());
+    for (const char *p = CONTENT; *p; ++p) {
+        ASSERT_EQ_MSG(0, reader.safe_get_char(c));
+        ASSERT_EQ_MSG(*p, c);
+    }
+    ASSERT_EQ_MSG(0, reader.close());
+
+    PropWare::ErrorCode err;
+    FatFileReader       throughFile(*testable, "2026/10/16/run.csv/x");
+    ASSERT_FALSE(throughFile.exists(err));
+    ASSERT_EQ_MSG(FatFS::NOT_A_DIRECTORY, err);
+    ASSERT_EQ_MSG(FatFS::NOT_A_DIRECTORY, testable->chdir("2026/10/16/run.csv"));
+    ASSERT_EQ_MSG(FatFS::PATH_NOT_FOUND, testable->chdir("2026/11"));
+    ASSERT_EQ_MSG(root, testable->m_dir_firstCluster);
+
+    // Relative paths start from the working directory
+    ASSERT_EQ_MSG(0, testable->chdir("2026/10"));
+    FatFileReader relative(*testable, "16/run.csv");
+    ASSERT_TRUE(relative.exists());
+    ASSERT_EQ_MSG(0, testable->chdir("./16"));
+
+    FatDirectoryIterator        iterator(*testable);
+    FatDirectoryIterator::Entry entry;
+    ASSERT_EQ_MSG(0, iterator.next(&entry));
+    ASSERT_EQ_MSG(0, strcmp(".", entry.name));
+    ASSERT_TRUE(entry.is_directory());
+    ASSERT_EQ_MSG(testable->m_dir_firstCluster, entry.firstCluster);
+    ASSERT_EQ_MSG(0, iterator.next(&entry));
+    ASSERT_EQ_MSG(0, strcmp("..", entry.name));
+    ASSERT_EQ_MSG(0, iterator.next(&entry));
+    ASSERT_EQ_MSG(0, strcmp("RUN.CSV", entry.name));
+    ASSERT_EQ_MSG((unsigned int) strlen(CONTENT), entry.size);
+    ASSERT_EQ_MSG(FatFS::EOC_END, iterator.next(&entry));
+
+    // ".." of a directory in the root holds cluster 0, and the root is its own parent
+    ASSERT_EQ_MSG(0, testable->chdir("../../../.."));
+    ASSERT_EQ_MSG(root, testable->m_dir_firstCluster);
+
+    g_image.reset_statistics();
+    FatFileReader uncached(*testable, "2026/10/16/run.csv");
+    ASSERT_TRUE(uncached.exists());
+    const uint32_t uncachedReads = g_image.get_sectors_read();
+
+    // With the path cache, only the final directory is read when opening a sibling
+    testable->set_path_cache(pathCache);
+    ASSERT_EQ_MSG(0, testable->chdir("/2026/10/16"));
+    ASSERT_EQ_MSG(0, testable->chdir("/"));
+    FatFileWriter sibling(*testable, "2026/10/16/run2.csv");
+    ASSERT_EQ_MSG(0, sibling.open());
+    ASSERT_EQ_MSG(0, sibling.close());
+    g_image.reset_statistics();
+    FatFileReader cached(*testable, "2026/10/16/run.csv");
+    ASSERT_TRUE(cached.exists());
+    ASSERT_EQ_MSG(1, g_image.get_sectors_read());
+    MESSAGE("Finding a file three directories deep read %u sectors without the path cache and %u with it",
+            uncachedReads, g_image.get_sectors_read());
+
+    testable->set_path_cache(NULL, 0);
+    tearDown();
+}
+
+static int32_t length_on_disk (const char name[]) {
+    FatFileReader reader(*testable, name);
+    return reader.open() ? -1 : reader.get_length();
+}
+
+TEST(SyncPolicy_groupsDirectoryUpdates) {
+    const uint8_t       WRITERS = 3;
+    const uint8_t       ROUNDS  = 10;
+    const int32_t       LENGTH  = 100;
+    const char          *names[WRITERS] = {"group0.txt", "group1.txt", "group2.txt"};
+    PropWare::ErrorCode err;
+    uint8_t             data[LENGTH];
+    uint32_t            sectorsWritten[2];
+    setUp();
+    memset(data, 'g', sizeof(data));
+
+    // Flushing every writer after every write, first with the default policy and then with explicit commits
+    for (uint8_t explicitCommits = 0; explicitCommits < 2; ++explicitCommits) {
+        FatFileWriter *writers[WRITERS];
+        for (uint8_t i = 0; i < WRITERS; ++i) {
+            writers[i] = new FatFileWriter(*testable, names[i]);
+            ASSERT_EQ_MSG(0, writers[i]->open());
+            if (explicitCommits)
+                writers[i]->set_sync_policy(FatFileWriter::SYNC_EXPLICIT);
+        }
+        ASSERT_EQ_MSG(0, testable->sync());
+
+        g_image.reset_statistics();
+        for (uint8_t round = 0; round < ROUNDS; ++round)
+            for (uint8_t i = 0; i < WRITERS; ++i) {
+                ASSERT_EQ_MSG(0, writers[i]->write(data, sizeof(data)));
+                ASSERT_EQ_MSG(0, writers[i]->flush());
+            }
+        sectorsWritten[explicitCommits] = g_image.get_sectors_written();
+
+        if (explicitCommits) {
+            // Content is safe, but the directory entries still hold the lengths from when the files were created
+            for (uint8_t i = 0; i < WRITERS; ++i)
+                ASSERT_EQ_MSG(0, length_on_disk(names[i]));
+
+            for (uint8_t i = 0; i < WRITERS; ++i)
+                ASSERT_EQ_MSG(0, writers[i]->write(data, sizeof(data)));
+            g_image.reset_statistics();
+            err = writers[0]->commit();
+            error_checker(err);
+            ASSERT_EQ_MSG(0, err);
+            // The first writer's content, both copies of the FAT sector linking the clusters added since the files were
+            // opened, and one directory sector for all three lengths
+            ASSERT_EQ_MSG(4, g_image.get_sectors_written());
+            for (uint8_t i = 0; i < WRITERS; ++i)
+                ASSERT_EQ_MSG((ROUNDS + 1) * LENGTH, length_on_disk(names[i]));
+        }
+
+        for (uint8_t i = 0; i < WRITERS; ++i) {
+            ASSERT_EQ_MSG(0, writers[i]->close());
+            delete writers[i];
+            ASSERT_EQ_MSG((ROUNDS + explicitCommits) * LENGTH, length_on_disk(names[i]));
+
+            FatFileWriter writer(*testable, names[i]);
+            ASSERT_EQ_MSG(0, writer.remove());
+            ASSERT_EQ_MSG(0, writer.flush());
+        }
+    }
+
+    MESSAGE("%u flushes wrote %u sectors when syncing on every flush, %u with explicit commits",
+            WRITERS * ROUNDS, sectorsWritten[0], sectorsWritten[1]);
+    // Exactly one directory sector write saved per flush. Syncing on flush also writes both copies of the FAT sector
+    // once per writer, when its first cluster is linked, because the FAT always reaches the card before a length
+    ASSERT_EQ_MSG(sectorsWritten[1] + WRITERS * ROUNDS + WRITERS * 2, sectorsWritten[0]);
+    tearDown();
+}
+
+TEST(SyncPolicy_commitsEveryNBytes) {
+    uint8_t data[DiskImage::SECTOR_SIZE];
+    setUp();
+    memset(data, 'n', sizeof(data));
+
+    {
+        FatFileWriter writer(*testable, LOG_NAME);
+        ASSERT_EQ_MSG(0, writer.open());
+        writer.set_sync_policy(FatFileWriter::SYNC_EVERY_N_BYTES, 3 * DiskImage::SECTOR_SIZE / 2);
+
+        ASSERT_EQ_MSG(0, writer.write(data, sizeof(data)));
+        ASSERT_EQ_MSG(0, writer.flush());
+        ASSERT_EQ_MSG(0, length_on_disk(LOG_NAME));
+
+        ASSERT_EQ_MSG(0, writer.write(data, sizeof(data)));
+        ASSERT_EQ_MSG(2 * DiskImage::SECTOR_SIZE, length_on_disk(LOG_NAME));
+
+        // Not due again until another 768 bytes are written
+        ASSERT_EQ_MSG(0, writer.write(data, 100));
+        ASSERT_EQ_MSG(2 * DiskImage::SECTOR_SIZE, length_on_disk(LOG_NAME));
+    }
+    ASSERT_EQ_MSG(2 * DiskImage::SECTOR_SIZE + 100, length_on_disk(LOG_NAME));
+
+    ASSERT_EQ_MSG(0, remove_log(*testable));
+    tearDown();
+}
+
+TEST(SyncPolicy_commitsEveryNMilliseconds) {
+    setUp();
+
+    {
+        FatFileWriter writer(*testable, LOG_NAME);
+        ASSERT_EQ_MSG(0, writer.open());
+        writer.set_sync_policy(FatFileWriter::SYNC_EVERY_N_MILLISECONDS, 5);
+
+        ASSERT_EQ_MSG(0, writer.safe_put_char('a'));
+        ASSERT_EQ_MSG(0, length_on_disk(LOG_NAME));
+
+        waitcnt(CNT + 5 * MILLISECOND);
+        ASSERT_EQ_MSG(0, writer.safe_put_char('b'));
+        ASSERT_EQ_MSG(2, length_on_disk(LOG_NAME));
+    }
+
+    ASSERT_EQ_MSG(0, remove_log(*testable));
+    tearDown();
+}
+
+/**
+ * @brief   Read a FAT32 entry straight from the image, bypassing the FAT buffer and cache
+ */
+static uint32_t fat_entry_on_disk (const FatFS &fs, const uint32_t cluster) {
+    const uint32_t entryMask = (1U << fs.m_entriesPerFatSector_Shift) - 1;
+    uint8_t        sector[DiskImage::SECTOR_SIZE];
+    g_image.read_data_block(fs.m_fatStart + (cluster >> fs.m_entriesPerFatSector_Shift), sector);
+    return g_image.get_long((uint16_t) ((cluster & entryMask) << 2), sector) & 0x0FFFFFFF;
+}
+
+TEST(Close_writesFatBeforeLength) {
+    const unsigned int CLUSTERS = 3;
+    uint8_t            data[DiskImage::SECTOR_SIZE];
+    uint32_t           cluster;
+    setUp();
+    memset(data, 'c', sizeof(data));
+
+    {
+        FatFileWriter writer(*testable, LOG_NAME);
+        ASSERT_EQ_MSG(0, writer.open());
+        writer.set_sync_policy(FatFileWriter::SYNC_EXPLICIT);
+        for (unsigned int i = 0; i < CLUSTERS; ++i)
+            ASSERT_EQ_MSG(0, writer.write(data, sizeof(data)));
+        ASSERT_EQ_MSG(0, writer.close());
+        cluster = writer.firstTier2;
+    }
+
+    // The length written by close() covers every cluster, so every link must already be on disk
+    for (unsigned int i = 1; i < CLUSTERS; ++i) {
+        cluster = fat_entry_on_disk(*testable, cluster);
+        ASSERT_FALSE(0 == cluster || testable->is_eoc(cluster));
+    }
+    ASSERT_TRUE(testable->is_eoc(fat_entry_on_disk(*testable, cluster)));
+    ASSERT_EQ_MSG((int32_t) (CLUSTERS * DiskImage::SECTOR_SIZE), length_on_disk(LOG_NAME));
+
+    ASSERT_EQ_MSG(0, remove_log(*testable));
+    tearDown();
+}
+
+TEST(OpenAppend_findsLastClusterWithMultiBlockReads) {
+    const unsigned int  CLUSTERS = 1000;  // Spans eight FAT sectors
+    const unsigned int  TAIL     = 100;  // The log ends part way through a cluster
+    PropWare::ErrorCode err;
+    uint8_t             sector[DiskImage::SECTOR_SIZE];
+    uint8_t             scratch[4 * DiskImage::SECTOR_SIZE];
+    uint32_t            readCommands[2];
+    setUp();
+
+    memset(sector, 'o', sizeof(sector));
+    {
+        FatFileWriter writer(*testable, LOG_NAME);
+        ASSERT_EQ_MSG(0, writer.open());
+        for (unsigned int i = 0; i < CLUSTERS; ++i)
+            ASSERT_EQ_MSG(0, writer.write(sector, sizeof(sector)));
+        ASSERT_EQ_MSG(0, writer.write(sector, TAIL));
+    }
+
+    // Baseline: open, seek to the end and append a single character
+    delete testable;
+    setUp();
+    g_image.reset_statistics();
+    {
+        FatFileWriter writer(*testable, LOG_NAME);
+        ASSERT_EQ_MSG(0, writer.open());
+        ASSERT_EQ_MSG(0, writer.seek(writer.get_length()));
+        ASSERT_EQ_MSG(0, writer.safe_put_char('1'));
+        readCommands[0] = g_image.get_read_commands();
+    }
+
+    delete testable;
+    setUp();
+    g_image.reset_statistics();
+    {
+        FatFileWriter writer(*testable, LOG_NAME);
+        err = writer.open_append(scratch, sizeof(scratch) / DiskImage::SECTOR_SIZE);
+        error_checker(err);
+        ASSERT_EQ_MSG(0, err);
+        ASSERT_EQ_MSG(CLUSTERS * DiskImage::SECTOR_SIZE + TAIL + 1, writer.tell());
+        ASSERT_EQ_MSG(0, writer.safe_put_char('2'));
+        readCommands[1] = g_image.get_read_commands();
+
+        // Crossing into a new cluster extends the chain as usual
+        ASSERT_EQ_MSG(0, writer.write(sector, sizeof(sector)));
+    }
+    MESSAGE("Appending read the device %u times with open and seek, %u times with open_append", readCommands[0],
+            readCommands[1]);
+    ASSERT_TRUE(readCommands[1] < readCommands[0]);
+
+    {
+        FatFileReader reader(*testable, LOG_NAME);
+        ASSERT_EQ_MSG(0, reader.open());
+        ASSERT_EQ_MSG((CLUSTERS + 1) * DiskImage::SECTOR_SIZE + TAIL + 2, reader.get_length());
+        ASSERT_EQ_MSG(0, reader.seek(CLUSTERS * DiskImage::SECTOR_SIZE + TAIL - 1));
+        ASSERT_EQ_MSG('o', reader.get_char());
+        ASSERT_EQ_MSG('1', reader.get_char());
+        ASSERT_EQ_MSG('2', reader.get_char());
+        ASSERT_EQ_MSG('o', reader.get_char());
+    }
+
+    ASSERT_EQ_MSG(0, remove_log(*testable));
+    tearDown();
+}
+
+TEST(BufferedFileLogger_dropsWholeRecordsWhenFull) {
+    const int32_t RECORD_LENGTH = 32;
+    const int32_t RECORDS       = 30;  // 960 bytes: one whole sector and a partial one
+    static char   ring[1024];
+    uint32_t      stack[1];  // The flusher is run on this thread
+    char          record[RECORD_LENGTH];
+    char          contents[RECORDS * RECORD_LENGTH];
+    setUp();
+
+    {
+        FatFileWriter writer(*testable, LOG_NAME);
+        ASSERT_EQ_MSG(0, writer.open());
+        BufferedFileLogger logger(writer, ring, stack);
+
+        for (int32_t i = 0; i < RECORDS; ++i) {
+            memset(record, 'a' + i % 26, RECORD_LENGTH);
+            ASSERT_TRUE(logger.append(record, RECORD_LENGTH));
+        }
+        ASSERT_EQ_MSG(RECORDS * RECORD_LENGTH, logger.get_high_water_mark());
+
+        // Too long for the 64 bytes left, so none of it may be queued
+        ASSERT_FALSE(logger.append(contents, 100));
+        ASSERT_EQ_MSG(1, logger.get_dropped_records());
+        ASSERT_EQ_MSG(100, logger.get_dropped_bytes());
+        ASSERT_EQ_MSG(RECORDS * RECORD_LENGTH, logger.get_pending_bytes());
+
+        logger.stop();
+        logger.run();
+        ASSERT_FALSE(logger.is_running());
+        ASSERT_EQ_MSG(0, logger.get_error());
+        ASSERT_EQ_MSG(0, logger.get_pending_bytes());
+        ASSERT_EQ_MSG(RECORDS * RECORD_LENGTH, writer.get_length());
+        ASSERT_EQ_MSG(0, writer.close());
+    }
+
+    {
+        FatFileReader reader(*testable, LOG_NAME);
+        ASSERT_EQ_MSG(0, reader.open());
+        ASSERT_EQ_MSG(0, reader.read((uint8_t *) contents, RECORDS * RECORD_LENGTH));
+    }
+    for (int32_t i = 0; i < RECORDS * RECORD_LENGTH; ++i)
+        ASSERT_EQ_MSG('a' + i / RECORD_LENGTH % 26, contents[i]);
+
+    ASSERT_EQ_MSG(0, remove_log(*testable));
+    tearDown();
+}
+
+/**
+ * Records where each write to the file ends, to check how the logger splits its drains
+ */
+class EndRecordingWriter : public FatFileWriter {
+    public:
+        EndRecordingWriter (FatFS &fs, const char name[])
+                : File(fs, name, PropWare::SHARED_BUFFER),
+                  FatFile(fs, name, PropWare::SHARED_BUFFER),
+                  FileWriter(fs, name, PropWare::SHARED_BUFFER),
+                  FatFileWriter(fs, name),
+                  writes(0) {
+        }
+
+        PropWare::ErrorCode write (const uint8_t *src, size_t len) {
+            const PropWare::ErrorCode err = FatFileWriter::write(src, len);
+            if (!err && writes < MAX_WRITES)
+                ends[writes++] = this->tell();
+            return err;
+        }
+
+    public:
+        static const unsigned int MAX_WRITES = 8;
+        int32_t                   ends[MAX_WRITES];
+        unsigned int              writes;
+};
+
+TEST(BufferedFileLogger_alignsDrainsToAppendedFile) {
+    const int32_t RECORD_LENGTH = 32;
+    const int32_t HEAD          = 100;  // Leaves the file part-way into its first sector
+    const int32_t RECORDS       = 40;   // 1280 bytes: completes the first sector, one whole sector and a partial one
+    static char   ring[2048];
+    uint32_t      stack[1];  // The flusher is run on this thread
+    char          record[RECORD_LENGTH];
+    setUp();
+
+    {
+        FatFileWriter writer(*testable, LOG_NAME);
+        ASSERT_EQ_MSG(0, writer.open());
+        memset(record, '-', RECORD_LENGTH);
+        for (int32_t i = 0; i < HEAD; i += 4)
+            ASSERT_EQ_MSG(0, writer.write((const uint8_t *) record, 4));
+        ASSERT_EQ_MSG(0, writer.close());
+    }
+
+    {
+        EndRecordingWriter writer(*testable, LOG_NAME);
+        ASSERT_EQ_MSG(0, writer.open_append());
+        BufferedFileLogger logger(writer, ring, stack);
+
+        for (int32_t i = 0; i < RECORDS; ++i) {
+            memset(record, 'a' + i % 26, RECORD_LENGTH);
+            ASSERT_TRUE(logger.append(record, RECORD_LENGTH));
+        }
+
+        logger.stop();
+        logger.run();
+        ASSERT_EQ_MSG(0, logger.get_error());
+        ASSERT_EQ_MSG(HEAD + RECORDS * RECORD_LENGTH, writer.get_length());
+        ASSERT_EQ_MSG(0, writer.close());
+
+        // Every drain but the final, partial one ends on a sector boundary of the file
+        ASSERT_TRUE(1 < writer.writes);
+        for (unsigned int i = 0; i < writer.writes - 1; ++i)
+            ASSERT_EQ_MSG(0, writer.ends[i] % DiskImage::SECTOR_SIZE);
+        ASSERT_EQ_MSG(HEAD + RECORDS * RECORD_LENGTH, writer.ends[writer.writes - 1]);
+    }
+
+    {
+        FatFileReader reader(*testable, LOG_NAME);
+        ASSERT_EQ_MSG(0, reader.open());
+        ASSERT_EQ_MSG(0, reader.seek(HEAD - 1));
+        ASSERT_EQ_MSG('-', reader.get_char());
+        ASSERT_EQ_MSG('a', reader.get_char());
+    }
+
+    ASSERT_EQ_MSG(0, remove_log(*testable));
+    tearDown();
+}
+
+static const uint32_t AU_SIZE = 64 * 1024;
+
+TEST(AllocationUnits_keepInterleavedFilesAligned) {
+    const unsigned int  CLUSTERS   = 300;
+    const uint32_t      AU_SECTORS = AU_SIZE / DiskImage::SECTOR_SIZE;
+    const char          *names[2]  = {FILE_NAME, LOG_NAME};
+    PropWare::ErrorCode err;
+    uint8_t             sector[DiskImage::SECTOR_SIZE];
+
+    setUp();
+    // Interleaved files are refused without a FAT cache to hold their FAT sectors. Only placement is checked here,
+    // so the files are declared as a single stream
+    ASSERT_EQ_MSG(FatFS::FAT_CACHE_TOO_SMALL, testable->set_allocation_unit_size(AU_SIZE, 2));
+    ASSERT_FALSE(testable->is_allocation_unit_start(testable->m_nextFreeHint));
+    ASSERT_EQ_MSG(0, testable->set_allocation_unit_size(AU_SIZE));
+    const uint32_t freeCount = testable->get_free_cluster_count();
+
+    // Two files growing side by side would take alternate clusters with first-free allocation
+    memset(sector, 'a', sizeof(sector));
+    {
+        FatFileWriter first(*testable, names[0]);
+        FatFileWriter second(*testable, names[1]);
+        ASSERT_EQ_MSG(0, first.open());
+        ASSERT_EQ_MSG(0, second.open());
+        for (unsigned int i = 0; i < CLUSTERS; ++i) {
+            err = first.write(sector, sizeof(sector));
+            error_checker(err);
+            ASSERT_EQ_MSG(0, err);
+            err = second.write(sector, sizeof(sector));
+            error_checker(err);
+            ASSERT_EQ_MSG(0, err);
+        }
+        ASSERT_EQ_MSG(0, first.close());
+        ASSERT_EQ_MSG(0, second.close());
+    }
+    ASSERT_EQ_MSG(freeCount - 2 * CLUSTERS, testable->get_free_cluster_count());
+
+    // Each file starts on an erase block boundary and fills as few erase blocks as possible
+    for (unsigned int file = 0; file < 2; ++file) {
+        FatFileReader reader(*testable, names[file]);
+        ASSERT_EQ_MSG(0, reader.open());
+        uint32_t cluster = reader.firstTier2;
+        ASSERT_TRUE(testable->is_allocation_unit_start(cluster));
+        ASSERT_EQ_MSG(0, testable->compute_tier1_from_tier2(cluster) % AU_SECTORS);
+
+        unsigned int eraseBlocks = 1;
+        uint32_t     next;
+        ASSERT_EQ_MSG(0, testable->get_fat_value(cluster, &next));
+        while (!testable->is_eoc(next)) {
+            // Clusters in use by others are skipped within the erase block
+            if (testable->is_allocation_unit_start(next)) {
+                ++eraseBlocks;
+            } else {
+                ASSERT_TRUE(cluster < next);
+                ASSERT_TRUE(next < testable->next_allocation_unit_start(cluster + 1));
+            }
+            cluster = next;
+            ASSERT_EQ_MSG(0, testable->get_fat_value(cluster, &next));
+        }
+        ASSERT_EQ_MSG((CLUSTERS + AU_SECTORS - 1) / AU_SECTORS, eraseBlocks);
+    }
+
+    for (unsigned int file = 0; file < 2; ++file) {
+        FatFileWriter writer(*testable, names[file]);
+        ASSERT_EQ_MSG(0, writer.remove());
+        ASSERT_EQ_MSG(0, writer.flush());
+    }
+    ASSERT_EQ_MSG(freeCount, testable->get_free_cluster_count());
+    tearDown();
+}
+
+TEST(AllocationUnits_leaveErasedBlocksToFiles) {
+    setUp();
+
+    // Leave the first free cluster part way into an erase block
+    FatFileWriter filler(*testable, LOG_NAME);
+    ASSERT_EQ_MSG(0, filler.open());
+    ASSERT_EQ_MSG(0, filler.safe_put_char('a'));
+    ASSERT_EQ_MSG(0, filler.close());
+    ASSERT_EQ_MSG(0, testable->set_allocation_unit_size(AU_SIZE));
+    const uint32_t firstFree = testable->m_nextFreeHint;
+    const uint32_t root      = testable->m_dir_firstCluster;
+    ASSERT_FALSE(testable->is_allocation_unit_start(firstFree));
+
+    ASSERT_EQ_MSG(0, testable->mkdir("LOGS"));
+    ASSERT_EQ_MSG(0, testable->chdir("LOGS"));
+    const uint32_t directory = testable->m_dir_firstCluster;
+    ASSERT_EQ_MSG(0, testable->chdir("/"));
+    ASSERT_EQ_MSG(root, testable->m_dir_firstCluster);
+
+    // The directory fills in the partly used erase block instead of claiming an empty one
+    const uint32_t nextAllocUnit = testable->next_allocation_unit_start(firstFree);
+    ASSERT_TRUE(firstFree <= directory);
+    ASSERT_TRUE(directory < nextAllocUnit);
+
+    FatFileWriter writer(*testable, FILE_NAME);
+    ASSERT_EQ_MSG(0, writer.open());
+    ASSERT_EQ_MSG(0, writer.safe_put_char('a'));
+    ASSERT_EQ_MSG(nextAllocUnit, writer.firstTier2);
+    ASSERT_EQ_MSG(0, writer.remove());
+    ASSERT_EQ_MSG(0, writer.flush());
+    ASSERT_EQ_MSG(0, filler.remove());
+    ASSERT_EQ_MSG(0, filler.flush());
+    tearDown();
+}
+
+TEST(BorrowSector_accessesBufferInPlace) {
+    const unsigned int  LENGTH = 3 * DiskImage::SECTOR_SIZE + 100;
+    PropWare::ErrorCode err;
+    uint8_t             *data;
+    const uint8_t       *readOnly;
+    uint16_t            length;
+    setUp();
+
+    // Fill a new file directly in its buffer, a sector (or the rest of one) at a time. Sectors past the end of the
+    // file are handed out cleared, without being read from the device
+    {
+        FatFileWriter writer(*testable, FILE_NAME);
+        ASSERT_EQ_MSG(0, writer.open());
+        g_image.reset_statistics();
+        for (int32_t offset = 0; offset < (int32_t) LENGTH; offset += length) {
+            err = writer.borrow_sector(offset, &data, &length);
+            error_checker(err);
+            ASSERT_EQ_MSG(0, err);
+            for (uint16_t i = 0; i < length; ++i)
+                ASSERT_EQ_MSG(0, data[i]);
+            if (LENGTH - offset < length)
+                length = (uint16_t) (LENGTH - offset);
+            for (uint16_t i = 0; i < length; ++i)
+                data[i] = (uint8_t) ('a' + (offset + i) % 26);
+            ASSERT_EQ_MSG(0, writer.release_sector(length));
+        }
+        ASSERT_EQ_MSG((int32_t) LENGTH, writer.get_length());
+        ASSERT_EQ_MSG(0, writer.tell());
+        ASSERT_EQ_MSG(0, g_image.get_sectors_read());
+
+        // Overwrite a few bytes in the middle of a sector
+        ASSERT_EQ_MSG(0, writer.borrow_sector(DiskImage::SECTOR_SIZE + 10, &data, &length));
+        ASSERT_EQ_MSG(DiskImage::SECTOR_SIZE - 10, length);
+        memcpy(data, "XYZ", 3);
+        ASSERT_EQ_MSG(0, writer.release_sector(3));
+        ASSERT_EQ_MSG((int32_t) LENGTH, writer.get_length());
+
+        ASSERT_EQ_MSG(PropWare::File::EOF_ERROR, writer.borrow_sector(LENGTH + 1, &data, &length));
+        ASSERT_EQ_MSG(FatFileWriter::SECTOR_NOT_BORROWED, writer.release_sector(0));
+        ASSERT_EQ_MSG(0, writer.close());
+    }
+
+    // Read it back in place: every sector is read once (the first one by open) and nothing is copied
+    {
+        FatFileReader reader(*testable, FILE_NAME);
+        ASSERT_EQ_MSG(0, reader.open());
+        g_image.reset_statistics();
+        for (int32_t offset = 0; offset < (int32_t) LENGTH; offset += length) {
+            err = reader.borrow_sector(offset, &readOnly, &length);
+            error_checker(err);
+            ASSERT_EQ_MSG(0, err);
+            ASSERT_TRUE(length <= LENGTH - offset);
+            for (uint16_t i = 0; i < length; ++i) {
+                const int32_t position = offset + i;
+                uint8_t       expected = (uint8_t) ('a' + position % 26);
+                if (DiskImage::SECTOR_SIZE + 10 <= position && position < DiskImage::SECTOR_SIZE + 13)
+                    expected = (uint8_t) ("XYZ"[position - DiskImage::SECTOR_SIZE - 10]);
+                ASSERT_EQ_MSG(expected, readOnly[i]);
+            }
+            ASSERT_EQ_MSG(0, reader.release_sector());
+        }
+        ASSERT_EQ_MSG(0, reader.tell());
+        ASSERT_EQ_MSG(PropWare::File::EOF_ERROR, reader.borrow_sector(LENGTH, &readOnly, &length));
+        ASSERT_EQ_MSG(LENGTH / DiskImage::SECTOR_SIZE, g_image.get_sectors_read());
+
+        // A sector that was taken back by another file (sharing the buffer) is reported
+        ASSERT_EQ_MSG(0, reader.borrow_sector(0, &readOnly, &length));
+        FatFileReader other(*testable, FILE_NAME);
+        ASSERT_EQ_MSG(0, other.open());
+        ASSERT_EQ_MSG(FatFileReader::SECTOR_NOT_BORROWED, reader.release_sector());
+    }
+
+    {
+        FatFileWriter writer(*testable, FILE_NAME);
+        ASSERT_EQ_MSG(0, writer.remove());
+        ASSERT_EQ_MSG(0, writer.flush());
+    }
+    tearDown();
+}
+
+static const char     EXFAT_IMAGE_PATH[]  = "exfat_host_test.img";
+static const uint32_t EXFAT_IMAGE_SECTORS = 8192;
+
+/**
+ * Independent implementations of the exFAT entry set checksum and name hash, for checking what the filesystem writes
+ */
+static uint16_t exfat_checksum (const uint8_t set[], const unsigned int entries) {
+    uint16_t checksum = 0;
+    for (unsigned int i = 0; i < entries * 32; ++i)
+        if (2 != i && 3 != i)
+            checksum = (uint16_t) ((checksum << 15) | (checksum >> 1)) + set[i];
+    return checksum;
+}
+
+static uint16_t exfat_name_hash (const char name[]) {
+    uint16_t hash = 0;
+    for (; *name; ++name) {
+        const uint16_t c = (uint16_t) ('a' <= *name && *name <= 'z' ? *name - 'a' + 'A' : *name);
+        hash = (uint16_t) ((hash << 15) | (hash >> 1)) + (uint8_t) c;
+        hash = (uint16_t) ((hash << 15) | (hash >> 1)) + (uint8_t) (c >> 8);
+    }
+    return hash;
+}
+
+static bool exfat_volume_dirty (const DiskImage &image) {
+    uint8_t bootSector[DiskImage::SECTOR_SIZE];
+    image.read_data_block(0, bootSector);
+    return 0 != (0x02 & bootSector[0x6A]);
+}
+
+static PropWare::ErrorCode read_exfat_set (const char name[], uint8_t set[]) {
+    PropWare::ErrorCode err;
+    uint16_t            offset;
+    uint8_t             entries;
+    check_errors(testable->find_entry_set(&PropWare::SHARED_BUFFER, testable->m_rootCluster, name,
+                                          (uint8_t) strlen(name), &offset));
+    return testable->read_entry_set(&PropWare::SHARED_BUFFER, offset, set, &entries);
+}
+
+static PropWare::ErrorCode write_pattern (const char name[], const unsigned int length, const bool append) {
+    PropWare::ErrorCode err;
+    FatFileWriter       writer(*testable, name);
+    check_errors(append ? writer.open_append() : writer.open());
+    for (unsigned int i = 0; i < length; ++i) {
+        check_errors(writer.safe_put_char((char) ('a' + i % 26)));
+    }
+    return writer.close();
+}
+
+static bool pattern_matches (const char name[], const unsigned int length) {
+    char          c;
+    FatFileReader reader(*testable, name);
+    if (reader.open() || (int32_t) length != reader.get_length())
+        return false;
+    for (unsigned int i = 0; i < length; ++i)
+        if (reader.safe_get_char(c) || (char) ('a' + i % 26) != c)
+            return false;
+    return true;
+}
+
+TEST(ExFat_contiguousFilesSkipTheFat) {
+    const char          NAME[]    = "Contiguous Data.bin";
+    const unsigned int  LENGTH    = 5 * DiskImage::SECTOR_SIZE + 17;
+    const unsigned int  APPENDED  = DiskImage::SECTOR_SIZE + 100;
+    const unsigned int  CLUSTERS  = 6;
+    DiskImage           image(EXFAT_IMAGE_PATH, EXFAT_IMAGE_SECTORS);
+    PropWare::ErrorCode err;
+    uint8_t             set[FatFS::EXFAT_MAX_SET_ENTRIES * FatFS::DIR_ENTRY_LENGTH];
+    uint32_t            fatValue;
+    bool                isFree;
+
+    testable = new FatFS(image, g_fatBuffer);
+    ASSERT_EQ_MSG(0, image.start());
+    ASSERT_EQ_MSG(0, FatImage::format_exfat(image, EXFAT_IMAGE_SECTORS, 0));
+    ASSERT_EQ_MSG(0, testable->mount(g_buffer));
+    ASSERT_EQ_MSG(FatFS::EX_FAT, testable->get_fs_type());
+    ASSERT_EQ_MSG(0, strcmp("PROPWARE", testable->m_label));
+    ASSERT_FALSE(exfat_volume_dirty(image));
+
+    err = write_pattern(NAME, LENGTH, false);
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+    ASSERT_TRUE(exfat_volume_dirty(image));
+
+    // One File entry, a stream extension and two name entries, marked as needing no FAT chain
+    ASSERT_EQ_MSG(0, read_exfat_set(NAME, set));
+    const uint8_t  *stream = &set[FatFS::DIR_ENTRY_LENGTH];
+    const uint32_t first   = image.get_long(FatFS::EXFAT_FIRST_CLUSTER, stream);
+    ASSERT_EQ_MSG(3, set[FatFS::EXFAT_SECONDARY_COUNT]);
+    ASSERT_EQ_MSG(exfat_checksum(set, 4), image.get_short(FatFS::EXFAT_SET_CHECKSUM, set));
+    ASSERT_EQ_MSG(exfat_name_hash(NAME), image.get_short(FatFS::EXFAT_NAME_HASH, stream));
+    const unsigned int contiguous = FatFS::EXFAT_ALLOC_POSSIBLE | FatFS::EXFAT_NO_FAT_CHAIN;
+    ASSERT_EQ_MSG(contiguous, stream[FatFS::EXFAT_FLAGS]);
+    ASSERT_EQ_MSG(LENGTH, image.get_long(FatFS::EXFAT_DATA_LENGTH, stream));
+    ASSERT_EQ_MSG(LENGTH, image.get_long(FatFS::EXFAT_VALID_DATA_LENGTH, stream));
+    for (unsigned int i = 0; i < CLUSTERS; ++i) {
+        ASSERT_EQ_MSG(0, testable->get_fat_value(first + i, &fatValue));
+        ASSERT_EQ_MSG(0, fatValue);
+        ASSERT_EQ_MSG(0, testable->cluster_is_free(first + i, &isFree));
+        ASSERT_FALSE(isFree);
+    }
+    ASSERT_EQ_MSG(0, testable->cluster_is_free(first + CLUSTERS, &isFree));
+    ASSERT_TRUE(isFree);
+
+    // The volume is clean again once unmounted, and the file survives
+    delete testable;
+    ASSERT_FALSE(exfat_volume_dirty(image));
+    testable = new FatFS(image, g_fatBuffer);
+    ASSERT_EQ_MSG(0, testable->mount(g_buffer));
+
+    // Reading the file needs the directory sector and the file's own sectors - never the FAT
+    image.reset_statistics();
+    ASSERT_TRUE(pattern_matches("CONTIGUOUS DATA.BIN", LENGTH));
+    ASSERT_EQ_MSG(1 + CLUSTERS, image.get_sectors_read());
+
+    // A file in the way forces the first one onto a FAT chain when it grows
+    ASSERT_EQ_MSG(0, write_pattern("blocker", 1, false));
+    err = write_pattern(NAME, APPENDED, true);
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+    ASSERT_EQ_MSG(0, read_exfat_set(NAME, set));
+    ASSERT_EQ_MSG((unsigned int) FatFS::EXFAT_ALLOC_POSSIBLE, stream[FatFS::EXFAT_FLAGS]);
+    ASSERT_EQ_MSG(LENGTH + APPENDED, image.get_long(FatFS::EXFAT_DATA_LENGTH, stream));
+    ASSERT_EQ_MSG(exfat_checksum(set, 4), image.get_short(FatFS::EXFAT_SET_CHECKSUM, set));
+    for (unsigned int i = 0; i + 1 < CLUSTERS; ++i) {
+        ASSERT_EQ_MSG(0, testable->get_fat_value(first + i, &fatValue));
+        ASSERT_EQ_MSG(first + i + 1, fatValue);
+    }
+    ASSERT_EQ_MSG(0, testable->get_fat_value(first + CLUSTERS - 1, &fatValue));
+    ASSERT_TRUE(first + CLUSTERS + 1 <= fatValue);
+    {
+        // Bytes of the original file and the appended ones, in one pattern-checking pass per write
+        FatFileReader reader(*testable, NAME);
+        char          c;
+        ASSERT_EQ_MSG(0, reader.open());
+        ASSERT_EQ_MSG(LENGTH + APPENDED, reader.get_length());
+        for (unsigned int i = 0; i < LENGTH + APPENDED; ++i) {
+            ASSERT_EQ_MSG(0, reader.safe_get_char(c));
+            ASSERT_EQ_MSG((char) ('a' + (i < LENGTH ? i : i - LENGTH) % 26), c);
+        }
+    }
+
+    // Removing the files gives back every cluster
+    const uint32_t last = fatValue;
+    const char     *names[2] = {NAME, "blocker"};
+    for (unsigned int file = 0; file < 2; ++file) {
+        FatFileWriter writer(*testable, names[file]);
+        ASSERT_EQ_MSG(0, writer.remove());
+        ASSERT_EQ_MSG(0, writer.flush());
+        ASSERT_FALSE(writer.exists());
+    }
+    for (uint32_t cluster = first; cluster <= last; ++cluster) {
+        ASSERT_EQ_MSG(0, testable->cluster_is_free(cluster, &isFree));
+        ASSERT_TRUE(isFree);
+    }
+
+    unlink(EXFAT_IMAGE_PATH);
+    tearDown();
+}
+
+TEST(ExFat_directoriesAndEmptyFiles) {
+    const char          CONTENT[] = "time,value\n";
+    DiskImage           image(EXFAT_IMAGE_PATH, EXFAT_IMAGE_SECTORS);
+    uint8_t             set[FatFS::EXFAT_MAX_SET_ENTRIES * FatFS::DIR_ENTRY_LENGTH];
+    bool                isFree;
+
+    testable = new FatFS(image, g_fatBuffer);
+    ASSERT_EQ_MSG(0, image.start());
+    ASSERT_EQ_MSG(0, FatImage::format_exfat(image, EXFAT_IMAGE_SECTORS));
+    ASSERT_EQ_MSG(0, testable->mount(g_buffer));
+
+    // An empty file has no cluster: the one it holds while open is given back when it is closed
+    uint32_t held;
+    {
+        FatFileWriter writer(*testable, "empty.txt");
+        ASSERT_EQ_MSG(0, writer.open());
+        held = writer.firstTier2;
+        ASSERT_NEQ_MSG(0, held);
+        ASSERT_EQ_MSG(0, writer.close());
+    }
+    ASSERT_EQ_MSG(0, testable->cluster_is_free(held, &isFree));
+    ASSERT_TRUE(isFree);
+    ASSERT_EQ_MSG(0, read_exfat_set("empty.txt", set));
+    ASSERT_EQ_MSG(0, image.get_long(FatFS::EXFAT_FIRST_CLUSTER, &set[FatFS::DIR_ENTRY_LENGTH]));
+    ASSERT_EQ_MSG(0, image.get_long(FatFS::EXFAT_DATA_LENGTH, &set[FatFS::DIR_ENTRY_LENGTH]));
+    {
+        FatFileReader reader(*testable, "EMPTY.TXT");
+        char          c;
+        ASSERT_EQ_MSG(0, reader.open());
+        ASSERT_EQ_MSG(0, reader.get_length());
+        ASSERT_EQ_MSG(PropWare::File::EOF_ERROR, reader.safe_get_char(c));
+    }
+
+    const uint32_t root = testable->m_dir_firstCluster;
+    ASSERT_EQ_MSG(0, testable->mkdir("Logs"));
+    ASSERT_EQ_MSG(0, testable->mkdir("Logs/October 2026"));
+    ASSERT_EQ_MSG(FatFS::ENTRY_EXISTS, testable->mkdir("LOGS"));
+    ASSERT_EQ_MSG(FatFS::INVALID_PATH, testable->mkdir("Logs/a name longer than thirty-one characters"));
+    ASSERT_EQ_MSG(FatFS::INVALID_PATH, testable->chdir("Logs/.."));
+    ASSERT_EQ_MSG(root, testable->m_dir_firstCluster);
+    ASSERT_EQ_MSG(0, read_exfat_set("Logs", set));
+    ASSERT_TRUE(FatFS::SUB_DIR_ATTRIBUTE & set[FatFS::EXFAT_FILE_ATTRIBUTES]);
+
+    {
+        FatFileWriter writer(*testable, "Logs/October 2026/Run 1.csv");
+        ASSERT_EQ_MSG(0, writer.open());
+        for (const char *p = CONTENT; *p; ++p)
+            ASSERT_EQ_MSG(0, writer.safe_put_char(*p));
+        ASSERT_EQ_MSG(0, writer.close());
+    }
+    {
+        FatFileReader reader(*testable, "logs/OCTOBER 2026/run 1.CSV");
+        char          c;
+        ASSERT_EQ_MSG(0, reader.open());
+        for (const char *p = CONTENT; *p; ++p) {
+            ASSERT_EQ_MSG(0, reader.safe_get_char(c));
+            ASSERT_EQ_MSG(*p, c);
+        }
+    }
+
+    ASSERT_EQ_MSG(0, testable->chdir("Logs/October 2026"));
+    FatDirectoryIterator        iterator(*testable);
+    FatDirectoryIterator::Entry entry;
+    ASSERT_EQ_MSG(0, iterator.next(&entry));
+    ASSERT_EQ_MSG(0, strcmp("Run 1.csv", entry.name));
+    ASSERT_FALSE(entry.is_directory());
+    ASSERT_EQ_MSG((unsigned int) strlen(CONTENT), entry.size);
+    ASSERT_EQ_MSG(FatFS::EOC_END, iterator.next(&entry));
+    ASSERT_EQ_MSG(0, testable->chdir("/"));
+
+    unlink(EXFAT_IMAGE_PATH);
+    tearDown();
+}
+
+TEST(ExFat_subdirectoriesGrow) {
+    const uint8_t  FILES        = 60;  // A 4 kB cluster holds 40 entry sets of three entries each
+    const uint8_t  IN_WORKING   = 35;  // Files before this one are created by path, the rest by name (and grow it)
+    const uint32_t CLUSTER_SIZE = 8 * DiskImage::SECTOR_SIZE;
+    DiskImage      image(EXFAT_IMAGE_PATH, EXFAT_IMAGE_SECTORS);
+    uint8_t        set[FatFS::EXFAT_MAX_SET_ENTRIES * FatFS::DIR_ENTRY_LENGTH];
+    char           name[20];
+
+    testable = new FatFS(image, g_fatBuffer);
+    ASSERT_EQ_MSG(0, image.start());
+    ASSERT_EQ_MSG(0, FatImage::format_exfat(image, EXFAT_IMAGE_SECTORS));
+    ASSERT_EQ_MSG(0, testable->mount(g_buffer));
+    ASSERT_EQ_MSG(0, testable->mkdir("Shard"));
+    ASSERT_EQ_MSG(0, testable->mkdir("Other"));
+
+    for (uint8_t i = 0; i < FILES; ++i) {
+        if (IN_WORKING == i) {
+            ASSERT_EQ_MSG(0, testable->chdir("Shard"));
+            // Leave a different directory as the one most recently found by path
+            FatFileWriter other(*testable, "/Other/other.txt");
+            ASSERT_EQ_MSG(0, other.open());
+            ASSERT_EQ_MSG(0, other.close());
+        }
+        if (IN_WORKING <= i)
+            sprintf(name, "f%02u.csv", i);
+        else
+            sprintf(name, "Shard/f%02u.csv", i);
+        FatFileWriter             writer(*testable, name);
+        const PropWare::ErrorCode err = writer.open();
+        error_checker(err);
+        ASSERT_EQ_MSG(0, err);
+        ASSERT_EQ_MSG(0, writer.safe_put_char((char) ('a' + i % 26)));
+        ASSERT_EQ_MSG(0, writer.close());
+    }
+    ASSERT_EQ_MSG(0, testable->chdir("/"));
+
+    // Everything must be on the device once the filesystem is unmounted
+    delete testable;
+    testable = new FatFS(image, g_fatBuffer);
+    ASSERT_EQ_MSG(0, testable->mount(g_buffer));
+    ASSERT_EQ_MSG(0, read_exfat_set("Shard", set));
+    const uint8_t *stream = &set[FatFS::DIR_ENTRY_LENGTH];
+    ASSERT_EQ_MSG(exfat_checksum(set, 1U + set[FatFS::EXFAT_SECONDARY_COUNT]),
+                  image.get_short(FatFS::EXFAT_SET_CHECKSUM, set));
+    ASSERT_EQ_MSG(2 * CLUSTER_SIZE, image.get_long(FatFS::EXFAT_DATA_LENGTH, stream));
+    ASSERT_EQ_MSG(2 * CLUSTER_SIZE, image.get_long(FatFS::EXFAT_VALID_DATA_LENGTH, stream));
+    ASSERT_FALSE(FatFS::EXFAT_NO_FAT_CHAIN & stream[FatFS::EXFAT_FLAGS]);
+
+    for (uint8_t i = 0; i < FILES; ++i) {
+        sprintf(name, "Shard/f%02u.csv", i);
+        FatFileReader reader(*testable, name);
+        ASSERT_EQ_MSG(0, reader.open());
+        ASSERT_EQ_MSG('a' + i % 26, reader.get_char());
+    }
+
+    ASSERT_EQ_MSG(0, testable->chdir("Shard"));
+    FatDirectoryIterator        iterator(*testable);
+    FatDirectoryIterator::Entry entry;
+    unsigned int                entries = 0;
+    PropWare::ErrorCode         err;
+    while (!(err = iterator.next(&entry)))
+        ++entries;
+    ASSERT_EQ_MSG(FatFS::EOC_END, err);
+    ASSERT_EQ_MSG(FILES, entries);
+    ASSERT_EQ_MSG(0, testable->chdir("/"));
+
+    unlink(EXFAT_IMAGE_PATH);
+    tearDown();
+}
+
+int main () {
+    PropWare::ErrorCode err;
+
+    START(FatFSHostTest);
+
+    if ((err = g_image.start()) || (err = FatImage::format_fat32(g_image, IMAGE_SECTORS))) {
+        error_checker(err);
+        failures = (uint8_t) -1;
+        COMPLETE();
+    }
+
+    RUN_TEST(Mount);
+    RUN_TEST(WriteThenRead);
+    RUN_TEST(Remount_keepsFreeCount);
+    RUN_TEST(FatCache_defersMirrorUntilSync);
+    RUN_TEST(Preallocate_writesWithoutTouchingFat);
+    RUN_TEST(CreateFile_extendsFullDirectory);
+    RUN_TEST(DirectoryIterator_readsEachDirectorySectorOnce);
+    RUN_TEST(DirectoryIndex_scansWhenDirectoryOutgrowsIt);
+    RUN_TEST(Subdirectories_openFilesByPath);
+    RUN_TEST(AllocationUnits_keepInterleavedFilesAligned);
+    RUN_TEST(SyncPolicy_groupsDirectoryUpdates);
+    RUN_TEST(SyncPolicy_commitsEveryNBytes);
+    RUN_TEST(SyncPolicy_commitsEveryNMilliseconds);
+    RUN_TEST(Close_writesFatBeforeLength);
+    RUN_TEST(OpenAppend_findsLastClusterWithMultiBlockReads);
+    RUN_TEST(BufferedFileLogger_dropsWholeRecordsWhenFull);
+    RUN_TEST(BufferedFileLogger_alignsDrainsToAppendedFile);
+    RUN_TEST(BorrowSector_accessesBufferInPlace);
+    // Leaves a directory behind in the root, so it runs after the other tests on this image
+    RUN_TEST(AllocationUnits_leaveErasedBlocksToFiles);
+    RUN_TEST(ExFat_contiguousFilesSkipTheFat);
+    RUN_TEST(ExFat_directoriesAndEmptyFiles);
+    RUN_TEST(ExFat_subdirectoriesGrow);
+
+    unlink(IMAGE_PATH);
+    COMPLETE();
+}
@@ -0,0 +1,288 @@
+/**
+ * @file        host/fatimage.h
+ *
+ * @author      David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <PropWare/PropWare.h>
+#include <PropWare/memory/blockstorage.h>
+#include <diskimage.h>
+
+namespace PropWare {
+
+/**
+ * @brief   Format a block storage device (typically a PropWare::DiskImage) with a FAT32 or exFAT filesystem, so that
+ *          host tests and benchmarks do not depend on external tools such as mkfs.fat
+ *
+ * The volume starts at sector 0 (no partition table). A FAT32 volume has two FATs, an FSInfo sector and an empty root
+ * directory in cluster 2 - the same layout produced by most formatting tools. An exFAT volume has one FAT, with the
+ * allocation bitmap, up-case table and root directory in the first clusters.
+ */
+class FatImage {
+    public:
+        typedef enum {
+            /** No error */                                 NO_ERROR         = 0,
+            /** First FatImage error code */                BEG_ERROR        = DiskImage::END_ERROR + 1,
+            /** The device is too small to hold FAT32 */    TOO_FEW_CLUSTERS = BEG_ERROR,
+            /** Last FatImage error code */                 END_ERROR        = TOO_FEW_CLUSTERS
+        } ErrorCode;
+
+        /** FAT32 requires at least this many clusters */
+        static const uint32_t MIN_FAT32_CLUSTERS = 65525;
+
+    public:
+        /**
+         * @brief       Write a fresh FAT32 filesystem to a device
+         *
+         * @param[in]   device              Destination; must already be started
+         * @param[in]   sectors             Number of sectors to use, starting at sector 0
+         * @param[in]   sectorsPerCluster   Power of two between 1 and 128
+         *
+         * @return      0 upon success, error code otherwise
+         */
+        static PropWare::ErrorCode format_fat32 (const BlockStorage &device, const uint32_t sectors,
+                                                 const uint8_t sectorsPerCluster = 1) {
+            PropWare::ErrorCode err;
+            const uint16_t      sectorSize       = device.get_sector_size();
+            const uint32_t      entriesPerSector = (uint32_t) (sectorSize >> 2);
+            uint8_t             buffer[sectorSize];
+
+            // Size the FAT generously: enough entries for every sector after the reserved area
+            const uint32_t fatSize  = ((sectors - RESERVED_SECTORS) / sectorsPerCluster + 2 + entriesPerSector - 1)
+                    / entriesPerSector;
+            const uint32_t clusters = (sectors - RESERVED_SECTORS - NUM_FATS * fatSize) / sectorsPerCluster;
+            if (MIN_FAT32_CLUSTERS > clusters)
+                return TOO_FEW_CLUSTERS;
+
+            // Boot sector, and its backup
+            memset(buffer, 0, sectorSize);
+            buffer[0] = 0xEB;
+            buffer[1] = 0x58;
+            buffer[2] = 0x90;
+            memcpy(&buffer[0x03], "PROPWARE", 8);
+            device.write_short(0x0B, buffer, sectorSize);
+            buffer[0x0D] = sectorsPerCluster;
+            device.write_short(0x0E, buffer, RESERVED_SECTORS);
+            buffer[0x10] = NUM_FATS;
+            buffer[0x15] = 0xF8;  // Fixed media
+            device.write_short(0x18, buffer, 63);  // Sectors per track
+            device.write_short(0x1A, buffer, 255);  // Heads
+            device.write_long(0x20, buffer, sectors);
+            device.write_long(0x24, buffer, fatSize);
+            device.write_long(0x2C, buffer, ROOT_CLUSTER);
+            device.write_short(0x30, buffer, FSINFO_SECTOR);
+            device.write_short(0x32, buffer, BACKUP_BOOT_SECTOR);
+            buffer[0x40] = 0x80;  // Drive number
+            buffer[0x42] = 0x29;  // Extended boot signature
+            device.write_long(0x43, buffer, 0x50574152);  // Volume ID
+            memcpy(&buffer[0x47], "PROPWARE   ", 11);
+            memcpy(&buffer[0x52], "FAT32   ", 8);
+            buffer[510] = 0x55;
+            buffer[511] = 0xAA;
+            check_errors(device.write_data_block(0, buffer));
+            check_errors(device.write_data_block(BACKUP_BOOT_SECTOR, buffer));
+
+            // FSInfo sector, and its backup. The root directory occupies the only cluster in use
+            memset(buffer, 0, sectorSize);
+            device.write_long(0, buffer, 0x41615252);
+            device.write_long(484, buffer, 0x61417272);
+            device.write_long(488, buffer, clusters - 1);
+            device.write_long(492, buffer, ROOT_CLUSTER + 1);
+            device.write_long(508, buffer, 0xAA550000);
+            check_errors(device.write_data_block(FSINFO_SECTOR, buffer));
+            check_errors(device.write_data_block(BACKUP_BOOT_SECTOR + FSINFO_SECTOR, buffer));
+
+            // Both copies of the FAT: media descriptor, reserved entry and end-of-chain for the root directory
+            for (uint32_t fatSector = 0; fatSector < fatSize; ++fatSector) {
+                memset(buffer, 0, sectorSize);
+                if (0 == fatSector) {
+                    device.write_long(0, buffer, 0x0FFFFFF8);
+                    device.write_long(4, buffer, 0x0FFFFFFF);
+                    device.write_long(ROOT_CLUSTER << 2, buffer, 0x0FFFFFFF);
+                }
+                for (uint8_t fat = 0; fat < NUM_FATS; ++fat)
+                    check_errors(device.write_data_block(RESERVED_SECTORS + fat * fatSize + fatSector, buffer));
+            }
+
+            // Empty root directory
+            memset(buffer, 0, sectorSize);
+            const uint32_t firstDataSector = RESERVED_SECTORS + NUM_FATS * fatSize;
+            for (uint8_t i = 0; i < sectorsPerCluster; ++i)
+                check_errors(device.write_data_block(firstDataSector + i, buffer));
+
+            return NO_ERROR;
+        }
+
+        /**
+         * @brief       Write a fresh exFAT filesystem to a device
+         *
+         * The up-case table is the minimal one (only 'a' through 'z' are mapped), which is all that the ASCII names
+         * supported by PropWare::FatFS need
+         *
+         * @param[in]   device                      Destination; must already be started
+         * @param[in]   sectors                     Number of sectors to use, starting at sector 0
+         * @param[in]   sectorsPerClusterShift      Base-2 logarithm of the number of sectors per cluster
+         *
+         * @return      0 upon success, error code otherwise
+         */
+        static PropWare::ErrorCode format_exfat (const BlockStorage &device, const uint32_t sectors,
+                                                 const uint8_t sectorsPerClusterShift = 3) {
+            PropWare::ErrorCode err;
+            const uint16_t      sectorSize        = device.get_sector_size();
+            const uint8_t       sectorShift       = device.get_sector_size_shift();
+            const uint32_t      sectorsPerCluster = (uint32_t) 1 << sectorsPerClusterShift;
+            uint8_t             buffer[sectorSize];
+
+            // The FAT is sized for the largest possible heap, which is then aligned to a cluster
+            const uint32_t maxClusters = (sectors - EXFAT_FAT_OFFSET) >> sectorsPerClusterShift;
+            const uint32_t fatLength   = (((maxClusters + 2) << 2) + sectorSize - 1) >> sectorShift;
+            const uint32_t heapOffset  = (EXFAT_FAT_OFFSET + fatLength + sectorsPerCluster - 1)
+                    & ~(sectorsPerCluster - 1);
+            const uint32_t clusters    = (sectors - heapOffset) >> sectorsPerClusterShift;
+            if (EXFAT_MIN_CLUSTERS > clusters)
+                return TOO_FEW_CLUSTERS;
+
+            // Allocation bitmap, up-case table and root directory, one after another
+            const uint32_t bitmapLength   = (clusters + 7) >> 3;
+            const uint32_t bitmapClusters = (bitmapLength + (sectorsPerCluster << sectorShift) - 1)
+                    >> (sectorShift + sectorsPerClusterShift);
+            const uint32_t upcaseCluster  = EXFAT_BITMAP_CLUSTER + bitmapClusters;
+            const uint32_t rootCluster    = upcaseCluster + 1;
+
+            // Main and backup boot regions
+            uint32_t checksum = 0;
+            for (uint8_t sector = 0; sector < EXFAT_BOOT_REGION_SECTORS; ++sector) {
+                memset(buffer, 0, sectorSize);
+                if (0 == sector) {
+                    buffer[0] = 0xEB;
+                    buffer[1] = 0x76;
+                    buffer[2] = 0x90;
+                    memcpy(&buffer[0x03], "EXFAT   ", 8);
+                    device.write_long(0x48, buffer, sectors);  // Volume length (low half)
+                    device.write_long(0x50, buffer, EXFAT_FAT_OFFSET);
+                    device.write_long(0x54, buffer, fatLength);
+                    device.write_long(0x58, buffer, heapOffset);
+                    device.write_long(0x5C, buffer, clusters);
+                    device.write_long(0x60, buffer, rootCluster);
+                    device.write_long(0x64, buffer, 0x50574152);  // Volume serial number
+                    device.write_short(0x68, buffer, 0x0100);  // Revision 1.00
+                    buffer[0x6C] = sectorShift;
+                    buffer[0x6D] = sectorsPerClusterShift;
+                    buffer[0x6E] = 1;  // Number of FATs
+                    buffer[0x6F] = 0x80;  // Drive select
+                    buffer[0x70] = 0xFF;  // Percent in use: unknown
+                }
+                if (8 >= sector) {  // The boot sector and the extended boot sectors
+                    buffer[sectorSize - 2] = 0x55;
+                    buffer[sectorSize - 1] = 0xAA;
+                }
+                if (EXFAT_BOOT_REGION_SECTORS - 1 == sector) {
+                    for (uint16_t i = 0; i < sectorSize; i += 4)
+                        device.write_long(i, buffer, checksum);
+                } else {
+                    // Volume flags and percent in use change at run time, so they are left out of the checksum
+                    for (uint16_t i = 0; i < sectorSize; ++i)
+                        if (0 != sector || (0x6A != i && 0x6B != i && 0x70 != i))
+                            checksum = ((checksum & 1) ? 0x80000000 : 0) + (checksum >> 1) + buffer[i];
+                }
+                check_errors(device.write_data_block(sector, buffer));
+                check_errors(device.write_data_block(EXFAT_BOOT_REGION_SECTORS + sector, buffer));
+            }
+
+            // The FAT: media descriptor, reserved entry, the bitmap's chain and end-of-chain for the other two
+            for (uint32_t fatSector = 0; fatSector < fatLength; ++fatSector) {
+                memset(buffer, 0, sectorSize);
+                for (uint32_t i = 0; i < (uint32_t) (sectorSize >> 2); ++i) {
+                    const uint32_t cluster = (fatSector << (sectorShift - 2)) + i;
+                    uint32_t       value   = 0;
+                    if (0 == cluster)
+                        value = 0xFFFFFFF8;
+                    else if (1 == cluster || upcaseCluster == cluster || rootCluster == cluster)
+                        value = 0xFFFFFFFF;
+                    else if (EXFAT_BITMAP_CLUSTER <= cluster && cluster < upcaseCluster)
+                        value = cluster + 1 == upcaseCluster ? 0xFFFFFFFF : cluster + 1;
+                    device.write_long((uint16_t) (i << 2), buffer, value);
+                }
+                check_errors(device.write_data_block(EXFAT_FAT_OFFSET + fatSector, buffer));
+            }
+
+            // Zero every cluster in use, then fill in their contents
+            memset(buffer, 0, sectorSize);
+            for (uint32_t sector = 0; sector < ((rootCluster - 1) << sectorsPerClusterShift); ++sector)
+                check_errors(device.write_data_block(heapOffset + sector, buffer));
+
+            const uint32_t used = rootCluster - 1;
+            for (uint32_t i = 0; i < used; ++i)
+                buffer[i >> 3] |= (uint8_t) (1 << (i & 7));
+            check_errors(device.write_data_block(heapOffset, buffer));
+
+            // Compressed: 0xFFFF followed by the length of a run of characters which map to themselves
+            const uint16_t upcase[]     = {0xFFFF, 'a', 'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H', 'I', 'J', 'K', 'L', 'M',
+                                           'N', 'O', 'P', 'Q', 'R', 'S', 'T', 'U', 'V', 'W', 'X', 'Y', 'Z', 0xFFFF,
+                                           (uint16_t) (0x10000 - '{')};
+            const uint16_t upcaseLength = sizeof(upcase);
+            uint32_t       upcaseSum    = 0;
+            memset(buffer, 0, sectorSize);
+            for (uint16_t i = 0; i < sizeof(upcase) / sizeof(upcase[0]); ++i)
+                device.write_short((uint16_t) (i << 1), buffer, upcase[i]);
+            for (uint16_t i = 0; i < upcaseLength; ++i)
+                upcaseSum = ((upcaseSum & 1) ? 0x80000000 : 0) + (upcaseSum >> 1) + buffer[i];
+            const uint32_t upcaseAddr = heapOffset + ((upcaseCluster - EXFAT_BITMAP_CLUSTER) << sectorsPerClusterShift);
+            check_errors(device.write_data_block(upcaseAddr, buffer));
+
+            // Root directory: volume label, allocation bitmap and up-case table
+            memset(buffer, 0, sectorSize);
+            uint8_t *label = &buffer[0];
+            label[0] = 0x83;
+            label[1] = 8;
+            for (uint8_t i = 0; i < 8; ++i)
+                device.write_short((uint16_t) (2 + (i << 1)), label, (uint8_t) "PROPWARE"[i]);
+            uint8_t *bitmap = &buffer[32];
+            bitmap[0] = 0x81;
+            device.write_long(20, bitmap, EXFAT_BITMAP_CLUSTER);
+            device.write_long(24, bitmap, bitmapLength);
+            uint8_t *upcaseEntry = &buffer[64];
+            upcaseEntry[0] = 0x82;
+            device.write_long(4, upcaseEntry, upcaseSum);
+            device.write_long(20, upcaseEntry, upcaseCluster);
+            device.write_long(24, upcaseEntry, upcaseLength);
+            check_errors(device.write_data_block(upcaseAddr + sectorsPerCluster, buffer));
+
+            return NO_ERROR;
+        }
+
+    private:
+        static const uint16_t RESERVED_SECTORS   = 32;
+        static const uint8_t  NUM_FATS           = 2;
+        static const uint32_t ROOT_CLUSTER       = 2;
+        static const uint16_t FSINFO_SECTOR      = 1;
+        static const uint16_t BACKUP_BOOT_SECTOR = 6;
+
+        static const uint32_t EXFAT_FAT_OFFSET          = 32;
+        static const uint8_t  EXFAT_BOOT_REGION_SECTORS = 12;
+        static const uint32_t EXFAT_BITMAP_CLUSTER      = 2;
+        static const uint32_t EXFAT_MIN_CLUSTERS        = 16;
+};
+
+}
@@ -0,0 +1,72 @@
+/**
+ * @file        host/hostsupport.cpp
+ *
+ * @author      David Zemon
+ *
+ * @brief       Definitions backing host/propeller.h, plus a `pwOut` that prints to the host's standard output
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <time.h>
+#include <propeller.h>
+#include <PropWare/hmi/output/printer.h>
+
+volatile uint32_t _OUTA;
+volatile uint32_t _DIRA;
+volatile uint32_t _INA;
+volatile uint32_t _CTRA;
+volatile uint32_t _FRQA;
+volatile uint32_t _PHSA;
+volatile uint32_t _CTRB;
+volatile uint32_t _FRQB;
+volatile uint32_t _PHSB;
+uint32_t          _clkfreq = 80000000;
+
+uint32_t _host_cnt (void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    const uint64_t nanoseconds = (uint64_t) now.tv_sec * 1000000000 + now.tv_nsec;
+    return (uint32_t) (nanoseconds * (_clkfreq / 1000000) / 1000);
+}
+
+namespace PropWare {
+
+/**
+ * @brief   Print to the host's standard output
+ */
+class StandardOutput : public PrintCapable {
+    public:
+        void put_char (const char c) {
+            putchar(c);
+        }
+
+        void puts (const char string[]) {
+            fputs(string, stdout);
+        }
+};
+
+}
+
+const PropWare::Printer::Format PropWare::Printer::DEFAULT_FORMAT;
+
+PropWare::StandardOutput _g_stdout;
+PropWare::Printer        pwOut(_g_stdout, false);
@@ -0,0 +1,139 @@
+/**
+ * @file        host/propeller.h
+ *
+ * @author      David Zemon
+ *
+ * @brief       Stand-in for PropGCC's propeller.h, just complete enough to build PropWare's filesystem and block
+ *              storage headers on a desktop Linux machine
+ *
+ * Hardware registers are plain variables and the system counter advances at CLKFREQ in real time, so code measuring
+ * elapsed time with CNT behaves sensibly. Nothing that talks to real pins will do anything useful.
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#ifdef __PROPELLER__
+#error "host/propeller.h must not be used when building for the Propeller"
+#endif
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern volatile uint32_t _OUTA;
+extern volatile uint32_t _DIRA;
+extern volatile uint32_t _INA;
+extern volatile uint32_t _CTRA;
+extern volatile uint32_t _FRQA;
+extern volatile uint32_t _PHSA;
+extern volatile uint32_t _CTRB;
+extern volatile uint32_t _FRQB;
+extern volatile uint32_t _PHSB;
+extern uint32_t          _clkfreq;
+
+/**
+ * @brief   Value of the Propeller's system counter, derived from the host's monotonic clock
+ */
+uint32_t _host_cnt (void);
+
+#define OUTA    _OUTA
+#define DIRA    _DIRA
+#define INA     _INA
+#define CTRA    _CTRA
+#define FRQA    _FRQA
+#define PHSA    _PHSA
+#define CTRB    _CTRB
+#define FRQB    _FRQB
+#define PHSB    _PHSB
+#define CNT     _host_cnt()
+#define CLKFREQ _clkfreq
+
+static inline void waitcnt (const uint32_t target) {
+    while ((int32_t) (target - CNT) > 0);
+}
+
+static inline uint32_t waitcnt2 (const uint32_t target, const uint32_t delta) {
+    waitcnt(target);
+    return target + delta;
+}
+
+static inline void waitpeq (const uint32_t state, const uint32_t mask) {
+    (void) state;
+    (void) mask;
+}
+
+static inline void waitpne (const uint32_t state, const uint32_t mask) {
+    (void) state;
+    (void) mask;
+}
+
+static inline int cogid (void) {
+    return 0;
+}
+
+static inline void cogstop (const int id) {
+    (void) id;
+}
+
+static inline int locknew (void) {
+    return 0;
+}
+
+static inline void lockret (const int id) {
+    (void) id;
+}
+
+static inline int lockset (const int id) {
+    (void) id;
+    return 0;
+}
+
+static inline void lockclr (const int id) {
+    (void) id;
+}
+
+/**
+ * @brief   Same as the `rev` instruction: reverse all 32 bits of `x` and then shift the result right by `bits`
+ */
+static inline uint32_t _host_rev (uint32_t x, const uint32_t bits) {
+    uint32_t reversed = 0;
+    for (int i = 0; i < 32; ++i) {
+        reversed = (reversed << 1) | (x & 1);
+        x >>= 1;
+    }
+    return 32 <= bits ? 0 : reversed >> bits;
+}
+
+static inline void _host_clkset (const uint32_t mode) {
+    (void) mode;
+}
+
+#define __builtin_propeller_rev(x, bits)    _host_rev(x, bits)
+#define __builtin_propeller_clkset(mode)    _host_clkset(mode)
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,218 @@
+/**
+ * @file    cachedblockstorage_test.cpp
+ *
+ * @author  David Zemon
+ *
+ * Hardware:
+ *      SD card connected with the following pins:
+ *          - MOSI = P0
+ *          - MISO = P1
+ *          - SCLK = P2
+ *          - CS   = P4
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "PropWareTests.h"
+#include <PropWare/memory/sd.h>
+#include <PropWare/memory/cachedblockstorage.h>
+
+using PropWare::SD;
+using PropWare::CachedBlockStorage;
+
+static const unsigned int SLOTS = 2;
+
+SD                       g_driver;
+CachedBlockStorage::Slot g_slots[SLOTS];
+CachedBlockStorage       *testable;
+
+void error_checker (const PropWare::ErrorCode err) {
+    if (err)
+        g_driver.print_error_str(pwOut, (SD::ErrorCode) err);
+}
+
+SETUP {
+    testable = new CachedBlockStorage(g_driver, g_slots);
+};
+
+TEARDOWN {
+    delete testable;
+    testable = NULL;
+}
+
+TEST(Constructor) {
+    setUp();
+
+    ASSERT_EQ_MSG(SLOTS, testable->get_slot_count());
+    ASSERT_EQ_MSG(0, testable->get_hits());
+    ASSERT_EQ_MSG(0, testable->get_misses());
+    for (unsigned int i = 0; i < SLOTS; ++i)
+        ASSERT_FALSE(g_slots[i].valid);
+
+    tearDown();
+}
+
+TEST(ReadDataBlock_hitsAndMisses) {
+    setUp();
+
+    uint8_t cached[SD::SECTOR_SIZE];
+    uint8_t uncached[SD::SECTOR_SIZE];
+
+    PropWare::ErrorCode err = testable->start();
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+
+    err = g_driver.read_data_block(0, uncached);
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+
+    err = testable->read_data_block(0, cached);
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+    ASSERT_EQ_MSG(0, testable->get_hits());
+    ASSERT_EQ_MSG(1, testable->get_misses());
+    ASSERT_EQ_MSG(0, memcmp(uncached, cached, sizeof(cached)));
+
+    memset(cached, 0, sizeof(cached));
+    err = testable->read_data_block(0, cached);
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+    ASSERT_EQ_MSG(1, testable->get_hits());
+    ASSERT_EQ_MSG(1, testable->get_misses());
+    ASSERT_EQ_MSG(0, memcmp(uncached, cached, sizeof(cached)));
+
+    tearDown();
+}
+
+TEST(ReadDataBlock_leastRecentlyUsedIsEvicted) {
+    setUp();
+
+    uint8_t buffer[SD::SECTOR_SIZE];
+
+    PropWare::ErrorCode err = testable->start();
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+
+    // Fill both slots and then touch sector 0 again, leaving sector 1 as the least recently used
+    ASSERT_EQ_MSG(0, testable->read_data_block(0, buffer));
+    ASSERT_EQ_MSG(0, testable->read_data_block(1, buffer));
+    ASSERT_EQ_MSG(0, testable->read_data_block(0, buffer));
+    ASSERT_EQ_MSG(0, testable->read_data_block(2, buffer));
+    ASSERT_EQ_MSG(1, testable->get_hits());
+    ASSERT_EQ_MSG(3, testable->get_misses());
+
+    // Sector 0 must have survived
+    ASSERT_EQ_MSG(0, testable->read_data_block(0, buffer));
+    ASSERT_EQ_MSG(2, testable->get_hits());
+
+    tearDown();
+}
+
+TEST(WriteDataBlock_writeBackOnFlush) {
+    setUp();
+
+    uint8_t       originalBlock[SD::SECTOR_SIZE];
+    uint8_t       moddedBlock[SD::SECTOR_SIZE];
+    const uint8_t *myData     = 0;
+    const uint8_t sdBlockAddr = 0;
+
+    PropWare::ErrorCode err = testable->start();
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+
+    err = g_driver.read_data_block(sdBlockAddr, originalBlock);
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+
+    // The write should only reach the cache...
+    err = testable->write_data_block(sdBlockAddr, myData);
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+    err = g_driver.read_data_block(sdBlockAddr, moddedBlock);
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+    ASSERT_EQ_MSG(0, memcmp(originalBlock, moddedBlock, SD::SECTOR_SIZE));
+    ASSERT_EQ_MSG(0, testable->get_write_backs());
+
+    // ...until the cache is flushed
+    err = testable->flush();
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+    ASSERT_EQ_MSG(1, testable->get_write_backs());
+    err = g_driver.read_data_block(sdBlockAddr, moddedBlock);
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+    ASSERT_EQ_MSG(0, memcmp(myData, moddedBlock, SD::SECTOR_SIZE));
+
+    // Put the original block back
+    err = testable->write_data_block(sdBlockAddr, originalBlock);
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+    err = testable->flush();
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+    err = g_driver.read_data_block(sdBlockAddr, moddedBlock);
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+    ASSERT_EQ_MSG(0, memcmp(originalBlock, moddedBlock, SD::SECTOR_SIZE));
+
+    tearDown();
+}
+
+TEST(NoSlots_bypassesCache) {
+    uint8_t            cached[SD::SECTOR_SIZE];
+    uint8_t            uncached[SD::SECTOR_SIZE];
+    CachedBlockStorage empty(g_driver, g_slots, 0);
+
+    PropWare::ErrorCode err = empty.start();
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+
+    err = g_driver.read_data_block(0, uncached);
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+
+    err = empty.read_data_block(0, cached);
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+    ASSERT_EQ_MSG(0, memcmp(uncached, cached, sizeof(cached)));
+    ASSERT_EQ_MSG(0, empty.get_hits());
+    ASSERT_EQ_MSG(0, empty.get_misses());
+
+    // Writes go straight through, too
+    err = empty.write_data_block(0, uncached);
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+    ASSERT_EQ_MSG(0, empty.get_write_backs());
+
+    return true;
+}
+
+int main () {
+    START(CachedBlockStorageTest);
+
+    RUN_TEST(Constructor);
+    RUN_TEST(ReadDataBlock_hitsAndMisses);
+    RUN_TEST(ReadDataBlock_leastRecentlyUsedIsEvicted);
+    RUN_TEST(WriteDataBlock_writeBackOnFlush);
+    RUN_TEST(NoSlots_bypassesCache);
+
+    COMPLETE();
+}
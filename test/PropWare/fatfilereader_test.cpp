@@ -165,6 +165,31 @@ TEST(Open_NonExistantFile) {
     tearDown();
 }
 
+TEST(Open_directoryIndex) {
+    FatFS::DirectoryIndexEntry index[64];
+    g_fs.set_directory_index(index);
+
+    // The first search scans the whole directory and builds the index
+    setUp();
+    ASSERT_TRUE(g_fs.directory_index_ready());
+    const uint32_t firstCluster = testable->firstTier2;
+    const int32_t  length       = testable->get_length();
+    tearDown();
+
+    // Subsequent searches go straight to the right sector
+    setUp();
+    ASSERT_TRUE(g_fs.directory_index_ready());
+    ASSERT_EQ_MSG(firstCluster, testable->firstTier2);
+    ASSERT_EQ_MSG(length, testable->get_length());
+    tearDown();
+
+    testable = new FatFileReader(g_fs, BOGUS_FILE_NAME);
+    ASSERT_FALSE(testable->exists());
+    tearDown();
+
+    g_fs.set_directory_index(NULL, 0);
+}
+
 TEST(SafeGetChar) {
     PropWare::ErrorCode err;
     setUp();
@@ -226,6 +251,130 @@ TEST(Seek) {
     tearDown();
 }
 
+TEST(ReadSectors) {
+    const unsigned int SECTORS = 2;
+    PropWare::ErrorCode err;
+    setUp();
+
+    const uint16_t sectorSize = g_driver.get_sector_size();
+    uint8_t        sectors[SECTORS * sectorSize];
+
+    err = testable->read_sectors(sectors, SECTORS);
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+    ASSERT_EQ_MSG(SECTORS * sectorSize, testable->tell());
+
+    // Compare against the same bytes read one character at a time
+    ASSERT_EQ_MSG(0, testable->seek(0, File::SeekDir::BEG));
+    for (unsigned int i = 0; i < sizeof(sectors); ++i) {
+        char c;
+        err = testable->safe_get_char(c);
+        error_checker(err);
+        ASSERT_EQ_MSG(0, err);
+        ASSERT_EQ_MSG((char) sectors[i], c);
+    }
+
+    tearDown();
+}
+
+TEST(ReadSectors_unaligned) {
+    setUp();
+
+    uint8_t sector[g_driver.get_sector_size()];
+    ASSERT_EQ_MSG(0, testable->seek(1, File::SeekDir::BEG));
+    ASSERT_EQ_MSG(FatFile::UNALIGNED_ACCESS, testable->read_sectors(sector, 1));
+
+    tearDown();
+}
+
+TEST(Read_spanningSectors) {
+    const unsigned int SECTORS = 2;
+    const unsigned int OFFSET  = 10;
+    PropWare::ErrorCode err;
+    setUp();
+
+    const uint16_t sectorSize = g_driver.get_sector_size();
+    uint8_t        sectors[SECTORS * sectorSize];
+    uint8_t        bytes[SECTORS * sectorSize - OFFSET];
+
+    err = testable->read_sectors(sectors, SECTORS);
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+
+    // An unaligned head followed by a whole sector exercises both the buffered and the direct path
+    ASSERT_EQ_MSG(0, testable->seek(OFFSET, File::SeekDir::BEG));
+    err = testable->read(bytes, sizeof(bytes));
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+    ASSERT_EQ_MSG(sizeof(sectors), testable->tell());
+    ASSERT_EQ_MSG(0, memcmp(&sectors[OFFSET], bytes, sizeof(bytes)));
+
+    ASSERT_EQ_MSG(0, testable->seek(0, File::SeekDir::END));
+    ASSERT_EQ_MSG(File::EOF_ERROR, testable->read(bytes, 1));
+
+    tearDown();
+}
+
+TEST(SafeGetChar_readAhead) {
+    const unsigned int SECTORS = 2;
+    PropWare::ErrorCode err;
+    setUp();
+
+    const uint16_t sectorSize = g_driver.get_sector_size();
+    uint8_t        sectors[SECTORS * sectorSize];
+    uint8_t        readAheadBuffer[sectorSize];
+
+    err = testable->read_sectors(sectors, SECTORS);
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+
+    // Every byte must match when the second sector comes from the read-ahead buffer
+    ASSERT_EQ_MSG(0, testable->set_read_ahead_buffer(readAheadBuffer));
+    ASSERT_EQ_MSG(0, testable->seek(0, File::SeekDir::BEG));
+    for (unsigned int i = 0; i < sizeof(sectors); ++i) {
+        char c;
+        err = testable->safe_get_char(c);
+        error_checker(err);
+        ASSERT_EQ_MSG(0, err);
+        ASSERT_EQ_MSG((char) sectors[i], c);
+        if (sectorSize - 1 == i)
+            ASSERT_EQ_MSG(1, testable->m_readAheadSector);
+    }
+
+    // Seeking backwards must discard the read-ahead and fall back to a normal load
+    ASSERT_EQ_MSG(0, testable->seek(0, File::SeekDir::BEG));
+    ASSERT_EQ_MSG((char) sectors[0], testable->get_char());
+
+    tearDown();
+}
+
+TEST(Seek_extentCache) {
+    FatFile::Extent extents[4];
+    setUp();
+
+    const int32_t lastByte = testable->get_length() - 1;
+    ASSERT_EQ_MSG(0, testable->seek(lastByte, File::SeekDir::BEG));
+    const char expectedLast = testable->get_char();
+    ASSERT_EQ_MSG(0, testable->seek(0, File::SeekDir::BEG));
+    const char expectedFirst = testable->get_char();
+
+    testable->set_extent_cache(extents);
+    ASSERT_EQ_MSG(1, testable->get_extent_count());
+
+    // Walking to the end of the file records the chain...
+    ASSERT_EQ_MSG(0, testable->seek(lastByte, File::SeekDir::BEG));
+    ASSERT_EQ_MSG(expectedLast, testable->get_char());
+    ASSERT_EQ_MSG(testable->m_curTier2 + 1, testable->m_extentCoverage);
+
+    // ...so that seeking backwards and forwards again resolves from the cache
+    ASSERT_EQ_MSG(0, testable->seek(0, File::SeekDir::BEG));
+    ASSERT_EQ_MSG(expectedFirst, testable->get_char());
+    ASSERT_EQ_MSG(0, testable->seek(lastByte, File::SeekDir::BEG));
+    ASSERT_EQ_MSG(expectedLast, testable->get_char());
+
+    tearDown();
+}
+
 int main () {
     START(FatFileReaderTest);
 
@@ -244,9 +393,15 @@ int main () {
     RUN_TEST(Exists_doeesNotExist);
     RUN_TEST(OpenClose);
     RUN_TEST(Open_NonExistantFile);
+    RUN_TEST(Open_directoryIndex);
     RUN_TEST(SafeGetChar);
     RUN_TEST(Tell);
     RUN_TEST(Seek);
+    RUN_TEST(ReadSectors);
+    RUN_TEST(ReadSectors_unaligned);
+    RUN_TEST(Read_spanningSectors);
+    RUN_TEST(SafeGetChar_readAhead);
+    RUN_TEST(Seek_extentCache);
 
     COMPLETE();
 }
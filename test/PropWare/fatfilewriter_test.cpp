@@ -363,6 +363,111 @@ TEST(CopyFile) {
     tearDown();
 }
 
+TEST(WriteSectors) {
+    const unsigned int SECTORS = 3;
+    PropWare::ErrorCode err;
+    setUp();
+
+    const uint16_t sectorSize = g_driver.get_sector_size();
+    uint8_t        sectors[SECTORS * sectorSize];
+    for (unsigned int i = 0; i < sizeof(sectors); ++i)
+        sectors[i] = (uint8_t) ('a' + i % 26);
+
+    err = testable->write_sectors(sectors, SECTORS);
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+    ASSERT_EQ_MSG(sizeof(sectors), testable->get_length());
+    ASSERT_EQ_MSG(sizeof(sectors), testable->tell());
+
+    err = testable->close();
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+
+    {
+        const BlockStorage   *driver = testable->m_driver;
+        BlockStorage::Buffer *buffer = testable->m_buf;
+        delete testable;
+        g_fs.flush_fat();
+
+        clear_buffer(driver, buffer);
+    }
+
+    FatFileReader reader(g_fs, NEW_FILE_NAME, buffer);
+    ASSERT_EQ_MSG(0, reader.open());
+    ASSERT_EQ_MSG(sizeof(sectors), reader.get_length());
+    for (unsigned int i = 0; i < sizeof(sectors); ++i)
+        ASSERT_EQ_MSG((char) sectors[i], reader.get_char());
+    reader.close();
+
+    testable = new FatFileWriter(g_fs, NEW_FILE_NAME, buffer);
+    err      = testable->remove();
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err); // testable->remove()
+    err = testable->flush();
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err); // testable->flush()
+
+    clear_buffer(testable);
+    ASSERT_FALSE(testable->exists());
+
+    tearDown();
+}
+
+TEST(Write_spanningSectors) {
+    const unsigned int SECTORS = 3;
+    const unsigned int HEAD    = 7;
+    PropWare::ErrorCode err;
+    setUp();
+
+    const uint16_t sectorSize = g_driver.get_sector_size();
+    uint8_t        bytes[SECTORS * sectorSize];
+    for (unsigned int i = 0; i < sizeof(bytes); ++i)
+        bytes[i] = (uint8_t) ('a' + i % 26);
+
+    // A short write leaves the pointer unaligned, so the second write has a buffered head followed by whole sectors
+    err = testable->write(bytes, HEAD);
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+    err = testable->write(&bytes[HEAD], sizeof(bytes) - HEAD);
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+    ASSERT_EQ_MSG(sizeof(bytes), testable->get_length());
+    ASSERT_EQ_MSG(sizeof(bytes), testable->tell());
+
+    err = testable->close();
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+
+    {
+        const BlockStorage   *driver = testable->m_driver;
+        BlockStorage::Buffer *buffer = testable->m_buf;
+        delete testable;
+        g_fs.flush_fat();
+
+        clear_buffer(driver, buffer);
+    }
+
+    FatFileReader reader(g_fs, NEW_FILE_NAME, buffer);
+    ASSERT_EQ_MSG(0, reader.open());
+    ASSERT_EQ_MSG(sizeof(bytes), reader.get_length());
+    for (unsigned int i = 0; i < sizeof(bytes); ++i)
+        ASSERT_EQ_MSG((char) bytes[i], reader.get_char());
+    reader.close();
+
+    testable = new FatFileWriter(g_fs, NEW_FILE_NAME, buffer);
+    err      = testable->remove();
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err); // testable->remove()
+    err = testable->flush();
+    error_checker(err);
+    ASSERT_EQ_MSG(0, err); // testable->flush()
+
+    clear_buffer(testable);
+    ASSERT_FALSE(testable->exists());
+
+    tearDown();
+}
+
 int main () {
     PropWare::ErrorCode err;
 
@@ -384,6 +489,8 @@ int main () {
     RUN_TEST(SafePutChar_singleChar);
     RUN_TEST(SafePutChar_MultiLine);
     RUN_TEST(CopyFile);
+    RUN_TEST(WriteSectors);
+    RUN_TEST(Write_spanningSectors);
 
     COMPLETE();
 }
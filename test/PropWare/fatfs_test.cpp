@@ -139,6 +139,42 @@ TEST(Mount_partition4) {
     tearDown();
 }
 
+TEST(FindEmptySpace_maintainsFreeSpaceBookkeeping) {
+    setUp();
+
+    PropWare::ErrorCode err;
+    uint8_t             buffer[testable->m_driver->get_sector_size()];
+    uint8_t             summary[16];
+    uint32_t            allocUnit;
+
+    err = testable->mount(buffer);
+    error_checker(err);
+    ASSERT_EQ_MSG(FatFS::NO_ERROR, err);
+    testable->set_free_space_summary(summary);
+    const uint32_t freeCount = testable->get_free_cluster_count();
+
+    err = testable->find_empty_space(1, &allocUnit);
+    error_checker(err);
+    ASSERT_EQ_MSG(FatFS::NO_ERROR, err);
+    ASSERT_EQ_MSG(allocUnit + 1, testable->m_nextFreeHint);
+    if (FatFS::UNKNOWN_FREE_COUNT != freeCount)
+        ASSERT_EQ_MSG(freeCount - 1, testable->get_free_cluster_count());
+
+    // Releasing the cluster must make it the first candidate again
+    err = testable->clear_chain(allocUnit);
+    error_checker(err);
+    ASSERT_EQ_MSG(FatFS::NO_ERROR, err);
+    ASSERT_EQ_MSG(allocUnit, testable->m_nextFreeHint);
+    ASSERT_EQ_MSG(freeCount, testable->get_free_cluster_count());
+    ASSERT_TRUE(testable->fat_sector_may_have_free(allocUnit >> testable->m_entriesPerFatSector_Shift));
+
+    err = testable->unmount();
+    error_checker(err);
+    ASSERT_EQ_MSG(FatFS::NO_ERROR, err);
+
+    tearDown();
+}
+
 TEST(ClearChain) {
     // TODO: Write test (and don't forget to invoke it in main)
 
@@ -154,6 +190,7 @@ int main () {
     RUN_TEST(Mount_partition0);
     RUN_TEST(Mount_partition1);
     RUN_TEST(Mount_partition4);
+    RUN_TEST(FindEmptySpace_maintainsFreeSpaceBookkeeping);
 
     COMPLETE();
 }
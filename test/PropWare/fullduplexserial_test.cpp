@@ -0,0 +1,137 @@
+/**
+ * @file    fullduplexserial_test.cpp
+ *
+ * @author  David Zemon
+ *
+ * Hardware:
+ *      Nothing may be connected to pin 12; it carries both transmit and receive
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "PropWareTests.h"
+#include <PropWare/serial/uart/fullduplexserial.h>
+
+using PropWare::FullDuplexSerial;
+
+// Transmitting and receiving on one pin loops every byte back to the driver cog
+const int PIN      = 12;
+const int BAUDRATE = 115200;
+
+char receiveBuffer[64];
+char transmitBuffer[32];
+
+FullDuplexSerial *testable;
+
+SETUP {
+    testable = new FullDuplexSerial(receiveBuffer, transmitBuffer, PIN, PIN, 0, BAUDRATE);
+};
+
+TEARDOWN {
+    if (NULL != testable) {
+        delete testable;
+        testable = NULL;
+    }
+};
+
+TEST(Write_readsBackThroughLoopback) {
+    const char message[] = "Longer than the transmit buffer, so write() has to wait for room";
+    char       received[sizeof(message)];
+    setUp();
+
+    ASSERT_NEQ_MSG(-1, testable->start());
+    testable->write(message, sizeof(message));
+    ASSERT_EQ_MSG(sizeof(message), testable->read(received, sizeof(received), 100 * MILLISECOND));
+    ASSERT_EQ_MSG(0, memcmp(message, received, sizeof(message)));
+
+    tearDown();
+}
+
+TEST(Read_wrapsAroundDefaultBuffers) {
+    const size_t LENGTH = 10;
+    char         sent[LENGTH];
+    char         received[LENGTH];
+    testable = new FullDuplexSerial(PIN, PIN, 0, BAUDRATE);
+
+    ASSERT_NEQ_MSG(-1, testable->start());
+
+    // Both 16-byte buffers wrap several times over, part way through a span
+    for (int round = 0; round < 5; ++round) {
+        for (size_t i = 0; i < LENGTH; ++i)
+            sent[i] = (char) ('a' + round * LENGTH + i);
+        testable->write(sent, LENGTH);
+        ASSERT_EQ_MSG(LENGTH, testable->read(received, LENGTH, 100 * MILLISECOND));
+        ASSERT_EQ_MSG(0, memcmp(sent, received, LENGTH));
+    }
+
+    tearDown();
+}
+
+TEST(Available_countsWaitingBytes) {
+    const char message[] = "0123456789";
+    char       received[sizeof(message)];
+    setUp();
+
+    ASSERT_NEQ_MSG(-1, testable->start());
+    ASSERT_EQ_MSG((size_t) 0, testable->available());
+
+    testable->write(message, sizeof(message));
+    const unsigned int start = CNT;
+    while (sizeof(message) != testable->available() && CNT - start < 100 * MILLISECOND);
+    ASSERT_EQ_MSG(sizeof(message), testable->available());
+
+    // A partial read leaves the rest waiting
+    ASSERT_EQ_MSG((size_t) 4, testable->read(received, 4, 0));
+    ASSERT_EQ_MSG(0, memcmp(message, received, 4));
+    ASSERT_EQ_MSG(sizeof(message) - 4, testable->available());
+
+    testable->truncate();
+    ASSERT_EQ_MSG((size_t) 0, testable->available());
+
+    // Nothing more is coming, so the timeout expires with nothing read
+    ASSERT_EQ_MSG((size_t) 0, testable->read(received, sizeof(received), MILLISECOND));
+
+    tearDown();
+}
+
+TEST(Write_consumesEchoes) {
+    const char message[] = "Each byte is echoed straight back";
+    testable = new FullDuplexSerial(receiveBuffer, transmitBuffer, PIN, PIN, FullDuplexSerial::IGNORE_TX_ECHO_ON_RX,
+                                    BAUDRATE);
+
+    ASSERT_NEQ_MSG(-1, testable->start());
+    testable->write(message, sizeof(message));
+    testable->puts(message);
+    ASSERT_EQ_MSG((size_t) 0, testable->available());
+
+    tearDown();
+}
+
+int main () {
+    START(FullDuplexSerialTest);
+
+    RUN_TEST(Write_readsBackThroughLoopback);
+    RUN_TEST(Read_wrapsAroundDefaultBuffers);
+    RUN_TEST(Available_countsWaitingBytes);
+    RUN_TEST(Write_consumesEchoes);
+
+    COMPLETE();
+}
@@ -102,6 +102,34 @@ TEST(ReadDataBlock) {
     tearDown();
 }
 
+TEST(ReadDataBlocks) {
+    setUp();
+
+    const unsigned int BLOCKS = 4;
+    uint8_t            multiBuffer[BLOCKS * SD::SECTOR_SIZE];
+    uint8_t            singleBuffer[SD::SECTOR_SIZE];
+
+    PropWare::ErrorCode err = testable->start();
+    sd_error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+
+    // Read a handful of blocks with a single multi-block command...
+    memset(multiBuffer, 0, sizeof(multiBuffer));
+    err = testable->read_data_blocks(0, BLOCKS, multiBuffer);
+    sd_error_checker(err);
+    ASSERT_EQ_MSG(SD::NO_ERROR, err);
+
+    // ...and make sure each one matches the same block read individually
+    for (unsigned int i = 0; i < BLOCKS; ++i) {
+        err = testable->read_data_block(i, singleBuffer);
+        sd_error_checker(err);
+        ASSERT_EQ_MSG(SD::NO_ERROR, err);
+        ASSERT_EQ_MSG(0, memcmp(singleBuffer, &multiBuffer[i * SD::SECTOR_SIZE], SD::SECTOR_SIZE));
+    }
+
+    tearDown();
+}
+
 TEST(WriteDataBlock) {
     setUp();
 
@@ -151,13 +179,64 @@ TEST(WriteDataBlock) {
     tearDown();
 }
 
+TEST(WriteDataBlocks) {
+    setUp();
+
+    const unsigned int BLOCKS = 2;
+    uint8_t            originalBlocks[BLOCKS * SD::SECTOR_SIZE];
+    uint8_t            moddedBlocks[BLOCKS * SD::SECTOR_SIZE];
+    const uint8_t      *myData     = 0;
+    const uint8_t      sdBlockAddr = 0;
+
+    PropWare::ErrorCode err = testable->start();
+    sd_error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+
+    err = testable->read_data_blocks(sdBlockAddr, BLOCKS, originalBlocks);
+    sd_error_checker(err);
+    ASSERT_EQ_MSG(SD::NO_ERROR, err);
+
+    // Write a random chunk of memory, both with and without pre-erasing
+    err = testable->write_data_blocks(sdBlockAddr, BLOCKS, myData);
+    sd_error_checker(err);
+    ASSERT_EQ_MSG(SD::NO_ERROR, err);
+    err = testable->read_data_blocks(sdBlockAddr, BLOCKS, moddedBlocks);
+    sd_error_checker(err);
+    ASSERT_EQ_MSG(SD::NO_ERROR, err);
+    ASSERT_EQ_MSG(0, memcmp(myData, moddedBlocks, sizeof(moddedBlocks)));
+    MESSAGE("WriteBlocks: Random blocks written with pre-erase");
+
+    err = testable->write_data_blocks(sdBlockAddr, BLOCKS, myData + SD::SECTOR_SIZE, false);
+    sd_error_checker(err);
+    ASSERT_EQ_MSG(SD::NO_ERROR, err);
+    err = testable->read_data_blocks(sdBlockAddr, BLOCKS, moddedBlocks);
+    sd_error_checker(err);
+    ASSERT_EQ_MSG(SD::NO_ERROR, err);
+    ASSERT_EQ_MSG(0, memcmp(myData + SD::SECTOR_SIZE, moddedBlocks, sizeof(moddedBlocks)));
+    MESSAGE("WriteBlocks: Random blocks written without pre-erase");
+
+    // Put the original blocks back
+    err = testable->write_data_blocks(sdBlockAddr, BLOCKS, originalBlocks);
+    sd_error_checker(err);
+    ASSERT_EQ_MSG(SD::NO_ERROR, err);
+    err = testable->read_data_blocks(sdBlockAddr, BLOCKS, moddedBlocks);
+    sd_error_checker(err);
+    ASSERT_EQ_MSG(SD::NO_ERROR, err);
+    ASSERT_EQ_MSG(0, memcmp(originalBlocks, moddedBlocks, sizeof(moddedBlocks)));
+    MESSAGE("WriteBlocks: Original blocks written back");
+
+    tearDown();
+}
+
 int main () {
     START(SDTest);
 
     RUN_TEST(DefaultConstructor_RELIES_ON_DNA_BOARD);
     RUN_TEST(Start);
     RUN_TEST(ReadDataBlock);
+    RUN_TEST(ReadDataBlocks);
     RUN_TEST(WriteDataBlock);
+    RUN_TEST(WriteDataBlocks);
 
     COMPLETE();
 }
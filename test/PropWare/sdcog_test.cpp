@@ -0,0 +1,158 @@
+/**
+ * @file    sdcog_test.cpp
+ *
+ * @author  David Zemon
+ *
+ * Hardware:
+ *      SD card connected with the following pins:
+ *          - MOSI = P0
+ *          - MISO = P1
+ *          - SCLK = P2
+ *          - CS   = P4
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "PropWareTests.h"
+#include <PropWare/memory/sdcog.h>
+
+using PropWare::SD;
+using PropWare::SDCog;
+
+SDCog *testable;
+
+void sd_error_checker (const PropWare::ErrorCode err) {
+    if (err)
+        testable->print_error_str(pwOut, (SDCog::ErrorCode) err);
+}
+
+SETUP {
+    testable = new SDCog();
+};
+
+TEARDOWN {
+    delete testable;
+}
+
+TEST(ReadDataBlock_notStarted) {
+    setUp();
+
+    uint8_t buffer[SD::SECTOR_SIZE];
+
+    ASSERT_EQ_MSG(SDCog::NOT_STARTED, testable->read_data_block(0, buffer));
+
+    tearDown();
+}
+
+TEST(Start) {
+    setUp();
+
+    PropWare::ErrorCode err = testable->start();
+    sd_error_checker(err);
+    ASSERT_EQ_MSG(SDCog::NO_ERROR, err);
+    ASSERT_NEQ_MSG(-1, testable->m_cogID);
+    ASSERT_FALSE(testable->is_busy());
+
+    tearDown();
+}
+
+TEST(SubmitRead) {
+    setUp();
+
+    const unsigned int BLOCKS = 2;
+    uint8_t            asyncBuffer[BLOCKS * SD::SECTOR_SIZE];
+    uint8_t            syncBuffer[SD::SECTOR_SIZE];
+
+    PropWare::ErrorCode err = testable->start();
+    sd_error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+
+    memset(asyncBuffer, 0, sizeof(asyncBuffer));
+    err = testable->submit_read(0, asyncBuffer, BLOCKS);
+    sd_error_checker(err);
+    ASSERT_EQ_MSG(SDCog::NO_ERROR, err);
+    err = testable->wait();
+    sd_error_checker(err);
+    ASSERT_EQ_MSG(SDCog::NO_ERROR, err);
+    ASSERT_FALSE(testable->is_busy());
+
+    // Each block should match the same block read with the blocking API
+    for (unsigned int i = 0; i < BLOCKS; ++i) {
+        err = testable->read_data_block(i, syncBuffer);
+        sd_error_checker(err);
+        ASSERT_EQ_MSG(SDCog::NO_ERROR, err);
+        ASSERT_EQ_MSG(0, memcmp(syncBuffer, &asyncBuffer[i * SD::SECTOR_SIZE], SD::SECTOR_SIZE));
+    }
+
+    tearDown();
+}
+
+TEST(SubmitWrite) {
+    setUp();
+
+    uint8_t       originalBlock[SD::SECTOR_SIZE];
+    uint8_t       moddedBlock[SD::SECTOR_SIZE];
+    const uint8_t *myData     = 0;
+    const uint8_t sdBlockAddr = 0;
+
+    PropWare::ErrorCode err = testable->start();
+    sd_error_checker(err);
+    ASSERT_EQ_MSG(0, err);
+
+    err = testable->read_data_block(sdBlockAddr, originalBlock);
+    sd_error_checker(err);
+    ASSERT_EQ_MSG(SDCog::NO_ERROR, err);
+
+    // Queue up a random block of memory and then the original block again - the second submission must wait for
+    // the first
+    err = testable->submit_write(sdBlockAddr, myData);
+    sd_error_checker(err);
+    ASSERT_EQ_MSG(SDCog::NO_ERROR, err);
+    err = testable->submit_read(sdBlockAddr, moddedBlock);
+    sd_error_checker(err);
+    ASSERT_EQ_MSG(SDCog::NO_ERROR, err);
+    err = testable->wait();
+    sd_error_checker(err);
+    ASSERT_EQ_MSG(SDCog::NO_ERROR, err);
+    ASSERT_EQ_MSG(0, memcmp(myData, moddedBlock, SD::SECTOR_SIZE));
+    MESSAGE("SubmitWrite: Random block written");
+
+    err = testable->submit_write(sdBlockAddr, originalBlock);
+    sd_error_checker(err);
+    ASSERT_EQ_MSG(SDCog::NO_ERROR, err);
+    err = testable->read_data_block(sdBlockAddr, moddedBlock);
+    sd_error_checker(err);
+    ASSERT_EQ_MSG(SDCog::NO_ERROR, err);
+    ASSERT_EQ_MSG(0, memcmp(originalBlock, moddedBlock, SD::SECTOR_SIZE));
+    MESSAGE("SubmitWrite: Original block written back");
+
+    tearDown();
+}
+
+int main () {
+    START(SDCogTest);
+
+    RUN_TEST(ReadDataBlock_notStarted);
+    RUN_TEST(Start);
+    RUN_TEST(SubmitRead);
+    RUN_TEST(SubmitWrite);
+
+    COMPLETE();
+}
@@ -28,10 +28,13 @@
 
 #include "PropWareTests.h"
 #include <PropWare/serial/spi/spi.h>
+#include <PropWare/serial/spi/staticspi.h>
+#include <PropWare/utility/utility.h>
 
 using PropWare::Pin;
 using PropWare::Port;
 using PropWare::SPI;
+using PropWare::StaticSPI;
 
 const Pin::Mask MOSI_MASK = Port::P0;
 const Pin::Mask MISO_MASK = Port::P1;
@@ -90,6 +93,158 @@ TEST(ShiftOutBlock) {
     tearDown();
 }
 
+TEST(ShiftOutBlock_AllModes) {
+    const SPI::Mode    MODES[]     = {SPI::Mode::MODE_0, SPI::Mode::MODE_1, SPI::Mode::MODE_2, SPI::Mode::MODE_3};
+    const SPI::BitMode BIT_MODES[] = {SPI::BitMode::MSB_FIRST, SPI::BitMode::LSB_FIRST};
+    const uint8_t      buffer[]    = {0x55, 0xAA, 0x0F};
+    setUp();
+
+    for (unsigned int mode = 0; mode < 4; ++mode)
+        for (unsigned int bitMode = 0; bitMode < 2; ++bitMode) {
+            testable->set_mode(MODES[mode]);
+            testable->set_bit_mode(BIT_MODES[bitMode]);
+            testable->shift_out_block(buffer, sizeof(buffer));
+        }
+
+    tearDown();
+}
+
+TEST(ExchangeBlock_Loopback) {
+    const SPI::Mode    MODES[]     = {SPI::Mode::MODE_0, SPI::Mode::MODE_1, SPI::Mode::MODE_2, SPI::Mode::MODE_3};
+    const SPI::BitMode BIT_MODES[] = {SPI::BitMode::MSB_FIRST, SPI::BitMode::LSB_FIRST};
+    const int          BUFFER_SIZE = 16;
+    setUp();
+
+    // Read MOSI back through INA: every byte received must be the byte that was sent
+    testable->set_miso(MOSI_MASK);
+    testable->set_mosi(MOSI_MASK);
+
+    uint8_t tx[BUFFER_SIZE];
+    uint8_t rx[BUFFER_SIZE];
+    for (uint8_t i = 0; i < BUFFER_SIZE; ++i)
+        tx[i] = (uint8_t) (0x81 + 0x1D * i);
+
+    for (unsigned int mode = 0; mode < 4; ++mode)
+        for (unsigned int bitMode = 0; bitMode < 2; ++bitMode) {
+            testable->set_mode(MODES[mode]);
+            testable->set_bit_mode(BIT_MODES[bitMode]);
+            memset(rx, 0, sizeof(rx));
+
+            testable->exchange_block(tx, rx, sizeof(tx));
+
+            for (int i = 0; i < BUFFER_SIZE; ++i)
+                ASSERT_EQ_MSG(tx[i], rx[i]);
+        }
+
+    tearDown();
+}
+
+/**
+ * Send a buffer with SPI::shift_out_block_nco while counter B adds up the system clocks for which its logic condition
+ * holds. Counter B's A input is MOSI and its B input is SCLK
+ */
+static uint32_t count_clocks_during_nco_write (const uint32_t logicMode, const uint8_t buffer[],
+                                               const size_t numberOfBytes) {
+    CTRB = logicMode << 26 | Port::from_mask(SCLK_MASK) << 9 | Port::from_mask(MOSI_MASK);
+    FRQB = 1;
+    PHSB = 0;
+    testable->shift_out_block_nco(buffer, numberOfBytes);
+    CTRB = 0;
+    return PHSB;
+}
+
+TEST(ShiftOutBlockNco_AllModes) {
+    const SPI::Mode    MODES[]           = {SPI::Mode::MODE_0, SPI::Mode::MODE_1, SPI::Mode::MODE_2, SPI::Mode::MODE_3};
+    const SPI::BitMode BIT_MODES[]       = {SPI::BitMode::MSB_FIRST, SPI::BitMode::LSB_FIRST};
+    const uint8_t      buffer[]          = {0x55, 0xAA, 0x0F, 0x80, 0xFF, 0x00, 0x01};
+    const uint32_t     LOGIC_A_AND_NOT_B = 0x12;
+    const uint32_t     LOGIC_NOT_B       = 0x13;
+    const uint32_t     LOGIC_A_AND_B     = 0x18;
+    const uint32_t     LOGIC_B           = 0x1C;
+    const uint32_t     HALF_PERIOD       = SPI::NCO_CLOCK_DIVISOR / 2;
+    setUp();
+
+    uint32_t ones = 0;
+    for (unsigned int i = 0; i < sizeof(buffer); ++i)
+        ones += PropWare::Utility::count_bits((uint32_t) buffer[i]);
+
+    for (unsigned int mode = 0; mode < 4; ++mode)
+        for (unsigned int bitMode = 0; bitMode < 2; ++bitMode) {
+            const bool idleHigh = SPI::clock_polarity(MODES[mode]);
+            testable->set_mode(MODES[mode]);
+            testable->set_bit_mode(BIT_MODES[bitMode]);
+
+            // SCLK leaves its idle level for exactly half a period per bit, and never between bytes
+            ASSERT_EQ_MSG(8 * (uint32_t) sizeof(buffer) * HALF_PERIOD,
+                          count_clocks_during_nco_write(idleHigh ? LOGIC_NOT_B : LOGIC_B, buffer, sizeof(buffer)));
+
+            // MOSI is high for the whole of that half period when a 1 is sent, and low throughout it for a 0
+            ASSERT_EQ_MSG(ones * HALF_PERIOD,
+                          count_clocks_during_nco_write(idleHigh ? LOGIC_A_AND_NOT_B : LOGIC_A_AND_B, buffer,
+                                                        sizeof(buffer)));
+        }
+
+    tearDown();
+}
+
+TEST(ShiftInBlockNco_HeldLine) {
+    const SPI::Mode    MODES[]     = {SPI::Mode::MODE_0, SPI::Mode::MODE_1, SPI::Mode::MODE_2, SPI::Mode::MODE_3};
+    const SPI::BitMode BIT_MODES[] = {SPI::BitMode::MSB_FIRST, SPI::BitMode::LSB_FIRST};
+    const int          BUFFER_SIZE = 16;
+    const Pin          line(Port::P4, Pin::Dir::OUT);
+    setUp();
+
+    // Read back a pin that this cog holds steady, to prove the counter's clock does not upset sampling
+    testable->set_miso(Port::P4);
+
+    uint8_t buffer[BUFFER_SIZE];
+    for (unsigned int mode = 0; mode < 4; ++mode)
+        for (unsigned int bitMode = 0; bitMode < 2; ++bitMode) {
+            testable->set_mode(MODES[mode]);
+            testable->set_bit_mode(BIT_MODES[bitMode]);
+
+            line.clear();
+            testable->shift_in_block_nco(buffer, sizeof(buffer));
+            for (int i = 0; i < BUFFER_SIZE; ++i)
+                ASSERT_EQ_MSG(0x00, buffer[i]);
+
+            line.set();
+            testable->shift_in_block_nco(buffer, sizeof(buffer));
+            for (int i = 0; i < BUFFER_SIZE; ++i)
+                ASSERT_EQ_MSG(0xFF, buffer[i]);
+        }
+
+    line.set_dir_in();
+    tearDown();
+}
+
+template<SPI::Mode MODE, SPI::BitMode BITMODE>
+static bool static_spi_loops_back (SPI &bus) {
+    const StaticSPI<MODE, BITMODE> device(bus);
+    const uint8_t                  tx[] = {0x81, 0x3C, 0xA5, 0x0F};
+    uint8_t                        rx[sizeof(tx)];
+
+    device.configure_bus();
+    device.shift_out(12, 0xA5C);
+    device.exchange_block(tx, rx, sizeof(tx));
+    return 0 == memcmp(tx, rx, sizeof(tx));
+}
+
+TEST(StaticSPI_ExchangeBlock_Loopback) {
+    setUp();
+
+    testable->set_miso(MOSI_MASK);
+    testable->set_mosi(MOSI_MASK);
+
+    ASSERT_TRUE((static_spi_loops_back<SPI::Mode::MODE_0, SPI::BitMode::MSB_FIRST>(*testable)));
+    ASSERT_TRUE((static_spi_loops_back<SPI::Mode::MODE_1, SPI::BitMode::LSB_FIRST>(*testable)));
+    ASSERT_TRUE((static_spi_loops_back<SPI::Mode::MODE_2, SPI::BitMode::MSB_FIRST>(*testable)));
+    ASSERT_TRUE((static_spi_loops_back<SPI::Mode::MODE_3, SPI::BitMode::LSB_FIRST>(*testable)));
+    ASSERT_TRUE(SPI::Mode::MODE_3 == testable->m_mode);
+
+    tearDown();
+}
+
 int main () {
     CS.set();
     START(SPITest_MUST_USE_LOGIC_ANALYZER);
@@ -97,6 +252,11 @@ int main () {
     RUN_TEST(ShiftOut_MsbFirst);
     RUN_TEST(ShiftOut_LsbFirst);
     RUN_TEST(ShiftOutBlock);
+    RUN_TEST(ShiftOutBlock_AllModes);
+    RUN_TEST(ExchangeBlock_Loopback);
+    RUN_TEST(ShiftOutBlockNco_AllModes);
+    RUN_TEST(ShiftInBlockNco_HeldLine);
+    RUN_TEST(StaticSPI_ExchangeBlock_Loopback);
 
     COMPLETE();
 }